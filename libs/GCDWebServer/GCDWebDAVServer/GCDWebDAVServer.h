@@ -40,7 +40,8 @@ NS_ASSUME_NONNULL_BEGIN
 @optional
 
 /**
- *  This method is called whenever a file has been downloaded.
+ *  This method is called whenever a file or a directory as a zip archive has
+ *  been downloaded.
  */
 - (void)davServer:(GCDWebDAVServer*)server didDownloadFileAtPath:(NSString*)path;
 
@@ -76,6 +77,9 @@ NS_ASSUME_NONNULL_BEGIN
  *  WebDAV server. It is also partially class 2 compliant but only when the
  *  client is the OS X WebDAV implementation (so it can work with the OS X Finder).
  *
+ *  A GET request for a directory with the "download=zip" query parameter
+ *  returns the directory's allowed contents as a zip archive streamed on the fly.
+ *
  *  See the README.md file for more information about the features of GCDWebDAVServer.
  */
 @interface GCDWebDAVServer : GCDWebServer
@@ -31,6 +31,8 @@
 
 // WebDAV specifications: http://webdav.org/specs/rfc4918.html
 
+#import <sys/stat.h>
+
 // Requires "HEADER_SEARCH_PATHS = $(SDKROOT)/usr/include/libxml2" in Xcode build settings
 #import <libxml/parser.h>
 
@@ -44,6 +46,8 @@
 #import "GCDWebServerDataResponse.h"
 #import "GCDWebServerErrorResponse.h"
 #import "GCDWebServerFileResponse.h"
+#import "GCDWebServerStreamedResponse.h"
+#import "GCDWebServerZipResponse.h"
 
 #define kXMLParseOptions (XML_PARSE_NONET | XML_PARSE_RECOVER | XML_PARSE_NOBLANKS | XML_PARSE_COMPACT | XML_PARSE_NOWARNING | XML_PARSE_NOERROR)
 
@@ -55,8 +59,37 @@ typedef NS_ENUM(NSInteger, DAVProperties) {
   kDAVAllProperties = kDAVProperty_ResourceType | kDAVProperty_CreationDate | kDAVProperty_LastModified | kDAVProperty_ContentLength
 };
 
+#define kPROPFINDChunkSize (64 * 1024)
+#define kPROPFINDCacheCountLimit 64
+
 NS_ASSUME_NONNULL_BEGIN
 
+// Cached property response of a directory item, reused while its inode, size,
+// and modification & status change dates are unchanged
+@interface GCDWebDAVListingItem : NSObject
+@property(nonatomic, copy) NSString* name;
+@property(nonatomic) struct stat info;
+@property(nonatomic, nullable) NSData* response;  // nil if the item is not listed, ie. a disallowed file extension
+@end
+
+@implementation GCDWebDAVListingItem
+@end
+
+// Cached Depth 1 PROPFIND listing of a directory, the item names are reused
+// while the directory modification date is unchanged & the items while the
+// requested properties, resource path, and filtering settings match
+@interface GCDWebDAVListing : NSObject
+@property(nonatomic) struct timespec modificationDate;
+@property(nonatomic) DAVProperties properties;
+@property(nonatomic, copy) NSString* resourcePath;
+@property(nonatomic) BOOL allowHiddenItems;
+@property(nonatomic, copy, nullable) NSArray<NSString*>* allowedFileExtensions;
+@property(nonatomic, copy) NSArray<GCDWebDAVListingItem*>* items;
+@end
+
+@implementation GCDWebDAVListing
+@end
+
 @interface GCDWebDAVServer (Methods)
 - (nullable GCDWebServerResponse*)performOPTIONS:(GCDWebServerRequest*)request;
 - (nullable GCDWebServerResponse*)performGET:(GCDWebServerRequest*)request;
@@ -71,13 +104,17 @@ NS_ASSUME_NONNULL_BEGIN
 
 NS_ASSUME_NONNULL_END
 
-@implementation GCDWebDAVServer
+@implementation GCDWebDAVServer {
+  NSCache<NSString*, GCDWebDAVListing*>* _listingCache;
+}
 
 @dynamic delegate;
 
 - (instancetype)initWithUploadDirectory:(NSString*)path {
   if ((self = [super init])) {
     _uploadDirectory = [path copy];
+    _listingCache = [[NSCache alloc] init];
+    _listingCache.countLimit = kPROPFINDCacheCountLimit;
     GCDWebDAVServer* __unsafe_unretained server = self;
 
     // 9.1 PROPFIND method
@@ -179,6 +216,29 @@ static inline BOOL _IsMacFinder(GCDWebServerRequest* request) {
   return response;
 }
 
+// Stream a directory as a zip archive, applying the same rules to its contents
+// as to individual downloads
+- (GCDWebServerResponse*)_zipResponseForDirectory:(NSString*)absolutePath {
+  GCDWebServerZipResponse* response = [GCDWebServerZipResponse responseWithDirectory:absolutePath
+                                                                               filter:^BOOL(NSString* relativePath, BOOL isDirectory) {
+                                                                                 NSString* itemName = [relativePath lastPathComponent];
+                                                                                 if ([itemName hasPrefix:@"."] && !self.allowHiddenItems) {
+                                                                                   return NO;
+                                                                                 }
+                                                                                 return (isDirectory || [self _checkFileExtension:itemName]);
+                                                                               }];
+  if (response == nil) {
+    return [GCDWebServerErrorResponse responseWithServerError:kGCDWebServerHTTPStatusCode_InternalServerError message:@"Failed zipping \"%@\"", [absolutePath lastPathComponent]];
+  }
+
+  if ([self.delegate respondsToSelector:@selector(davServer:didDownloadFileAtPath:)]) {
+    dispatch_async(dispatch_get_main_queue(), ^{
+      [self.delegate davServer:self didDownloadFileAtPath:absolutePath];
+    });
+  }
+  return response;
+}
+
 - (GCDWebServerResponse*)performGET:(GCDWebServerRequest*)request {
   NSString* relativePath = request.path;
   NSString* absolutePath = [_uploadDirectory stringByAppendingPathComponent:GCDWebServerNormalizePath(relativePath)];
@@ -194,6 +254,9 @@ static inline BOOL _IsMacFinder(GCDWebServerRequest* request) {
 
   // Because HEAD requests are mapped to GET ones, we need to handle directories but it's OK to return nothing per http://webdav.org/specs/rfc4918.html#rfc.section.9.4
   if (isDirectory) {
+    if ([[request.query objectForKey:@"download"] isEqualToString:@"zip"]) {
+      return [self _zipResponseForDirectory:absolutePath];
+    }
     return [GCDWebServerResponse response];
   }
 
@@ -423,16 +486,33 @@ static inline xmlNodePtr _XMLChildWithName(xmlNodePtr child, const xmlChar* name
   return NULL;
 }
 
+static inline NSDate* _NSDateFromTimeSpec(const struct timespec* t) {
+  return [NSDate dateWithTimeIntervalSince1970:((NSTimeInterval)t->tv_sec + (NSTimeInterval)t->tv_nsec / 1000000000.0)];
+}
+
+static inline BOOL _IsEqualTimeSpec(struct timespec a, struct timespec b) {
+  return (a.tv_sec == b.tv_sec) && (a.tv_nsec == b.tv_nsec);
+}
+
+static inline BOOL _IsUnchangedItem(const struct stat* a, const struct stat* b) {
+  return (a->st_ino == b->st_ino) && (a->st_size == b->st_size) && _IsEqualTimeSpec(a->st_mtimespec, b->st_mtimespec) && _IsEqualTimeSpec(a->st_ctimespec, b->st_ctimespec);
+}
+
 - (void)_addPropertyResponseForItem:(NSString*)itemPath resource:(NSString*)resourcePath properties:(DAVProperties)properties xmlString:(NSMutableString*)xmlString {
+  struct stat info;
+  if (lstat([itemPath fileSystemRepresentation], &info) == 0) {
+    [self _addPropertyResponseForItem:itemPath info:&info resource:resourcePath properties:properties xmlString:xmlString];
+  }
+}
+
+- (void)_addPropertyResponseForItem:(NSString*)itemPath info:(const struct stat*)info resource:(NSString*)resourcePath properties:(DAVProperties)properties xmlString:(NSMutableString*)xmlString {
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wdeprecated-declarations"
   CFStringRef escapedPath = CFURLCreateStringByAddingPercentEscapes(kCFAllocatorDefault, (__bridge CFStringRef)resourcePath, NULL, CFSTR("<&>?+"), kCFStringEncodingUTF8);
 #pragma clang diagnostic pop
   if (escapedPath) {
-    NSDictionary* attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:itemPath error:NULL];
-    NSString* type = [attributes objectForKey:NSFileType];
-    BOOL isFile = [type isEqualToString:NSFileTypeRegular];
-    BOOL isDirectory = [type isEqualToString:NSFileTypeDirectory];
+    BOOL isFile = S_ISREG(info->st_mode);
+    BOOL isDirectory = S_ISDIR(info->st_mode);
     if ((isFile && [self _checkFileExtension:itemPath]) || isDirectory) {
       [xmlString appendString:@"<D:response>"];
       [xmlString appendFormat:@"<D:href>%@</D:href>", escapedPath];
@@ -447,16 +527,16 @@ static inline xmlNodePtr _XMLChildWithName(xmlNodePtr child, const xmlChar* name
         }
       }
 
-      if ((properties & kDAVProperty_CreationDate) && [attributes objectForKey:NSFileCreationDate]) {
-        [xmlString appendFormat:@"<D:creationdate>%@</D:creationdate>", GCDWebServerFormatISO8601((NSDate*)[attributes fileCreationDate])];
+      if (properties & kDAVProperty_CreationDate) {
+        [xmlString appendFormat:@"<D:creationdate>%@</D:creationdate>", GCDWebServerFormatISO8601(_NSDateFromTimeSpec(&info->st_birthtimespec))];
       }
 
-      if ((properties & kDAVProperty_LastModified) && isFile && [attributes objectForKey:NSFileModificationDate]) {  // Last modification date is not useful for directories as it changes implicitely and 'Last-Modified' header is not provided for directories anyway
-        [xmlString appendFormat:@"<D:getlastmodified>%@</D:getlastmodified>", GCDWebServerFormatRFC822((NSDate*)[attributes fileModificationDate])];
+      if ((properties & kDAVProperty_LastModified) && isFile) {  // Last modification date is not useful for directories as it changes implicitely and 'Last-Modified' header is not provided for directories anyway
+        [xmlString appendFormat:@"<D:getlastmodified>%@</D:getlastmodified>", GCDWebServerFormatRFC822(_NSDateFromTimeSpec(&info->st_mtimespec))];
       }
 
-      if ((properties & kDAVProperty_ContentLength) && !isDirectory && [attributes objectForKey:NSFileSize]) {
-        [xmlString appendFormat:@"<D:getcontentlength>%llu</D:getcontentlength>", [attributes fileSize]];
+      if ((properties & kDAVProperty_ContentLength) && !isDirectory) {
+        [xmlString appendFormat:@"<D:getcontentlength>%llu</D:getcontentlength>", (unsigned long long)info->st_size];
       }
 
       [xmlString appendString:@"</D:prop>"];
@@ -470,6 +550,87 @@ static inline xmlNodePtr _XMLChildWithName(xmlNodePtr child, const xmlChar* name
   }
 }
 
+// Returns the property responses of the listed items of a directory, reusing
+// the cached listing & the responses of the items which haven't changed
+- (nullable NSArray<NSData*>*)_propertyResponsesForDirectory:(NSString*)absolutePath resource:(NSString*)resourcePath properties:(DAVProperties)properties error:(NSError**)error {
+  struct stat info;
+  if (stat([absolutePath fileSystemRepresentation], &info) != 0) {
+    if (error) {
+      *error = GCDWebServerMakePosixError(errno);
+    }
+    return nil;
+  }
+
+  GCDWebDAVListing* listing = [_listingCache objectForKey:absolutePath];
+  if (listing && !((listing.properties == properties) && [listing.resourcePath isEqualToString:resourcePath] && (listing.allowHiddenItems == _allowHiddenItems) &&
+                   ((listing.allowedFileExtensions == _allowedFileExtensions) || [listing.allowedFileExtensions isEqualToArray:_allowedFileExtensions]))) {
+    listing = nil;
+  }
+  __block BOOL changed = (listing == nil);
+
+  // Only re-read & sort the names when the directory itself has changed
+  NSArray<GCDWebDAVListingItem*>* previousItems = listing.items;
+  NSArray<NSString*>* names = nil;
+  NSMutableDictionary<NSString*, GCDWebDAVListingItem*>* previousItemsByName = nil;
+  if (listing && _IsEqualTimeSpec(listing.modificationDate, info.st_mtimespec)) {
+    names = [previousItems valueForKey:@"name"];
+  } else {
+    names = [[[NSFileManager defaultManager] contentsOfDirectoryAtPath:absolutePath error:error] sortedArrayUsingSelector:@selector(localizedStandardCompare:)];
+    if (names == nil) {
+      return nil;
+    }
+    if (!_allowHiddenItems) {
+      names = [names objectsAtIndexes:[names indexesOfObjectsPassingTest:^BOOL(NSString* name, NSUInteger index, BOOL* stop) {
+                       return ![name hasPrefix:@"."];
+                     }]];
+    }
+    previousItemsByName = [[NSMutableDictionary alloc] initWithCapacity:previousItems.count];
+    for (GCDWebDAVListingItem* item in previousItems) {
+      [previousItemsByName setObject:item forKey:item.name];
+    }
+    previousItems = nil;
+    changed = YES;
+  }
+
+  NSMutableArray<GCDWebDAVListingItem*>* items = [[NSMutableArray alloc] initWithCapacity:names.count];
+  NSMutableArray<NSData*>* responses = [[NSMutableArray alloc] initWithCapacity:names.count];
+  NSMutableString* xmlString = [[NSMutableString alloc] init];
+  [names enumerateObjectsUsingBlock:^(NSString* name, NSUInteger index, BOOL* stop) {
+    NSString* itemPath = [absolutePath stringByAppendingPathComponent:name];
+    struct stat itemInfo;
+    if (lstat([itemPath fileSystemRepresentation], &itemInfo) != 0) {
+      return;  // Removed since the directory was read
+    }
+    GCDWebDAVListingItem* item = (previousItems ? [previousItems objectAtIndex:index] : [previousItemsByName objectForKey:name]);
+    struct stat previousInfo = item.info;
+    if (item == nil || !_IsUnchangedItem(&previousInfo, &itemInfo)) {
+      [xmlString setString:@""];
+      [self _addPropertyResponseForItem:itemPath info:&itemInfo resource:[resourcePath stringByAppendingString:name] properties:properties xmlString:xmlString];
+      item = [[GCDWebDAVListingItem alloc] init];
+      item.name = name;
+      item.info = itemInfo;
+      item.response = (xmlString.length ? [xmlString dataUsingEncoding:NSUTF8StringEncoding] : nil);
+      changed = YES;
+    }
+    [items addObject:item];
+    if (item.response) {
+      [responses addObject:(NSData*)item.response];
+    }
+  }];
+
+  if (changed || (items.count != names.count)) {
+    listing = [[GCDWebDAVListing alloc] init];
+    listing.modificationDate = info.st_mtimespec;
+    listing.properties = properties;
+    listing.resourcePath = resourcePath;
+    listing.allowHiddenItems = _allowHiddenItems;
+    listing.allowedFileExtensions = _allowedFileExtensions;
+    listing.items = items;
+    [_listingCache setObject:listing forKey:absolutePath];
+  }
+  return responses;
+}
+
 - (GCDWebServerResponse*)performPROPFIND:(GCDWebServerDataRequest*)request {
   NSInteger depth;
   NSString* depthHeader = [request.headers objectForKey:@"Depth"];
@@ -534,35 +695,58 @@ static inline xmlNodePtr _XMLChildWithName(xmlNodePtr child, const xmlChar* name
     return [GCDWebServerErrorResponse responseWithClientError:kGCDWebServerHTTPStatusCode_Forbidden message:@"Retrieving properties for item name \"%@\" is not allowed", itemName];
   }
 
-  NSArray* items = nil;
-  if (isDirectory) {
-    NSError* error = nil;
-    items = [[[NSFileManager defaultManager] contentsOfDirectoryAtPath:absolutePath error:&error] sortedArrayUsingSelector:@selector(localizedStandardCompare:)];
-    if (items == nil) {
-      return [GCDWebServerErrorResponse responseWithServerError:kGCDWebServerHTTPStatusCode_InternalServerError underlyingError:error message:@"Failed listing directory \"%@\"", relativePath];
-    }
-  }
-
   NSMutableString* xmlString = [NSMutableString stringWithString:@"<?xml version=\"1.0\" encoding=\"utf-8\" ?>"];
   [xmlString appendString:@"<D:multistatus xmlns:D=\"DAV:\">\n"];
   if (![relativePath hasPrefix:@"/"]) {
     relativePath = [@"/" stringByAppendingString:relativePath];
   }
   [self _addPropertyResponseForItem:absolutePath resource:relativePath properties:properties xmlString:xmlString];
-  if (depth == 1) {
-    if (![relativePath hasSuffix:@"/"]) {
-      relativePath = [relativePath stringByAppendingString:@"/"];
-    }
-    for (NSString* item in items) {
-      if (_allowHiddenItems || ![item hasPrefix:@"."]) {
-        [self _addPropertyResponseForItem:[absolutePath stringByAppendingPathComponent:item] resource:[relativePath stringByAppendingString:item] properties:properties xmlString:xmlString];
-      }
-    }
+  if (!isDirectory || (depth == 0)) {
+    [xmlString appendString:@"</D:multistatus>"];
+    GCDWebServerDataResponse* response = [GCDWebServerDataResponse responseWithData:(NSData*)[xmlString dataUsingEncoding:NSUTF8StringEncoding]
+                                                                        contentType:@"application/xml; charset=\"utf-8\""];
+    response.statusCode = kGCDWebServerHTTPStatusCode_MultiStatus;
+    return response;
   }
-  [xmlString appendString:@"</D:multistatus>"];
 
-  GCDWebServerDataResponse* response = [GCDWebServerDataResponse responseWithData:(NSData*)[xmlString dataUsingEncoding:NSUTF8StringEncoding]
-                                                                      contentType:@"application/xml; charset=\"utf-8\""];
+  if (![relativePath hasSuffix:@"/"]) {
+    relativePath = [relativePath stringByAppendingString:@"/"];
+  }
+  NSError* error = nil;
+  NSArray<NSData*>* itemResponses = [self _propertyResponsesForDirectory:absolutePath resource:relativePath properties:properties error:&error];
+  if (itemResponses == nil) {
+    return [GCDWebServerErrorResponse responseWithServerError:kGCDWebServerHTTPStatusCode_InternalServerError underlyingError:error message:@"Failed listing directory \"%@\"", relativePath];
+  }
+
+  // Stream the listing in chunks of the item responses, the length is known
+  // up front so clients still get a "Content-Length" header
+  NSData* headerData = (NSData*)[xmlString dataUsingEncoding:NSUTF8StringEncoding];
+  NSData* footerData = (NSData*)[@"</D:multistatus>" dataUsingEncoding:NSUTF8StringEncoding];
+  NSUInteger contentLength = headerData.length + footerData.length;
+  for (NSData* data in itemResponses) {
+    contentLength += data.length;
+  }
+  __block NSUInteger index = 0;
+  __block BOOL finished = NO;
+  GCDWebServerStreamedResponse* response = [GCDWebServerStreamedResponse responseWithContentType:@"application/xml; charset=\"utf-8\""
+                                                                                     streamBlock:^NSData*(NSError** streamError) {
+                                                                                       if (finished) {
+                                                                                         return [NSData data];
+                                                                                       }
+                                                                                       NSMutableData* chunk = [[NSMutableData alloc] initWithCapacity:kPROPFINDChunkSize];
+                                                                                       if (index == 0) {
+                                                                                         [chunk appendData:headerData];
+                                                                                       }
+                                                                                       while ((index < itemResponses.count) && (chunk.length < kPROPFINDChunkSize)) {
+                                                                                         [chunk appendData:[itemResponses objectAtIndex:index++]];
+                                                                                       }
+                                                                                       if (index == itemResponses.count) {
+                                                                                         [chunk appendData:footerData];
+                                                                                         finished = YES;
+                                                                                       }
+                                                                                       return chunk;
+                                                                                     }];
+  response.contentLength = contentLength;
   response.statusCode = kGCDWebServerHTTPStatusCode_MultiStatus;
   return response;
 }
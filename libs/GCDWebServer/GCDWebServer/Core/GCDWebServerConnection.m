@@ -38,8 +38,8 @@
 #import "GCDWebServerPrivate.h"
 
 #define kHeadersReadCapacity (1 * 1024)
-#define kBodyReadCapacity (256 * 1024)
 
+typedef void (^ReadBufferCompletionBlock)(dispatch_data_t _Nullable buffer);
 typedef void (^ReadDataCompletionBlock)(BOOL success);
 typedef void (^ReadHeadersCompletionBlock)(NSData* extraData);
 typedef void (^ReadBodyCompletionBlock)(BOOL success);
@@ -60,6 +60,7 @@ static int32_t _connectionCounter = 0;
 NS_ASSUME_NONNULL_BEGIN
 
 @interface GCDWebServerConnection (Read)
+- (void)readBufferWithLength:(NSUInteger)length completionBlock:(ReadBufferCompletionBlock)block;
 - (void)readData:(NSMutableData*)data withLength:(NSUInteger)length completionBlock:(ReadDataCompletionBlock)block;
 - (void)readHeaders:(NSMutableData*)headersData withCompletionBlock:(ReadHeadersCompletionBlock)block;
 - (void)readBodyWithRemainingLength:(NSUInteger)length completionBlock:(ReadBodyCompletionBlock)block;
@@ -412,35 +413,48 @@ NS_ASSUME_NONNULL_END
 
 @implementation GCDWebServerConnection (Read)
 
-- (void)readData:(NSMutableData*)data withLength:(NSUInteger)length completionBlock:(ReadDataCompletionBlock)block {
+- (void)readBufferWithLength:(NSUInteger)length completionBlock:(ReadBufferCompletionBlock)block {
   dispatch_read(_socket, length, dispatch_get_global_queue(_server.dispatchQueuePriority, 0), ^(dispatch_data_t buffer, int error) {
     @autoreleasepool {
       if (error == 0) {
         size_t size = dispatch_data_get_size(buffer);
         if (size > 0) {
-          NSUInteger originalLength = data.length;
           dispatch_data_apply(buffer, ^bool(dispatch_data_t region, size_t chunkOffset, const void* chunkBytes, size_t chunkSize) {
-            [data appendBytes:chunkBytes length:chunkSize];
+            [self didReadBytes:chunkBytes length:chunkSize];
             return true;
           });
-          [self didReadBytes:((char*)data.bytes + originalLength) length:(data.length - originalLength)];
-          block(YES);
+          block(buffer);
         } else {
           if (self->_totalBytesRead > 0) {
             GWS_LOG_ERROR(@"No more data available on socket %i", self->_socket);
           } else {
             GWS_LOG_WARNING(@"No data received from socket %i", self->_socket);
           }
-          block(NO);
+          block(nil);
         }
       } else {
         GWS_LOG_ERROR(@"Error while reading from socket %i: %s (%i)", self->_socket, strerror(error), error);
-        block(NO);
+        block(nil);
       }
     }
   });
 }
 
+- (void)readData:(NSMutableData*)data withLength:(NSUInteger)length completionBlock:(ReadDataCompletionBlock)block {
+  [self readBufferWithLength:length
+             completionBlock:^(dispatch_data_t buffer) {
+               if (buffer) {
+                 dispatch_data_apply(buffer, ^bool(dispatch_data_t region, size_t chunkOffset, const void* chunkBytes, size_t chunkSize) {
+                   [data appendBytes:chunkBytes length:chunkSize];
+                   return true;
+                 });
+                 block(YES);
+               } else {
+                 block(NO);
+               }
+             }];
+}
+
 - (void)readHeaders:(NSMutableData*)headersData withCompletionBlock:(ReadHeadersCompletionBlock)block {
   GWS_DCHECK(_requestMessage);
   [self readData:headersData
@@ -472,33 +486,32 @@ NS_ASSUME_NONNULL_END
 
 - (void)readBodyWithRemainingLength:(NSUInteger)length completionBlock:(ReadBodyCompletionBlock)block {
   GWS_DCHECK([_request hasBody] && ![_request usesChunkedTransferEncoding]);
-  NSMutableData* bodyData = [[NSMutableData alloc] initWithCapacity:kBodyReadCapacity];
-  [self readData:bodyData
-           withLength:length
-      completionBlock:^(BOOL success) {
-        if (success) {
-          if (bodyData.length <= length) {
-            NSError* error = nil;
-            if ([self->_request performWriteData:bodyData error:&error]) {
-              NSUInteger remainingLength = length - bodyData.length;
-              if (remainingLength) {
-                [self readBodyWithRemainingLength:remainingLength completionBlock:block];
-              } else {
-                block(YES);
-              }
-            } else {
-              GWS_LOG_ERROR(@"Failed writing request body on socket %i: %@", self->_socket, error);
-              block(NO);
-            }
-          } else {
-            GWS_LOG_ERROR(@"Unexpected extra content reading request body on socket %i", self->_socket);
-            block(NO);
-            GWS_DNOT_REACHED();
-          }
-        } else {
-          block(NO);
-        }
-      }];
+  [self readBufferWithLength:length
+             completionBlock:^(dispatch_data_t buffer) {
+               if (buffer) {
+                 NSData* bodyData = (__bridge NSData*)buffer;  // Passed on as read, writers which can take discontiguous data avoid a copy
+                 if (bodyData.length <= length) {
+                   NSError* error = nil;
+                   if ([self->_request performWriteData:bodyData error:&error]) {
+                     NSUInteger remainingLength = length - bodyData.length;
+                     if (remainingLength) {
+                       [self readBodyWithRemainingLength:remainingLength completionBlock:block];
+                     } else {
+                       block(YES);
+                     }
+                   } else {
+                     GWS_LOG_ERROR(@"Failed writing request body on socket %i: %@", self->_socket, error);
+                     block(NO);
+                   }
+                 } else {
+                   GWS_LOG_ERROR(@"Unexpected extra content reading request body on socket %i", self->_socket);
+                   block(NO);
+                   GWS_DNOT_REACHED();
+                 }
+               } else {
+                 block(NO);
+               }
+             }];
 }
 
 static inline NSUInteger _ScanHexNumber(const void* bytes, NSUInteger size) {
@@ -570,14 +583,25 @@ static inline NSUInteger _ScanHexNumber(const void* bytes, NSUInteger size) {
 @implementation GCDWebServerConnection (Write)
 
 - (void)writeData:(NSData*)data withCompletionBlock:(WriteDataCompletionBlock)block {
-  dispatch_data_t buffer = dispatch_data_create(data.bytes, data.length, dispatch_get_global_queue(_server.dispatchQueuePriority, 0), ^{
-    [data self];  // Keeps ARC from releasing data too early
-  });
+  dispatch_data_t buffer;
+  if ([data conformsToProtocol:@protocol(OS_dispatch_data)]) {
+    buffer = (__bridge dispatch_data_t)data;  // Written as is, ie. file data read with dispatch I/O
+#if !OS_OBJECT_USE_OBJC_RETAIN_RELEASE
+    dispatch_retain(buffer);
+#endif
+  } else {
+    buffer = dispatch_data_create(data.bytes, data.length, dispatch_get_global_queue(_server.dispatchQueuePriority, 0), ^{
+      [data self];  // Keeps ARC from releasing data too early
+    });
+  }
   dispatch_write(_socket, buffer, dispatch_get_global_queue(_server.dispatchQueuePriority, 0), ^(dispatch_data_t remainingData, int error) {
     @autoreleasepool {
       if (error == 0) {
         GWS_DCHECK(remainingData == NULL);
-        [self didWriteBytes:data.bytes length:data.length];
+        dispatch_data_apply(buffer, ^bool(dispatch_data_t region, size_t chunkOffset, const void* chunkBytes, size_t chunkSize) {
+          [self didWriteBytes:chunkBytes length:chunkSize];
+          return true;
+        });
         block(YES);
       } else {
         GWS_LOG_ERROR(@"Error while writing to socket %i: %s (%i)", self->_socket, strerror(error), error);
@@ -57,10 +57,28 @@
   return YES;
 }
 
+// Data read from the socket is usually discontiguous dispatch data, so each
+// of its byte ranges is written in turn instead of flattening it first
 - (BOOL)writeData:(NSData*)data error:(NSError**)error {
-  if (write(_file, data.bytes, data.length) != (ssize_t)data.length) {
+  __block int result = 0;
+  [data enumerateByteRangesUsingBlock:^(const void* bytes, NSRange byteRange, BOOL* stop) {
+    size_t offset = 0;
+    while (offset < byteRange.length) {
+      ssize_t written = write(self->_file, (const char*)bytes + offset, byteRange.length - offset);
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        result = errno;
+        *stop = YES;
+        return;
+      }
+      offset += written;
+    }
+  }];
+  if (result) {
     if (error) {
-      *error = GCDWebServerMakePosixError(errno);
+      *error = GCDWebServerMakePosixError(result);
     }
     return NO;
   }
@@ -36,6 +36,9 @@ NS_ASSUME_NONNULL_BEGIN
  *  It will automatically set the contentType, lastModifiedDate and eTag
  *  properties of the GCDWebServerResponse according to the file extension and
  *  metadata.
+ *
+ *  Unless the body is encoded, it is read through a dispatch I/O channel and
+ *  the resulting dispatch data is written to the socket as is.
  */
 @interface GCDWebServerFileResponse : GCDWebServerResponse
 @property(nonatomic, copy) NSString* contentType;  // Redeclare as non-null
@@ -33,13 +33,14 @@
 
 #import "GCDWebServerPrivate.h"
 
-#define kFileReadBufferSize (32 * 1024)
+#define kFileReadBufferSize (256 * 1024)
 
 @implementation GCDWebServerFileResponse {
   NSString* _path;
   NSUInteger _offset;
   NSUInteger _size;
   int _file;
+  dispatch_io_t _channel;
 }
 
 @dynamic contentType, lastModifiedDate, eTag;
@@ -145,35 +146,86 @@ static inline NSDate* _NSDateFromTimeSpec(const struct timespec* t) {
     }
     return NO;
   }
-  if (lseek(_file, _offset, SEEK_SET) != (off_t)_offset) {
-    if (error) {
-      *error = GCDWebServerMakePosixError(errno);
-    }
-    close(_file);
-    return NO;
-  }
   return YES;
 }
 
+// Used when the body is encoded, ie. gzip, reads at the current offset into
+// an uninitialized buffer
 - (NSData*)readData:(NSError**)error {
   size_t length = MIN((NSUInteger)kFileReadBufferSize, _size);
-  NSMutableData* data = [[NSMutableData alloc] initWithLength:length];
-  ssize_t result = read(_file, data.mutableBytes, length);
-  if (result < 0) {
-    if (error) {
-      *error = GCDWebServerMakePosixError(errno);
+  void* buffer = length ? malloc(length) : NULL;
+  ssize_t result = length ? pread(_file, buffer, length, _offset) : 0;
+  if (result <= 0) {
+    free(buffer);
+    if (result < 0) {
+      if (error) {
+        *error = GCDWebServerMakePosixError(errno);
+      }
+      return nil;
     }
-    return nil;
+    return [NSData data];
+  }
+  _offset += result;
+  _size -= result;
+  return [[NSData alloc] initWithBytesNoCopy:buffer length:result freeWhenDone:YES];
+}
+
+// Used when the body is sent as is, reads through a dispatch I/O channel &
+// passes the dispatch data on so it is written to the socket without a copy
+- (void)asyncReadDataWithCompletion:(GCDWebServerBodyReaderCompletionBlock)block {
+  if (_size == 0) {
+    block([NSData data], nil);
+    return;
   }
-  if (result > 0) {
-    [data setLength:result];
-    _size -= result;
+  dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+  if (_channel == NULL) {
+    int file = _file;
+    _channel = dispatch_io_create(DISPATCH_IO_RANDOM, file, queue, ^(int error) {
+      close(file);
+    });
+    if (_channel == NULL) {
+      block(nil, GCDWebServerMakePosixError(EBADF));
+      return;
+    }
+    _file = -1;  // Closed by the channel
   }
-  return data;
+  __block dispatch_data_t chunk = dispatch_data_empty;
+  dispatch_io_read(_channel, _offset, MIN((NSUInteger)kFileReadBufferSize, _size), queue, ^(bool done, dispatch_data_t data, int error) {
+    if (data) {
+      dispatch_data_t concat = dispatch_data_create_concat(chunk, data);
+#if !OS_OBJECT_USE_OBJC_RETAIN_RELEASE
+      dispatch_release(chunk);
+#endif
+      chunk = concat;
+    }
+    if (!done) {
+      return;
+    }
+    if (error) {
+      block(nil, GCDWebServerMakePosixError(error));
+    } else {
+      size_t length = dispatch_data_get_size(chunk);  // Short if the file was truncated
+      self->_offset += length;
+      self->_size = (length ? self->_size - length : 0);
+      block((__bridge NSData*)chunk, nil);
+    }
+#if !OS_OBJECT_USE_OBJC_RETAIN_RELEASE
+    dispatch_release(chunk);
+#endif
+  });
 }
 
 - (void)close {
-  close(_file);
+  if (_channel) {
+    dispatch_io_close(_channel, DISPATCH_IO_STOP);
+#if !OS_OBJECT_USE_OBJC_RETAIN_RELEASE
+    dispatch_release(_channel);
+#endif
+    _channel = NULL;
+  } else if (_file > 0) {
+    close(_file);
+    _file = -1;
+  }
 }
 
 - (NSString*)description {
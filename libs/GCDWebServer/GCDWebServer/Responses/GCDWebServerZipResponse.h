@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+
+#import "GCDWebServerResponse.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  The GCDWebServerZipItemFilterBlock is called for each item found in the
+ *  directory and returns YES if the item should be added to the archive.
+ *  Returning NO for a directory skips its contents.
+ */
+typedef BOOL (^GCDWebServerZipItemFilterBlock)(NSString* relativePath, BOOL isDirectory);
+
+/**
+ *  The GCDWebServerZipResponse subclass of GCDWebServerResponse streams a
+ *  directory on disk as a zip archive which is built on the fly.
+ *
+ *  The directory is walked as the body is read and each file is compressed in
+ *  chunks, so memory use is bounded by the chunk size plus the central
+ *  directory regardless of the size of the files. Entries use data
+ *  descriptors as the output can't seek, zip64 is used for files of 4 GiB
+ *  or more, and already compressed media like audio and images is stored.
+ *
+ *  The body is sent with chunked transfer encoding as its length is unknown
+ *  and the "Content-Disposition" HTTP header is set for a download of
+ *  "<directory name>.zip".
+ */
+@interface GCDWebServerZipResponse : GCDWebServerResponse
+@property(nonatomic, copy) NSString* contentType;  // Redeclare as non-null
+
+/**
+ *  Creates a response with the contents of a directory.
+ */
++ (nullable instancetype)responseWithDirectory:(NSString*)path;
+
+/**
+ *  Creates a response with the contents of a directory, only adding the items
+ *  passing the filter.
+ */
++ (nullable instancetype)responseWithDirectory:(NSString*)path filter:(nullable GCDWebServerZipItemFilterBlock)filter;
+
+/**
+ *  This method is the designated initializer for the class.
+ *
+ *  Entries are named relative to the directory's parent, so the archive
+ *  unpacks into a directory of the same name. Returns nil if the path is not
+ *  a directory.
+ */
+- (nullable instancetype)initWithDirectory:(NSString*)path filter:(nullable GCDWebServerZipItemFilterBlock)filter;
+
+@end
+
+NS_ASSUME_NONNULL_END
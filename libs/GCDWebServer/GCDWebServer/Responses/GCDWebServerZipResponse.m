@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+
+#if !__has_feature(objc_arc)
+#error GCDWebServer requires ARC
+#endif
+
+#import <sys/stat.h>
+#import <time.h>
+
+#import "GCDWebServerPrivate.h"
+
+#import "minizip/zip.h"
+
+#define kZipReadBufferSize (64 * 1024)
+#define kZipChunkSize (64 * 1024)
+
+#define kZipFlagDataDescriptor (1 << 3)
+#define kZipFlagUTF8 (1 << 11)
+#define kZipVersionMadeByUnix ((3 << 8) | 20)  // Keeps the mode in external_fa
+
+// Output sink for the zip writer, appends to the pending body data & only
+// allows seeking to the current position as the body can't be rewound
+typedef struct {
+  CFMutableDataRef data;  // Not retained
+  ZPOS64_T position;
+} GWSZipOutput;
+
+static voidpf ZCALLBACK _ZipOpen(voidpf opaque, const void* filename, int mode) {
+  return opaque;
+}
+
+static uLong ZCALLBACK _ZipRead(voidpf opaque, voidpf stream, void* buf, uLong size) {
+  return 0;
+}
+
+static uLong ZCALLBACK _ZipWrite(voidpf opaque, voidpf stream, const void* buf, uLong size) {
+  GWSZipOutput* output = (GWSZipOutput*)stream;
+  CFDataAppendBytes(output->data, (const UInt8*)buf, (CFIndex)size);
+  output->position += size;
+  return size;
+}
+
+static ZPOS64_T ZCALLBACK _ZipTell(voidpf opaque, voidpf stream) {
+  return ((GWSZipOutput*)stream)->position;
+}
+
+static long ZCALLBACK _ZipSeek(voidpf opaque, voidpf stream, ZPOS64_T offset, int origin) {
+  GWSZipOutput* output = (GWSZipOutput*)stream;
+  if (origin == ZLIB_FILEFUNC_SEEK_SET) {
+    return (offset == output->position ? 0 : -1);
+  }
+  return (offset == 0 ? 0 : -1);
+}
+
+static int ZCALLBACK _ZipClose(voidpf opaque, voidpf stream) {
+  return 0;
+}
+
+static int ZCALLBACK _ZipError(voidpf opaque, voidpf stream) {
+  return 0;
+}
+
+// Deflating these barely shrinks them, so they are stored
+static inline BOOL _IsCompressedMedia(NSString* extension) {
+  static NSSet* extensions = nil;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    extensions = [NSSet setWithArray:@[ @"wav", @"wave", @"aif", @"aiff", @"caf", @"mp3", @"m4a", @"aac", @"ogg", @"oga", @"opus", @"flac",
+                                        @"jpg", @"jpeg", @"png", @"gif", @"mp4", @"mov", @"zip", @"pdz", @"rjz" ]];
+  });
+  return [extensions containsObject:[extension lowercaseString]];
+}
+
+@implementation GCDWebServerZipResponse {
+  NSString* _path;
+  GCDWebServerZipItemFilterBlock _filter;
+  NSDirectoryEnumerator* _enumerator;
+  GWSZipOutput _output;
+  NSMutableData* _pending;
+  NSMutableData* _buffer;
+  zipFile _zip;
+  int _file;
+  BOOL _finished;
+}
+
+@dynamic contentType;
+
++ (instancetype)responseWithDirectory:(NSString*)path {
+  return [(GCDWebServerZipResponse*)[[self class] alloc] initWithDirectory:path filter:nil];
+}
+
++ (instancetype)responseWithDirectory:(NSString*)path filter:(GCDWebServerZipItemFilterBlock)filter {
+  return [(GCDWebServerZipResponse*)[[self class] alloc] initWithDirectory:path filter:filter];
+}
+
+- (instancetype)initWithDirectory:(NSString*)path filter:(GCDWebServerZipItemFilterBlock)filter {
+  struct stat info;
+  if (lstat([path fileSystemRepresentation], &info) || !S_ISDIR(info.st_mode)) {
+    GWS_DNOT_REACHED();
+    return nil;
+  }
+
+  if ((self = [super init])) {
+    _path = [path copy];
+    _filter = [filter copy];
+    _file = -1;
+
+    NSString* fileName = [[path lastPathComponent] stringByAppendingPathExtension:@"zip"];
+    NSData* data = [[fileName stringByReplacingOccurrencesOfString:@"\"" withString:@""] dataUsingEncoding:NSISOLatin1StringEncoding allowLossyConversion:YES];
+    NSString* lossyFileName = data ? [[NSString alloc] initWithData:data encoding:NSISOLatin1StringEncoding] : nil;
+    if (lossyFileName) {
+      NSString* value = [NSString stringWithFormat:@"attachment; filename=\"%@\"; filename*=UTF-8''%@", lossyFileName, GCDWebServerEscapeURLString(fileName)];
+      [self setValue:value forAdditionalHeader:@"Content-Disposition"];
+    }
+
+    self.contentType = @"application/zip";
+  }
+  return self;
+}
+
+- (void)dealloc {
+  [self close];
+}
+
+- (BOOL)open:(NSError**)error {
+  _enumerator = [[NSFileManager defaultManager] enumeratorAtPath:_path];
+  _pending = [[NSMutableData alloc] initWithCapacity:(kZipChunkSize + kZipReadBufferSize)];
+  _buffer = [[NSMutableData alloc] initWithLength:kZipReadBufferSize];
+  _output.data = (__bridge CFMutableDataRef)_pending;
+  _output.position = 0;
+
+  zlib_filefunc64_def filefunc;
+  filefunc.zopen64_file = _ZipOpen;
+  filefunc.zread_file = _ZipRead;
+  filefunc.zwrite_file = _ZipWrite;
+  filefunc.ztell64_file = _ZipTell;
+  filefunc.zseek64_file = _ZipSeek;
+  filefunc.zclose_file = _ZipClose;
+  filefunc.zerror_file = _ZipError;
+  filefunc.opaque = &_output;
+  _zip = zipOpen2_64("", APPEND_STATUS_CREATE, NULL, &filefunc);
+  if (!_enumerator || !_zip) {
+    if (error) {
+      *error = GCDWebServerMakePosixError(_enumerator ? EIO : ENOENT);
+    }
+    return NO;
+  }
+  return YES;
+}
+
+- (NSData*)readData:(NSError**)error {
+  while ((_pending.length < kZipChunkSize) && !_finished) {
+    if (_file < 0) {
+      if (![self _openNextEntry:error]) {
+        return nil;
+      }
+      continue;
+    }
+    ssize_t result = read(_file, _buffer.mutableBytes, kZipReadBufferSize);
+    if (result < 0) {
+      if (error) {
+        *error = GCDWebServerMakePosixError(errno);
+      }
+      return nil;
+    }
+    if (result == 0) {
+      close(_file);
+      _file = -1;
+      if (zipCloseFileInZip(_zip) != ZIP_OK) {
+        if (error) {
+          *error = GCDWebServerMakePosixError(EIO);
+        }
+        return nil;
+      }
+      continue;
+    }
+    if (zipWriteInFileInZip(_zip, _buffer.bytes, (unsigned)result) != ZIP_OK) {
+      if (error) {
+        *error = GCDWebServerMakePosixError(EIO);
+      }
+      return nil;
+    }
+  }
+  NSData* data = [_pending copy];  // Empty once the central directory is sent
+  [_pending setLength:0];
+  return data;
+}
+
+- (void)close {
+  if (_file >= 0) {
+    close(_file);
+    _file = -1;
+  }
+  if (_zip) {
+    zipClose(_zip, NULL);
+    _zip = NULL;
+  }
+  _output.data = NULL;
+  _pending = nil;
+  _enumerator = nil;
+}
+
+- (NSString*)description {
+  NSMutableString* description = [NSMutableString stringWithString:[super description]];
+  [description appendFormat:@"\n\n{%@}", _path];
+  return description;
+}
+
+// Start the next entry, directories are written whole & files are left open
+// for reading, writes the central directory when there are no items left
+- (BOOL)_openNextEntry:(NSError**)error {
+  NSString* relativePath;
+  while ((relativePath = [_enumerator nextObject])) {
+    NSString* absolutePath = [_path stringByAppendingPathComponent:relativePath];
+    struct stat info;
+    if (lstat([absolutePath fileSystemRepresentation], &info) != 0) {
+      continue;  // Removed since the directory was read
+    }
+    BOOL isDirectory = S_ISDIR(info.st_mode);
+    if (!isDirectory && !S_ISREG(info.st_mode)) {
+      continue;  // Links, etc
+    }
+    if (_filter && !_filter(relativePath, isDirectory)) {
+      if (isDirectory) {
+        [_enumerator skipDescendants];
+      }
+      continue;
+    }
+
+    zip_fileinfo fileInfo;
+    memset(&fileInfo, 0, sizeof(zip_fileinfo));
+    struct tm date;
+    localtime_r(&info.st_mtimespec.tv_sec, &date);
+    fileInfo.tmz_date.tm_sec = date.tm_sec;
+    fileInfo.tmz_date.tm_min = date.tm_min;
+    fileInfo.tmz_date.tm_hour = date.tm_hour;
+    fileInfo.tmz_date.tm_mday = date.tm_mday;
+    fileInfo.tmz_date.tm_mon = date.tm_mon;
+    fileInfo.tmz_date.tm_year = date.tm_year + 1900;
+    fileInfo.external_fa = (uLong)(info.st_mode & 0xFFFF) << 16;
+
+    NSString* name = [[_path lastPathComponent] stringByAppendingPathComponent:relativePath];
+    if (isDirectory) {
+      name = [name stringByAppendingString:@"/"];
+    } else {
+      _file = open([absolutePath fileSystemRepresentation], O_NOFOLLOW | O_RDONLY);
+      if (_file < 0) {
+        GWS_LOG_WARNING(@"Skipping unreadable file \"%@\" in zip of \"%@\"", relativePath, _path);
+        continue;
+      }
+    }
+    BOOL store = isDirectory || _IsCompressedMedia([relativePath pathExtension]);
+    int zip64 = (info.st_size >= 0xFFFFFFFF);
+    if (zipOpenNewFileInZip4_64(_zip, [name UTF8String], &fileInfo, NULL, 0, NULL, 0, NULL,
+                                store ? 0 : Z_DEFLATED, store ? 0 : Z_DEFAULT_COMPRESSION, 0,
+                                -MAX_WBITS, DEF_MEM_LEVEL, Z_DEFAULT_STRATEGY, NULL, 0, kZipVersionMadeByUnix,
+                                kZipFlagDataDescriptor | kZipFlagUTF8, zip64) != ZIP_OK ||
+        (isDirectory && zipCloseFileInZip(_zip) != ZIP_OK)) {
+      if (error) {
+        *error = GCDWebServerMakePosixError(EIO);
+      }
+      return NO;
+    }
+    if (!isDirectory) {
+      return YES;
+    }
+  }
+
+  // Done, write the central directory
+  int result = zipClose(_zip, NULL);
+  _zip = NULL;
+  _finished = YES;
+  if (result != ZIP_OK) {
+    if (error) {
+      *error = GCDWebServerMakePosixError(EIO);
+    }
+    return NO;
+  }
+  return YES;
+}
+
+@end
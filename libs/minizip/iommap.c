@@ -0,0 +1,180 @@
+/* iommap.c -- IO base function header for compress/uncompress .zip
+     Read-only memory-mapped file functions for POSIX systems
+
+     part of the MiniZip project - ( http://www.winimage.com/zLibDll/minizip.html )
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "zlib.h"
+#include "iommap.h"
+
+#ifndef local
+#  define local static
+#endif
+
+typedef struct
+{
+    unsigned char* data;
+    ZPOS64_T       size;
+    ZPOS64_T       pos;
+    int            error;
+    mmap_filefunc_mapping* mapping;
+} mmap_stream;
+
+
+local voidpf ZCALLBACK mmap_open64_file_func(voidpf opaque, const void* filename, int mode) {
+    mmap_stream* stream;
+    struct stat st;
+    int fd;
+
+    if ((filename == NULL) ||
+        ((mode & ZLIB_FILEFUNC_MODE_READWRITEFILTER) != ZLIB_FILEFUNC_MODE_READ))
+        return NULL;
+
+    fd = open((const char*)filename, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    if ((fstat(fd, &st) != 0) || !S_ISREG(st.st_mode))
+    {
+        close(fd);
+        return NULL;
+    }
+
+    stream = (mmap_stream*)calloc(1, sizeof(mmap_stream));
+    if (stream == NULL)
+    {
+        close(fd);
+        return NULL;
+    }
+    stream->size = (ZPOS64_T)st.st_size;
+    if (stream->size > 0)
+    {
+        void* data = mmap(NULL, (size_t)stream->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            free(stream);
+            return NULL;
+        }
+        stream->data = (unsigned char*)data;
+    }
+    close(fd); /* the mapping keeps the file */
+
+    stream->mapping = (mmap_filefunc_mapping*)opaque;
+    if (stream->mapping != NULL)
+    {
+        stream->mapping->data = stream->data;
+        stream->mapping->size = stream->size;
+    }
+    return stream;
+}
+
+local uLong ZCALLBACK mmap_read_file_func(voidpf opaque, voidpf stream, void* buf, uLong size) {
+    mmap_stream* s = (mmap_stream*)stream;
+    ZPOS64_T left;
+    (void)opaque;
+
+    if (s == NULL)
+        return 0;
+    left = s->size - s->pos;
+    if ((ZPOS64_T)size > left)
+        size = (uLong)left;
+    if (size > 0)
+    {
+        memcpy(buf, s->data + s->pos, size);
+        s->pos += size;
+    }
+    return size;
+}
+
+local uLong ZCALLBACK mmap_write_file_func(voidpf opaque, voidpf stream, const void* buf, uLong size) {
+    mmap_stream* s = (mmap_stream*)stream;
+    (void)opaque;
+    (void)buf;
+    (void)size;
+
+    if (s != NULL)
+        s->error = 1;
+    return 0;
+}
+
+local ZPOS64_T ZCALLBACK mmap_tell64_file_func(voidpf opaque, voidpf stream) {
+    mmap_stream* s = (mmap_stream*)stream;
+    (void)opaque;
+
+    if (s == NULL)
+        return (ZPOS64_T)-1;
+    return s->pos;
+}
+
+local long ZCALLBACK mmap_seek64_file_func(voidpf opaque, voidpf stream, ZPOS64_T offset, int origin) {
+    mmap_stream* s = (mmap_stream*)stream;
+    ZPOS64_T base;
+    (void)opaque;
+
+    if (s == NULL)
+        return -1;
+    switch (origin)
+    {
+    case ZLIB_FILEFUNC_SEEK_CUR :
+        base = s->pos;
+        break;
+    case ZLIB_FILEFUNC_SEEK_END :
+        base = s->size;
+        break;
+    case ZLIB_FILEFUNC_SEEK_SET :
+        base = 0;
+        break;
+    default: return -1;
+    }
+    /* can't seek past the end of the mapping */
+    if ((offset > s->size) || (base + offset > s->size))
+        return -1;
+    s->pos = base + offset;
+    return 0;
+}
+
+local int ZCALLBACK mmap_close_file_func(voidpf opaque, voidpf stream) {
+    mmap_stream* s = (mmap_stream*)stream;
+    (void)opaque;
+
+    if (s == NULL)
+        return -1;
+    if (s->data != NULL)
+        munmap(s->data, (size_t)s->size);
+    if (s->mapping != NULL)
+    {
+        s->mapping->data = NULL;
+        s->mapping->size = 0;
+    }
+    free(s);
+    return 0;
+}
+
+local int ZCALLBACK mmap_error_file_func(voidpf opaque, voidpf stream) {
+    mmap_stream* s = (mmap_stream*)stream;
+    (void)opaque;
+
+    if (s == NULL)
+        return -1;
+    return s->error;
+}
+
+void fill_mmap_filefunc64(zlib_filefunc64_def* pzlib_filefunc_def,
+                          mmap_filefunc_mapping* pmapping) {
+    pzlib_filefunc_def->zopen64_file = mmap_open64_file_func;
+    pzlib_filefunc_def->zread_file = mmap_read_file_func;
+    pzlib_filefunc_def->zwrite_file = mmap_write_file_func;
+    pzlib_filefunc_def->ztell64_file = mmap_tell64_file_func;
+    pzlib_filefunc_def->zseek64_file = mmap_seek64_file_func;
+    pzlib_filefunc_def->zclose_file = mmap_close_file_func;
+    pzlib_filefunc_def->zerror_file = mmap_error_file_func;
+    pzlib_filefunc_def->opaque = pmapping;
+}
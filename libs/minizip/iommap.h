@@ -0,0 +1,45 @@
+/* iommap.h -- IO base function header for compress/uncompress .zip
+     Read-only memory-mapped file functions for POSIX systems
+
+     part of the MiniZip project - ( http://www.winimage.com/zLibDll/minizip.html )
+
+     The whole archive is mapped with mmap on open, reads copy straight out of
+     the mapping without stdio buffering or a syscall per read, and seeks only
+     move the read position. Writing is not supported.
+
+     The mapping of the open archive can be exposed through a
+     mmap_filefunc_mapping so the data of STORED entries can be used in place,
+     see unzGetCurrentFileStoredPos64 in unzip.h.
+
+*/
+
+#ifndef _IOMMAP_H
+#define _IOMMAP_H
+
+#include "ioapi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct mmap_filefunc_mapping_s
+{
+    const unsigned char* data;  /* start of the mapped archive, NULL when closed */
+    ZPOS64_T             size;  /* archive size in bytes */
+} mmap_filefunc_mapping;
+
+void fill_mmap_filefunc64(zlib_filefunc64_def* pzlib_filefunc_def,
+                          mmap_filefunc_mapping* pmapping);
+/*
+  Fill the file functions with the memory-mapped implementation.
+  If pmapping!=NULL, it receives the mapping when the archive is opened and
+    is cleared when it is closed, so it must outlive the unzFile. As the
+    mapping is stored per filefunc def, use one def per open archive.
+  Opening for writing fails.
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -185,8 +185,31 @@ typedef struct
     unsigned long keys[3];     /* keys defining the pseudo-random sequence */
     const z_crc_t* pcrc_32_tab;
 #    endif
+
+    struct unz64_index_s* index; /* file name index, NULL until built */
 } unz64_s;
 
+/* unz64_index_s is a hash table of normalized file names to their position
+   in the central directory, built by unzBuildIndex
+*/
+typedef struct
+{
+    uLong hash;             /* name hash, slot is free when name is NULL */
+    const char* name;       /* normalized name, points into names */
+    unz64_file_pos pos;     /* position in the central directory */
+} unz64_index_slot;
+
+typedef struct unz64_index_s
+{
+    int iCaseSensitivity;   /* case sensitivity the index was built with */
+    uLong mask;             /* slot count - 1, slot count is a power of 2 */
+    uLong count;            /* used slots, kept at most half the slot count */
+    unz64_index_slot* slots;
+    char* names;            /* all names, null terminated */
+} unz64_index;
+
+local void unz64local_FreeIndex(unz64_s* s);
+
 
 #ifndef NOUNCRYPT
 #include "crypt.h"
@@ -657,6 +680,7 @@ local unzFile unzOpenInternal(const void *path,
     us.central_pos = central_pos;
     us.pfile_in_zip_read = NULL;
     us.encrypted = 0;
+    us.index = NULL;
 
 
     s=(unz64_s*)ALLOC(sizeof(unz64_s));
@@ -717,6 +741,7 @@ extern int ZEXPORT unzClose(unzFile file) {
     if (s->pfile_in_zip_read!=NULL)
         unzCloseCurrentFile(file);
 
+    unz64local_FreeIndex(s);
     ZCLOSE64(s->z_filefunc, s->filestream);
     free(s);
     return UNZ_OK;
@@ -1080,6 +1105,7 @@ extern int ZEXPORT unzGoToFirstFile(unzFile file) {
 */
 extern int ZEXPORT unzGoToNextFile(unzFile file) {
     unz64_s* s;
+    ZPOS64_T pos_in_central_dir;
     int err;
 
     if (file==NULL)
@@ -1090,9 +1116,13 @@ extern int ZEXPORT unzGoToNextFile(unzFile file) {
     if (s->gi.number_entry != 0xffff)    /* 2^16 files overflow hack */
       if (s->num_file+1==s->gi.number_entry)
         return UNZ_END_OF_LIST_OF_FILE;
-
-    s->pos_in_central_dir += SIZECENTRALDIRITEM + s->cur_file_info.size_filename +
+    pos_in_central_dir = s->pos_in_central_dir + SIZECENTRALDIRITEM + s->cur_file_info.size_filename +
             s->cur_file_info.size_file_extra + s->cur_file_info.size_file_comment ;
+    if (s->gi.number_entry == 0xffff)    /* the count may be truncated, stop at the end */
+      if (pos_in_central_dir >= s->offset_central_dir + s->size_central_dir)
+        return UNZ_END_OF_LIST_OF_FILE;
+
+    s->pos_in_central_dir = pos_in_central_dir;
     s->num_file++;
     err = unz64local_GetCurrentFileInfoInternal(file,&s->cur_file_info,
                                                &s->cur_file_info_internal,
@@ -1167,6 +1197,216 @@ extern int ZEXPORT unzLocateFile(unzFile file, const char *szFileName, int iCase
 }
 
 
+/*
+   Normalize a file name for the index into dest, which must hold
+   UNZ_MAXFILENAMEINZIP+1 chars: backslashes become slashes & letters are
+   lowered if the index is not case sensitive. Returns the name hash.
+*/
+local uLong unz64local_NormalizeName(char* dest, const char* name, int iCaseSensitivity) {
+    uLong hash = 2166136261UL; /* FNV-1a */
+    int i;
+    for (i = 0; name[i] != '\0' && i < UNZ_MAXFILENAMEINZIP; i++)
+    {
+        char c = name[i];
+        if (c == '\\')
+            c = '/';
+        else if (iCaseSensitivity == 2 && c >= 'A' && c <= 'Z')
+            c = (char)(c - 'A' + 'a');
+        dest[i] = c;
+        hash = ((hash ^ (unsigned char)c) * 16777619UL) & 0xffffffffUL;
+    }
+    dest[i] = '\0';
+    return hash;
+}
+
+local void unz64local_FreeIndex(unz64_s* s) {
+    if (s->index != NULL)
+    {
+        free(s->index->slots);
+        free(s->index->names);
+        free(s->index);
+        s->index = NULL;
+    }
+}
+
+/*
+   Double the slot count of the index, names are unique so each moves to the
+   first free slot for its hash.
+*/
+local int unz64local_GrowIndex(unz64_index* index) {
+    uLong slotCount = (index->mask + 1) * 2;
+    uLong newMask = slotCount - 1;
+    unz64_index_slot* slots;
+    uLong i, j;
+    if (slotCount <= index->mask + 1)
+        return UNZ_INTERNALERROR;
+    slots = (unz64_index_slot*)calloc(slotCount, sizeof(unz64_index_slot));
+    if (slots == NULL)
+        return UNZ_INTERNALERROR;
+    for (i = 0; i <= index->mask; i++)
+    {
+        if (index->slots[i].name == NULL)
+            continue;
+        for (j = index->slots[i].hash & newMask; slots[j].name != NULL; j = (j + 1) & newMask)
+            ;
+        slots[j] = index->slots[i];
+    }
+    free(index->slots);
+    index->slots = slots;
+    index->mask = newMask;
+    return UNZ_OK;
+}
+
+extern int ZEXPORT unzBuildIndex(unzFile file, int iCaseSensitivity) {
+    unz64_s* s;
+    unz64_index* index;
+    uLong slotCount = 1;
+    ZPOS64_T namesSize = 0, namesUsed = 0;
+    int err;
+
+    /* current file state is restored afterwards */
+    unz_file_info64 cur_file_infoSaved;
+    unz_file_info64_internal cur_file_info_internalSaved;
+    ZPOS64_T num_fileSaved;
+    ZPOS64_T pos_in_central_dirSaved;
+    ZPOS64_T current_file_okSaved;
+
+    if (file==NULL)
+        return UNZ_PARAMERROR;
+    s=(unz64_s*)file;
+    if (iCaseSensitivity==0)
+        iCaseSensitivity=CASESENSITIVITYDEFAULTVALUE;
+
+    unz64local_FreeIndex(s);
+
+    /* the entry count is only a hint as it may be truncated to 0xffff, the
+       table grows when more than half full */
+    while (slotCount < s->gi.number_entry * 2 && slotCount < 0x20000)
+        slotCount <<= 1;
+
+    /* names are at most the central directory size, which includes them */
+    namesSize = s->size_central_dir + 1;
+    if ((uLong)namesSize != namesSize)
+        return UNZ_INTERNALERROR;
+
+    index = (unz64_index*)ALLOC(sizeof(unz64_index));
+    if (index == NULL)
+        return UNZ_INTERNALERROR;
+    index->iCaseSensitivity = iCaseSensitivity;
+    index->mask = slotCount - 1;
+    index->count = 0;
+    index->slots = (unz64_index_slot*)calloc(slotCount, sizeof(unz64_index_slot));
+    index->names = (char*)ALLOC((uLong)namesSize);
+    if (index->slots == NULL || index->names == NULL)
+    {
+        free(index->slots);
+        free(index->names);
+        free(index);
+        return UNZ_INTERNALERROR;
+    }
+
+    num_fileSaved = s->num_file;
+    pos_in_central_dirSaved = s->pos_in_central_dir;
+    cur_file_infoSaved = s->cur_file_info;
+    cur_file_info_internalSaved = s->cur_file_info_internal;
+    current_file_okSaved = s->current_file_ok;
+
+    err = unzGoToFirstFile(file);
+    while (err == UNZ_OK)
+    {
+        char szCurrentFileName[UNZ_MAXFILENAMEINZIP+1];
+        char szNormalized[UNZ_MAXFILENAMEINZIP+1];
+        uLong hash, i;
+        size_t length;
+        err = unzGetCurrentFileInfo64(file,NULL,
+                                      szCurrentFileName,sizeof(szCurrentFileName)-1,
+                                      NULL,0,NULL,0);
+        if (err != UNZ_OK)
+            break;
+        szCurrentFileName[sizeof(szCurrentFileName)-1] = '\0';
+        hash = unz64local_NormalizeName(szNormalized, szCurrentFileName, iCaseSensitivity);
+        length = strlen(szNormalized);
+        if (namesUsed + length + 1 > namesSize)
+        {
+            err = UNZ_BADZIPFILE;
+            break;
+        }
+
+        if ((index->count + 1) * 2 > index->mask + 1)
+        {
+            err = unz64local_GrowIndex(index);
+            if (err != UNZ_OK)
+                break;
+        }
+
+        /* linear probing, the first of any duplicate names wins like
+           unzLocateFile */
+        for (i = hash & index->mask; index->slots[i].name != NULL; i = (i + 1) & index->mask)
+        {
+            if (index->slots[i].hash == hash && strcmp(index->slots[i].name, szNormalized) == 0)
+                break;
+        }
+        if (index->slots[i].name == NULL)
+        {
+            memcpy(index->names + namesUsed, szNormalized, length + 1);
+            index->slots[i].hash = hash;
+            index->slots[i].name = index->names + namesUsed;
+            index->slots[i].pos.pos_in_zip_directory = s->pos_in_central_dir;
+            index->slots[i].pos.num_of_file = s->num_file;
+            index->count++;
+            namesUsed += length + 1;
+        }
+        err = unzGoToNextFile(file);
+    }
+
+    s->num_file = num_fileSaved;
+    s->pos_in_central_dir = pos_in_central_dirSaved;
+    s->cur_file_info = cur_file_infoSaved;
+    s->cur_file_info_internal = cur_file_info_internalSaved;
+    s->current_file_ok = current_file_okSaved;
+
+    if (err != UNZ_END_OF_LIST_OF_FILE)
+    {
+        free(index->slots);
+        free(index->names);
+        free(index);
+        return err;
+    }
+    s->index = index;
+    return UNZ_OK;
+}
+
+extern int ZEXPORT unzLocateFileIndexed(unzFile file, const char *szFileName, int iCaseSensitivity) {
+    unz64_s* s;
+    char szNormalized[UNZ_MAXFILENAMEINZIP+1];
+    uLong hash, i;
+
+    if (file==NULL)
+        return UNZ_PARAMERROR;
+    if (strlen(szFileName)>=UNZ_MAXFILENAMEINZIP)
+        return UNZ_PARAMERROR;
+    s=(unz64_s*)file;
+    if (iCaseSensitivity==0)
+        iCaseSensitivity=CASESENSITIVITYDEFAULTVALUE;
+
+    if (s->index == NULL || s->index->iCaseSensitivity != iCaseSensitivity)
+    {
+        int err = unzBuildIndex(file, iCaseSensitivity);
+        if (err != UNZ_OK)
+            return err;
+    }
+
+    hash = unz64local_NormalizeName(szNormalized, szFileName, iCaseSensitivity);
+    for (i = hash & s->index->mask; s->index->slots[i].name != NULL; i = (i + 1) & s->index->mask)
+    {
+        const unz64_index_slot* slot = &s->index->slots[i];
+        if (slot->hash == hash && strcmp(slot->name, szNormalized) == 0)
+            return unzGoToFilePos64(file, &slot->pos);
+    }
+    return UNZ_END_OF_LIST_OF_FILE;
+}
+
+
 /*
 ///////////////////////////////////////////
 // Contributed by Ryan Haksi (mailto://cryogen@infoserve.net)
@@ -1539,6 +1779,36 @@ extern ZPOS64_T ZEXPORT unzGetCurrentFileZStreamPos64(unzFile file) {
 
 /** Addition for GDAL : END */
 
+/*
+  Get the position of the data of the current file in the zipfile, if it is
+  STORED and not encrypted, by reading its local header.
+  Does not need the current file to be opened, the raw data can then be used
+  in place, ie. with the mapping of iommap.
+*/
+extern int ZEXPORT unzGetCurrentFileStoredPos64(unzFile file, ZPOS64_T* pos, ZPOS64_T* size) {
+    unz64_s* s;
+    uInt iSizeVar;
+    ZPOS64_T offset_local_extrafield;
+    uInt size_local_extrafield;
+    if ((file==NULL) || (pos==NULL) || (size==NULL))
+        return UNZ_PARAMERROR;
+    s=(unz64_s*)file;
+    if (!s->current_file_ok)
+        return UNZ_PARAMERROR;
+    if ((s->cur_file_info.compression_method!=0) ||
+        ((s->cur_file_info.flag & 1) != 0) ||
+        (s->cur_file_info.compressed_size!=s->cur_file_info.uncompressed_size))
+        return UNZ_PARAMERROR;
+
+    if (unz64local_CheckCurrentFileCoherencyHeader(s,&iSizeVar, &offset_local_extrafield,&size_local_extrafield)!=UNZ_OK)
+        return UNZ_BADZIPFILE;
+
+    *pos = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER +
+           iSizeVar + s->byte_before_the_zipfile;
+    *size = s->cur_file_info.uncompressed_size;
+    return UNZ_OK;
+}
+
 /*
   Read bytes from the current file.
   buf contain buffer where data must be copied
@@ -251,6 +251,33 @@ extern int ZEXPORT unzLocateFile(unzFile file,
   UNZ_END_OF_LIST_OF_FILE if the file is not found
 */
 
+extern int ZEXPORT unzBuildIndex(unzFile file, int iCaseSensitivity);
+/*
+  Build an in-memory index of the file names in the zipfile for
+  unzLocateFileIndexed, replacing any previous index. Names are normalized
+  with backslashes as slashes & case folded when not case sensitive. The
+  table is sized from the entry count & grows when half full, as the count
+  may be truncated to 0xffff. The index is freed by unzClose. The current
+  file is not changed.
+  For the iCaseSensitivity signification, see unzStringFileNameCompare
+
+  return value :
+  UNZ_OK if the index was built
+*/
+
+extern int ZEXPORT unzLocateFileIndexed(unzFile file,
+                                        const char *szFileName,
+                                        int iCaseSensitivity);
+/*
+  Locate the file szFileName in the zipfile like unzLocateFile, using a hash
+  of the normalized name instead of comparing every name. The index is built
+  on the first call or when iCaseSensitivity differs from the index.
+
+  return value :
+  UNZ_OK if the file is found. It becomes the current file.
+  UNZ_END_OF_LIST_OF_FILE if the file is not found
+*/
+
 
 /* ****************************************** */
 /* Ryan supplied functions */
@@ -322,6 +349,18 @@ extern ZPOS64_T ZEXPORT unzGetCurrentFileZStreamPos64(unzFile file);
 
 /** Addition for GDAL : END */
 
+extern int ZEXPORT unzGetCurrentFileStoredPos64(unzFile file,
+                                                ZPOS64_T* pos,
+                                                ZPOS64_T* size);
+/*
+  Get the absolute position & size of the data of the current file in the
+    zipfile without opening it, the local header is checked.
+  Works for STORED, not encrypted files only, the data can then be used in
+    place, see iommap.h
+  return UNZ_OK if there is no problem
+  return UNZ_PARAMERROR if the file is compressed or encrypted
+*/
+
 
 /***************************************************************************/
 /* for reading the content of the current zipfile, you can open it, read data
@@ -101,6 +101,7 @@ const char zip_copyright[] =" zip 1.01 Copyright 1998-2004 Gilles Vollant - http
 #define ENDHEADERMAGIC      (0x06054b50)
 #define ZIP64ENDHEADERMAGIC      (0x6064b50)
 #define ZIP64ENDLOCHEADERMAGIC   (0x7064b50)
+#define DATADESCRIPTORMAGIC      (0x08074b50)
 
 #define FLAG_LOCALHEADER_OFFSET (0x06)
 #define CRC_LOCALHEADER_OFFSET  (0x0e)
@@ -1555,8 +1556,8 @@ extern int ZEXPORT zipCloseFileInZipRaw64(zipFile file, ZPOS64_T uncompressed_si
     // update Current Item crc and sizes,
     if(compressed_size >= 0xffffffff || uncompressed_size >= 0xffffffff || zi->ci.pos_local_header >= 0xffffffff)
     {
-      /*version Made by*/
-      zip64local_putValue_inmemory(zi->ci.central_header+4,(uLong)45,2);
+      /*version Made by, keeping the host system*/
+      zip64local_putValue_inmemory(zi->ci.central_header+4,((uLong)(unsigned char)zi->ci.central_header[5] << 8) | 45,2);
       /*version needed*/
       zip64local_putValue_inmemory(zi->ci.central_header+6,(uLong)45,2);
 
@@ -1643,7 +1644,37 @@ extern int ZEXPORT zipCloseFileInZipRaw64(zipFile file, ZPOS64_T uncompressed_si
 
     free(zi->ci.central_header);
 
-    if (err==ZIP_OK)
+    if ((err==ZIP_OK) && ((zi->ci.flag & 8) != 0))
+    {
+        // Data descriptor requested (flag bit 3), ie. when streaming to an
+        // output which can't seek: append the crc & sizes after the data
+        // instead of updating the LocalFileHeader, 8 byte sizes when the
+        // LocalFileHeader has the ZIP64 extended info.
+        err = zip64local_putValue(&zi->z_filefunc,zi->filestream,(uLong)DATADESCRIPTORMAGIC,4);
+
+        if (err==ZIP_OK)
+            err = zip64local_putValue(&zi->z_filefunc,zi->filestream,crc32,4);
+
+        if (zi->ci.zip64)
+        {
+          if (err==ZIP_OK)
+              err = zip64local_putValue(&zi->z_filefunc,zi->filestream,compressed_size,8);
+
+          if (err==ZIP_OK)
+              err = zip64local_putValue(&zi->z_filefunc,zi->filestream,uncompressed_size,8);
+        }
+        else if(uncompressed_size >= 0xffffffff || compressed_size >= 0xffffffff )
+            err = ZIP_BADZIPFILE; // Caller passed zip64 = 0, so no room for zip64 sizes -> fatal
+        else
+        {
+          if (err==ZIP_OK)
+              err = zip64local_putValue(&zi->z_filefunc,zi->filestream,compressed_size,4);
+
+          if (err==ZIP_OK)
+              err = zip64local_putValue(&zi->z_filefunc,zi->filestream,uncompressed_size,4);
+        }
+    }
+    else if (err==ZIP_OK)
     {
         // Update the LocalFileHeader with the new values.
 
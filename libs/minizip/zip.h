@@ -303,6 +303,9 @@ extern int ZEXPORT zipOpenNewFileInZip4_64(zipFile file,
   Same than zipOpenNewFileInZip4, except
     versionMadeBy : value for Version made by field
     flag : value for flag field (compression level info will be added)
+      if bit 3 (8) is set, the crc & sizes are written in a data descriptor
+      after the file data instead of seeking back to the local header, so
+      the zipfile can be written to an output which can't seek
  */
 
 
@@ -24,6 +24,7 @@ void midifile_setup(void);
 void rj_accum_setup(void);
 void rj_barkflux_accum_tilde_setup(void);
 void rj_centroid_tilde_setup(void);
+void rj_onset_tilde_setup(void);
 void rj_senergy_tilde_setup(void);
 void rj_zcr_tilde_setup(void);
 
@@ -43,6 +44,7 @@ void rj_zcr_tilde_setup(void);
 	rj_accum_setup();
 	rj_barkflux_accum_tilde_setup();
 	rj_centroid_tilde_setup();
+	rj_onset_tilde_setup();
 	rj_senergy_tilde_setup();
 	rj_zcr_tilde_setup();
 }
@@ -1,7 +1,10 @@
-/* code for the "rj_accum" pd class. 
-ver 0.3
-Amaury Hazan 
+/* code for the "rj_accum" pd class.
+ver 0.4
+Amaury Hazan
 Damian Stewart
+
+a float accumulates a single stream, a list of K values accumulates K streams
+at once and outputs K relative changes (vector mode)
 */
 
 #include "m_pd.h"
@@ -9,66 +12,181 @@ Damian Stewart
 #include <string.h>
 
 #define DEF_BLOCKSIZE 512
- 
+
+// short/long-term ring buffer for K streams: frames are stored one after
+// another with the K feature values for a tick contiguous, running totals are
+// kept per feature in separate arrays so an update is a linear pass over K
+typedef struct rj_accum_ring
+{
+  t_float * buffer; // size * nfeatures values
+  int capacity;     // allocated values
+  int size;         // frames
+  int cnt;          // frames used for the mean, up to size
+  int idx;          // next frame to write
+  float duration;   // desired duration in s
+  double * total;   // per feature running sum
+  double * sqtotal; // per feature running sum of squares
+  t_float * mean;   // per feature mean
+  t_float * var;    // per feature variance
+} t_rj_accum_ring;
+
 typedef struct rj_accum
 {
   t_object x_obj;
-  
+
   // configuration values
   float blocksize;
   float samplerate;
-  
-  //short-time buffer, size,counter and desired duration (in s)
-  float * st_buffer;
-  int st_buffersize;
-  int st_buffercnt;
-  float st_duration;
-  float st_mean;
-  float st_total;
-  int st_idx;
-	
-  //long-time buffer, size, counter and desired duration (in s)
-  float * lt_buffer;
-  int lt_buffersize;
-  int lt_buffercnt;
-  float lt_duration;
-  float lt_mean;
-  float lt_total;
-  int lt_idx;
-  
-  float rel_change;
-  
+
+  // number of streams, 1 for scalar floats
+  int nfeatures;
+
+  //short-time & long-time buffers
+  t_rj_accum_ring st;
+  t_rj_accum_ring lt;
+
+  t_float * in;
+  t_float * rel_change;
+  t_atom * out;
+
   t_outlet* relative_change;		   /* m: place for outlet */
-  
+  t_outlet* variance;
+
 } t_rj_accum;
 
+static void rj_accum_ring_reset(t_rj_accum_ring *r, int nfeatures)
+{
+  memset( r->buffer, 0, r->size*nfeatures*sizeof(t_float) );
+  memset( r->total, 0, nfeatures*sizeof(double) );
+  memset( r->sqtotal, 0, nfeatures*sizeof(double) );
+  memset( r->mean, 0, nfeatures*sizeof(t_float) );
+  memset( r->var, 0, nfeatures*sizeof(t_float) );
+  r->cnt = 0;
+  r->idx = 0;
+}
+
+// (re)size ring for duration, only reallocates when growing
+static void rj_accum_ring_resize(t_rj_accum_ring *r, int nfeatures,
+  float blocksize, float samplerate)
+{
+  r->size = (int) ((r->duration*samplerate)/blocksize);
+  if (r->size < 1) r->size = 1;
+  if (r->size*nfeatures > r->capacity) {
+    free( r->buffer );
+    r->capacity = r->size*nfeatures;
+    r->buffer = (t_float*)malloc( r->capacity*sizeof(t_float) );
+  }
+  rj_accum_ring_reset(r, nfeatures);
+}
+
+// per feature arrays, buffer is sized afterwards by rj_accum_ring_resize()
+static void rj_accum_ring_alloc(t_rj_accum_ring *r, int nfeatures)
+{
+  free( r->total );
+  free( r->sqtotal );
+  free( r->mean );
+  free( r->var );
+  r->total = (double*)malloc( nfeatures*sizeof(double) );
+  r->sqtotal = (double*)malloc( nfeatures*sizeof(double) );
+  r->mean = (t_float*)malloc( nfeatures*sizeof(t_float) );
+  r->var = (t_float*)malloc( nfeatures*sizeof(t_float) );
+}
+
+static void rj_accum_ring_free(t_rj_accum_ring *r)
+{
+  free( r->buffer );
+  free( r->total );
+  free( r->sqtotal );
+  free( r->mean );
+  free( r->var );
+}
+
+static void rj_accum_ring_add(t_rj_accum_ring *r, const t_float *f, int nfeatures)
+{
+  t_float *frame = r->buffer + r->idx*nfeatures;
+  int i;
+
+  if (r->cnt < r->size) r->cnt++;
+  // increment index
+  r->idx = ( r->idx + 1 ) % r->size;
+
+  for (i = 0; i < nfeatures; i++) {
+    // calculate new totals: subtract old, add new
+    t_float old = frame[i];
+    r->total[i] += f[i] - old;
+    r->sqtotal[i] += f[i]*f[i] - old*old;
+    frame[i] = f[i];
+
+    r->mean[i] = r->total[i] / r->cnt;
+    r->var[i] = r->sqtotal[i] / r->cnt - r->mean[i]*r->mean[i];
+    if (r->var[i] < 0) r->var[i] = 0;
+  }
+}
+
+static void rj_accum_setsize(t_rj_accum *x, int nfeatures)
+{
+  x->nfeatures = nfeatures;
+  rj_accum_ring_alloc(&x->st, nfeatures);
+  rj_accum_ring_alloc(&x->lt, nfeatures);
+  rj_accum_ring_resize(&x->st, nfeatures, x->blocksize, x->samplerate);
+  rj_accum_ring_resize(&x->lt, nfeatures, x->blocksize, x->samplerate);
+  free( x->in );
+  free( x->rel_change );
+  free( x->out );
+  x->in = (t_float*)malloc( nfeatures*sizeof(t_float) );
+  x->rel_change = (t_float*)malloc( nfeatures*sizeof(t_float) );
+  x->out = (t_atom*)malloc( nfeatures*sizeof(t_atom) );
+  memset( x->rel_change, 0, nfeatures*sizeof(t_float) );
+}
+
+static void rj_accum_tick(t_rj_accum *x, const t_float *f)
+{
+  int i;
+  rj_accum_ring_add(&x->st, f, x->nfeatures);
+  rj_accum_ring_add(&x->lt, f, x->nfeatures);
+  for (i = 0; i < x->nfeatures; i++) {
+    if (x->lt.mean[i]==0) x->rel_change[i]=0;
+    else x->rel_change[i]=(x->st.mean[i]-x->lt.mean[i])/x->lt.mean[i];
+  }
+}
+
 void rj_accum_float(t_rj_accum *x, t_floatarg f)
 {
-    if (x->st_buffercnt< x->st_buffersize-1) x->st_buffercnt++;
-    // calculate new total: subtract old, add new
-    x->st_total -= x->st_buffer[x->st_idx];
-    x->st_total += f;
-    x->st_buffer[x->st_idx] = f;
-    // increment index
-    x->st_idx = ( x->st_idx + 1 ) % x->st_buffersize;
-    
-    //x->st_mean=x->st_mean*st_before_weight + f*st_after_weight;
-    x->st_mean = x->st_total / x->st_buffercnt;
-    
-    if (x->lt_buffercnt< x->lt_buffersize-1) x->lt_buffercnt++;
-    // calculate new total: subtract old, add new
-    x->lt_total -= x->lt_buffer[x->lt_idx];
-    x->lt_total += f;
-    x->lt_buffer[x->lt_idx] = f;
-    // increment index
-    x->lt_idx = ( x->lt_idx + 1 ) % x->lt_buffersize;
-    //x->lt_mean=x->lt_mean*lt_before_weight + f*lt_after_weight;
-    x->lt_mean = x->lt_total / x->lt_buffercnt;
-    
-    if (x->lt_mean==0) x->rel_change=0;
-    else x->rel_change=(x->st_mean-x->lt_mean)/x->lt_mean;    
-    
-	outlet_float(x->relative_change, x->rel_change);
+  t_float value = f;
+  if (x->nfeatures != 1) rj_accum_setsize(x, 1);
+  rj_accum_tick(x, &value);
+  outlet_float(x->variance, x->st.var[0]);
+  outlet_float(x->relative_change, x->rel_change[0]);
+}
+
+void rj_accum_list(t_rj_accum *x, t_symbol *s, int argc, t_atom *argv)
+{
+  int i;
+  if (argc < 1) return;
+  if (argc == 1) {
+    rj_accum_float(x, atom_getfloat(argv));
+    return;
+  }
+
+  // a new feature count restarts accumulation
+  if (argc != x->nfeatures) {
+    post("rj_accum: accumulating %d features", argc);
+    rj_accum_setsize(x, argc);
+  }
+
+  for (i = 0; i < argc; i++) {
+    x->in[i] = atom_getfloat(argv+i);
+  }
+  rj_accum_tick(x, x->in);
+
+  for (i = 0; i < argc; i++) {
+    SETFLOAT(x->out+i, x->st.var[i]);
+  }
+  outlet_list(x->variance, &s_list, argc, x->out);
+  for (i = 0; i < argc; i++) {
+    SETFLOAT(x->out+i, x->rel_change[i]);
+  }
+  outlet_list(x->relative_change, &s_list, argc, x->out);
 }
 
 t_class *rj_accum_class;
@@ -76,120 +194,90 @@ t_class *rj_accum_class;
 void rj_accum_set_st(t_rj_accum *x, t_floatarg g)
 {
     post("short term duration fixed to %f", g);
-    x->st_duration=g;
-    // determining st buffer size
-    x->st_buffersize= (int) ((x->st_duration*x->samplerate)/x->blocksize);  
-    x->st_buffercnt=0;
-    free( x->st_buffer );
-    x->st_buffer = malloc( x->st_buffersize*sizeof(float) );
-    memset( x->st_buffer, 0, x->st_buffersize*sizeof(float) );
-    x->st_total = 0;
-    x->st_idx = 0;
-    post("short term number of frames %d", x->st_buffersize);
-    
+    x->st.duration=g;
+    rj_accum_ring_resize(&x->st, x->nfeatures, x->blocksize, x->samplerate);
+    post("short term number of frames %d", x->st.size);
 }
 
 void rj_accum_set_lt(t_rj_accum *x, t_floatarg g)
 {
     post("long term duration fixed to %f", g);
-    x->lt_duration=g;
-    // determining st buffer size
-    x->lt_buffersize= (int) ((x->lt_duration*x->samplerate)/x->blocksize);  
-    x->lt_buffercnt=0;
-    free( x->lt_buffer );
-    x->lt_buffer = malloc( x->lt_buffersize*sizeof(float) );
-    memset( x->lt_buffer, 0, x->lt_buffersize*sizeof(float) );
-    x->lt_total = 0;
-    x->lt_idx = 0;
-    post("long term number of frames %d", x->lt_buffersize);
+    x->lt.duration=g;
+    rj_accum_ring_resize(&x->lt, x->nfeatures, x->blocksize, x->samplerate);
+    post("long term number of frames %d", x->lt.size);
 }
 
 void *rj_accum_new(t_symbol *selector, int argcount, t_atom *argvec)
 {
     t_rj_accum *x = (t_rj_accum *)pd_new(rj_accum_class);
     x->relative_change=outlet_new(&x->x_obj, &s_float);
-    
+    x->variance=outlet_new(&x->x_obj, 0);
+
     post("new %s", selector->s_name);
-    
+
     // param passing
     if (argcount==1){
-      x->st_duration=5.f;
-      x->lt_duration=30.f;
+      x->st.duration=5.f;
+      x->lt.duration=30.f;
       x->blocksize=argvec[0].a_w.w_float;
       x->samplerate=sys_getsr();
     }
     else if (argcount==0){
-      x->st_duration=5.f;
-      x->lt_duration=30.f;
-      x->blocksize=DEF_BLOCKSIZE;  
+      x->st.duration=5.f;
+      x->lt.duration=30.f;
+      x->blocksize=DEF_BLOCKSIZE;
       x->samplerate=sys_getsr();
     }
     else{
       post("usage: rj_accum [hopsize]");
       post("       where hopsize is processing hop size (default 512)");
-      
+
       post("you provided %d arguments",argcount);
-      
-      x->st_duration=5.f;
-      x->lt_duration=30.f;
-      x->blocksize=DEF_BLOCKSIZE;  
-      x->samplerate=sys_getsr();  
+
+      x->st.duration=5.f;
+      x->lt.duration=30.f;
+      x->blocksize=DEF_BLOCKSIZE;
+      x->samplerate=sys_getsr();
     }
-    
-    post("std %f", x->st_duration);
-    post("ltd %f", x->lt_duration);
+
+    post("std %f", x->st.duration);
+    post("ltd %f", x->lt.duration);
     post("hopsize %f", x->blocksize);
     post("samplerate %f", x->samplerate);
-    
-    // buffers allocation
-    int cnt;
-    
-    // detrmining st buffer size
-    x->st_buffersize= (int) ((x->st_duration*x->samplerate)/x->blocksize);  
-    x->st_buffercnt=0;
-    
-    // detrmining lt buffer size
-    x->lt_buffersize= (int) ((x->lt_duration*x->samplerate)/x->blocksize);  
-	x->lt_buffercnt=0;
-
-    // initializing buffers	
-    x->st_buffer = (float*)malloc( x->st_buffersize*sizeof(float) );
-    x->lt_buffer = (float*)malloc( x->lt_buffersize*sizeof(float) );
-    memset( x->st_buffer, 0, x->st_buffersize*sizeof(float) );
-    memset( x->lt_buffer, 0, x->lt_buffersize*sizeof(float) );
-
-	// initilaizing means
-	x->st_mean=0.f;
-	x->lt_mean=0.f;
-	
-	// initializing totals and indexes
-	x->st_total = 0.f;
-	x->st_idx = 0;
-	x->lt_total = 0.f;
-	x->lt_idx = 0;
-	
-	x->rel_change=0.f;
-    
+
+    // buffers allocation, starts with a single stream
+    x->st.buffer = x->lt.buffer = NULL;
+    x->st.capacity = x->lt.capacity = 0;
+    x->st.total = x->st.sqtotal = x->lt.total = x->lt.sqtotal = NULL;
+    x->st.mean = x->st.var = x->lt.mean = x->lt.var = NULL;
+    x->in = NULL;
+    x->rel_change = NULL;
+    x->out = NULL;
+    rj_accum_setsize(x, 1);
+
     return (void *)x;
 }
 
-static void rj_accumulator_free(t_rj_accum *x) 
+static void rj_accumulator_free(t_rj_accum *x)
 {
-    free( x->st_buffer );	
-    free( x->lt_buffer );	
+    rj_accum_ring_free(&x->st);
+    rj_accum_ring_free(&x->lt);
+    free( x->in );
+    free( x->rel_change );
+    free( x->out );
 }
 
 void rj_accum_setup(void)
 {
-    
+
     /* We specify "A_GIMME" as creation argument for both the creation
 	routine and the method (callback) for the "conf" message.  */
     rj_accum_class = class_new(gensym("rj_accum"), (t_newmethod)rj_accum_new,
     	(t_method)rj_accumulator_free, sizeof(t_rj_accum), 0, A_GIMME, 0);
-    
+
     class_addfloat(rj_accum_class, rj_accum_float);
+    class_addlist(rj_accum_class, rj_accum_list);
     class_addmethod(rj_accum_class, (t_method)rj_accum_set_st, gensym("st"), A_FLOAT, 0);
 	class_addmethod(rj_accum_class, (t_method)rj_accum_set_lt, gensym("lt"), A_FLOAT, 0);
-    post("rj_accum version 0.3");
+    post("rj_accum version 0.4");
 }
-
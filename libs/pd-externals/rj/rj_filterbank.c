@@ -0,0 +1,110 @@
+/* rectangular bark filterbank shared by the rj spectral externals,
+   moved out of rj_barkflux_accum~.c */
+
+#include "rj_filterbank.h"
+#include <math.h>
+#include <stdlib.h>
+
+/* ----------------------- frequency domain conversion utilities -----------------------*/
+
+// Bark <-> Hz conversion functions
+// // See: Traunmüller (1990) "Analytical expressions for the tonotopic sensory scale" J. Acoust. Soc. Am. 88: 97-100. 
+float freq2bark(float freq){
+    return (26.81f / (1.f + 1960.f / freq ) - 0.53f);
+}
+
+float bark2freq(float z){
+    return (1960.f / (26.81f / (z + 0.53f) - 1.f));
+}
+
+// Mel <-> Hz conversion functions
+// // See: Stevens, Volkman and Newman in 1937 (J. Acoust. Soc. Am 8(3) 185--190)
+float freq2mel(float freq){
+  return (1127.01048f * log (1.f+(freq/700.f)));
+}
+
+float mel2freq(float m){
+    return (700.f*(exp(m/1127.01048f)-1));
+}
+
+// FFTBin <-> Hz conversion functions
+
+int freq2bin(int windowSize,int sampleRate, float freq){
+    return (int) ceil((windowSize*2*freq)/(float)sampleRate);
+}
+
+float bin2freq(int windowSize,int sampleRate, int bin){
+    return ((float) (bin*sampleRate))/(2.f*(float) windowSize);
+}
+
+
+/* ------------------------ Filter objects ------------------------ */
+
+float getCf(RectSpecFilter m) {
+    return (m.hf+m.lf)*.5f;
+}
+
+float getEnergy(RectSpecFilter m ,float * input, int winSize, int sampleRate) { 
+    int lf_index=freq2bin(winSize, sampleRate, m.lf); 
+    int hf_index=freq2bin(winSize, sampleRate, m.hf); 
+    float res=0.; 
+    int i;
+	for (i=lf_index; i<=hf_index; i++) {
+        res+=input[i]*input[i]; 
+    } 
+    return res; 
+}
+
+/* ------------------------ Filterbank ---------------------------- */
+
+Filterbank_ptr allocFilterbank(int nFilters) {
+	
+	Filterbank_ptr fb=malloc(sizeof(Filterbank));
+	fb->bankFilters=malloc(nFilters*sizeof(RectSpecFilter));
+	fb->bankEn=malloc(nFilters*sizeof(float));
+	
+	return fb;
+}
+
+
+void deleteFilterbank(Filterbank_ptr fb) {
+
+	free(fb->bankFilters);
+	free(fb->bankEn);
+	free(fb);
+}
+
+void initFilterbank(Filterbank_ptr m, int nFilters, int winSize, int sampleRate, float lowF, float highF) {
+	
+	m->lowF=lowF;
+	m->highF=highF;
+	m->sampleRate=sampleRate;
+	m->nFilters=nFilters;
+	m->winSize=winSize;
+	
+	float zBeg, zEnd, zBw;
+	zBeg=freq2bark(lowF);
+	zEnd=freq2bark(highF);
+	zBw=(zEnd-zBeg)/(float) nFilters;
+	
+	// linear separation on the bark scale
+	int i;
+	for (i=0; i<nFilters; i++) {
+		
+		float lf=bark2freq(zBeg+zBw*((float) i));
+		float hf=bark2freq(zBeg+zBw*((float) i + 1.f));
+		float gain=1.f;
+		
+		// set filters lf, hf, gain
+	    m->bankFilters[i].lf=lf;
+		m->bankFilters[i].hf=hf;
+		m->bankFilters[i].gain=lf;
+	}
+};
+
+void computeFilterEnergies(Filterbank_ptr m, float * input){
+	int i;
+	for (i=0; i< m->nFilters; i++){
+		m->bankEn[i]=getEnergy(m->bankFilters[i],input, m->winSize, m->sampleRate) /((float) m->winSize);
+	}
+};
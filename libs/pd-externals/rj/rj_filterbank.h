@@ -0,0 +1,50 @@
+/* rectangular bark filterbank shared by the rj spectral externals */
+
+#ifndef RJ_FILTERBANK_H
+#define RJ_FILTERBANK_H
+
+/* ----------------------- frequency domain conversion utilities -----------------------*/
+
+float freq2bark(float freq);
+float bark2freq(float z);
+float freq2mel(float freq);
+float mel2freq(float m);
+int freq2bin(int windowSize,int sampleRate, float freq);
+float bin2freq(int windowSize,int sampleRate, int bin);
+
+/* ------------------------ Filter objects ------------------------ */
+
+typedef struct {
+    float lf;
+    float hf;
+    float gain;
+} RectSpecFilter;
+
+typedef RectSpecFilter * RectSpecFilter_ptr;
+
+float getCf(RectSpecFilter m);
+float getEnergy(RectSpecFilter m ,float * input, int winSize, int sampleRate);
+
+/* ------------------------ Filterbank ---------------------------- */
+
+typedef struct {
+	int winSize;
+	int nFilters; 
+	int sampleRate;
+	float lowF;
+	float highF;
+	RectSpecFilter_ptr bankFilters;
+	// bank energies
+	float * bankEn;
+} Filterbank;
+
+typedef Filterbank * Filterbank_ptr;
+
+Filterbank_ptr allocFilterbank(int nFilters);
+void deleteFilterbank(Filterbank_ptr fb);
+void initFilterbank(Filterbank_ptr m, int nFilters, int winSize, int sampleRate, float lowF, float highF);
+
+// compute bank energies from a magnitude spectrum of winSize bins
+void computeFilterEnergies(Filterbank_ptr m, float * input);
+
+#endif
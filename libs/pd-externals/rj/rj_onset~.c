@@ -0,0 +1,245 @@
+#include "m_pd.h"
+#include "rj_filterbank.h"
+#include <math.h>
+#include <stdlib.h>
+
+#ifdef NT
+#pragma warning( disable : 4244 )
+#pragma warning( disable : 4305 )
+#endif
+
+#define NFILTERS 12
+#define LF 40.f
+#define HF 8000.f
+#define WINSIZE 513
+
+#define DEF_MEDIAN 7
+#define MAXMEDIAN 31
+#define DEF_THRESHOLD 1.5f
+#define DEF_DELTA 0.0001f
+#define DEF_REST 50.f
+
+/* ------------------------ rj_onset~ for pd----------------------------- */
+
+/* spectral flux onset detector on the bark filterbank, expects a magnitude
+   spectrum like rj_barkflux_accum~.
+
+   per block, the half-wave rectified energy increase summed over the bands is
+   compared to an adaptive threshold: the median of the last few flux values
+   times a multiplier plus an offset. a bang is output when the flux rises
+   above the threshold, delayed by one block so the position of the threshold
+   crossing within the block can be kept: the output has a constant latency
+   but onset spacing is sub-block accurate. */
+
+static t_class *rj_onset_class;
+
+typedef struct _rj_onset
+{
+    t_object x_obj; 	   /* obligatory header */
+    t_float x_f;    	   /* place to hold inlet's value if it's set by message */
+    Filterbank_ptr fb;     /* fb: place to hold the filterbank structure */
+
+    // previous bank energies
+    float prev[NFILTERS];
+
+    // ring buffer of past flux values for the median
+    float history[MAXMEDIAN];
+    float sorted[MAXMEDIAN];
+    int median;
+    int historycnt;
+    int historyidx;
+
+    // threshold = median * threshold + delta
+    float threshold;
+    float delta;
+
+    float prevflux;
+    float prevthresh;
+    int above;
+
+    // timing
+    double blockms;        /* block period in ms */
+    double restms;         /* min time between onsets */
+    double lastonset;      /* logical time of the last onset */
+    double onsetdelay;     /* delay for the pending bang */
+    int toosmall;          /* input is not a full spectrum */
+
+    t_clock *clock;
+    t_outlet *onset;
+    t_outlet *flux;
+
+} t_rj_onset;
+
+static void rj_onset_tick(t_rj_onset *x)
+{
+	outlet_bang(x->onset);
+}
+
+// median of the history via insertion sort, the history is short
+static float rj_onset_median(t_rj_onset *x)
+{
+	int n=x->historycnt, i, j;
+	for (i=0; i<n; i++) {
+		float v=x->history[i];
+		for (j=i; j>0 && x->sorted[j-1]>v; j--) {
+			x->sorted[j]=x->sorted[j-1];
+		}
+		x->sorted[j]=v;
+	}
+	if (n==0) return 0;
+	return (n%2) ? x->sorted[n/2] : 0.5f*(x->sorted[n/2-1]+x->sorted[n/2]);
+}
+
+    /* this is the actual performance routine which acts on the samples.
+    It's called with a single pointer "w" which is our location in the
+    DSP call list.  We return a new "w" which will point to the next item
+    after us.  Meanwhile, w[0] is just a pointer to dsp-perform itself
+    (no use to us), w[1] and w[2] are the input and output vector locations,
+    and w[3] is the number of points to calculate. */
+
+static t_int *rj_onset_perform(t_int *w)
+{
+	t_rj_onset *x = (t_rj_onset *)(w[1]);
+    t_float *in = (t_float *)(w[2]);
+	int ifilter;
+	float flux=0.f, thresh;
+
+	if (x->toosmall) return (w+4);
+
+	// half-wave rectified band flux
+	computeFilterEnergies(x->fb, in);
+	for (ifilter=0; ifilter<x->fb->nFilters; ifilter++) {
+		float diff=x->fb->bankEn[ifilter]-x->prev[ifilter];
+		if (diff>0) flux+=diff;
+		x->prev[ifilter]=x->fb->bankEn[ifilter];
+	}
+
+	// adaptive threshold from the median of the previous blocks
+	thresh=rj_onset_median(x)*x->threshold+x->delta;
+	x->history[x->historyidx]=flux;
+	x->historyidx=(x->historyidx+1)%x->median;
+	if (x->historycnt<x->median) x->historycnt++;
+
+	if (flux>thresh) {
+		// rising edge only, respecting the rest time
+		if (!x->above && clock_gettimesince(x->lastonset)>=x->restms) {
+			// interpolate where the crossing happened between the
+			// previous block and this one
+			float frac=1.f;
+			float d=(flux-thresh)-(x->prevflux-x->prevthresh);
+			if (d>0) {
+				frac=1.f-(flux-thresh)/d;
+				if (frac<0) frac=0;
+			}
+			x->onsetdelay=frac*x->blockms;
+			x->lastonset=clock_getlogicaltime();
+			clock_delay(x->clock, x->onsetdelay);
+		}
+		x->above=1;
+	}
+	else x->above=0;
+
+	x->prevflux=flux;
+	x->prevthresh=thresh;
+	outlet_float(x->flux, flux);
+
+	return (w+4);
+}
+
+    /* called to start DSP.  Here we call Pd back to add our perform
+    routine to a linear callback list which Pd in turn calls to grind
+    out the samples. */
+static void rj_onset_dsp(t_rj_onset *x, t_signal **sp)
+{
+	x->toosmall=(sp[0]->s_n<WINSIZE);
+	if (x->toosmall) {
+		pd_error(x, "rj_onset~: input buffer too small. expected spectrum size is %d, so block size should be %d",WINSIZE,(WINSIZE-1)*2);
+	}
+	x->blockms=1000.*sp[0]->s_n/sp[0]->s_sr;
+	initFilterbank(x->fb, NFILTERS, WINSIZE, sys_getsr(), LF, HF);
+    dsp_add(rj_onset_perform, 3, x, sp[0]->s_vec, sp[0]->s_n);
+}
+
+static void rj_onset_set_threshold(t_rj_onset *x, t_floatarg f)
+{
+	x->threshold=f;
+}
+
+static void rj_onset_set_delta(t_rj_onset *x, t_floatarg f)
+{
+	x->delta=f;
+}
+
+static void rj_onset_set_median(t_rj_onset *x, t_floatarg f)
+{
+	int n=(int)f;
+	if (n<1) n=1;
+	if (n>MAXMEDIAN) n=MAXMEDIAN;
+	x->median=n;
+	x->historycnt=0;
+	x->historyidx=0;
+}
+
+static void rj_onset_set_rest(t_rj_onset *x, t_floatarg f)
+{
+	x->restms=(f<0 ? 0 : f);
+}
+
+static void *rj_onset_new(t_floatarg threshold, t_floatarg delta)
+{
+	int ifilter;
+
+    t_rj_onset *x = (t_rj_onset *)pd_new(rj_onset_class);
+	x->onset=outlet_new(&x->x_obj, &s_bang);
+	x->flux=outlet_new(&x->x_obj, &s_float);
+	x->clock=clock_new(x, (t_method)rj_onset_tick);
+	x->x_f = 0;
+
+	x->threshold=(threshold>0 ? threshold : DEF_THRESHOLD);
+	x->delta=(delta>0 ? delta : DEF_DELTA);
+	x->median=DEF_MEDIAN;
+	x->historycnt=0;
+	x->historyidx=0;
+	x->prevflux=0;
+	x->prevthresh=0;
+	x->above=0;
+	x->blockms=1000.*1024/sys_getsr();
+	x->restms=DEF_REST;
+	x->lastonset=clock_getlogicaltime();
+	x->onsetdelay=0;
+	x->toosmall=0;
+	for (ifilter=0; ifilter<NFILTERS; ifilter++) {
+		x->prev[ifilter]=0;
+	}
+
+	// filterbank alloc and init
+	x->fb=allocFilterbank(NFILTERS);
+	initFilterbank(x->fb, NFILTERS, WINSIZE, sys_getsr(), LF, HF);
+
+	return (x);
+}
+
+static void rj_onset_free(t_rj_onset *x) {
+
+	clock_free(x->clock);
+	deleteFilterbank(x->fb);
+}
+
+    /* this routine, which must have exactly this name (with the "~" replaced
+    by "_tilde) is called when the code is first loaded, and tells Pd how
+    to build the "class". */
+void rj_onset_tilde_setup(void)
+{
+    rj_onset_class = class_new(gensym("rj_onset~"), (t_newmethod)rj_onset_new, (t_method)rj_onset_free,
+    	sizeof(t_rj_onset), 0, A_DEFFLOAT, A_DEFFLOAT, 0);
+
+    CLASS_MAINSIGNALIN(rj_onset_class, t_rj_onset, x_f);
+	class_addmethod(rj_onset_class, (t_method)rj_onset_dsp, gensym("dsp"), 0);
+
+	class_addmethod(rj_onset_class, (t_method)rj_onset_set_threshold, gensym("threshold"), A_FLOAT, 0);
+	class_addmethod(rj_onset_class, (t_method)rj_onset_set_delta, gensym("delta"), A_FLOAT, 0);
+	class_addmethod(rj_onset_class, (t_method)rj_onset_set_median, gensym("median"), A_FLOAT, 0);
+	class_addmethod(rj_onset_class, (t_method)rj_onset_set_rest, gensym("rest"), A_FLOAT, 0);
+
+	post("rj_onset version 0.1");
+}
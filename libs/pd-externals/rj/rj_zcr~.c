@@ -1,29 +1,103 @@
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
 #include "m_pd.h"
 #ifdef NT
 #pragma warning( disable : 4244 )
 #pragma warning( disable : 4305 )
 #endif
 
+// define RJ_NO_SIMD to build the scalar loop only, ie. for testing
+#if PD_FLOATSIZE == 32 && !defined(RJ_NO_SIMD)
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RJ_ZCR_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define RJ_ZCR_SSE2
+#endif
+#endif
+
 #define WINDOWSIZE 1024
+#define MAXSEGMENTS 1024
 
 /* ------------------------ rj_zcr~ for pd----------------------------- */
 
-/* tilde object to take absolute value. */
+/* zero crossing rate over a sliding window, output every hop.
+
+   the window is split into hop sized segments: sign changes are counted
+   once per incoming sample and summed per segment, the window count is then
+   a running total over the last window/hop segments so nothing is rescanned */
 
 static t_class *rj_zcr_class;
 
 typedef struct _rj_zcr
 {
-    t_object x_obj; 	   /* obligatory header */    
-	t_float x_f;	
+    t_object x_obj; 	   /* obligatory header */
+	t_float x_f;
 	t_outlet* rj_zcr;		   /* m: place for outlet */
-	
-	float * buffer;
-	int buffercnt;
-    
+
+	int window;      /* window size in samples, multiple of hop */
+	int hop;         /* output period in samples */
+
+	int * segments;  /* ring of sign change counts per hop segment */
+	int nsegments;
+	int segidx;
+	int total;       /* sign changes within the current window */
+
+	int count;       /* sign changes in the current segment so far */
+	int hopcnt;      /* samples in the current segment so far */
+	t_float last;    /* last sample of the previous block */
+
 } t_rj_zcr;
 
+/* count zero crossings in in[0..n-1], including the transition from prev,
+   a crossing is a pair of samples with a negative product as in the original
+   rj_zcr~ so zeros, of either sign, never cross */
+static int rj_zcr_count(const t_float *in, int n, t_float prev)
+{
+	int ncross=0;
+	int i=0;
+
+	if(n<=0) return 0;
+	ncross+=(prev*in[0]<0);
+	n--; // pairs in[i], in[i+1]
+
+#if defined(RJ_ZCR_NEON)
+	{
+		const float32x4_t zero=vdupq_n_f32(0);
+		uint32x4_t acc=vdupq_n_u32(0);
+		for (; i+4<=n; i+=4) {
+			float32x4_t p=vmulq_f32(vld1q_f32(in+i), vld1q_f32(in+i+1));
+			acc=vsubq_u32(acc, vcltq_f32(p, zero)); // mask is all ones, ie. -1
+		}
+		uint32_t lanes[4];
+		vst1q_u32(lanes, acc);
+		ncross+=lanes[0]+lanes[1]+lanes[2]+lanes[3];
+	}
+#elif defined(RJ_ZCR_SSE2)
+	{
+		const __m128 zero=_mm_setzero_ps();
+		__m128i acc=_mm_setzero_si128();
+		for (; i+4<=n; i+=4) {
+			__m128 p=_mm_mul_ps(_mm_loadu_ps(in+i), _mm_loadu_ps(in+i+1));
+			acc=_mm_sub_epi32(acc, _mm_castps_si128(_mm_cmplt_ps(p, zero))); // mask is -1
+		}
+		uint32_t lanes[4];
+		_mm_storeu_si128((__m128i *)lanes, acc);
+		ncross+=lanes[0]+lanes[1]+lanes[2]+lanes[3];
+	}
+#endif
+
+	// remainder, or everything without simd
+	for (; i<n; i++) {
+		ncross+=(in[i]*in[i+1]<0);
+	}
+
+	return ncross;
+}
+
     /* this is the actual performance routine which acts on the samples.
     It's called with a single pointer "w" which is our location in the
     DSP call list.  We return a new "w" which will point to the next item
@@ -33,31 +107,37 @@ typedef struct _rj_zcr
 
 static t_int *rj_zcr_perform(t_int *w)
 {
-	
+
 	t_rj_zcr *x = (t_rj_zcr *)(w[1]);
-    
+
 	t_float *in = (t_float *)(w[2]);
-	
-	t_float rate=1.f;
-
-	int size=(int)(w[3]); 
-	
-	int ibuf; 
-	for (ibuf=0; ibuf<size; ibuf++) {
-		x->buffer[x->buffercnt++]=in[ibuf];
-		if(x->buffercnt==WINDOWSIZE-1) {
-			
-			int ncross=0;
-			int i;
-			for (i=0; i<WINDOWSIZE-1; i++) {
-				if(in[i]*in[i+1]<0) ncross++;
-			}
-			rate=(float) ncross/(float) WINDOWSIZE;
-			
+
+	int size=(int)(w[3]);
+
+	// consume the block in chunks up to the next hop boundary
+	while (size>0) {
+		int n=x->hop-x->hopcnt;
+		if(n>size) n=size;
+
+		x->count+=rj_zcr_count(in, n, x->last);
+		x->last=in[n-1];
+		x->hopcnt+=n;
+		in+=n;
+		size-=n;
+
+		if(x->hopcnt==x->hop) {
+
+			// replace the oldest segment
+			x->total-=x->segments[x->segidx];
+			x->total+=x->count;
+			x->segments[x->segidx]=x->count;
+			x->segidx=(x->segidx+1)%x->nsegments;
+
 			// copy rate
-			outlet_float(x->rj_zcr, rate);
-			
-			x->buffercnt=0;
+			outlet_float(x->rj_zcr, (float) x->total/(float) x->window);
+
+			x->count=0;
+			x->hopcnt=0;
 		}
 	}
 
@@ -72,20 +152,73 @@ static void rj_zcr_dsp(t_rj_zcr *x, t_signal **sp)
     dsp_add(rj_zcr_perform, 3, x, sp[0]->s_vec, sp[0]->s_n);
 }
 
-static void *rj_zcr_new(void)
+static void rj_zcr_reset(t_rj_zcr *x)
+{
+	memset(x->segments, 0, x->nsegments*sizeof(int));
+	x->segidx=0;
+	x->total=0;
+	x->count=0;
+	x->hopcnt=0;
+	x->last=0;
+}
+
+// set window & hop sizes, the window is rounded up to a multiple of the hop,
+// returns 0 & keeps the current sizes if the segments can't be allocated
+static int rj_zcr_configure(t_rj_zcr *x, int window, int hop)
+{
+	if(window<1) window=WINDOWSIZE;
+	if(hop<1 || hop>window) hop=window;
+	int nsegments=(window+hop-1)/hop;
+	if(nsegments>MAXSEGMENTS) {
+		post("rj_zcr~: window/hop ratio too large, clamping to %d", MAXSEGMENTS);
+		nsegments=MAXSEGMENTS;
+	}
+
+	if(nsegments!=x->nsegments) {
+		int * segments=malloc(nsegments*sizeof(int));
+		if(!segments) {
+			pd_error(x, "rj_zcr~: couldn't allocate %d segments", nsegments);
+			return 0;
+		}
+		free(x->segments);
+		x->segments=segments;
+		x->nsegments=nsegments;
+	}
+	x->hop=hop;
+	x->window=nsegments*hop;
+	rj_zcr_reset(x);
+	return 1;
+}
+
+static void rj_zcr_window(t_rj_zcr *x, t_floatarg f)
+{
+	rj_zcr_configure(x, (int)f, x->hop);
+}
+
+static void rj_zcr_hop(t_rj_zcr *x, t_floatarg f)
+{
+	rj_zcr_configure(x, x->window, (int)f);
+}
+
+static void *rj_zcr_new(t_floatarg window, t_floatarg hop)
 {
     t_rj_zcr *x = (t_rj_zcr *)pd_new(rj_zcr_class);
 	x->rj_zcr=outlet_new(&x->x_obj, &s_float);
 	x->x_f = 0;
-	
-	x->buffer=malloc(WINDOWSIZE*sizeof(float));
-	x->buffercnt=0;
-	
+
+	// defaults to non-overlapping windows
+	x->segments=NULL;
+	x->nsegments=0;
+	if(!rj_zcr_configure(x, (int)window, (int)hop)) {
+		pd_free((t_pd *)x);
+		return NULL;
+	}
+
 	return (x);
 }
 
 static void rj_zcr_free(t_rj_zcr *x) {
-	free(x->buffer);	
+	free(x->segments);
 }
 
 
@@ -95,7 +228,7 @@ static void rj_zcr_free(t_rj_zcr *x) {
 void rj_zcr_tilde_setup(void)
 {
     rj_zcr_class = class_new(gensym("rj_zcr~"), (t_newmethod)rj_zcr_new, (t_method)rj_zcr_free,
-    	sizeof(t_rj_zcr), 0, A_DEFFLOAT, 0);
+    	sizeof(t_rj_zcr), 0, A_DEFFLOAT, A_DEFFLOAT, 0);
 
 	    /* this is magic to declare that the leftmost, "main" inlet
 	    takes signals; other signal inlets are done differently... */
@@ -103,7 +236,10 @@ void rj_zcr_tilde_setup(void)
     CLASS_MAINSIGNALIN(rj_zcr_class, t_rj_zcr, x_f);
     	/* here we tell Pd about the "dsp" method, which is called back
 	when DSP is turned on. */
-    
+
 	class_addmethod(rj_zcr_class, (t_method)rj_zcr_dsp, gensym("dsp"), 0);
-	post("rj_zcr version 0.1");
+	class_addmethod(rj_zcr_class, (t_method)rj_zcr_window, gensym("window"), A_FLOAT, 0);
+	class_addmethod(rj_zcr_class, (t_method)rj_zcr_hop, gensym("hop"), A_FLOAT, 0);
+	class_addmethod(rj_zcr_class, (t_method)rj_zcr_reset, gensym("reset"), 0);
+	post("rj_zcr version 0.2");
 }
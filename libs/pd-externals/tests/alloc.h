@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+/* force included before each external source so its allocations are counted
+   by the shim, the system headers are included first so their declarations
+   are left alone */
+#ifndef SHIM_ALLOC_H
+#define SHIM_ALLOC_H
+
+#include <stdlib.h>
+#include <string.h>
+
+void *shim_malloc(size_t size);
+void *shim_calloc(size_t count, size_t size);
+void *shim_realloc(void *ptr, size_t size);
+void shim_free_ptr(void *ptr);
+
+#ifndef SHIM_ALLOC_NO_MACROS
+#define malloc(size) shim_malloc(size)
+#define calloc(count, size) shim_calloc(count, size)
+#define realloc(ptr, size) shim_realloc(ptr, size)
+#define free(ptr) shim_free_ptr(ptr)
+#endif
+
+#endif
@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+/* offline benchmark of the bundled externals: drives each object's perform
+   routine directly with synthetic signals & reports the cost per sample,
+   throughput, & allocation counts */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "shim.h"
+#include "externals.h"
+
+#define BENCH_MAXSIGNALS 4
+#define BENCH_INPUTBLOCKS 64 // pregenerated input blocks, cycled through
+
+/// run options
+typedef struct Options {
+	int blocksize;
+	t_float samplerate;
+	double seconds;  ///< audio length to render per external
+	int messages;    ///< messages per control external
+	char **names;    ///< externals to run, all if NULL
+	int nnames;
+} Options;
+
+/// signal external setup
+typedef struct SignalBench {
+	const char *name;
+	const char *args;  ///< creation args as floats, NULL for none
+	int spectral;      ///< takes a magnitude spectrum, needs blocks >= 1024
+} SignalBench;
+
+static const SignalBench signalBenches[] = {
+	{"moog~", NULL, 0},
+	{"rj_zcr~", NULL, 0},
+	{"rj_zcr~", "1024 64", 0},
+	{"rj_centroid~", NULL, 1},
+	{"rj_senergy~", NULL, 1},
+	{"rj_barkflux_accum~", NULL, 1},
+	{"rj_onset~", NULL, 1},
+	{NULL, NULL, 0}
+};
+
+/// per run allocation counts
+typedef struct Allocs {
+	size_t create; ///< while creating
+	size_t dsp;    ///< while adding to the dsp chain
+	size_t run;    ///< while performing
+} Allocs;
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static size_t allocs(void) {
+	return shim_allocstats().allocs;
+}
+
+static int selected(const Options *o, const char *name) {
+	if(!o->names) {
+		return 1;
+	}
+	for(int i = 0; i < o->nnames; ++i) {
+		if(!strcmp(o->names[i], name)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// parse space separated float creation args, returns count
+static int parseargs(const char *args, t_atom *argv, int max) {
+	int argc = 0;
+	char *end;
+	while(args && *args && argc < max) {
+		float f = strtof(args, &end);
+		if(end == args) {
+			break;
+		}
+		SETFLOAT(&argv[argc], f);
+		argc++;
+		args = end;
+	}
+	return argc;
+}
+
+static void printheader(const Options *o) {
+	printf("block %d, samplerate %g, %g s per signal external, %d messages per control external\n\n",
+		o->blocksize, o->samplerate, o->seconds, o->messages);
+	printf("%-28s %6s %10s %12s %11s  %s\n",
+		"signal external", "block", "ns/sample", "Msamples/s", "x realtime", "allocs new/dsp/run");
+}
+
+// fill the input blocks for a signal external
+static void fillinputs(const SignalBench *b, t_sample **inputs, int ninputs, int n, t_float sr) {
+	Generator g[BENCH_MAXSIGNALS];
+	for(int s = 0; s < ninputs; ++s) {
+		generator_init(&g[s], 1 + s);
+	}
+	for(int block = 0; block < BENCH_INPUTBLOCKS; ++block) {
+		for(int s = 0; s < ninputs; ++s) {
+			t_sample *in = inputs[s] + block * n;
+			if(b->spectral) {
+				generator_spectrum(&g[s], in, n);
+			}
+			else if(s == 0) { // audio
+				generator_saw(&g[s], in, n, 110, sr);
+			}
+			else if(s == 1) { // cutoff
+				for(int i = 0; i < n; ++i) {in[i] = 200 + 3800 * (block + (float)i / n) / BENCH_INPUTBLOCKS;}
+			}
+			else { // resonance
+				for(int i = 0; i < n; ++i) {in[i] = 2.5f;}
+			}
+		}
+	}
+}
+
+static void runsignal(const Options *o, const SignalBench *b) {
+	int n = (b->spectral && o->blocksize < 1024 ? 1024 : o->blocksize);
+	t_atom argv[4];
+	int argc = parseargs(b->args, argv, 4);
+	Allocs a;
+	size_t start = allocs();
+
+	t_pd *x = shim_new(b->name, argc, argv);
+	if(!x) {
+		fprintf(stderr, "bench: couldn't create %s\n", b->name);
+		return;
+	}
+	a.create = allocs() - start;
+
+	int nins = shim_signalinlets(x), nouts = shim_signaloutlets(x);
+	if(nins > BENCH_MAXSIGNALS || nouts > BENCH_MAXSIGNALS) {
+		fprintf(stderr, "bench: too many signals for %s\n", b->name);
+		shim_free(x);
+		return;
+	}
+	t_sample *inputs[BENCH_MAXSIGNALS], *ins[BENCH_MAXSIGNALS], *outs[BENCH_MAXSIGNALS];
+	for(int s = 0; s < nins; ++s) {
+		inputs[s] = calloc((size_t)n * BENCH_INPUTBLOCKS, sizeof(t_sample));
+		ins[s] = calloc(n, sizeof(t_sample));
+	}
+	for(int s = 0; s < nouts; ++s) {
+		outs[s] = calloc(n, sizeof(t_sample));
+	}
+	fillinputs(b, inputs, nins, n, o->samplerate);
+
+	start = allocs();
+	shim_dspclear();
+	shim_dspadd(x, n, ins, outs);
+	a.dsp = allocs() - start;
+
+	// warm up, then time the perform routine while cycling through the input
+	// blocks, the cost of copying the inputs is timed separately & subtracted
+	long blocks = (long)(o->seconds * o->samplerate / n);
+	if(blocks < 1) {blocks = 1;}
+	for(int block = 0; block < BENCH_INPUTBLOCKS; ++block) {
+		shim_dsptick(n);
+	}
+	start = allocs();
+	double t = now();
+	for(long block = 0; block < blocks; ++block) {
+		for(int s = 0; s < nins; ++s) {
+			memcpy(ins[s], inputs[s] + (block % BENCH_INPUTBLOCKS) * n, n * sizeof(t_sample));
+		}
+		shim_dsptick(n);
+	}
+	double elapsed = now() - t;
+	a.run = allocs() - start;
+	t = now();
+	for(long block = 0; block < blocks; ++block) {
+		for(int s = 0; s < nins; ++s) {
+			memcpy(ins[s], inputs[s] + (block % BENCH_INPUTBLOCKS) * n, n * sizeof(t_sample));
+		}
+		__asm__ __volatile__("" ::: "memory"); // keep the copies
+	}
+	elapsed -= now() - t;
+	if(elapsed <= 0) {elapsed = 1e-9;}
+
+	double samples = (double)blocks * n;
+	char label[64];
+	snprintf(label, sizeof(label), "%s%s%s", b->name, (b->args ? " " : ""), (b->args ? b->args : ""));
+	printf("%-28s %6d %10.2f %12.2f %11.1f  %zu/%zu/%zu\n",
+		label, n, elapsed * 1e9 / samples, samples / elapsed * 1e-6,
+		samples / o->samplerate / elapsed, a.create, a.dsp, a.run);
+
+	shim_dspclear();
+	shim_free(x);
+	for(int s = 0; s < nins; ++s) {free(inputs[s]); free(ins[s]);}
+	for(int s = 0; s < nouts; ++s) {free(outs[s]);}
+}
+
+// control externals
+
+static void printcontrol(const char *label, int messages, double elapsed,
+                         size_t create, size_t run) {
+	printf("%-28s %10.1f %12.3f  %zu/%zu\n",
+		label, elapsed * 1e9 / messages, messages / elapsed * 1e-6, create, run);
+}
+
+static void runaccum(const Options *o, int nfeatures) {
+	t_atom argv[16];
+	size_t start = allocs();
+	t_pd *x = shim_new("rj_accum", 0, NULL);
+	if(!x) {return;}
+	size_t create = allocs() - start;
+	Generator g;
+	generator_init(&g, 7);
+
+	start = allocs();
+	double t = now();
+	for(int m = 0; m < o->messages; ++m) {
+		t_sample values[16];
+		generator_noise(&g, values, nfeatures, 1);
+		if(nfeatures == 1) {
+			shim_float(x, values[0]);
+		}
+		else {
+			for(int i = 0; i < nfeatures; ++i) {SETFLOAT(&argv[i], values[i]);}
+			shim_list(x, nfeatures, argv);
+		}
+	}
+	double elapsed = now() - t;
+
+	char label[64];
+	snprintf(label, sizeof(label), "rj_accum %d value%s", nfeatures, (nfeatures > 1 ? "s" : ""));
+	printcontrol(label, o->messages, elapsed, create, allocs() - start);
+	shim_free(x);
+}
+
+static void countevents(t_pd *x, int outlet, t_symbol *s, int argc, t_atom *argv, void *userData) {
+	(void)x; (void)s; (void)argc; (void)argv;
+	if(outlet == 0) {(*(int *)userData)++;}
+}
+
+static void runmidifile(const Options *o) {
+	char path[] = "/tmp/pdparty-bench-XXXXXX";
+	int fd = mkstemp(path);
+	if(fd < 0 || !externals_writemidifile(path, o->messages / 2)) {
+		fprintf(stderr, "bench: couldn't write midi file\n");
+		if(fd >= 0) {close(fd); unlink(path);}
+		return;
+	}
+	close(fd);
+
+	size_t start = allocs();
+	t_pd *x = shim_new("midifile", 0, NULL);
+	if(!x) {unlink(path); return;}
+	t_atom verbosity;
+	SETFLOAT(&verbosity, 0);
+	shim_message(x, "verbose", 1, &verbosity);
+	t_atom file;
+	SETSYMBOL(&file, gensym(path));
+	shim_message(x, "read", 1, &file);
+	size_t create = allocs() - start;
+
+	int events = 0;
+	shim_setoutlethook(countevents, &events);
+	start = allocs();
+	double t = now();
+	for(int tick = 0; tick <= o->messages / 2 + 1; ++tick) {
+		shim_bang(x);
+	}
+	double elapsed = now() - t;
+	shim_setoutlethook(NULL, NULL);
+
+	printcontrol("midifile playback", (events ? events : 1), elapsed, create, allocs() - start);
+	shim_free(x);
+	unlink(path);
+}
+
+static void usage(void) {
+	fprintf(stderr,
+		"usage: bench [-b blocksize] [-r samplerate] [-s seconds] [-m messages] [-v] [external ...]\n"
+		"  -b  signal block size, the spectral externals use at least 1024 (default 64)\n"
+		"  -r  sample rate (default 44100)\n"
+		"  -s  audio seconds rendered per signal external (default 60)\n"
+		"  -m  messages or midi events per control external (default 1000000)\n"
+		"  -v  print external post & error output\n");
+}
+
+int main(int argc, char *argv[]) {
+	Options o = {64, 44100, 60, 1000000, NULL, 0};
+	int opt;
+	while((opt = getopt(argc, argv, "b:r:s:m:vh")) != -1) {
+		switch(opt) {
+			case 'b': o.blocksize = atoi(optarg); break;
+			case 'r': o.samplerate = strtof(optarg, NULL); break;
+			case 's': o.seconds = strtod(optarg, NULL); break;
+			case 'm': o.messages = atoi(optarg); break;
+			case 'v': shim_setverbose(1); break;
+			default: usage(); return (opt == 'h' ? 0 : 1);
+		}
+	}
+	if(o.blocksize < 1 || o.samplerate <= 0 || o.seconds <= 0 || o.messages < 2) {
+		usage();
+		return 1;
+	}
+	if(optind < argc) {
+		o.names = argv + optind;
+		o.nnames = argc - optind;
+	}
+
+	shim_setsamplerate(o.samplerate);
+	shim_setblocksize(o.blocksize);
+	externals_setup();
+
+	printheader(&o);
+	for(const SignalBench *b = signalBenches; b->name; ++b) {
+		if(selected(&o, b->name)) {
+			runsignal(&o, b);
+		}
+	}
+	printf("\n%-28s %10s %12s  %s\n", "control external", "ns/message", "Mmessages/s", "allocs new/run");
+	if(selected(&o, "rj_accum")) {
+		runaccum(&o, 1);
+		runaccum(&o, 12);
+	}
+	if(selected(&o, "midifile")) {
+		runmidifile(&o);
+	}
+	return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include "externals.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+void moog_tilde_setup(void);
+void midifile_setup(void);
+void rj_accum_setup(void);
+void rj_barkflux_accum_tilde_setup(void);
+void rj_centroid_tilde_setup(void);
+void rj_onset_tilde_setup(void);
+void rj_senergy_tilde_setup(void);
+void rj_zcr_tilde_setup(void);
+
+void externals_setup(void) {
+	moog_tilde_setup();
+	midifile_setup();
+	rj_accum_setup();
+	rj_barkflux_accum_tilde_setup();
+	rj_centroid_tilde_setup();
+	rj_onset_tilde_setup();
+	rj_senergy_tilde_setup();
+	rj_zcr_tilde_setup();
+}
+
+int externals_writemidifile(const char *path, int count) {
+	FILE *f = fopen(path, "wb");
+	if(!f) {return 0;}
+	const unsigned char header[] = {'M','T','h','d', 0,0,0,6, 0,0, 0,1, 0,96};
+	uint32_t length = count * 8 + 4;
+	const unsigned char track[] = {'M','T','r','k',
+		length >> 24, (length >> 16) & 0xFF, (length >> 8) & 0xFF, length & 0xFF};
+	fwrite(header, 1, sizeof(header), f);
+	fwrite(track, 1, sizeof(track), f);
+	for(int i = 0; i < count; ++i) {
+		unsigned char note = 36 + (i % 48);
+		const unsigned char events[] = {1, 0x90, note, 100, 0, 0x80, note, 0};
+		fwrite(events, 1, sizeof(events), f);
+	}
+	const unsigned char end[] = {0, 0xFF, 0x2F, 0};
+	fwrite(end, 1, sizeof(end), f);
+	return (fclose(f) == 0);
+}
+
+// 32 bit lcg, the same sequence on every platform
+static uint32_t lcg(uint32_t *seed) {
+	*seed = *seed * 1664525u + 1013904223u;
+	return *seed;
+}
+
+// uniform -1 to 1
+static double uniform(uint32_t *seed) {
+	return (double)(lcg(seed) >> 8) / (double)(1 << 23) - 1.0;
+}
+
+void generator_init(Generator *g, uint32_t seed) {
+	g->phase = 0;
+	g->seed = seed;
+	g->frame = 0;
+}
+
+void generator_sine(Generator *g, t_sample *out, int n, double freq, double sr) {
+	for(int i = 0; i < n; ++i) {
+		out[i] = (t_sample)sin(2 * M_PI * g->phase);
+		g->phase += freq / sr;
+		g->phase -= floor(g->phase);
+	}
+}
+
+void generator_saw(Generator *g, t_sample *out, int n, double freq, double sr) {
+	for(int i = 0; i < n; ++i) {
+		out[i] = (t_sample)(2 * g->phase - 1);
+		g->phase += freq / sr;
+		g->phase -= floor(g->phase);
+	}
+}
+
+void generator_noise(Generator *g, t_sample *out, int n, t_sample amp) {
+	for(int i = 0; i < n; ++i) {
+		out[i] = amp * (t_sample)uniform(&g->seed);
+	}
+}
+
+void generator_spectrum(Generator *g, t_sample *out, int n) {
+	static const double peaks[3] = {12, 60, 200}; // start bins
+	double t = g->frame++;
+	for(int i = 0; i < EXTERNALS_SPECTRUM_SIZE; ++i) {
+		double m = 0.01 + 0.005 * uniform(&g->seed);
+		for(int p = 0; p < 3; ++p) {
+			double center = peaks[p] * (1 + 0.5 * sin(t * 0.05 * (p + 1)));
+			double d = (i - center) / (2.0 + p);
+			double amp = (p == 0 && ((int)t % 16) == 0 ? 40 : 10 / (p + 1.0));
+			m += amp * exp(-0.5 * d * d);
+		}
+		out[i] = (t_sample)m;
+	}
+	memset(out + EXTERNALS_SPECTRUM_SIZE, 0, (n - EXTERNALS_SPECTRUM_SIZE) * sizeof(t_sample));
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+/* bundled externals setup & deterministic test signals shared by the
+   benchmark & golden output test */
+#ifndef EXTERNALS_H
+#define EXTERNALS_H
+
+#include <stdint.h>
+#include "m_pd.h"
+
+/// spectrum size expected by the rj spectral externals, needs a block size
+/// of at least 1024
+#define EXTERNALS_SPECTRUM_SIZE 513
+
+/// setup the bundled externals, same as in Externals.m
+void externals_setup(void);
+
+/// write a format 0 midi file with count note on & off pairs 1 tick apart,
+/// returns 0 on failure
+int externals_writemidifile(const char *path, int count);
+
+/// test signal generator state
+typedef struct Generator {
+	double phase;  ///< oscillator phase 0-1
+	uint32_t seed; ///< noise seed
+	int frame;     ///< spectrum frame count
+} Generator;
+
+/// init generator with a noise seed
+void generator_init(Generator *g, uint32_t seed);
+
+/// write n samples of a sine at freq Hz
+void generator_sine(Generator *g, t_sample *out, int n, double freq, double sr);
+
+/// write n samples of a naive sawtooth at freq Hz
+void generator_saw(Generator *g, t_sample *out, int n, double freq, double sr);
+
+/// write n samples of uniform white noise scaled by amp
+void generator_noise(Generator *g, t_sample *out, int n, t_sample amp);
+
+/// write a magnitude spectrum frame into the first EXTERNALS_SPECTRUM_SIZE
+/// bins of out with a few peaks that move over time above a noise floor, the
+/// rest of the n samples are zeroed, n must be >= 1024
+void generator_spectrum(Generator *g, t_sample *out, int n);
+
+#endif
@@ -0,0 +1,463 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+/* golden output test for the bundled externals: renders fixed input signals
+   & messages through each external & compares the output to the reference
+   files in the golden directory within an error bound, -r rewrites them
+
+   each output is a line of logical time in ms, outlet, selector, & values,
+   signal outlets are written once per block as ~index */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include "shim.h"
+#include "externals.h"
+
+#define GOLDEN_MAXSIGNALS 4
+#define GOLDEN_MAXLINE 65536
+
+/// output line
+typedef struct Line {
+	double time;
+	char outlet[8];
+	char selector[32];
+	int argc;
+	char **symbols; ///< symbol per value or NULL for floats
+	double *floats;
+} Line;
+
+/// recorded or loaded output
+typedef struct Output {
+	Line *lines;
+	int count, capacity;
+} Output;
+
+/// test case
+typedef struct Case {
+	const char *name; ///< golden file name without extension
+	int (*render)(Output *output);
+} Case;
+
+static Line *addline(Output *o, double time, const char *outlet, const char *selector, int argc) {
+	if(o->count == o->capacity) {
+		o->capacity = (o->capacity ? o->capacity * 2 : 256);
+		o->lines = realloc(o->lines, o->capacity * sizeof(Line));
+	}
+	Line *l = &o->lines[o->count++];
+	l->time = time;
+	snprintf(l->outlet, sizeof(l->outlet), "%s", outlet);
+	snprintf(l->selector, sizeof(l->selector), "%s", selector);
+	l->argc = argc;
+	l->symbols = calloc(argc + 1, sizeof(char *));
+	l->floats = calloc(argc + 1, sizeof(double));
+	return l;
+}
+
+static void freeoutput(Output *o) {
+	for(int i = 0; i < o->count; ++i) {
+		for(int a = 0; a < o->lines[i].argc; ++a) {
+			free(o->lines[i].symbols[a]);
+		}
+		free(o->lines[i].symbols);
+		free(o->lines[i].floats);
+	}
+	free(o->lines);
+	memset(o, 0, sizeof(Output));
+}
+
+// record outlet messages with the current logical time
+static void recordmessage(t_pd *x, int outlet, t_symbol *s, int argc, t_atom *argv, void *userData) {
+	char index[8];
+	(void)x;
+	snprintf(index, sizeof(index), "%d", outlet);
+	Line *l = addline((Output *)userData, clock_getlogicaltime(), index, s->s_name, argc);
+	for(int i = 0; i < argc; ++i) {
+		if(argv[i].a_type == A_SYMBOL) {
+			l->symbols[i] = strdup(argv[i].a_w.w_symbol->s_name);
+		}
+		else {
+			l->floats[i] = atom_getfloat(&argv[i]);
+		}
+	}
+}
+
+static void recordsignal(Output *o, double time, int outlet, const t_sample *vec, int n) {
+	char index[8];
+	snprintf(index, sizeof(index), "~%d", outlet);
+	Line *l = addline(o, time, index, "signal", n);
+	for(int i = 0; i < n; ++i) {
+		l->floats[i] = vec[i];
+	}
+}
+
+// input generator callback for a block, called once per block
+typedef void (*FillBlock)(int block, t_sample **ins, int nins, int n, Generator *g);
+
+// create an external & run it for nblocks of n samples, recording both
+// messages & signal outputs
+static int rendersignal(Output *o, const char *name, int argc, t_atom *argv,
+                        int nblocks, int n, FillBlock fill) {
+	shim_setoutlethook(recordmessage, o);
+	t_pd *x = shim_new(name, argc, argv);
+	if(!x) {
+		shim_setoutlethook(NULL, NULL);
+		return 0;
+	}
+	int nins = shim_signalinlets(x), nouts = shim_signaloutlets(x);
+	t_sample *ins[GOLDEN_MAXSIGNALS], *outs[GOLDEN_MAXSIGNALS];
+	Generator g[GOLDEN_MAXSIGNALS];
+	for(int s = 0; s < nins; ++s) {
+		ins[s] = calloc(n, sizeof(t_sample));
+		generator_init(&g[s], 1 + s);
+	}
+	for(int s = 0; s < nouts; ++s) {
+		outs[s] = calloc(n, sizeof(t_sample));
+	}
+	shim_dspclear();
+	shim_dspadd(x, n, ins, outs);
+	for(int block = 0; block < nblocks; ++block) {
+		double time = clock_getlogicaltime();
+		fill(block, ins, nins, n, g);
+		shim_dsptick(n);
+		for(int s = 0; s < nouts; ++s) {
+			recordsignal(o, time, s, outs[s], n);
+		}
+	}
+	shim_dspclear();
+	shim_free(x);
+	shim_setoutlethook(NULL, NULL);
+	for(int s = 0; s < nins; ++s) {free(ins[s]);}
+	for(int s = 0; s < nouts; ++s) {free(outs[s]);}
+	return 1;
+}
+
+// cases
+
+// saw & noise through a sweeping cutoff & resonance
+static void fillmoog(int block, t_sample **ins, int nins, int n, Generator *g) {
+	t_sample noise[1024];
+	generator_saw(&g[0], ins[0], n, 110, sys_getsr());
+	generator_noise(&g[0], noise, n, 0.1f);
+	for(int i = 0; i < n; ++i) {
+		double t = (block * n + i) / (128.0 * n);
+		ins[0][i] += noise[i];
+		ins[1][i] = (t_sample)(100 * pow(50, t));
+		ins[2][i] = (t_sample)(3.9 * t);
+	}
+	(void)nins;
+}
+
+static int rendermoog(Output *o) {
+	return rendersignal(o, "moog~", 0, NULL, 128, 64, fillmoog);
+}
+
+// tone & noise with silence, +-0, & a near silent stretch to pin down which
+// pairs count as crossings
+static void fillzcr(int block, t_sample **ins, int nins, int n, Generator *g) {
+	int section = (block / 16) % 4;
+	generator_sine(&g[0], ins[0], n, 440 + 20 * block, sys_getsr());
+	if(section == 1) { // silence with alternating signed zeros
+		for(int i = 0; i < n; ++i) {ins[0][i] = (i & 1 ? -0.0f : 0.0f);}
+	}
+	else if(section == 2) { // noise
+		generator_noise(&g[0], ins[0], n, 0.5f);
+	}
+	else if(section == 3) { // near silent noise with zeros in between
+		generator_noise(&g[0], ins[0], n, 1e-30f);
+		for(int i = 0; i < n; i += 3) {ins[0][i] = 0;}
+	}
+	(void)nins;
+}
+
+static int renderzcr(Output *o) {
+	return rendersignal(o, "rj_zcr~", 0, NULL, 256, 64, fillzcr);
+}
+
+static int renderzcrhop(Output *o) {
+	t_atom argv[2];
+	SETFLOAT(&argv[0], 1000);
+	SETFLOAT(&argv[1], 250);
+	return rendersignal(o, "rj_zcr~", 2, argv, 256, 64, fillzcr);
+}
+
+static void fillspectrum(int block, t_sample **ins, int nins, int n, Generator *g) {
+	(void)block;
+	for(int s = 0; s < nins; ++s) {
+		generator_spectrum(&g[s], ins[s], n);
+	}
+}
+
+static int rendercentroid(Output *o) {
+	return rendersignal(o, "rj_centroid~", 0, NULL, 64, 1024, fillspectrum);
+}
+
+static int rendersenergy(Output *o) {
+	return rendersignal(o, "rj_senergy~", 0, NULL, 64, 1024, fillspectrum);
+}
+
+static int renderbarkflux(Output *o) {
+	return rendersignal(o, "rj_barkflux_accum~", 0, NULL, 64, 1024, fillspectrum);
+}
+
+static int renderonset(Output *o) {
+	return rendersignal(o, "rj_onset~", 0, NULL, 96, 1024, fillspectrum);
+}
+
+// single stream floats, then 12 stream lists, with buffer length changes
+static int renderaccum(Output *o) {
+	Generator g;
+	t_atom argv[12];
+	generator_init(&g, 3);
+	shim_setoutlethook(recordmessage, o);
+	t_pd *x = shim_new("rj_accum", 0, NULL);
+	if(!x) {
+		shim_setoutlethook(NULL, NULL);
+		return 0;
+	}
+	SETFLOAT(&argv[0], 1);
+	shim_message(x, "st", 1, argv);
+	SETFLOAT(&argv[0], 3);
+	shim_message(x, "lt", 1, argv);
+	for(int i = 0; i < 400; ++i) {
+		t_sample f;
+		generator_noise(&g, &f, 1, 1);
+		shim_float(x, f + (i / 100) * 0.5f);
+	}
+	for(int i = 0; i < 400; ++i) {
+		t_sample values[12];
+		generator_noise(&g, values, 12, 1);
+		for(int v = 0; v < 12; ++v) {
+			SETFLOAT(&argv[v], values[v] + v * (i / 100));
+		}
+		shim_list(x, 12, argv);
+		if(i == 200) {
+			t_atom st;
+			SETFLOAT(&st, 0.5f);
+			shim_message(x, "st", 1, &st);
+		}
+	}
+	shim_free(x);
+	shim_setoutlethook(NULL, NULL);
+	return 1;
+}
+
+static int rendermidifile(Output *o) {
+	char path[] = "/tmp/pdparty-golden-XXXXXX";
+	int fd = mkstemp(path);
+	if(fd < 0) {
+		return 0;
+	}
+	close(fd);
+	if(!externals_writemidifile(path, 100)) {
+		unlink(path);
+		return 0;
+	}
+	t_pd *x = shim_new("midifile", 0, NULL);
+	if(!x) {
+		unlink(path);
+		return 0;
+	}
+	t_atom a;
+	SETFLOAT(&a, 0);
+	shim_message(x, "verbose", 1, &a);
+	SETSYMBOL(&a, gensym(path));
+	shim_message(x, "read", 1, &a);
+	shim_setoutlethook(recordmessage, o);
+	for(int tick = 0; tick < 120; ++tick) {
+		shim_bang(x);
+		shim_advance(1);
+	}
+	shim_setoutlethook(NULL, NULL);
+	shim_free(x);
+	unlink(path);
+	return 1;
+}
+
+static const Case cases[] = {
+	{"moog~", rendermoog},
+	{"rj_zcr~", renderzcr},
+	{"rj_zcr~-1000-250", renderzcrhop},
+	{"rj_centroid~", rendercentroid},
+	{"rj_senergy~", rendersenergy},
+	{"rj_barkflux_accum~", renderbarkflux},
+	{"rj_onset~", renderonset},
+	{"rj_accum", renderaccum},
+	{"midifile", rendermidifile},
+	{NULL, NULL}
+};
+
+// files
+
+static int writeoutput(const Output *o, const char *path, const char *name) {
+	FILE *f = fopen(path, "w");
+	if(!f) {
+		return 0;
+	}
+	fprintf(f, "# %s golden output: time outlet selector values...\n", name);
+	for(int i = 0; i < o->count; ++i) {
+		const Line *l = &o->lines[i];
+		fprintf(f, "%.9g %s %s", l->time, l->outlet, l->selector);
+		for(int a = 0; a < l->argc; ++a) {
+			if(l->symbols[a]) {
+				fprintf(f, " %s", l->symbols[a]);
+			}
+			else {
+				fprintf(f, " %.9g", l->floats[a]);
+			}
+		}
+		fputc('\n', f);
+	}
+	return (fclose(f) == 0);
+}
+
+static int readoutput(Output *o, const char *path) {
+	FILE *f = fopen(path, "r");
+	if(!f) {
+		return 0;
+	}
+	char *buffer = malloc(GOLDEN_MAXLINE);
+	static char *tokens[GOLDEN_MAXLINE / 2];
+	while(fgets(buffer, GOLDEN_MAXLINE, f)) {
+		if(buffer[0] == '#' || buffer[0] == '\n') {
+			continue;
+		}
+		int count = 0;
+		for(char *t = strtok(buffer, " \n"); t; t = strtok(NULL, " \n")) {
+			tokens[count++] = t;
+		}
+		if(count < 3) {
+			continue;
+		}
+		Line *l = addline(o, strtod(tokens[0], NULL), tokens[1], tokens[2], count - 3);
+		for(int a = 0; a < l->argc; ++a) {
+			char *end;
+			double value = strtod(tokens[a + 3], &end);
+			if(*end == '\0') {
+				l->floats[a] = value;
+			}
+			else {
+				l->symbols[a] = strdup(tokens[a + 3]);
+			}
+		}
+	}
+	free(buffer);
+	fclose(f);
+	return 1;
+}
+
+// relative to the reference value, absolute below 1
+static double relerror(double value, double ref) {
+	if(isnan(value) || isnan(ref)) {
+		return (isnan(value) && isnan(ref) ? 0 : INFINITY);
+	}
+	return fabs(value - ref) / (fabs(ref) > 1 ? fabs(ref) : 1);
+}
+
+// compare output to reference, prints the first mismatch & returns the max
+// error or INFINITY if the structure differs
+static double compare(const Output *o, const Output *ref, const char *name) {
+	double maxerr = 0;
+	if(o->count != ref->count) {
+		printf("%s: %d output lines, expected %d\n", name, o->count, ref->count);
+		return INFINITY;
+	}
+	for(int i = 0; i < o->count; ++i) {
+		const Line *l = &o->lines[i], *r = &ref->lines[i];
+		if(strcmp(l->outlet, r->outlet) || strcmp(l->selector, r->selector) || l->argc != r->argc) {
+			printf("%s: line %d is \"%s %s\" with %d values, expected \"%s %s\" with %d values\n",
+				name, i + 1, l->outlet, l->selector, l->argc, r->outlet, r->selector, r->argc);
+			return INFINITY;
+		}
+		double err = relerror(l->time, r->time);
+		if(err > maxerr) {maxerr = err;}
+		for(int a = 0; a < l->argc; ++a) {
+			if(l->symbols[a] || r->symbols[a]) {
+				if(!l->symbols[a] || !r->symbols[a] || strcmp(l->symbols[a], r->symbols[a])) {
+					printf("%s: line %d value %d differs\n", name, i + 1, a + 1);
+					return INFINITY;
+				}
+				continue;
+			}
+			err = relerror(l->floats[a], r->floats[a]);
+			if(err > maxerr) {maxerr = err;}
+		}
+	}
+	return maxerr;
+}
+
+static void usage(void) {
+	fprintf(stderr,
+		"usage: golden [-d dir] [-t tolerance] [-r] [-v] [case ...]\n"
+		"  -d  golden reference directory (default golden)\n"
+		"  -t  max error, relative for values above 1 & absolute below (default 1e-5)\n"
+		"  -r  record: write the reference files instead of comparing\n"
+		"  -v  print external post & error output\n");
+}
+
+int main(int argc, char *argv[]) {
+	const char *dir = "golden";
+	double tolerance = 1e-5;
+	int record = 0, failed = 0, opt;
+	while((opt = getopt(argc, argv, "d:t:rvh")) != -1) {
+		switch(opt) {
+			case 'd': dir = optarg; break;
+			case 't': tolerance = strtod(optarg, NULL); break;
+			case 'r': record = 1; break;
+			case 'v': shim_setverbose(1); break;
+			default: usage(); return (opt == 'h' ? 0 : 1);
+		}
+	}
+
+	shim_setsamplerate(44100);
+	shim_setblocksize(64);
+	externals_setup();
+
+	for(const Case *c = cases; c->name; ++c) {
+		int selected = (optind == argc);
+		for(int i = optind; i < argc; ++i) {
+			if(!strcmp(argv[i], c->name)) {selected = 1;}
+		}
+		if(!selected) {
+			continue;
+		}
+		char path[1024];
+		Output output = {NULL, 0, 0}, ref = {NULL, 0, 0};
+		snprintf(path, sizeof(path), "%s/%s.txt", dir, c->name);
+		shim_settime(0);
+		if(!c->render(&output)) {
+			printf("%-24s FAILED to render\n", c->name);
+			failed++;
+		}
+		else if(record) {
+			if(writeoutput(&output, path, c->name)) {
+				printf("%-24s recorded %d lines to %s\n", c->name, output.count, path);
+			}
+			else {
+				printf("%-24s FAILED to write %s\n", c->name, path);
+				failed++;
+			}
+		}
+		else if(!readoutput(&ref, path)) {
+			printf("%-24s FAILED to read %s\n", c->name, path);
+			failed++;
+		}
+		else {
+			double err = compare(&output, &ref, c->name);
+			int ok = (err <= tolerance);
+			printf("%-24s %-6s max error %g\n", c->name, (ok ? "ok" : "FAILED"), err);
+			failed += !ok;
+		}
+		freeoutput(&output);
+		freeoutput(&ref);
+	}
+	return (failed ? 1 : 0);
+}
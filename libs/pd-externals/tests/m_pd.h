@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+/* minimal m_pd.h stand in for building the bundled externals natively
+   without pd, only declares what the externals use, see shim.c */
+#ifndef __m_pd_h_
+#define __m_pd_h_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PD_MAJOR_VERSION 0
+#define PD_MINOR_VERSION 54
+#define PD_BUGFIX_VERSION 0
+
+#define PD_FLOATSIZE 32
+
+#define MAXPDSTRING 1000
+#define MAXPDARG 5
+
+typedef intptr_t t_int;
+typedef float t_float;
+typedef float t_floatarg;
+typedef float t_sample;
+
+typedef struct _symbol {
+	const char *s_name;
+	struct _class **s_thing;
+	struct _symbol *s_next;
+} t_symbol;
+
+typedef union word {
+	t_float w_float;
+	t_symbol *w_symbol;
+	int w_index;
+} t_word;
+
+typedef enum {
+	A_NULL,
+	A_FLOAT,
+	A_SYMBOL,
+	A_POINTER,
+	A_SEMI,
+	A_COMMA,
+	A_DEFFLOAT,
+	A_DEFSYM,
+	A_DOLLAR,
+	A_DOLLSYM,
+	A_GIMME,
+	A_CANT
+} t_atomtype;
+
+#define A_DEFSYMBOL A_DEFSYM
+
+typedef struct _atom {
+	t_atomtype a_type;
+	union word a_w;
+} t_atom;
+
+typedef struct _class t_class;
+typedef struct _outlet t_outlet;
+typedef struct _inlet t_inlet;
+typedef struct _clock t_clock;
+
+typedef t_class *t_pd;
+
+typedef struct _object {
+	t_pd ob_pd;
+} t_object;
+
+typedef struct _signal {
+	int s_n;
+	t_sample *s_vec;
+	t_float s_sr;
+} t_signal;
+
+typedef t_int *(*t_perfroutine)(t_int *w);
+typedef void *(*t_newmethod)(void);
+typedef void (*t_method)(void);
+typedef void (*t_bangmethod)(t_pd *x);
+typedef void (*t_floatmethod)(t_pd *x, t_float f);
+typedef void (*t_listmethod)(t_pd *x, t_symbol *s, int argc, t_atom *argv);
+
+extern t_symbol s_bang, s_float, s_symbol, s_list, s_anything, s_signal;
+
+t_symbol *gensym(const char *s);
+
+/* classes */
+
+#define CLASS_DEFAULT 0
+#define CLASS_NOINLET 8
+
+t_class *class_new(t_symbol *name, t_newmethod newmethod, t_method freemethod,
+	size_t size, int flags, t_atomtype arg1, ...);
+void class_addmethod(t_class *c, t_method fn, t_symbol *sel, t_atomtype arg1, ...);
+void class_addbang(t_class *c, t_method fn);
+void class_addfloat(t_class *c, t_method fn);
+void class_addlist(t_class *c, t_method fn);
+void class_domainsignalin(t_class *c, int onset);
+
+#define class_addbang(x, y) class_addbang((x), (t_method)(y))
+#define class_addfloat(x, y) class_addfloat((x), (t_method)(y))
+#define class_addlist(x, y) class_addlist((x), (t_method)(y))
+
+#define CLASS_MAINSIGNALIN(c, type, field) \
+	class_domainsignalin(c, (int)offsetof(type, field))
+
+void nullfn(void);
+
+/* objects */
+
+t_pd *pd_new(t_class *c);
+void pd_free(t_pd *x);
+
+t_inlet *inlet_new(t_object *owner, t_pd *dest, t_symbol *s1, t_symbol *s2);
+t_outlet *outlet_new(t_object *owner, t_symbol *s);
+void outlet_bang(t_outlet *x);
+void outlet_float(t_outlet *x, t_float f);
+void outlet_symbol(t_outlet *x, t_symbol *s);
+void outlet_list(t_outlet *x, t_symbol *s, int argc, t_atom *argv);
+void outlet_anything(t_outlet *x, t_symbol *s, int argc, t_atom *argv);
+
+/* atoms */
+
+#define SETFLOAT(atom, f) ((atom)->a_type = A_FLOAT, (atom)->a_w.w_float = (f))
+#define SETSYMBOL(atom, s) ((atom)->a_type = A_SYMBOL, (atom)->a_w.w_symbol = (s))
+
+t_float atom_getfloat(const t_atom *a);
+t_int atom_getint(const t_atom *a);
+t_symbol *atom_getsymbol(const t_atom *a);
+t_float atom_getfloatarg(int which, int argc, const t_atom *argv);
+
+/* memory */
+
+void *getbytes(size_t nbytes);
+void *resizebytes(void *x, size_t oldsize, size_t newsize);
+void freebytes(void *x, size_t nbytes);
+
+/* printing */
+
+void post(const char *fmt, ...);
+void verbose(int level, const char *fmt, ...);
+void logpost(const void *object, int level, const char *fmt, ...);
+void error(const char *fmt, ...);
+void pd_error(const void *object, const char *fmt, ...);
+
+/* dsp */
+
+void dsp_add(t_perfroutine f, int n, ...);
+t_float sys_getsr(void);
+int sys_getblksize(void);
+
+/* clocks, logical time is in ms */
+
+t_clock *clock_new(void *owner, t_method fn);
+void clock_delay(t_clock *x, double delaytime);
+void clock_unset(t_clock *x);
+void clock_free(t_clock *x);
+double clock_getlogicaltime(void);
+double clock_gettimesince(double prevsystime);
+
+/* files */
+
+t_symbol *canvas_getcurrentdir(void);
+int sys_open(const char *path, int oflag, ...);
+FILE *sys_fopen(const char *filename, const char *mode);
+int sys_fclose(FILE *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,682 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include "shim.h"
+
+#define SHIM_ALLOC_NO_MACROS
+#include "alloc.h"
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define SHIM_MAXMETHODS 32
+#define SHIM_MAXOUTLETS 8
+
+typedef struct _method {
+	t_symbol *sel;
+	t_method fn;
+	t_atomtype args[MAXPDARG + 1];
+} t_shimmethod;
+
+struct _class {
+	t_symbol *name;
+	t_newmethod newmethod;
+	t_method freemethod;
+	size_t size;
+	t_atomtype args[MAXPDARG + 1];
+	int mainsignalin;
+	t_method bangmethod;
+	t_method floatmethod;
+	t_method listmethod;
+	t_shimmethod methods[SHIM_MAXMETHODS];
+	int nmethods;
+	struct _class *next;
+};
+
+struct _outlet {
+	t_object *owner;
+	int index;
+	int signal;
+};
+
+struct _inlet {
+	int signal;
+};
+
+struct _clock {
+	void *owner;
+	t_method fn;
+	double settime; // < 0 if unset
+	struct _clock *next;
+};
+
+/// per object bookkeeping, t_object only holds the class pointer
+typedef struct _objectinfo {
+	t_pd *x;
+	t_outlet outlets[SHIM_MAXOUTLETS];
+	int noutlets;
+	t_inlet *inlets[SHIM_MAXOUTLETS];
+	int ninlets;
+	int nsignalinlets;  // excluding the main inlet
+	int nsignaloutlets;
+	t_signal *signals;
+	struct _objectinfo *next;
+} t_objectinfo;
+
+t_symbol s_bang = {"bang", NULL, NULL};
+t_symbol s_float = {"float", NULL, NULL};
+t_symbol s_symbol = {"symbol", NULL, NULL};
+t_symbol s_list = {"list", NULL, NULL};
+t_symbol s_anything = {"anything", NULL, NULL};
+t_symbol s_signal = {"signal", NULL, NULL};
+
+static t_symbol *symbols = NULL;
+static t_class *classes = NULL;
+static t_objectinfo *objects = NULL;
+static t_clock *clocks = NULL;
+
+static t_float samplerate = 44100;
+static int blocksize = 64;
+static int verbosity = 0;
+static int errors = 0;
+static ShimOutletHook outlethook = NULL;
+static void *outlethookdata = NULL;
+static ShimAllocStats allocstats = {0, 0, 0};
+
+static t_int *chain = NULL;
+static int chainsize = 0, chaincapacity = 0;
+
+static double logicaltime = 0;
+
+// collect a 0 terminated arg type list
+static void argtypes(t_atomtype *types, t_atomtype arg1, va_list ap) {
+	int i = 0;
+	t_atomtype type = arg1;
+	while(type != A_NULL && i < MAXPDARG) {
+		types[i++] = type;
+		type = (t_atomtype)va_arg(ap, int);
+	}
+	types[i] = A_NULL;
+}
+
+static t_objectinfo *objectinfo(const void *x) {
+	for(t_objectinfo *o = objects; o; o = o->next) {
+		if(o->x == x) {
+			return o;
+		}
+	}
+	return NULL;
+}
+
+static t_shimmethod *findmethod(t_class *c, t_symbol *sel) {
+	for(int i = 0; i < c->nmethods; ++i) {
+		if(c->methods[i].sel == sel) {
+			return &c->methods[i];
+		}
+	}
+	return NULL;
+}
+
+static void vprint(const char *prefix, const char *fmt, va_list ap) {
+	if(!verbosity) {
+		return;
+	}
+	fputs(prefix, stderr);
+	vfprintf(stderr, fmt, ap);
+	fputc('\n', stderr);
+}
+
+// call fn with the args in argv converted to the given types: the shim only
+// supports the signatures used by the bundled externals, up to 3 floats or
+// a single symbol
+static void *callwithargs(t_pd *x, t_symbol *sel, void *fn, const t_atomtype *types,
+	int argc, t_atom *argv, int *ok) {
+	t_float f[3] = {0, 0, 0};
+	t_symbol *sym = NULL;
+	int nfloats = 0, nsymbols = 0;
+	*ok = 1;
+	if(types[0] == A_GIMME) {
+		if(x) {
+			((void (*)(t_pd *, t_symbol *, int, t_atom *))fn)(x, sel, argc, argv);
+			return NULL;
+		}
+		return ((void *(*)(t_symbol *, int, t_atom *))fn)(sel, argc, argv);
+	}
+	for(int i = 0; types[i] != A_NULL; ++i) {
+		const t_atom *a = (i < argc ? &argv[i] : NULL);
+		switch(types[i]) {
+			case A_FLOAT: case A_DEFFLOAT:
+				if(nfloats == 3 || nsymbols) {*ok = 0; return NULL;}
+				f[nfloats++] = (a && a->a_type == A_FLOAT ? a->a_w.w_float : 0);
+				break;
+			case A_SYMBOL: case A_DEFSYM:
+				if(nfloats || nsymbols) {*ok = 0; return NULL;}
+				sym = (a && a->a_type == A_SYMBOL ? a->a_w.w_symbol : &s_symbol);
+				nsymbols++;
+				break;
+			default:
+				*ok = 0;
+				return NULL;
+		}
+	}
+	if(x) {
+		if(nsymbols) {((void (*)(t_pd *, t_symbol *))fn)(x, sym);}
+		else if(nfloats == 0) {((void (*)(t_pd *))fn)(x);}
+		else if(nfloats == 1) {((void (*)(t_pd *, t_float))fn)(x, f[0]);}
+		else if(nfloats == 2) {((void (*)(t_pd *, t_float, t_float))fn)(x, f[0], f[1]);}
+		else {((void (*)(t_pd *, t_float, t_float, t_float))fn)(x, f[0], f[1], f[2]);}
+		return NULL;
+	}
+	if(nsymbols) {return ((void *(*)(t_symbol *))fn)(sym);}
+	else if(nfloats == 0) {return ((void *(*)(void))fn)();}
+	else if(nfloats == 1) {return ((void *(*)(t_float))fn)(f[0]);}
+	else if(nfloats == 2) {return ((void *(*)(t_float, t_float))fn)(f[0], f[1]);}
+	return ((void *(*)(t_float, t_float, t_float))fn)(f[0], f[1], f[2]);
+}
+
+static void sendoutlet(t_outlet *x, t_symbol *s, int argc, t_atom *argv) {
+	if(outlethook) {
+		outlethook((t_pd *)x->owner, x->index, s, argc, argv, outlethookdata);
+	}
+}
+
+// m_pd.h
+
+t_symbol *gensym(const char *s) {
+	t_symbol *builtin[] = {&s_bang, &s_float, &s_symbol, &s_list, &s_anything, &s_signal};
+	for(size_t i = 0; i < sizeof(builtin) / sizeof(builtin[0]); ++i) {
+		if(!strcmp(builtin[i]->s_name, s)) {
+			return builtin[i];
+		}
+	}
+	for(t_symbol *sym = symbols; sym; sym = sym->s_next) {
+		if(!strcmp(sym->s_name, s)) {
+			return sym;
+		}
+	}
+	t_symbol *sym = calloc(1, sizeof(t_symbol));
+	sym->s_name = strdup(s);
+	sym->s_next = symbols;
+	symbols = sym;
+	return sym;
+}
+
+t_class *class_new(t_symbol *name, t_newmethod newmethod, t_method freemethod,
+	size_t size, int flags, t_atomtype arg1, ...) {
+	va_list ap;
+	t_class *c = calloc(1, sizeof(t_class));
+	(void)flags;
+	c->name = name;
+	c->newmethod = newmethod;
+	c->freemethod = freemethod;
+	c->size = size;
+	va_start(ap, arg1);
+	argtypes(c->args, arg1, ap);
+	va_end(ap);
+	c->next = classes;
+	classes = c;
+	return c;
+}
+
+void class_addmethod(t_class *c, t_method fn, t_symbol *sel, t_atomtype arg1, ...) {
+	va_list ap;
+	if(sel == &s_signal) {
+		c->mainsignalin = 1;
+		return;
+	}
+	if(c->nmethods == SHIM_MAXMETHODS) {
+		fprintf(stderr, "shim: too many methods for %s\n", c->name->s_name);
+		return;
+	}
+	t_shimmethod *m = &c->methods[c->nmethods++];
+	m->sel = sel;
+	m->fn = fn;
+	va_start(ap, arg1);
+	argtypes(m->args, arg1, ap);
+	va_end(ap);
+}
+
+#undef class_addbang
+#undef class_addfloat
+#undef class_addlist
+
+void class_addbang(t_class *c, t_method fn) {c->bangmethod = fn;}
+void class_addfloat(t_class *c, t_method fn) {c->floatmethod = fn;}
+void class_addlist(t_class *c, t_method fn) {c->listmethod = fn;}
+
+void class_domainsignalin(t_class *c, int onset) {
+	(void)onset;
+	c->mainsignalin = 1;
+}
+
+void nullfn(void) {}
+
+t_pd *pd_new(t_class *c) {
+	t_pd *x = calloc(1, c->size);
+	t_objectinfo *info = calloc(1, sizeof(t_objectinfo));
+	*x = c;
+	info->x = x;
+	info->next = objects;
+	objects = info;
+	return x;
+}
+
+void pd_free(t_pd *x) {
+	t_class *c = *x;
+	if(c->freemethod) {
+		((void (*)(t_pd *))c->freemethod)(x);
+	}
+	for(t_objectinfo **o = &objects; *o; o = &(*o)->next) {
+		if((*o)->x == x) {
+			t_objectinfo *info = *o;
+			*o = info->next;
+			for(int i = 0; i < info->ninlets; ++i) {
+				free(info->inlets[i]);
+			}
+			free(info->signals);
+			free(info);
+			break;
+		}
+	}
+	free(x);
+}
+
+t_inlet *inlet_new(t_object *owner, t_pd *dest, t_symbol *s1, t_symbol *s2) {
+	t_objectinfo *info = objectinfo(owner);
+	t_inlet *inlet = calloc(1, sizeof(t_inlet));
+	(void)dest; (void)s2;
+	inlet->signal = (s1 == &s_signal);
+	if(info && info->ninlets < SHIM_MAXOUTLETS) {
+		info->inlets[info->ninlets++] = inlet;
+		info->nsignalinlets += inlet->signal;
+	}
+	return inlet;
+}
+
+t_outlet *outlet_new(t_object *owner, t_symbol *s) {
+	t_objectinfo *info = objectinfo(owner);
+	if(!info || info->noutlets == SHIM_MAXOUTLETS) {
+		fprintf(stderr, "shim: can't add outlet\n");
+		abort();
+	}
+	t_outlet *outlet = &info->outlets[info->noutlets];
+	outlet->owner = owner;
+	outlet->index = info->noutlets++;
+	outlet->signal = (s == &s_signal);
+	info->nsignaloutlets += outlet->signal;
+	return outlet;
+}
+
+void outlet_bang(t_outlet *x) {
+	sendoutlet(x, &s_bang, 0, NULL);
+}
+
+void outlet_float(t_outlet *x, t_float f) {
+	t_atom a;
+	SETFLOAT(&a, f);
+	sendoutlet(x, &s_float, 1, &a);
+}
+
+void outlet_symbol(t_outlet *x, t_symbol *s) {
+	t_atom a;
+	SETSYMBOL(&a, s);
+	sendoutlet(x, &s_symbol, 1, &a);
+}
+
+void outlet_list(t_outlet *x, t_symbol *s, int argc, t_atom *argv) {
+	(void)s;
+	sendoutlet(x, &s_list, argc, argv);
+}
+
+void outlet_anything(t_outlet *x, t_symbol *s, int argc, t_atom *argv) {
+	sendoutlet(x, s, argc, argv);
+}
+
+t_float atom_getfloat(const t_atom *a) {
+	return (a->a_type == A_FLOAT ? a->a_w.w_float : 0);
+}
+
+t_int atom_getint(const t_atom *a) {
+	return (t_int)atom_getfloat(a);
+}
+
+t_symbol *atom_getsymbol(const t_atom *a) {
+	return (a->a_type == A_SYMBOL ? a->a_w.w_symbol : &s_symbol);
+}
+
+t_float atom_getfloatarg(int which, int argc, const t_atom *argv) {
+	return (which < argc ? atom_getfloat(&argv[which]) : 0);
+}
+
+void *getbytes(size_t nbytes) {
+	return shim_calloc(1, (nbytes ? nbytes : 1));
+}
+
+void *resizebytes(void *x, size_t oldsize, size_t newsize) {
+	void *y = shim_realloc(x, (newsize ? newsize : 1));
+	if(y && newsize > oldsize) {
+		memset((char *)y + oldsize, 0, newsize - oldsize);
+	}
+	return y;
+}
+
+void freebytes(void *x, size_t nbytes) {
+	(void)nbytes;
+	shim_free_ptr(x);
+}
+
+void post(const char *fmt, ...) {
+	va_list ap;
+	va_start(ap, fmt);
+	vprint("", fmt, ap);
+	va_end(ap);
+}
+
+void verbose(int level, const char *fmt, ...) {
+	va_list ap;
+	(void)level;
+	va_start(ap, fmt);
+	vprint("verbose: ", fmt, ap);
+	va_end(ap);
+}
+
+void logpost(const void *object, int level, const char *fmt, ...) {
+	va_list ap;
+	(void)object; (void)level;
+	va_start(ap, fmt);
+	vprint("", fmt, ap);
+	va_end(ap);
+}
+
+void error(const char *fmt, ...) {
+	va_list ap;
+	errors++;
+	va_start(ap, fmt);
+	vprint("error: ", fmt, ap);
+	va_end(ap);
+}
+
+void pd_error(const void *object, const char *fmt, ...) {
+	va_list ap;
+	(void)object;
+	errors++;
+	va_start(ap, fmt);
+	vprint("error: ", fmt, ap);
+	va_end(ap);
+}
+
+void dsp_add(t_perfroutine f, int n, ...) {
+	va_list ap;
+	if(chainsize + n + 1 > chaincapacity) {
+		chaincapacity = (chainsize + n + 1) * 2;
+		chain = realloc(chain, chaincapacity * sizeof(t_int));
+	}
+	chain[chainsize++] = (t_int)f;
+	va_start(ap, n);
+	for(int i = 0; i < n; ++i) {
+		chain[chainsize++] = va_arg(ap, t_int);
+	}
+	va_end(ap);
+}
+
+t_float sys_getsr(void) {
+	return samplerate;
+}
+
+int sys_getblksize(void) {
+	return blocksize;
+}
+
+t_clock *clock_new(void *owner, t_method fn) {
+	t_clock *x = calloc(1, sizeof(t_clock));
+	x->owner = owner;
+	x->fn = fn;
+	x->settime = -1;
+	x->next = clocks;
+	clocks = x;
+	return x;
+}
+
+void clock_delay(t_clock *x, double delaytime) {
+	x->settime = logicaltime + (delaytime > 0 ? delaytime : 0);
+}
+
+void clock_unset(t_clock *x) {
+	x->settime = -1;
+}
+
+void clock_free(t_clock *x) {
+	for(t_clock **c = &clocks; *c; c = &(*c)->next) {
+		if(*c == x) {
+			*c = x->next;
+			break;
+		}
+	}
+	free(x);
+}
+
+double clock_getlogicaltime(void) {
+	return logicaltime;
+}
+
+double clock_gettimesince(double prevsystime) {
+	return logicaltime - prevsystime;
+}
+
+t_symbol *canvas_getcurrentdir(void) {
+	return gensym(".");
+}
+
+int sys_open(const char *path, int oflag, ...) {
+	int mode = 0;
+	if(oflag & O_CREAT) {
+		va_list ap;
+		va_start(ap, oflag);
+		mode = va_arg(ap, int);
+		va_end(ap);
+	}
+	return open(path, oflag, mode);
+}
+
+FILE *sys_fopen(const char *filename, const char *mode) {
+	return fopen(filename, mode);
+}
+
+int sys_fclose(FILE *stream) {
+	return fclose(stream);
+}
+
+// alloc.h
+
+void *shim_malloc(size_t size) {
+	allocstats.allocs++;
+	allocstats.bytes += size;
+	return malloc(size);
+}
+
+void *shim_calloc(size_t count, size_t size) {
+	allocstats.allocs++;
+	allocstats.bytes += count * size;
+	return calloc(count, size);
+}
+
+void *shim_realloc(void *ptr, size_t size) {
+	allocstats.allocs++;
+	allocstats.bytes += size;
+	return realloc(ptr, size);
+}
+
+void shim_free_ptr(void *ptr) {
+	if(ptr) {
+		allocstats.frees++;
+	}
+	free(ptr);
+}
+
+// shim.h
+
+void shim_setsamplerate(t_float sr) {
+	samplerate = sr;
+}
+
+void shim_setblocksize(int n) {
+	blocksize = n;
+}
+
+void shim_setverbose(int verbose) {
+	verbosity = verbose;
+}
+
+void shim_setoutlethook(ShimOutletHook hook, void *userData) {
+	outlethook = hook;
+	outlethookdata = userData;
+}
+
+ShimAllocStats shim_allocstats(void) {
+	return allocstats;
+}
+
+int shim_errorcount(void) {
+	return errors;
+}
+
+t_pd *shim_new(const char *name, int argc, t_atom *argv) {
+	t_symbol *sym = gensym(name);
+	for(t_class *c = classes; c; c = c->next) {
+		if(c->name == sym) {
+			int ok;
+			t_pd *x = callwithargs(NULL, sym, (void *)c->newmethod, c->args, argc, argv, &ok);
+			if(!ok) {
+				fprintf(stderr, "shim: unsupported creation args for %s\n", name);
+			}
+			return x;
+		}
+	}
+	fprintf(stderr, "shim: %s not found\n", name);
+	return NULL;
+}
+
+void shim_free(t_pd *x) {
+	pd_free(x);
+}
+
+int shim_bang(t_pd *x) {
+	t_class *c = *x;
+	if(c->bangmethod) {
+		((t_bangmethod)c->bangmethod)(x);
+		return 1;
+	}
+	return shim_message(x, "bang", 0, NULL);
+}
+
+int shim_float(t_pd *x, t_float f) {
+	t_class *c = *x;
+	if(c->floatmethod) {
+		((t_floatmethod)c->floatmethod)(x, f);
+		return 1;
+	}
+	t_atom a;
+	SETFLOAT(&a, f);
+	return shim_message(x, "float", 1, &a);
+}
+
+int shim_list(t_pd *x, int argc, t_atom *argv) {
+	t_class *c = *x;
+	if(c->listmethod) {
+		((t_listmethod)c->listmethod)(x, &s_list, argc, argv);
+		return 1;
+	}
+	if(argc == 1 && argv[0].a_type == A_FLOAT) {
+		return shim_float(x, argv[0].a_w.w_float);
+	}
+	return shim_message(x, "list", argc, argv);
+}
+
+int shim_message(t_pd *x, const char *sel, int argc, t_atom *argv) {
+	t_symbol *sym = gensym(sel);
+	t_shimmethod *m = findmethod(*x, sym);
+	int ok = 0;
+	if(m) {
+		callwithargs(x, sym, (void *)m->fn, m->args, argc, argv, &ok);
+		if(!ok) {
+			fprintf(stderr, "shim: unsupported args for %s %s\n", (*x)->name->s_name, sel);
+		}
+	}
+	return ok;
+}
+
+int shim_signalinlets(t_pd *x) {
+	t_objectinfo *info = objectinfo(x);
+	return (info ? (*x)->mainsignalin + info->nsignalinlets : 0);
+}
+
+int shim_signaloutlets(t_pd *x) {
+	t_objectinfo *info = objectinfo(x);
+	return (info ? info->nsignaloutlets : 0);
+}
+
+void shim_dspclear(void) {
+	chainsize = 0;
+}
+
+int shim_dspadd(t_pd *x, int n, t_sample **ins, t_sample **outs) {
+	t_objectinfo *info = objectinfo(x);
+	t_shimmethod *m = findmethod(*x, gensym("dsp"));
+	if(!info || !m) {
+		return 0;
+	}
+	int nins = shim_signalinlets(x), nouts = shim_signaloutlets(x);
+	t_signal *sp[SHIM_MAXOUTLETS * 2];
+	free(info->signals);
+	info->signals = calloc(nins + nouts + 1, sizeof(t_signal));
+	for(int i = 0; i < nins + nouts; ++i) {
+		t_signal *s = &info->signals[i];
+		s->s_n = n;
+		s->s_sr = samplerate;
+		s->s_vec = (i < nins ? ins[i] : outs[i - nins]);
+		sp[i] = s;
+	}
+	((void (*)(t_pd *, t_signal **))m->fn)(x, sp);
+	return 1;
+}
+
+void shim_dsptick(int n) {
+	t_int *w = chain, *end = chain + chainsize;
+	while(w && w < end) {
+		w = (*(t_perfroutine)(*w))(w);
+	}
+	shim_advance(1000.0 * n / samplerate);
+}
+
+void shim_advance(double ms) {
+	double until = logicaltime + ms;
+	for(;;) {
+		t_clock *next = NULL;
+		for(t_clock *c = clocks; c; c = c->next) {
+			if(c->settime >= 0 && c->settime <= until && (!next || c->settime < next->settime)) {
+				next = c;
+			}
+		}
+		if(!next) {
+			break;
+		}
+		logicaltime = next->settime;
+		next->settime = -1;
+		((void (*)(void *))next->fn)(next->owner);
+	}
+	logicaltime = until;
+}
+
+void shim_settime(double ms) {
+	logicaltime = ms;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+/* host side of the m_pd.h shim: creates objects by class name, sends them
+   messages, & runs their dsp perform routines directly without pd */
+#ifndef SHIM_H
+#define SHIM_H
+
+#include "m_pd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// called for every message sent to an outlet, outlet is the index counted
+/// from the left, floats & bangs are sent with s_float & s_bang selectors
+typedef void (*ShimOutletHook)(t_pd *x, int outlet, t_symbol *s,
+	int argc, t_atom *argv, void *userData);
+
+/// allocation counts through malloc, calloc, realloc, & getbytes, see alloc.h
+typedef struct ShimAllocStats {
+	size_t allocs; ///< number of allocations, including reallocations
+	size_t frees;  ///< number of frees
+	size_t bytes;  ///< bytes requested
+} ShimAllocStats;
+
+/// set sample rate returned by sys_getsr(), default 44100
+void shim_setsamplerate(t_float sr);
+
+/// set block size returned by sys_getblksize(), default 64
+void shim_setblocksize(int n);
+
+/// print post & error output to stderr? (default 0)
+void shim_setverbose(int verbose);
+
+/// set outlet hook & user data, NULL to ignore outlet output
+void shim_setoutlethook(ShimOutletHook hook, void *userData);
+
+/// current allocation counts
+ShimAllocStats shim_allocstats(void);
+
+/// number of errors posted with error() or pd_error()
+int shim_errorcount(void);
+
+/// create an object by class name with creation args, the class setup
+/// function must have been called, returns NULL if not found or on failure
+t_pd *shim_new(const char *name, int argc, t_atom *argv);
+
+/// free an object created with shim_new
+void shim_free(t_pd *x);
+
+/// send a bang, float, list, or selector message to an object's left inlet,
+/// returns 0 if the object has no method for it
+int shim_bang(t_pd *x);
+int shim_float(t_pd *x, t_float f);
+int shim_list(t_pd *x, int argc, t_atom *argv);
+int shim_message(t_pd *x, const char *sel, int argc, t_atom *argv);
+
+/// number of signal inlets & outlets of an object
+int shim_signalinlets(t_pd *x);
+int shim_signaloutlets(t_pd *x);
+
+/// clear the dsp chain
+void shim_dspclear(void);
+
+/// add an object to the dsp chain by calling its dsp method with n sample
+/// signal vectors, ins & outs hold one vector per signal inlet & outlet,
+/// returns 0 if the object has no dsp method
+int shim_dspadd(t_pd *x, int n, t_sample **ins, t_sample **outs);
+
+/// run the dsp chain once, then advance logical time by n samples at the
+/// current sample rate & fire due clocks
+void shim_dsptick(int n);
+
+/// advance logical time by ms & fire due clocks
+void shim_advance(double ms);
+
+/// set logical time in ms, ie. to start a run from 0
+void shim_settime(double ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -15,6 +15,7 @@
 #import "Osc.h"
 #import "SceneManager.h"
 #import "WebServer.h"
+#import "SceneLibrary.h"
 
 /// shake event notification name
 extern NSString *const PdPartyMotionShakeEndedNotification;
@@ -37,6 +38,7 @@ extern NSString *const PdPartyMotionShakeEndedNotification;
 @property (strong, nonatomic) Osc *osc;
 @property (strong, nonatomic) SceneManager *sceneManager;
 @property (strong, nonatomic) WebServer *server;
+@property (strong, nonatomic) SceneLibrary *sceneLibrary;
 
 /// returns whether the patch view is currently visible
 @property (readonly, nonatomic) BOOL isPatchViewVisible;
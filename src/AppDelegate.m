@@ -12,9 +12,11 @@
 
 #import "MBProgressHUD.h"
 #import "Unzip.h"
+#import "ZipMount.h"
 
 #import "Log.h"
 #import "Util.h"
+#import "PdParser.h"
 #import "Widget.h"
 
 #import "StartViewController.h"
@@ -68,7 +70,9 @@ NSString *const PdPartyMotionShakeEndedNotification = @"PdPartyMotionShakeEndedN
 	self.pureData = [[PureData alloc] init];
 	[PdBase setMidiDelegate:self.midi pollingEnabled:NO];
 	self.pureData.osc = self.osc;
+	self.pureData.midi = self.midi;
 	[Widget setDispatcher:self.pureData.dispatcher];
+	[Widget setMailbox:self.pureData.mailbox];
 
 	// set up the scene manager
 	self.sceneManager = [[SceneManager alloc] init];
@@ -78,6 +82,10 @@ NSString *const PdPartyMotionShakeEndedNotification = @"PdPartyMotionShakeEndedN
 	// set up webserver
 	self.server = [[WebServer alloc] init];
 
+	// set up scene library index
+	NSString *indexPath = [Util.cachesPath stringByAppendingPathComponent:@"SceneLibrary.index"];
+	self.sceneLibrary = [[SceneLibrary alloc] initWithDirectory:Util.documentsPath indexPath:indexPath];
+
 	// set up app behavior
 	self.lockScreenDisabled = [defaults boolForKey:@"lockScreenDisabled"];
 	self.runsInBackground = [defaults boolForKey:@"runsInBackground"];
@@ -97,10 +105,19 @@ NSString *const PdPartyMotionShakeEndedNotification = @"PdPartyMotionShakeEndedN
 			[defaults setBool:NO forKey:@"firstRun"];
 			dispatch_async(dispatch_get_main_queue(), ^{
 				[hud hideAnimated:YES];
+				[self.sceneLibrary setNeedsUpdate];
 			});
 		});
 	}
 
+	// clear cached patch atom lines left by another build, the parsing or
+	// filtering rules may have changed & old entries are never looked up again
+	NSString *build = NSBundle.mainBundle.infoDictionary[@"CFBundleVersion"];
+	if(build && ![[defaults stringForKey:@"patchCacheBuild"] isEqualToString:build]) {
+		[PdParser clearCache];
+		[defaults setObject:build forKey:@"patchCacheBuild"];
+	}
+
 	// clear any Documents/Inbox leftovers
 	NSString *inboxPath = [Util.documentsPath stringByAppendingPathComponent:@"Inbox"];
 	if([NSFileManager.defaultManager fileExistsAtPath:inboxPath]) {
@@ -159,6 +176,9 @@ NSString *const PdPartyMotionShakeEndedNotification = @"PdPartyMotionShakeEndedN
 			[self.server start];
 		}
 	}
+
+	// files may have been changed via the Files app
+	[self.sceneLibrary setNeedsUpdate];
 }
 
 - (void)applicationDidBecomeActive:(UIApplication *)application {
@@ -172,6 +192,7 @@ NSString *const PdPartyMotionShakeEndedNotification = @"PdPartyMotionShakeEndedN
 
 - (void)applicationWillTerminate:(UIApplication *)application {
 	// Called when the application is about to terminate. Save data if appropriate. See also applicationDidEnterBackground:.
+	[Log flush];
 }
 
 // references:
@@ -231,8 +252,9 @@ NSString *const PdPartyMotionShakeEndedNotification = @"PdPartyMotionShakeEndedN
 	NSString *filename = path.lastPathComponent;
 	LogVerbose(@"AppDelegate: receiving %@", filename);
 
-	// pd patch
-	if([path.pathExtension isEqualToString:@"pd"]) {
+	// pd patch or scene archive, which can be run without unzipping
+	if([path.pathExtension isEqualToString:@"pd"] ||
+	   ([BrowserViewController isZipFile:path] && [ZipMount mountForArchive:path].sceneDirectory)) {
 		NSString *newPath = [Util.documentsPath stringByAppendingPathComponent:path.lastPathComponent];
 		newPath = [Util generateCopyPathForPath:newPath];
 		if(![NSFileManager.defaultManager copyItemAtPath:path toPath:newPath error:&error]) {
@@ -249,10 +271,12 @@ NSString *const PdPartyMotionShakeEndedNotification = @"PdPartyMotionShakeEndedN
 		[[UIAlertController alertControllerWithTitle:@"Copy Succeeded"
 		                                     message:message
 		                           cancelButtonTitle:@"Ok"] show];
+		[self.sceneLibrary setNeedsUpdate];
 		[self.browserViewController reloadDirectory];
 	}
 	else { // assume zip file
 		if([BrowserViewController unzipPath:path toDirectory:Util.documentsPath]) {
+			[self.sceneLibrary setNeedsUpdate];
 			NSString *message = [NSString stringWithFormat:@"%@ unzipped to Documents", filename];
 			[[UIAlertController alertControllerWithTitle:@"Unzip Succeeded"
 			                                     message:message
@@ -15,12 +15,14 @@
 #import "Log.h"
 #import "Unzip.h"
 #import "Util.h"
+#import "ZipMount.h"
 
 @interface BrowserViewController () {
 	/// temp variables required for segues on iPhone since PatchViewController
 	/// may not exist yet when opening first scene
 	NSString *selectedPatch; ///< maybe subpatch in the case of Rj Scenes, etc
 	NSString *selectedSceneType;
+	ZipMount *archiveMount; ///< keeps the archive of a running scene cached
 }
 
 /// run the given scene in the PatchViewController
@@ -29,6 +31,7 @@
 /// called when a patch is selected, return NO if the path was not handled
 - (BOOL)selectFile:(NSString *)path; ///< assumes full path
 - (BOOL)selectDirectory:(NSString *)path; ///< assumes full path
+- (BOOL)selectArchive:(NSString *)path; ///< assumes full path
 
 @end
 
@@ -168,7 +171,11 @@
 	else if([RecordingScene isRecording:path]) { // recordings
 		[self runScene:path withSceneType:@"RecordingScene"];
 	}
-	else if([BrowserViewController isZipFile:path]) { // unzip zipfiles
+	else if([BrowserViewController isZipFile:path]) {
+		if([self selectArchive:path]) { // run scene archives in place
+			return YES;
+		}
+		// unzip other zipfiles
 		if([BrowserViewController unzipPath:path toDirectory:self.directory]) {
 			NSString *message = [NSString stringWithFormat:@"%@ unzipped to %@",
 				path.lastPathComponent, self.directory.lastPathComponent];
@@ -197,4 +204,21 @@
 	return YES;
 }
 
+// only the members libpd opens by path are extracted into the archive cache,
+// the mount is kept before the scene loads so the rest is read from the archive
+- (BOOL)selectArchive:(NSString *)path {
+	ZipMount *mount = [ZipMount mountForArchive:path];
+	if(!mount.sceneDirectory) {
+		return NO;
+	}
+	archiveMount = mount;
+	NSString *directory = [mount extractScene];
+	if(!directory || ![self selectDirectory:directory]) {
+		LogError(@"Browser: couldn't run scene in %@", path.lastPathComponent);
+		archiveMount = nil;
+		return NO;
+	}
+	return YES;
+}
+
 @end
@@ -42,7 +42,7 @@ typedef NS_ENUM(NSUInteger, LogLevel) {
 #endif
 
 // log method
-#define LOG_MACRO(format, ...) [Log log:format, ##__VA_ARGS__]
+#define LOG_MACRO(flag, format, ...) [Log logFlag:flag format:format, ##__VA_ARGS__]
 
 // current log level variable
 #ifndef LOG_LEVEL_DEF
@@ -52,7 +52,7 @@ typedef NS_ENUM(NSUInteger, LogLevel) {
 // log message filtering
 // if level is a constant, the compiler can optimize out the entire macro call
 #define LOG_MAYBE(level, flag, format, ...) \
-        do { if((level & flag) != 0) LOG_MACRO(format, ##__VA_ARGS__); } while(0)
+        do { if((level & flag) != 0) LOG_MACRO(flag, format, ##__VA_ARGS__); } while(0)
 
 // NSLog replacements
 #define LogError(format, ...)   LOG_MAYBE(LOG_LEVEL_DEF, LogFlagError,   format, ##__VA_ARGS__)
@@ -75,6 +75,11 @@ typedef NS_ENUM(NSUInteger, LogLevel) {
 /// LogInfo("1 + 1 = %d", 1+1);
 /// LogVerbose("let me tell you the story of my life: %@", bioString);
 ///
+/// messages are formatted by the caller & pushed as fixed size records into a
+/// lock-free queue, a background queue then hands them to the loggers, so
+/// logging never waits on the loggers, if the queue is full the message is
+/// dropped & the number of dropped messages is logged later
+///
 @interface Log : NSObject
 
 /// set up console logger
@@ -85,6 +90,15 @@ typedef NS_ENUM(NSUInteger, LogLevel) {
 /// log a message
 + (void)log:(NSString *)format, ... NS_FORMAT_FUNCTION(1,2);
 
+/// log a message with a level flag
++ (void)logFlag:(LogFlag)flag format:(NSString *)format, ... NS_FORMAT_FUNCTION(2,3);
+
+/// log a pd print message at the info level, loggers receive it via logPrint:
++ (void)print:(NSString *)message;
+
+/// wait until all queued messages have been handed to the loggers
++ (void)flush;
+
 /// add a logger
 + (void)addLogger:(Logger *)logger;
 
@@ -106,12 +120,15 @@ typedef NS_ENUM(NSUInteger, LogLevel) {
 
 #pragma mark - Logger
 
-/// base logging class
+/// base logging class, loggers are called on the background log queue
 @interface Logger : NSObject
 
 /// handle a new message to log, default implementation does nothing
 - (void)logMessage:(NSString *)message;
 
+/// handle a pd print message, default implementation calls logMessage:
+- (void)logPrint:(NSString *)message;
+
 @end
 
 #pragma mark - ConsoleLogger
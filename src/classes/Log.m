@@ -11,12 +11,59 @@
 #import "Log.h"
 
 #import "TextViewLogger.h"
+#import "LogQueue.h"
 
 @implementation Log
 
-static NSMutableArray *s_loggers = nil;
+// record flag for pd prints, above the level flags
+#define LOG_PRINT (1u << 31)
+
+static LogQueue s_queue;
+static dispatch_queue_t s_logQueue = nil; ///< background consumer
+static dispatch_source_t s_logSource = nil; ///< wakes the consumer on push
+static NSArray *s_loggers = nil; ///< log queue only
 static TextViewLogger *s_textViewLogger = nil;
 
+// hand queued records to the loggers, log queue only
+static void LogDrain(void) {
+	LogRecord record;
+	while(LogQueuePop(&s_queue, &record)) {
+		@autoreleasepool {
+			NSString *message = [[NSString alloc] initWithBytes:record.text
+			                                             length:record.length
+			                                           encoding:NSUTF8StringEncoding];
+			if(!message) {continue;}
+			for(Logger *logger in s_loggers) {
+				if(record.flags & LOG_PRINT) {
+					[logger logPrint:message];
+				}
+				else {
+					[logger logMessage:message];
+				}
+			}
+		}
+	}
+	unsigned long dropped = LogQueueTakeDropped(&s_queue);
+	if(dropped > 0) {
+		NSString *message = [NSString stringWithFormat:@"Log: dropped %lu messages", dropped];
+		for(Logger *logger in s_loggers) {
+			[logger logMessage:message];
+		}
+	}
+}
+
++ (void)initialize {
+	if(self != Log.class) {return;}
+	LogQueueInit(&s_queue);
+	s_loggers = @[];
+	s_logQueue = dispatch_queue_create("Log", DISPATCH_QUEUE_SERIAL);
+	s_logSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_DATA_ADD, 0, 0, s_logQueue);
+	dispatch_source_set_event_handler(s_logSource, ^{
+		LogDrain();
+	});
+	dispatch_resume(s_logSource);
+}
+
 + (void)setup {
 	[Log addLogger:[ConsoleLogger new]];
 	if([NSUserDefaults.standardUserDefaults boolForKey:@"logTextView"]) {
@@ -36,25 +83,58 @@ static TextViewLogger *s_textViewLogger = nil;
 }
 
 + (void)log:(NSString *)format, ... NS_FORMAT_FUNCTION(1,2) {
+	if(!format || (LOG_LEVEL_DEF & LogFlagInfo) == 0) {return;} // same as LogInfo
+	va_list args;
+	va_start(args, format);
+	NSString *message = [[NSString alloc] initWithFormat:format arguments:args];
+	va_end(args);
+	[Log push:message withFlags:LogFlagInfo];
+}
+
++ (void)logFlag:(LogFlag)flag format:(NSString *)format, ... NS_FORMAT_FUNCTION(2,3) {
 	if(!format) {return;}
 	va_list args;
 	va_start(args, format);
 	NSString *message = [[NSString alloc] initWithFormat:format arguments:args];
 	va_end(args);
-	for(Logger *logger in s_loggers) {
-		[logger logMessage:message];
-	}
+	[Log push:message withFlags:(unsigned int)flag];
+}
+
++ (void)print:(NSString *)message {
+	if(!message || (LOG_LEVEL_DEF & LogFlagInfo) == 0) {return;} // same as LogInfo
+	[Log push:message withFlags:(LogFlagInfo | LOG_PRINT)];
+}
+
++ (void)flush {
+	dispatch_sync(s_logQueue, ^{
+		LogDrain();
+	});
 }
 
 + (void)addLogger:(Logger *)logger {
-	if(!s_loggers) {s_loggers = [NSMutableArray new];}
-	if(![s_loggers containsObject:logger]) {
-		[s_loggers addObject:logger];
-	}
+	dispatch_async(s_logQueue, ^{
+		if(![s_loggers containsObject:logger]) {
+			s_loggers = [s_loggers arrayByAddingObject:logger];
+		}
+	});
 }
 
 + (void)removeLogger:(Logger *)logger {
-	[s_loggers removeObject:logger];
+	dispatch_async(s_logQueue, ^{
+		NSMutableArray *loggers = [s_loggers mutableCopy];
+		[loggers removeObject:logger];
+		s_loggers = loggers;
+	});
+}
+
+#pragma mark Private
+
+// push message into the queue & wake the consumer, never blocks
++ (void)push:(NSString *)message withFlags:(unsigned int)flags {
+	const char *text = message.UTF8String;
+	if(!text) {return;}
+	LogQueuePush(&s_queue, flags, CFAbsoluteTimeGetCurrent(), text, strlen(text));
+	dispatch_source_merge_data(s_logSource, 1);
 }
 
 #pragma mark TextViewLogger
@@ -85,6 +165,7 @@ static TextViewLogger *s_textViewLogger = nil;
 
 @implementation Logger
 - (void)logMessage:(NSString *)message {}
+- (void)logPrint:(NSString *)message {[self logMessage:message];}
 @end
 
 #pragma mark - ConsoleLogger
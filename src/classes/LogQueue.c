@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include "LogQueue.h"
+
+#include <string.h>
+
+#define MASK (LOG_QUEUE_SIZE - 1)
+
+void LogQueueInit(LogQueue *queue) {
+	for(unsigned int i = 0; i < LOG_QUEUE_SIZE; ++i) {
+		queue->slots[i].sequence = i;
+	}
+	queue->head = 0;
+	queue->tail = 0;
+	queue->dropped = 0;
+}
+
+int LogQueuePush(LogQueue *queue, unsigned int flags, double timestamp,
+                 const char *text, size_t length) {
+	unsigned int pos = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+	while(1) {
+		unsigned int sequence = __atomic_load_n(&queue->slots[pos & MASK].sequence, __ATOMIC_ACQUIRE);
+		int diff = (int)(sequence - pos);
+		if(diff == 0) {
+			// slot is free, claim it
+			if(__atomic_compare_exchange_n(&queue->head, &pos, pos + 1, 1,
+			                               __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				break;
+			}
+			// pos now holds the current head, try again
+		}
+		else if(diff < 0) {
+			// slot not read yet, queue is full
+			__atomic_add_fetch(&queue->dropped, 1, __ATOMIC_RELAXED);
+			return 0;
+		}
+		else {
+			// another producer claimed the slot
+			pos = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+		}
+	}
+
+	LogRecord *record = &queue->slots[pos & MASK].record;
+	if(length > LOG_QUEUE_TEXT_SIZE - 1) {
+		length = LOG_QUEUE_TEXT_SIZE - 1;
+		while(length > 0 && ((unsigned char)text[length] & 0xC0) == 0x80) {
+			length--; // don't split a multibyte character
+		}
+	}
+	record->flags = flags;
+	record->timestamp = timestamp;
+	record->length = length;
+	memcpy(record->text, text, length);
+	record->text[length] = '\0';
+
+	// publish
+	__atomic_store_n(&queue->slots[pos & MASK].sequence, pos + 1, __ATOMIC_RELEASE);
+	return 1;
+}
+
+int LogQueuePop(LogQueue *queue, LogRecord *record) {
+	unsigned int pos = queue->tail;
+	unsigned int sequence = __atomic_load_n(&queue->slots[pos & MASK].sequence, __ATOMIC_ACQUIRE);
+	if(sequence != pos + 1) {
+		return 0; // empty or still being written
+	}
+	const LogRecord *slot = &queue->slots[pos & MASK].record;
+	record->flags = slot->flags;
+	record->timestamp = slot->timestamp;
+	record->length = slot->length;
+	memcpy(record->text, slot->text, slot->length + 1);
+
+	// free the slot for the producer one lap ahead
+	__atomic_store_n(&queue->slots[pos & MASK].sequence, pos + LOG_QUEUE_SIZE, __ATOMIC_RELEASE);
+	queue->tail = pos + 1;
+	return 1;
+}
+
+unsigned long LogQueueTakeDropped(LogQueue *queue) {
+	return __atomic_exchange_n(&queue->dropped, 0, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#ifndef LOGQUEUE_H
+#define LOGQUEUE_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// max queued records, must be a power of 2
+#define LOG_QUEUE_SIZE 256
+
+/// max record text length in bytes, including the null terminator
+#define LOG_QUEUE_TEXT_SIZE 1024
+
+/// log record, fixed size so pushing never allocates
+typedef struct LogRecord {
+	unsigned int flags;  ///< level & kind flags
+	double timestamp;    ///< time the record was pushed, in s
+	size_t length;       ///< text length, without the null terminator
+	char text[LOG_QUEUE_TEXT_SIZE]; ///< UTF-8 text, null terminated
+} LogRecord;
+
+/// bounded multiple producer, single consumer record queue
+///
+/// any thread can push, each slot has a sequence number which tells whether
+/// it is free to write or ready to read, so producers only contend on the
+/// write position & never wait on the consumer: when the queue is full the
+/// record is dropped & counted instead
+typedef struct LogQueue {
+	struct {
+		unsigned int sequence;
+		LogRecord record;
+	} slots[LOG_QUEUE_SIZE];
+	unsigned int head;     ///< next write, producers
+	unsigned int tail;     ///< next read, consumer only
+	unsigned long dropped; ///< records not queued as the queue was full
+} LogQueue;
+
+/// init queue
+void LogQueueInit(LogQueue *queue);
+
+/// copy text into a new record, text longer than LOG_QUEUE_TEXT_SIZE - 1 is
+/// truncated on a UTF-8 character boundary, returns 0 if the queue is full
+/// any thread
+int LogQueuePush(LogQueue *queue, unsigned int flags, double timestamp,
+                 const char *text, size_t length);
+
+/// copy the oldest record, returns 0 if the queue is empty
+/// consumer thread only
+int LogQueuePop(LogQueue *queue, LogRecord *record);
+
+/// returns & clears the dropped record count, any thread
+unsigned long LogQueueTakeDropped(LogQueue *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
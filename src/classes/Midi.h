@@ -15,6 +15,7 @@
  */
 #import <Foundation/Foundation.h>
 #import <CoreMIDI/CoreMIDI.h>
+#import "MidiParser.h"
 
 // MIDI status bytes
 enum MidiStatus {
@@ -84,8 +85,11 @@ enum MidiStatus {
 
 /// midi connection event delegate, called on MIDI thread so make sure
 /// to do any GUI updates on the main thread
+///
+/// the event is only valid for the duration of the call, sysex messages may
+/// arrive in multiple segments, see MidiEvent
 @protocol MidiInputDelegate <NSObject>
-- (void)midiInput:(MidiInput *)input receivedMessage:(NSData *)message;
+- (void)midiInput:(MidiInput *)input receivedEvent:(const MidiEvent *)event;
 @end
 
 /// a MIDI input
@@ -94,8 +98,8 @@ enum MidiStatus {
 /// input delegate
 @property (nonatomic, weak) id<MidiInputDelegate> delegate;
 
-/// receive and forward a complete MIDI message to delegate
-- (void)receiveMessage:(NSData *)message;
+/// receive and forward a parsed MIDI event to delegate
+- (void)receiveEvent:(const MidiEvent *)event;
 
 @end
 
@@ -107,6 +111,10 @@ enum MidiStatus {
 /// send a complete MIDI message
 - (BOOL)sendMessage:(NSData *)message;
 
+/// send one or more complete MIDI messages or a sysex segment as a single
+/// packet, running status is not allowed
+- (BOOL)sendBytes:(const Byte *)bytes length:(size_t)length;
+
 /// flush any remaining bytes
 - (void)flush;
 
@@ -79,10 +79,11 @@ static BOOL isNetworkSession(MIDIEndpointRef ref) {
 
 #pragma mark - MidiInput
 
+// MidiParser callback
+static void MIDIParsedEvent(const MidiEvent *event, void *userData);
+
 @implementation MidiInput {
-	bool firstPacket;       ///< is this the first received packet?
-	bool continueSysex;     ///< is this packet part of a sysex message?
-	NSMutableData *message; ///< raw MIDI byte buffer
+	MidiParser parser; ///< byte stream parser, no allocation while parsing
 }
 
 - (instancetype)initWithMidi:(Midi *)midi
@@ -90,16 +91,14 @@ static BOOL isNetworkSession(MIDIEndpointRef ref) {
                         port:(int)port {
 	self = [super initWithMidi:midi endpoint:endpoint port:port];
 	if(self) {
-		firstPacket = true;
-		continueSysex = false;
-		message = [NSMutableData data];
+		MidiParserInit(&parser, MIDIParsedEvent, (__bridge void *)self);
 	}
 	return self;
 }
 
-- (void)receiveMessage:(NSData *)message {
+- (void)receiveEvent:(const MidiEvent *)event {
 	if(self.delegate) {
-		[self.delegate midiInput:self receivedMessage:message];
+		[self.delegate midiInput:self receivedEvent:event];
 	}
 }
 
@@ -122,91 +121,17 @@ static void MIDIReadVirtualInput(const MIDIPacketList *pktlist, void *readProcRe
 	}
 }
 
-// adapted from ofxMidi iOS & RTMidi CoreMIDI message parsing
+// MidiParser callback
+static void MIDIParsedEvent(const MidiEvent *event, void *userData) {
+	MidiInput *input = (__bridge MidiInput *)userData;
+	[input receiveEvent:event];
+}
+
 // called on the MIDI thread, not the main run loop
 - (void)midiReceived:(const MIDIPacketList *)packetList {
 	const MIDIPacket *packet = &packetList->packet[0];
-	unsigned char statusByte;
-	unsigned short nBytes, curByte, msgSize;
-
 	for(int i = 0; i < packetList->numPackets; ++i) {
-		nBytes = packet->length;
-		if(nBytes == 0) {
-			continue;
-		}
-		if(firstPacket) {
-			firstPacket = false;
-		}
-
-		// handle segmented sysex messages
-		curByte = 0;
-		if(continueSysex) {
-
-			// copy the packet
-			for(int i = 0; i < nBytes; ++i) {
-				[message appendBytes:&packet->data[i] length:1];
-			}
-			continueSysex = packet->data[nBytes-1] != MIDI_SYSEX_END; // look for stop
-
-			if(!continueSysex) {
-				// send message if sysex message complete
-				if(message.length > 0) {
-					[self receiveMessage:message];
-				}
-				[message setLength:0];
-			}
-		}
-		else { // not sysex, parse bytes
-			while(curByte < nBytes) {
-				msgSize = 0;
-
-				// next byte in the packet should be a status byte
-				statusByte = packet->data[curByte];
-				if(!(statusByte & MIDI_NOTE_ON)) {
-					break;
-				}
-
-				// determine number of bytes in midi message
-				if(statusByte < MIDI_PROGRAM_CHANGE) {
-					msgSize = 3;
-				}
-				else if(statusByte < MIDI_PITCH_BEND) {
-					msgSize = 2;
-				}
-				else if(statusByte < MIDI_SYSEX) {
-					msgSize = 3;
-				}
-				else if(statusByte == MIDI_SYSEX) {
-					msgSize = nBytes - curByte;
-					continueSysex = packet->data[nBytes-1] != MIDI_SYSEX_END;
-				}
-				else if(statusByte == MIDI_TIME_CODE) {
-					msgSize = 2;
-				}
-				else if(statusByte == MIDI_SONG_POS_POINTER) {
-					msgSize = 3;
-				}
-				else if(statusByte == MIDI_SONG_SELECT) {
-					msgSize = 2;
-				}
-				else { // remaining 1 byte messages: MIDI_START, MIDI_STOP, etc
-					msgSize = 1;
-				}
-
-				// copy packet
-				if(msgSize) {
-					[message appendBytes:&packet->data[curByte] length:curByte+msgSize];
-					if(!continueSysex) {
-						// send message if sysex message complete
-						if(message.length > 0) {
-							[self receiveMessage:message];
-						}
-						[message setLength:0];
-					}
-					curByte += msgSize;
-				}
-			}
-		}
+		MidiParserParse(&parser, packet->data, packet->length, packet->timeStamp);
 		packet = MIDIPacketNext(packet);
 	}
 }
@@ -221,12 +146,16 @@ static void MIDIReadVirtualInput(const MIDIPacketList *pktlist, void *readProcRe
 	MIDIFlushOutput(self.endpoint);
 }
 
-// adapted from PGMidi sendBytes
 - (BOOL)sendMessage:(NSData *)message {
-	Byte packetBuffer[message.length+100];
+	return [self sendBytes:message.bytes length:message.length];
+}
+
+// adapted from PGMidi sendBytes
+- (BOOL)sendBytes:(const Byte *)bytes length:(size_t)length {
+	Byte packetBuffer[length+100];
 	MIDIPacketList *packetList = (MIDIPacketList *)packetBuffer;
 	MIDIPacket *packet = MIDIPacketListInit(packetList);
-	packet = MIDIPacketListAdd(packetList, sizeof(packetBuffer), packet, 0, message.length, message.bytes);
+	packet = MIDIPacketListAdd(packetList, sizeof(packetBuffer), packet, 0, length, bytes);
 	if(!packet) {
 		return NO;
 	}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ * References: http://www.srm.com/qtma/davidsmidispec.html
+ *
+ */
+#include "MidiParser.h"
+
+#include <string.h>
+
+// emit buffered sysex bytes as a segment
+static void flushSysex(MidiParser *parser, uint64_t timestamp, uint8_t complete) {
+	MidiEvent event;
+	if(parser->sysexLength == 0 && !complete) {
+		return;
+	}
+	memset(&event, 0, sizeof(MidiEvent));
+	event.timestamp = timestamp;
+	event.sysex = parser->sysex;
+	event.sysexLength = parser->sysexLength;
+	event.sysexComplete = complete;
+	parser->callback(&event, parser->userData);
+	parser->sysexLength = 0;
+}
+
+static void emit(MidiParser *parser, const uint8_t *bytes, uint8_t length, uint64_t timestamp) {
+	MidiEvent event;
+	memset(&event, 0, sizeof(MidiEvent));
+	event.timestamp = timestamp;
+	memcpy(event.bytes, bytes, length);
+	event.length = length;
+	parser->callback(&event, parser->userData);
+}
+
+void MidiParserInit(MidiParser *parser, MidiParserCallback callback, void *userData) {
+	parser->callback = callback;
+	parser->userData = userData;
+	MidiParserReset(parser);
+}
+
+void MidiParserReset(MidiParser *parser) {
+	parser->status = 0;
+	parser->expected = 0;
+	parser->count = 0;
+	parser->inSysex = 0;
+	parser->sysexLength = 0;
+}
+
+int MidiParserDataLength(uint8_t status) {
+	if(status < 0xF0) {
+		switch(status & 0xF0) {
+			case 0xC0: case 0xD0: // program change, aftertouch
+				return 1;
+			default:
+				return 2;
+		}
+	}
+	switch(status) {
+		case 0xF0: // sysex
+			return -1;
+		case 0xF1: case 0xF3: // time code, song select
+			return 1;
+		case 0xF2: // song position pointer
+			return 2;
+		default: // tune request, sysex end, realtime
+			return 0;
+	}
+}
+
+void MidiParserParse(MidiParser *parser, const uint8_t *bytes, size_t length, uint64_t timestamp) {
+	for(size_t i = 0; i < length; ++i) {
+		uint8_t byte = bytes[i];
+
+		// realtime bytes can appear anywhere, even within sysex,
+		// and do not affect running status
+		if(byte >= 0xF8) {
+			emit(parser, &byte, 1, timestamp);
+			continue;
+		}
+
+		if(parser->inSysex) {
+			if(byte & 0x80) {
+				// sysex end, any other status byte also terminates sysex
+				if(byte == 0xF7) {
+					parser->sysex[parser->sysexLength++] = byte;
+				}
+				parser->inSysex = 0;
+				flushSysex(parser, timestamp, 1);
+				if(byte == 0xF7) {
+					continue;
+				}
+			}
+			else {
+				parser->sysex[parser->sysexLength++] = byte;
+				if(parser->sysexLength >= MIDI_PARSER_SYSEX_SIZE - 1) {
+					// keep a byte free for the sysex end
+					flushSysex(parser, timestamp, 0);
+				}
+				continue;
+			}
+		}
+
+		if(byte & 0x80) { // status
+			int dataLength = MidiParserDataLength(byte);
+			if(dataLength < 0) { // sysex start
+				parser->status = 0;
+				parser->inSysex = 1;
+				parser->sysexLength = 0;
+				parser->sysex[parser->sysexLength++] = byte;
+			}
+			else if(dataLength == 0) { // tune request, stray sysex end
+				parser->status = 0;
+				if(byte != 0xF7) {
+					emit(parser, &byte, 1, timestamp);
+				}
+			}
+			else {
+				// system common messages cancel running status,
+				// but are parsed the same way for their data bytes
+				parser->status = byte;
+				parser->expected = (uint8_t)dataLength;
+				parser->count = 0;
+			}
+			continue;
+		}
+
+		// data byte, dropped if there is no status to apply it to
+		if(parser->status == 0) {
+			continue;
+		}
+		parser->data[parser->count++] = byte;
+		if(parser->count == parser->expected) {
+			uint8_t message[3] = {parser->status, parser->data[0], parser->data[1]};
+			emit(parser, message, parser->expected + 1, timestamp);
+			parser->count = 0;
+			if(parser->status >= 0xF0) {
+				parser->status = 0; // no running status for system common
+			}
+		}
+	}
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ * References: http://www.srm.com/qtma/davidsmidispec.html
+ *
+ */
+#ifndef MIDIPARSER_H
+#define MIDIPARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// max sysex bytes buffered before a segment is emitted
+#define MIDI_PARSER_SYSEX_SIZE 512
+
+/// a parsed MIDI event, valid for the duration of the callback only
+typedef struct MidiEvent {
+	uint64_t timestamp;    ///< host timestamp of the packet, 0 if unknown
+	uint8_t bytes[3];      ///< status & data bytes, unused for sysex
+	uint8_t length;        ///< number of bytes, 0 for sysex
+	const uint8_t *sysex;  ///< sysex segment bytes, NULL otherwise: the first
+	                       ///< segment starts with 0xF0 & the last ends with
+	                       ///< 0xF7 unless the sysex was cut off
+	size_t sysexLength;    ///< number of sysex bytes in this segment
+	uint8_t sysexComplete; ///< 1 if this is the last sysex segment
+} MidiEvent;
+
+/// event callback
+typedef void (*MidiParserCallback)(const MidiEvent *event, void *userData);
+
+/// MIDI byte stream parser, handles running status, realtime bytes
+/// interleaved anywhere in the stream, and sysex messages split across
+/// packets, which are delivered in bounded segments
+///
+/// no allocation is done while parsing, all state lives in this struct
+typedef struct MidiParser {
+	MidiParserCallback callback;
+	void *userData;
+	uint8_t status;      ///< current (running) status, 0 if none
+	uint8_t expected;    ///< data bytes expected for status
+	uint8_t count;       ///< data bytes received so far
+	uint8_t data[2];
+	uint8_t inSysex;
+	size_t sysexLength;
+	uint8_t sysex[MIDI_PARSER_SYSEX_SIZE];
+} MidiParser;
+
+/// init parser with event callback and user data pointer
+void MidiParserInit(MidiParser *parser, MidiParserCallback callback, void *userData);
+
+/// clear running status & any partial message or sysex
+void MidiParserReset(MidiParser *parser);
+
+/// parse bytes, events are delivered via the callback as they complete
+void MidiParserParse(MidiParser *parser, const uint8_t *bytes, size_t length, uint64_t timestamp);
+
+/// returns the number of data bytes for a status byte or -1 for sysex
+int MidiParserDataLength(uint8_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include "MidiScheduler.h"
+
+#include <string.h>
+#include <math.h>
+
+#define MASK (MIDI_SCHEDULER_SIZE - 1)
+#define SYSEX_MASK (MIDI_SCHEDULER_SYSEX_SIZE - 1)
+
+// buffer start smoothing, small enough to average out callback jitter
+#define ANCHOR_SMOOTHING 0.05
+
+// events timestamped further than this in the future (in s) are released
+// right away, keeps a bad timestamp from blocking the queue
+#define MAX_DELAY 1.0
+
+void MidiSchedulerInit(MidiScheduler *scheduler, double hostRate) {
+	scheduler->hostRate = hostRate;
+	MidiSchedulerSetTickSize(scheduler, 44100, 64);
+	MidiSchedulerReset(scheduler);
+}
+
+void MidiSchedulerSetTickSize(MidiScheduler *scheduler, double sampleRate, int blockSize) {
+	if(sampleRate <= 0 || blockSize <= 0) {
+		return;
+	}
+	scheduler->tickPeriod = (double)blockSize / sampleRate * scheduler->hostRate;
+	scheduler->synced = 0;
+}
+
+void MidiSchedulerReset(MidiScheduler *scheduler) {
+	scheduler->head = 0;
+	scheduler->tail = 0;
+	scheduler->sysexHead = 0;
+	scheduler->sysexTail = 0;
+	scheduler->tick = 0;
+	scheduler->lastHost = 0;
+	scheduler->anchor = 0;
+	scheduler->synced = 0;
+	scheduler->bufferTicks = 1;
+	scheduler->burstTicks = 0;
+	scheduler->activeUntil = 0;
+	memset(&scheduler->stats, 0, sizeof(MidiSchedulerStats));
+}
+
+// copy bytes into the sysex ring at pos, wrapping around the end
+static void writeSysex(MidiScheduler *scheduler, unsigned int pos, const uint8_t *bytes, size_t length) {
+	size_t first = MIDI_SCHEDULER_SYSEX_SIZE - (pos & SYSEX_MASK);
+	if(first > length) {
+		first = length;
+	}
+	memcpy(scheduler->sysex + (pos & SYSEX_MASK), bytes, first);
+	memcpy(scheduler->sysex, bytes + first, length - first);
+}
+
+// copy bytes out of the sysex ring at pos, wrapping around the end
+static void readSysex(MidiScheduler *scheduler, unsigned int pos, uint8_t *bytes, size_t length) {
+	size_t first = MIDI_SCHEDULER_SYSEX_SIZE - (pos & SYSEX_MASK);
+	if(first > length) {
+		first = length;
+	}
+	memcpy(bytes, scheduler->sysex + (pos & SYSEX_MASK), first);
+	memcpy(bytes + first, scheduler->sysex, length - first);
+}
+
+int MidiSchedulerPush(MidiScheduler *scheduler, const MidiEvent *event, int source) {
+	unsigned int head = scheduler->head;
+	unsigned int tail = __atomic_load_n(&scheduler->tail, __ATOMIC_ACQUIRE);
+	if(head - tail >= MIDI_SCHEDULER_SIZE) {
+		__atomic_add_fetch(&scheduler->stats.dropped, 1, __ATOMIC_RELAXED);
+		return 0;
+	}
+	if(event->sysex) {
+		unsigned int sysexHead = scheduler->sysexHead;
+		unsigned int sysexTail = __atomic_load_n(&scheduler->sysexTail, __ATOMIC_ACQUIRE);
+		if(event->sysexLength > MIDI_PARSER_SYSEX_SIZE ||
+		   sysexHead - sysexTail + event->sysexLength > MIDI_SCHEDULER_SYSEX_SIZE) {
+			__atomic_add_fetch(&scheduler->stats.dropped, 1, __ATOMIC_RELAXED);
+			return 0;
+		}
+		writeSysex(scheduler, sysexHead, event->sysex, event->sysexLength);
+		__atomic_store_n(&scheduler->sysexHead, sysexHead + (unsigned int)event->sysexLength, __ATOMIC_RELEASE);
+	}
+	scheduler->events[head & MASK].event = *event;
+	scheduler->events[head & MASK].source = source;
+	__atomic_store_n(&scheduler->head, head + 1, __ATOMIC_RELEASE);
+	return 1;
+}
+
+// track the host time of the start of each buffer
+static void sync(MidiScheduler *scheduler, uint64_t hostTime) {
+	double gap = (double)(hostTime - scheduler->lastHost);
+	if(!scheduler->synced || gap > scheduler->tickPeriod * 0.5) {
+		double observed = (double)hostTime - (double)scheduler->tick * scheduler->tickPeriod;
+		if(scheduler->burstTicks > 0) {
+			scheduler->bufferTicks = scheduler->burstTicks;
+		}
+		scheduler->burstTicks = 0;
+		if(!scheduler->synced ||
+		   fabs(observed - scheduler->anchor) > scheduler->tickPeriod * scheduler->bufferTicks) {
+			// first buffer or lost sync, ie. audio was stopped
+			scheduler->anchor = observed;
+			scheduler->synced = 1;
+		}
+		else {
+			scheduler->anchor += (observed - scheduler->anchor) * ANCHOR_SMOOTHING;
+		}
+	}
+	scheduler->burstTicks++;
+	scheduler->lastHost = hostTime;
+}
+
+// release the event at tail through the callback & free its sysex bytes
+static void release(MidiScheduler *scheduler, unsigned int tail,
+                    MidiSchedulerCallback callback, void *userData) {
+	const MidiEvent *event = &scheduler->events[tail & MASK].event;
+	scheduler->stats.released++;
+	if(event->sysex) {
+		// sysex bytes are read in the same order they were written
+		MidiEvent segment = *event;
+		readSysex(scheduler, scheduler->sysexTail, scheduler->segment, segment.sysexLength);
+		segment.sysex = scheduler->segment;
+		__atomic_store_n(&scheduler->sysexTail,
+			scheduler->sysexTail + (unsigned int)segment.sysexLength, __ATOMIC_RELEASE);
+		callback(&segment, scheduler->events[tail & MASK].source, userData);
+	}
+	else {
+		callback(event, scheduler->events[tail & MASK].source, userData);
+	}
+}
+
+void MidiSchedulerTick(MidiScheduler *scheduler, uint64_t hostTime,
+                       MidiSchedulerCallback callback, void *userData) {
+	MidiSchedulerStats *stats = &scheduler->stats;
+	sync(scheduler, hostTime);
+
+	// events are due a buffer later than their nominal tick, by then all
+	// events for the tick have arrived
+	double latency = scheduler->tickPeriod * scheduler->bufferTicks;
+	double now = scheduler->anchor + (double)scheduler->tick * scheduler->tickPeriod;
+	double due = now - latency;
+	double limit = (double)hostTime + MAX_DELAY * scheduler->hostRate;
+	stats->latency = latency / scheduler->hostRate;
+
+	// idle once a few buffers have been missed
+	double idle = latency * 4;
+	if(idle < MIDI_SCHEDULER_IDLE_TIME * scheduler->hostRate) {
+		idle = MIDI_SCHEDULER_IDLE_TIME * scheduler->hostRate;
+	}
+	__atomic_store_n(&scheduler->activeUntil, hostTime + (uint64_t)idle, __ATOMIC_RELEASE);
+
+	unsigned int tail = scheduler->tail;
+	unsigned int head = __atomic_load_n(&scheduler->head, __ATOMIC_ACQUIRE);
+	while(tail != head) {
+		const MidiEvent *event = &scheduler->events[tail & MASK].event;
+		double timestamp = (double)event->timestamp;
+		if(event->timestamp != 0 && timestamp > due && timestamp < limit) {
+			break; // not yet, keep order
+		}
+		if(event->timestamp != 0) {
+			double delay = (now - timestamp) / scheduler->hostRate;
+			if(stats->timed == 0 || delay < stats->minDelay) {
+				stats->minDelay = delay;
+			}
+			if(stats->timed == 0 || delay > stats->maxDelay) {
+				stats->maxDelay = delay;
+			}
+			stats->timed++;
+		}
+		release(scheduler, tail, callback, userData);
+		tail++;
+	}
+	__atomic_store_n(&scheduler->tail, tail, __ATOMIC_RELEASE);
+	scheduler->tick++;
+}
+
+int MidiSchedulerActive(MidiScheduler *scheduler, uint64_t hostTime) {
+	return hostTime < __atomic_load_n(&scheduler->activeUntil, __ATOMIC_ACQUIRE);
+}
+
+uint64_t MidiSchedulerIdleTime(MidiScheduler *scheduler) {
+	return __atomic_load_n(&scheduler->activeUntil, __ATOMIC_ACQUIRE);
+}
+
+int MidiSchedulerPending(MidiScheduler *scheduler) {
+	return __atomic_load_n(&scheduler->head, __ATOMIC_ACQUIRE) !=
+	       __atomic_load_n(&scheduler->tail, __ATOMIC_ACQUIRE);
+}
+
+void MidiSchedulerFlush(MidiScheduler *scheduler, MidiSchedulerCallback callback, void *userData) {
+	unsigned int tail = scheduler->tail;
+	unsigned int head = __atomic_load_n(&scheduler->head, __ATOMIC_ACQUIRE);
+	while(tail != head) {
+		release(scheduler, tail, callback, userData);
+		tail++;
+	}
+	__atomic_store_n(&scheduler->tail, tail, __ATOMIC_RELEASE);
+}
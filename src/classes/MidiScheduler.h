@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#ifndef MIDISCHEDULER_H
+#define MIDISCHEDULER_H
+
+#include "MidiParser.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// max queued events, must be a power of 2
+#define MIDI_SCHEDULER_SIZE 1024
+
+/// max queued sysex bytes, must be a power of 2
+#define MIDI_SCHEDULER_SYSEX_SIZE 65536
+
+/// min time in s without ticks after which the scheduler is idle
+#define MIDI_SCHEDULER_IDLE_TIME 0.05
+
+/// release callback, source is the value given when the event was pushed
+typedef void (*MidiSchedulerCallback)(const MidiEvent *event, int source, void *userData);
+
+/// timing stats for released events, delays are in seconds from the event
+/// timestamp to the nominal time of the tick it was released in
+typedef struct MidiSchedulerStats {
+	unsigned long released; ///< events released
+	unsigned long timed;    ///< released events with timestamps
+	unsigned long dropped;  ///< events not queued as the queue was full
+	double minDelay;        ///< smallest delay
+	double maxDelay;        ///< largest delay, jitter is max - min
+	double latency;         ///< current scheduling latency
+} MidiSchedulerStats;
+
+/// timestamped event queue between a MIDI input thread & the audio thread
+///
+/// events are pushed with their host timestamps by a single producer and
+/// released by a single consumer once per DSP tick, at the tick which
+/// corresponds to the timestamp plus a constant latency of one audio buffer:
+/// the relative timing of the events is kept down to the tick size instead
+/// of being quantized to when the audio buffers happen to be processed
+///
+/// the host time of each tick is estimated from when the ticks are run:
+/// all ticks for an audio buffer are run back to back, so a gap between
+/// ticks marks a new buffer, the ticks per buffer are counted & the start
+/// of each buffer is tracked with a slowly moving average
+///
+/// when no ticks are run, ie. audio is stopped, the scheduler is idle and
+/// the producer should deliver events itself after flushing the queue
+///
+/// sysex segment bytes are copied into a preallocated byte ring in one go,
+/// so a long sysex transfer is queued with one push per segment and kept in
+/// order with the other events
+typedef struct MidiScheduler {
+	struct {
+		MidiEvent event;
+		int source;
+	} events[MIDI_SCHEDULER_SIZE];
+	unsigned int head;  ///< next write, producer only
+	unsigned int tail;  ///< next read, consumer only
+
+	uint8_t sysex[MIDI_SCHEDULER_SYSEX_SIZE];
+	unsigned int sysexHead; ///< next byte write, producer only
+	unsigned int sysexTail; ///< next byte read, consumer only
+	uint8_t segment[MIDI_PARSER_SYSEX_SIZE]; ///< released sysex segment
+
+	double hostRate;    ///< host time units per second
+	double tickPeriod;  ///< tick duration in host time units
+
+	uint64_t tick;      ///< ticks run so far
+	uint64_t lastHost;  ///< host time of the last tick
+	double anchor;      ///< estimated host time of tick 0
+	int synced;         ///< is the anchor valid?
+	int bufferTicks;    ///< ticks in the last full buffer
+	int burstTicks;     ///< ticks in the current buffer so far
+	uint64_t activeUntil; ///< host time after which the scheduler is idle
+
+	MidiSchedulerStats stats;
+} MidiScheduler;
+
+/// init scheduler, host rate is the number of host time units per second
+void MidiSchedulerInit(MidiScheduler *scheduler, double hostRate);
+
+/// set tick duration from the sample rate & block size, resyncs timing
+void MidiSchedulerSetTickSize(MidiScheduler *scheduler, double sampleRate, int blockSize);
+
+/// clear queue & timing, producer & consumer must not be running
+void MidiSchedulerReset(MidiScheduler *scheduler);
+
+/// queue event from the source with its timestamp, a 0 timestamp is released
+/// on the next tick, sysex bytes are copied, returns 0 if the queue is full
+/// producer thread only
+int MidiSchedulerPush(MidiScheduler *scheduler, const MidiEvent *event, int source);
+
+/// run a tick at the current host time, events which are due are released
+/// through the callback in the order they were pushed, sysex segments point
+/// to a copy which is valid for the duration of the callback
+/// consumer thread only, call once per DSP tick before processing it
+void MidiSchedulerTick(MidiScheduler *scheduler, uint64_t hostTime,
+                       MidiSchedulerCallback callback, void *userData);
+
+/// returns 1 if ticks are being run at the given host time or 0 if idle, ie.
+/// no ticks for a few buffers or MIDI_SCHEDULER_IDLE_TIME, whichever is longer
+/// producer thread
+int MidiSchedulerActive(MidiScheduler *scheduler, uint64_t hostTime);
+
+/// returns the host time at which the scheduler becomes idle unless another
+/// tick is run, 0 if no ticks were run yet, any thread
+uint64_t MidiSchedulerIdleTime(MidiScheduler *scheduler);
+
+/// returns 1 if events are queued, any thread
+int MidiSchedulerPending(MidiScheduler *scheduler);
+
+/// release all queued events right away in the order they were pushed, ie.
+/// before delivering events directly while idle, must not run at the same
+/// time as MidiSchedulerTick
+void MidiSchedulerFlush(MidiScheduler *scheduler, MidiSchedulerCallback callback, void *userData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ * References: http://www.srm.com/qtma/davidsmidispec.html
+ *
+ */
+#include "MidiWriter.h"
+
+#include <string.h>
+
+// number of data bytes following a status byte
+static int dataLength(uint8_t status) {
+	switch(status & 0xF0) {
+		case 0xC0: case 0xD0:
+			return 1;
+		case 0xF0:
+			return (status == 0xF1 || status == 0xF3 ? 1 : (status == 0xF2 ? 2 : 0));
+		default:
+			return 2;
+	}
+}
+
+void MidiWriterInit(MidiWriter *writer, MidiWriterCallback callback, void *userData, int runningStatus) {
+	writer->callback = callback;
+	writer->userData = userData;
+	writer->runningStatus = (runningStatus != 0);
+	writer->status = 0;
+	writer->inStatus = 0;
+	writer->inSysex = 0;
+	writer->pending = 0;
+	writer->start = 0;
+	writer->length = 0;
+}
+
+// add byte to the buffer, flushes first if full
+static void append(MidiWriter *writer, uint8_t byte) {
+	if(writer->length == MIDI_WRITER_SIZE) {
+		MidiWriterFlush(writer);
+		if(writer->length == MIDI_WRITER_SIZE) {
+			// an incomplete message filled the buffer, ie. with realtime bytes
+			writer->callback(writer->buffer, writer->length, writer->userData);
+			writer->length = 0;
+			writer->start = 0;
+		}
+	}
+	writer->buffer[writer->length++] = byte;
+}
+
+// current message is complete, leave out its status byte when repeated
+static void complete(MidiWriter *writer) {
+	uint8_t status = writer->buffer[writer->start];
+	if(status < 0xF0) {
+		if(writer->runningStatus && status == writer->status) {
+			memmove(writer->buffer + writer->start, writer->buffer + writer->start + 1,
+				writer->length - writer->start - 1);
+			writer->length--;
+		}
+		writer->status = status;
+	}
+	else {
+		writer->status = 0; // system common cancels running status
+	}
+	writer->pending = 0;
+	writer->start = writer->length;
+}
+
+// start a new non-sysex message, flushes first if it wouldn't fit
+static void begin(MidiWriter *writer, uint8_t status) {
+	int length = dataLength(status);
+	if(writer->length + 1 + length > MIDI_WRITER_SIZE) {
+		MidiWriterFlush(writer);
+	}
+	writer->start = writer->length;
+	writer->buffer[writer->length++] = status;
+	writer->pending = length;
+	if(length == 0) {
+		complete(writer);
+	}
+}
+
+void MidiWriterMessage(MidiWriter *writer, const uint8_t *bytes, size_t length) {
+	if(length == 0 || bytes[0] < 0x80 || bytes[0] == 0xF0) {
+		return;
+	}
+	for(size_t i = 0; i < length; ++i) {
+		MidiWriterByte(writer, bytes[i]);
+	}
+}
+
+void MidiWriterByte(MidiWriter *writer, uint8_t byte) {
+	if(byte >= 0xF8) {
+		// realtime, can go anywhere
+		append(writer, byte);
+		if(writer->pending == 0) {
+			writer->start = writer->length;
+		}
+		return;
+	}
+	if(byte == 0xF7) {
+		if(writer->inSysex) {
+			append(writer, byte);
+			MidiWriterFlush(writer);
+			writer->inSysex = 0;
+		}
+		return; // ignore stray sysex end
+	}
+	if(byte & 0x80) {
+		if(writer->pending > 0) {
+			// drop interrupted message
+			writer->length = writer->start;
+			writer->pending = 0;
+		}
+		if(writer->inSysex || byte == 0xF0) {
+			// sysex start, any other status ends sysex
+			MidiWriterFlush(writer);
+			writer->inSysex = (byte == 0xF0);
+		}
+		writer->inStatus = (byte < 0xF0 ? byte : 0);
+		if(byte == 0xF0) {
+			append(writer, byte);
+		}
+		else {
+			begin(writer, byte);
+		}
+		return;
+	}
+
+	// data
+	if(writer->inSysex) {
+		append(writer, byte);
+		return;
+	}
+	if(writer->pending == 0) {
+		if(writer->inStatus == 0) {
+			return; // no status, drop
+		}
+		begin(writer, writer->inStatus); // running status
+	}
+	append(writer, byte);
+	if(--writer->pending == 0) {
+		complete(writer);
+	}
+}
+
+void MidiWriterFlush(MidiWriter *writer) {
+	size_t end = (writer->pending > 0 ? writer->start : writer->length);
+	if(end > 0) {
+		writer->callback(writer->buffer, end, writer->userData);
+		memmove(writer->buffer, writer->buffer + end, writer->length - end);
+		writer->length -= end;
+	}
+	writer->start = 0;
+	writer->status = 0; // next flush starts with a status byte
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ * References: http://www.srm.com/qtma/davidsmidispec.html
+ *
+ */
+#ifndef MIDIWRITER_H
+#define MIDIWRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// max bytes buffered before they are flushed
+#define MIDI_WRITER_SIZE 1024
+
+/// flush callback, bytes are valid for the duration of the callback only
+typedef void (*MidiWriterCallback)(const uint8_t *bytes, size_t length, void *userData);
+
+/// MIDI output accumulator, collects messages & raw bytes into a single
+/// buffer which is flushed at once, ie. as one packet list per cycle
+///
+/// raw bytes are parsed into messages as they are written: the buffer is only
+/// flushed at message boundaries so a message is never split between two
+/// flushes, an incomplete message is kept until it is completed, dropped if
+/// interrupted by another status byte, and data bytes without a preceding
+/// status byte use running status
+///
+/// optionally leaves out repeated channel voice status bytes (running
+/// status), the buffer always starts with a status byte after a flush
+///
+/// sysex is flushed separately from other messages: pending bytes are
+/// flushed before a sysex start and the sysex is flushed on its end or
+/// when the buffer is full
+///
+/// no allocation is done while writing, all state lives in this struct
+typedef struct MidiWriter {
+	MidiWriterCallback callback;
+	void *userData;
+	uint8_t runningStatus; ///< leave out repeated status bytes?
+	uint8_t status;        ///< last buffered channel voice status, 0 if none
+	uint8_t inStatus;      ///< running status of the written bytes, 0 if none
+	uint8_t inSysex;       ///< within sysex?
+	int pending;           ///< data bytes left to complete the current message
+	size_t start;          ///< buffer offset of the current message
+	size_t length;
+	uint8_t buffer[MIDI_WRITER_SIZE];
+} MidiWriter;
+
+/// init writer with flush callback, user data pointer, and whether to use
+/// running status
+void MidiWriterInit(MidiWriter *writer, MidiWriterCallback callback, void *userData, int runningStatus);
+
+/// write a complete non-sysex message starting with its status byte
+void MidiWriterMessage(MidiWriter *writer, const uint8_t *bytes, size_t length);
+
+/// write a raw byte from a byte stream, ie. from [midiout]
+void MidiWriterByte(MidiWriter *writer, uint8_t byte);
+
+/// send buffered complete messages & sysex bytes through the callback, if
+/// any, an incomplete message is kept for the next flush
+void MidiWriterFlush(MidiWriter *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -10,9 +10,18 @@
  */
 #import "PartyBrowser.h"
 
+#import "AppDelegate.h"
 #import "Log.h"
 #import "AllScenes.h"
 
+/// scene directory types, cached with the browser's directory listings
+typedef enum {
+	PartyBrowserTypeNone = 0,
+	PartyBrowserTypeRjScene,
+	PartyBrowserTypeDroidScene,
+	PartyBrowserTypePartyScene
+} PartyBrowserType;
+
 @implementation PartyBrowser
 
 // lock orientation on iPhone
@@ -112,9 +121,7 @@
 - (BOOL)browser:(Browser *)browser isPathSelectable:(NSString *)path isDir:(BOOL)isDir {
 	// make sure we can't navigate into known scene folder types
 	if(browser.mode == BrowserModeMove) {
-		if([RjScene isRjDjDirectory:path] ||
-		   [DroidScene isDroidPartyDirectory:path] ||
-		   [PartyScene isPdPartyDirectory:path]) {
+		if(isDir && [browser typeForPath:path isDir:isDir] != PartyBrowserTypeNone) {
 			return NO;
 		}
 	}
@@ -130,7 +137,8 @@
 	cell.detailTextLabel.text = @"";
 	if(isDir) {
 		cell.accessoryType = UITableViewCellAccessoryNone;
-		if([RjScene isRjDjDirectory:path]) {
+		PartyBrowserType type = [browser typeForPath:path isDir:isDir];
+		if(type == PartyBrowserTypeRjScene) {
 			
 			// thumbnail
 			UIImage *thumb = [RjScene thumbnailForSceneAt:path];
@@ -155,10 +163,10 @@
 				}
 			}
 		}
-		else if([DroidScene isDroidPartyDirectory:path]) {
+		else if(type == PartyBrowserTypeDroidScene) {
 			cell.imageView.image = [UIImage imageNamed:@"droidparty"];
 		}
-		else if([PartyScene isPdPartyDirectory:path]) {
+		else if(type == PartyBrowserTypePartyScene) {
 		
 			// thumbnail
 			UIImage *thumb = [PartyScene thumbnailForSceneAt:path];
@@ -204,4 +212,27 @@
 	}
 }
 
+// thread safe, only checks for scene files
+- (int)browser:(Browser *)browser typeForPath:(NSString *)path isDir:(BOOL)isDir {
+	if(!isDir) {
+		return PartyBrowserTypeNone;
+	}
+	if([RjScene isRjDjDirectory:path]) {
+		return PartyBrowserTypeRjScene;
+	}
+	else if([DroidScene isDroidPartyDirectory:path]) {
+		return PartyBrowserTypeDroidScene;
+	}
+	else if([PartyScene isPdPartyDirectory:path]) {
+		return PartyBrowserTypePartyScene;
+	}
+	return PartyBrowserTypeNone;
+}
+
+// scenes may have changed, the library updates when next searched
+- (void)browser:(Browser *)browser changedPath:(NSString *)path {
+	AppDelegate *app = (AppDelegate *)UIApplication.sharedApplication.delegate;
+	[app.sceneLibrary setNeedsUpdate];
+}
+
 @end
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include "PatchCache.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char magic[4] = {'P', 'd', 'P', 'C'};
+
+// reader
+
+// read a value at pos if it fits, advances pos
+static int readBytes(const PatchCache *cache, size_t *pos, void *dest, size_t length) {
+	if(length > cache->size - *pos) {
+		return 0;
+	}
+	memcpy(dest, (const uint8_t *)cache->data + *pos, length);
+	*pos += length;
+	return 1;
+}
+
+// check the header against the key & walk all records for bounds
+static int validate(PatchCache *cache, const PatchCacheKey *key) {
+	size_t pos = 0;
+	char fileMagic[4];
+	uint32_t version, filter, pathLength, lines;
+	uint64_t size;
+	int64_t mtime;
+	if(!readBytes(cache, &pos, fileMagic, 4) || memcmp(fileMagic, magic, 4) != 0 ||
+	   !readBytes(cache, &pos, &version, 4) || version != PATCH_CACHE_VERSION ||
+	   !readBytes(cache, &pos, &filter, 4) || filter != key->filter ||
+	   !readBytes(cache, &pos, &size, 8) || size != key->size ||
+	   !readBytes(cache, &pos, &mtime, 8) || mtime != key->mtime ||
+	   !readBytes(cache, &pos, &pathLength, 4) || pathLength != strlen(key->path) ||
+	   pathLength > cache->size - pos ||
+	   memcmp((const uint8_t *)cache->data + pos, key->path, pathLength) != 0) {
+		return 0;
+	}
+	pos += pathLength;
+	if(!readBytes(cache, &pos, &lines, 4)) {
+		return 0;
+	}
+	cache->pos = pos;
+	cache->lines = lines;
+	for(uint32_t i = 0; i < lines; ++i) {
+		uint32_t count;
+		if(!readBytes(cache, &pos, &count, 4)) {
+			return 0;
+		}
+		for(uint32_t j = 0; j < count; ++j) {
+			uint8_t type;
+			uint32_t length;
+			if(!readBytes(cache, &pos, &type, 1)) {
+				return 0;
+			}
+			if(type == PATCH_CACHE_NULL) {
+				continue;
+			}
+			if(type != PATCH_CACHE_STRING || !readBytes(cache, &pos, &length, 4) ||
+			   length > cache->size - pos) {
+				return 0;
+			}
+			pos += length;
+		}
+	}
+	return (pos == cache->size);
+}
+
+int PatchCacheOpen(PatchCache *cache, const char *path, const PatchCacheKey *key) {
+	struct stat st;
+	cache->data = NULL;
+	cache->size = 0;
+	cache->pos = 0;
+	cache->lines = 0;
+	int fd = open(path, O_RDONLY);
+	if(fd < 0) {
+		return 0;
+	}
+	if(fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return 0;
+	}
+	void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(data == MAP_FAILED) {
+		return 0;
+	}
+	cache->data = data;
+	cache->size = (size_t)st.st_size;
+	if(!validate(cache, key)) {
+		PatchCacheClose(cache);
+		return 0;
+	}
+	return 1;
+}
+
+int PatchCacheNextLine(PatchCache *cache, uint32_t *count) {
+	if(cache->lines == 0 || !readBytes(cache, &cache->pos, count, 4)) {
+		return 0;
+	}
+	cache->lines--;
+	return 1;
+}
+
+int PatchCacheNextAtom(PatchCache *cache, PatchCacheAtom *atom) {
+	uint8_t type = PATCH_CACHE_NULL;
+	atom->type = PATCH_CACHE_NULL;
+	atom->text = NULL;
+	atom->length = 0;
+	if(!readBytes(cache, &cache->pos, &type, 1)) {
+		return 0;
+	}
+	if(type == PATCH_CACHE_STRING) {
+		uint32_t length;
+		if(!readBytes(cache, &cache->pos, &length, 4) || length > cache->size - cache->pos) {
+			return 0;
+		}
+		atom->type = PATCH_CACHE_STRING;
+		atom->text = (const char *)cache->data + cache->pos;
+		atom->length = length;
+		cache->pos += length;
+	}
+	return 1;
+}
+
+void PatchCacheClose(PatchCache *cache) {
+	if(cache->data) {
+		munmap(cache->data, cache->size);
+	}
+	cache->data = NULL;
+	cache->size = 0;
+	cache->pos = 0;
+	cache->lines = 0;
+}
+
+// writer
+
+static void writeBytes(PatchCacheWriter *writer, const void *bytes, size_t length) {
+	if(!writer->error && fwrite(bytes, 1, length, writer->file) != length) {
+		writer->error = 1;
+	}
+}
+
+int PatchCacheWriterOpen(PatchCacheWriter *writer, const char *path, const PatchCacheKey *key) {
+	uint32_t version = PATCH_CACHE_VERSION;
+	uint32_t pathLength = (uint32_t)strlen(key->path);
+	memset(writer, 0, sizeof(PatchCacheWriter));
+	writer->path = strdup(path);
+	writer->tempPath = (char *)malloc(strlen(path) + 5);
+	if(!writer->path || !writer->tempPath) {
+		free(writer->path);
+		free(writer->tempPath);
+		return 0;
+	}
+	strcpy(writer->tempPath, path);
+	strcat(writer->tempPath, ".tmp");
+	writer->file = fopen(writer->tempPath, "wb");
+	if(!writer->file) {
+		free(writer->path);
+		free(writer->tempPath);
+		return 0;
+	}
+	writeBytes(writer, magic, 4);
+	writeBytes(writer, &version, 4);
+	writeBytes(writer, &key->filter, 4);
+	writeBytes(writer, &key->size, 8);
+	writeBytes(writer, &key->mtime, 8);
+	writeBytes(writer, &pathLength, 4);
+	writeBytes(writer, key->path, pathLength);
+	writer->linesPos = ftell(writer->file);
+	writeBytes(writer, &writer->lines, 4); // placeholder
+	return 1;
+}
+
+void PatchCacheWriterLine(PatchCacheWriter *writer, uint32_t count) {
+	writeBytes(writer, &count, 4);
+	writer->lines++;
+}
+
+void PatchCacheWriterAtom(PatchCacheWriter *writer, PatchCacheAtomType type,
+                          const char *text, uint32_t length) {
+	uint8_t t = (uint8_t)type;
+	writeBytes(writer, &t, 1);
+	if(type == PATCH_CACHE_STRING) {
+		writeBytes(writer, &length, 4);
+		writeBytes(writer, text, length);
+	}
+}
+
+int PatchCacheWriterClose(PatchCacheWriter *writer) {
+	int ok = 0;
+	if(!writer->error && fseek(writer->file, writer->linesPos, SEEK_SET) == 0) {
+		writeBytes(writer, &writer->lines, 4);
+		ok = !writer->error;
+	}
+	if(fclose(writer->file) != 0) {
+		ok = 0;
+	}
+	if(ok) {
+		ok = (rename(writer->tempPath, writer->path) == 0);
+	}
+	if(!ok) {
+		unlink(writer->tempPath);
+		unlink(writer->path); // don't leave a stale cache behind
+	}
+	free(writer->path);
+	free(writer->tempPath);
+	memset(writer, 0, sizeof(PatchCacheWriter));
+	return ok;
+}
+
+uint64_t PatchCacheHash(const char *string) {
+	uint64_t hash = 14695981039346656037ULL;
+	for(; *string; ++string) {
+		hash ^= (uint8_t)*string;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#ifndef PATCHCACHE_H
+#define PATCHCACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// cache file format version, bump when the format or the parsing rules change
+#define PATCH_CACHE_VERSION 2
+
+/// source patch file identity, a cache is stale if any of these differ
+typedef struct PatchCacheKey {
+	const char *path; ///< source patch path
+	uint64_t size;    ///< source file size in bytes
+	int64_t mtime;    ///< source modification time in ns
+	uint32_t filter;  ///< version of the line filter applied when caching,
+	                  ///< change when the filter changes, 0 for none
+} PatchCacheKey;
+
+/// atom types
+typedef enum PatchCacheAtomType {
+	PATCH_CACHE_STRING, ///< string, text is set
+	PATCH_CACHE_NULL    ///< separator, ie. unescaped comma
+} PatchCacheAtomType;
+
+/// an atom, text points into the mapped cache file and is not null terminated
+typedef struct PatchCacheAtom {
+	PatchCacheAtomType type;
+	const char *text;
+	uint32_t length;
+} PatchCacheAtom;
+
+/// binary cache of parsed patch atom lines, a compact versioned file which is
+/// memory mapped & validated in full when opened so reading cannot fail
+///
+/// format, native byte order:
+///
+///   header: "PdPC" magic, u32 version, u32 filter, u64 size, i64 mtime,
+///           u32 path length, path bytes, u32 line count
+///   line:   u32 atom count, atoms
+///   atom:   u8 type, string atoms are followed by u32 length & text bytes
+///
+typedef struct PatchCache {
+	void *data;
+	size_t size;
+	size_t pos;      ///< read position
+	uint32_t lines;  ///< number of lines
+} PatchCache;
+
+/// map & validate the cache file at path against the source key,
+/// returns 1 on success or 0 if the cache is missing, stale, or invalid
+int PatchCacheOpen(PatchCache *cache, const char *path, const PatchCacheKey *key);
+
+/// read the next line's atom count, call PatchCacheNextAtom() count times after,
+/// returns 0 when there are no more lines or on a read past the end
+int PatchCacheNextLine(PatchCache *cache, uint32_t *count);
+
+/// read the next atom in the current line, returns 0 on a read past the end,
+/// ie. when called more times than the line's atom count at the end of the cache
+int PatchCacheNextAtom(PatchCache *cache, PatchCacheAtom *atom);
+
+/// unmap cache file
+void PatchCacheClose(PatchCache *cache);
+
+/// cache file writer, writes to a temporary file which replaces the cache
+/// file when finished so readers never see a partial cache
+typedef struct PatchCacheWriter {
+	FILE *file;
+	char *path;      ///< cache file path
+	char *tempPath;  ///< temporary file path
+	uint32_t lines;
+	long linesPos;   ///< file position of the line count
+	int error;
+} PatchCacheWriter;
+
+/// start writing a cache for the source key to the file at path,
+/// returns 0 on error
+int PatchCacheWriterOpen(PatchCacheWriter *writer, const char *path, const PatchCacheKey *key);
+
+/// begin a new line with the given number of atoms
+void PatchCacheWriterLine(PatchCacheWriter *writer, uint32_t count);
+
+/// write an atom, text is ignored for PATCH_CACHE_NULL
+void PatchCacheWriterAtom(PatchCacheWriter *writer, PatchCacheAtomType type,
+                          const char *text, uint32_t length);
+
+/// finish & move the cache into place, returns 0 on error in which case the
+/// cache file is removed
+int PatchCacheWriterClose(PatchCacheWriter *writer);
+
+/// 64 bit FNV-1a hash of a string, ie. for naming cache files after paths
+uint64_t PatchCacheHash(const char *string);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -36,4 +36,20 @@
 ///
 + (NSArray *)getAtomLines:(NSString *)patchText;
 
+#pragma mark Cache
+
+/// read atom lines previously cached for a pd patch, returns nil if there is
+/// no cache, the patch has changed since, or the lines were cached using
+/// another filter version
++ (NSArray *)readCachedAtomLines:(NSString *)patch filterVersion:(uint32_t)filterVersion;
+
+/// cache atom lines for a pd patch, keyed by its path, size, and modification
+/// time, filter version identifies which lines were kept, if filtered, and
+/// should change whenever the filter does, returns NO on error
++ (BOOL)writeCachedAtomLines:(NSArray *)atomLines forPatch:(NSString *)patch
+               filterVersion:(uint32_t)filterVersion;
+
+/// remove all cached atom lines
++ (void)clearCache;
+
 @end
@@ -11,11 +11,17 @@
 #import "PdParser.h"
 
 #import "Util.h"
+#import "ZipMount.h"
 #import "Log.h"
-#include "m_pd.h" // for binbuf
+#include "PdTokenizer.h"
+#include "PatchCache.h"
+#include <sys/stat.h>
+#include "m_pd.h" // for MAXPDSTRING
 
 //#define DEBUG_PARSER
 
+static void PdParserLine(const PdToken *tokens, int count, void *userData);
+
 @implementation PdParser
 
 + (void)printAtomLine:(NSArray *)line {
@@ -37,145 +43,235 @@
 
 + (NSString *)readPatch:(NSString *)patch {
 	
-	NSString *absPath = patch;
-	if(![patch isAbsolutePath]) {
-		absPath = [NSString pathWithComponents:[NSArray arrayWithObjects:@"/", Util.bundlePath, patch, nil]];
-	}
+	NSString *absPath = [PdParser absolutePath:patch];
 	
 	// verbose
 	LogVerbose(@"PdParser: opening patch \"%@\"", patch.lastPathComponent);
 
-	if(![NSFileManager.defaultManager isReadableFileAtPath:absPath]) {
+	// patches in archives are read without being extracted
+	NSData *buffer = [ZipMount dataWithContentsOfFile:absPath];
+	if(!buffer) {
 		// error
 		LogError(@"PdParser: can't read patch: \"%@\"", patch.lastPathComponent);
 		return @"";
 	}
-
-	NSError *error = NULL;
-	NSData *buffer = [NSData dataWithContentsOfFile:absPath options:NSDataReadingUncached error:&error];
-	if(!buffer) {
+	
+	// convert buffer to string
+	NSString *text = [[NSString alloc] initWithBytes:buffer.bytes
+	                                          length:buffer.length
+	                                        encoding:NSUTF8StringEncoding];
+	if(!text) {
 		// error
-		LogError(@"PdParser: couldn't open patch \"%@\": %@", patch.lastPathComponent, error.localizedFailureReason);
+		LogError(@"PdParser: couldn't read patch \"%@\": invalid UTF-8", patch.lastPathComponent);
 		return @"";
 	}
-	
-	// convert buffer to string
-	return [[NSString alloc] initWithBytes:buffer.bytes
-	                                length:buffer.length
-	                              encoding:NSUTF8StringEncoding];
+	return text;
 }
 
-// icu regex doc: http://userguide.icu-project.org/strings/regexp
 + (NSArray *)getAtomLines:(NSString *)patchText {
-
 	NSMutableArray *atomLines = [NSMutableArray array];
+	const char *text = patchText.UTF8String;
+	if(!text) {
+		return atomLines; // nil text
+	}
+	PdTokenizer tokenizer;
+	PdTokenizerInit(&tokenizer);
+	int count = PdTokenizerParse(&tokenizer, text, strlen(text), PdParserLine, (__bridge void *)atomLines);
+	PdTokenizerFree(&tokenizer);
+	if(count < 0) {
+		LogError(@"PdParser: couldn't allocate tokens");
+	}
 	
-	// break string into lines
-	NSRegularExpression *lineRegexp =
-		[NSRegularExpression regularExpressionWithPattern:@"(#((.|\r|\n)*?)[^\\\\])\r{0,1}\n{0,1};\r{0,1}\n"
-		                                          options:NSRegularExpressionCaseInsensitive
-		                                            error:NULL];
-	NSArray *lineMatches = [lineRegexp matchesInString:patchText options:0 range:NSMakeRange(0, patchText.length)];
-	t_binbuf *binbuf = binbuf_new();
-	for(NSTextCheckingResult *lineMatch in lineMatches) {
-		NSString *line = [patchText substringWithRange:lineMatch.range];
-
-		// parse atom lines using pd's binbuf
-		NSMutableArray *atomLine = [NSMutableArray new];
-		binbuf_text(binbuf, line.UTF8String, [line lengthOfBytesUsingEncoding:NSUTF8StringEncoding]);
-		int argc = binbuf_getnatom(binbuf);
-		t_atom *argv = binbuf_getvec(binbuf);
-		//binbuf_print(binbuf);
-		for(int i = 0; i < argc; i++) {
-			t_atom *a = &argv[i];
-			switch(a->a_type) {
-				case A_FLOAT: // FIXME: convert back to string for now
-					[atomLine addObject:[NSString stringWithFormat:@"%g", a->a_w.w_float]];
-					break;
-				case A_SYMBOL:
-					if(strncmp(a->a_w.w_symbol->s_name, ",", MAXPDSTRING) == 0 && atomLine.lastObject) {
-						// concat single commas with previous words
+	// verbose
+	LogVerbose(@"PdParser: parsed %lu atom lines", (unsigned long)atomLines.count);
+	
+	return atomLines;
+}
+
+#pragma mark Cache
+
++ (NSArray *)readCachedAtomLines:(NSString *)patch filterVersion:(uint32_t)filterVersion {
+	NSString *absPath = [PdParser absolutePath:patch];
+	PatchCacheKey key;
+	if(![PdParser cacheKey:&key forPath:absPath filterVersion:filterVersion]) {
+		return nil;
+	}
+	PatchCache cache;
+	if(!PatchCacheOpen(&cache, [PdParser cachePathForPath:absPath].fileSystemRepresentation, &key)) {
+		return nil;
+	}
+	NSMutableArray *atomLines = [NSMutableArray arrayWithCapacity:cache.lines];
+	uint32_t count;
+	while(PatchCacheNextLine(&cache, &count)) {
+		NSMutableArray *atomLine = [NSMutableArray arrayWithCapacity:count];
+		for(uint32_t i = 0; i < count; ++i) {
+			PatchCacheAtom atom;
+			if(!PatchCacheNextAtom(&cache, &atom)) {
+				PatchCacheClose(&cache);
+				return nil;
+			}
+			if(atom.type == PATCH_CACHE_NULL) {
+				[atomLine addObject:[NSNull null]];
+			}
+			else {
+				NSString *string = [[NSString alloc] initWithBytes:atom.text
+				                                            length:atom.length
+				                                          encoding:NSUTF8StringEncoding];
+				[atomLine addObject:(string ? string : @"")];
+			}
+		}
+		[atomLines addObject:atomLine];
+	}
+	PatchCacheClose(&cache);
+	LogVerbose(@"PdParser: read %lu cached atom lines", (unsigned long)atomLines.count);
+	return atomLines;
+}
+
++ (BOOL)writeCachedAtomLines:(NSArray *)atomLines forPatch:(NSString *)patch
+               filterVersion:(uint32_t)filterVersion {
+	NSString *absPath = [PdParser absolutePath:patch];
+	PatchCacheKey key;
+	if(![PdParser cacheKey:&key forPath:absPath filterVersion:filterVersion]) {
+		return NO;
+	}
+	NSString *cachePath = [PdParser cachePathForPath:absPath];
+	NSError *error;
+	if(![NSFileManager.defaultManager createDirectoryAtPath:cachePath.stringByDeletingLastPathComponent
+	                            withIntermediateDirectories:YES
+	                                             attributes:nil
+	                                                  error:&error]) {
+		LogError(@"PdParser: couldn't create cache dir: %@", error.localizedDescription);
+		return NO;
+	}
+	PatchCacheWriter writer;
+	if(!PatchCacheWriterOpen(&writer, cachePath.fileSystemRepresentation, &key)) {
+		LogError(@"PdParser: couldn't write cache for \"%@\"", patch.lastPathComponent);
+		return NO;
+	}
+	for(NSArray *atomLine in atomLines) {
+		PatchCacheWriterLine(&writer, (uint32_t)atomLine.count);
+		for(id atom in atomLine) {
+			if([atom isKindOfClass:NSString.class]) {
+				const char *text = [atom UTF8String];
+				PatchCacheWriterAtom(&writer, PATCH_CACHE_STRING, text, (uint32_t)strlen(text));
+			}
+			else {
+				PatchCacheWriterAtom(&writer, PATCH_CACHE_NULL, NULL, 0);
+			}
+		}
+	}
+	if(!PatchCacheWriterClose(&writer)) {
+		LogError(@"PdParser: couldn't write cache for \"%@\"", patch.lastPathComponent);
+		return NO;
+	}
+	return YES;
+}
+
++ (void)clearCache {
+	NSString *cacheDir = [Util.cachesPath stringByAppendingPathComponent:@"PatchCache"];
+	[NSFileManager.defaultManager removeItemAtPath:cacheDir error:nil];
+}
+
+#pragma mark Private
+
+// patches relative paths are in the app bundle
++ (NSString *)absolutePath:(NSString *)patch {
+	if(![patch isAbsolutePath]) {
+		return [NSString pathWithComponents:[NSArray arrayWithObjects:@"/", Util.bundlePath, patch, nil]];
+	}
+	return patch;
+}
+
+// cache file name is a hash of the patch path
++ (NSString *)cachePathForPath:(NSString *)absPath {
+	NSString *name = [NSString stringWithFormat:@"%016llx.cache",
+		(unsigned long long)PatchCacheHash(absPath.fileSystemRepresentation)];
+	return [NSString pathWithComponents:@[Util.cachesPath, @"PatchCache", name]];
+}
+
+// fill cache key with the patch file's current size & modification time,
+// path points into an autoreleased string
++ (BOOL)cacheKey:(PatchCacheKey *)key forPath:(NSString *)absPath filterVersion:(uint32_t)filterVersion {
+	struct stat st;
+	key->path = absPath.fileSystemRepresentation;
+	key->filter = filterVersion;
+	if(stat(key->path, &st) != 0) {
+		return NO;
+	}
+	key->size = (uint64_t)st.st_size;
+	key->mtime = (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+	return YES;
+}
+
+
+// returns YES if the float text is already in %g form, ie. a short integer
+static BOOL isPlainInteger(const PdToken *token) {
+	const char *text = token->text;
+	size_t length = token->length;
+	if(length > 0 && text[0] == '-') {
+		text++;
+		length--;
+	}
+	if(length == 0 || length > 6 || (text[0] == '0' && length > 1)) {
+		return NO;
+	}
+	for(size_t i = 0; i < length; ++i) {
+		if(text[i] < '0' || text[i] > '9') {
+			return NO;
+		}
+	}
+	return YES;
+}
+
+// PdTokenizer callback, converts a line of tokens into an atom line
+static void PdParserLine(const PdToken *tokens, int count, void *userData) {
+	NSMutableArray *atomLines = (__bridge NSMutableArray *)userData;
+	NSMutableArray *atomLine = [NSMutableArray arrayWithCapacity:count];
+	char symbol[MAXPDSTRING];
+	for(int i = 0; i < count; i++) {
+		const PdToken *token = &tokens[i];
+		switch(token->type) {
+			case PD_TOKEN_FLOAT:
+				if(isPlainInteger(token)) {
+					[atomLine addObject:[[NSString alloc] initWithBytes:token->text
+					                                             length:token->length
+					                                           encoding:NSUTF8StringEncoding]];
+				}
+				else { // same as a t_float printed by pd
+					[atomLine addObject:[NSString stringWithFormat:@"%g", (float)token->value]];
+				}
+				break;
+			case PD_TOKEN_SYMBOL: {
+				NSString *string = nil;
+				if(token->escaped) {
+					PdTokenCopy(token, symbol, MAXPDSTRING);
+					if(strcmp(symbol, ",") == 0 && atomLine.lastObject) {
+						// concat single escaped commas with previous words
 						atomLine[atomLine.count-1] = [NSString stringWithFormat:@"%@,", atomLine.lastObject];
+						break;
 					}
-					else {
-						[atomLine addObject:[NSString stringWithUTF8String:a->a_w.w_symbol->s_name]];
-					}
-					break;
-				case A_COMMA: // separates main list from options afterward
-					[atomLine addObject:[NSNull null]];
-					break;
-				// ignore, shouldn't see these in a file...
-				case A_NULL:
-				case A_POINTER:
-				case A_SEMI:
-				case A_DEFFLOAT:
-				case A_DEFSYM:
-				case A_DOLLAR:
-				case A_DOLLSYM:
-				case A_GIMME:
-				case A_CANT:
-				default:
-					break;
+					string = [NSString stringWithUTF8String:symbol];
+				}
+				else {
+					string = [[NSString alloc] initWithBytes:token->text
+					                                  length:token->length
+					                                encoding:NSUTF8StringEncoding];
+				}
+				if(string) {
+					[atomLine addObject:string];
+				}
+				break;
 			}
+			case PD_TOKEN_COMMA: // separates main list from options afterward
+				[atomLine addObject:[NSNull null]];
+				break;
 		}
-		[atomLines addObject:atomLine];
-		binbuf_clear(binbuf);
+	}
+	[atomLines addObject:atomLine];
 
-		#ifdef DEBUG_PARSER
-			NSLog(@"%@", [atomLine componentsJoinedByString:@" "]);
-		#endif
-/*
-		// grab matching line as a string & remove trailing ";\n"
-		NSString *line = [patchText substringWithRange:NSMakeRange(lineMatch.range.location, lineMatch.range.length-2)];
-
-		// replace whitespace chars with a space
-		NSRegularExpression *atomRegexp =
-			[NSRegularExpression regularExpressionWithPattern:@"\t|\r\n?|\n"
-			                                          options:NSRegularExpressionCaseInsensitive
-			                                            error:NULL];
-		NSString *atom = [atomRegexp stringByReplacingMatchesInString:line
-		                                                      options:NSMatchingWithTransparentBounds
-		                                                        range:NSMakeRange(0, line.length)
-		                                                 withTemplate:@" "];
-		
-		// catch Pd 0.46+ variable width length info appended with a comma at the end of float & symbol atoms
-		//
-		// example:
-		//
-		//     #X symbolatom 138 49 10 0 0 0 - - send-ame, f 10;
-		//     #X floatatom 137 84 5 0 0 0 - - send-name, f 5;
-		//
-		// The ", f 10" & ", f5" are supplemental so the following regex catches the ", " and appends a space in front so the comma
-		// will become a separate string when parsed. This way, we can catch this supplemental information at the end of an atom line
-		// with arbitrary length by looking for a "," in the returned atom line array:
-		//
-		// array: "#X" "symbolatom" "138" "49" "10" "0" "0" "0" "-" "-" "send-name" "," "f" "10"
-		// array: "#X" "floatatom"  "137" "84"  "5" "0" "0" "0" "-" "-" "send-name" "," "f" "5"
-		//                                                          atom end ^       ^ info start
-		//
-		// note: the regex will *not* match escaped commas aka "\," so the following will not be broken:
-		//
-		// #X text 207 218 hello \, world \, foo & bar \,;
-		//
-		NSRegularExpression *commaRegexp
-			[NSRegularExpression regularExpressionWithPattern:@"(?<!\\\\),\\s"
-			                                          options:NSRegularExpressionCaseInsensitive
-			                                            error:NULL];
-		atom = [commaRegexp stringByReplacingMatchesInString:atom
-		                                             options:NSMatchingWithTransparentBounds
-		                                               range:NSMakeRange(0, line.length)
-		                                        withTemplate:@" , "]; // add preceding space
-
-		// break line into strings delimited by spaces
-		[atomLines addObject:[atom componentsSeparatedByString:@" "]];
-*/
-	}
-	binbuf_free(binbuf);
-	
-	// verbose
-	LogVerbose(@"PdParser: parsed %lu atom lines", (unsigned long)atomLines.count);
-	
-	return atomLines;
+	#ifdef DEBUG_PARSER
+		NSLog(@"%@", [atomLine componentsJoinedByString:@" "]);
+	#endif
 }
 
 @end
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include "PdTokenizer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// initial line token storage
+#define DEFAULT_CAPACITY 64
+
+// max number text length, longer words are kept as symbols
+#define MAX_NUMBER 64
+
+void PdTokenizerInit(PdTokenizer *tokenizer) {
+	tokenizer->tokens = NULL;
+	tokenizer->capacity = 0;
+}
+
+void PdTokenizerFree(PdTokenizer *tokenizer) {
+	free(tokenizer->tokens);
+	tokenizer->tokens = NULL;
+	tokenizer->capacity = 0;
+}
+
+// number recognizer states, same as binbuf_text()
+enum {
+	FLOAT_NONE = -1,  // not a number
+	FLOAT_BEGIN,      // beginning
+	FLOAT_MINUS,      // got minus
+	FLOAT_DIGITS,     // got digits
+	FLOAT_DOT,        // got '.' without digits
+	FLOAT_DIGITS_DOT, // got '.' after digits
+	FLOAT_FRACTION,   // got digits after .
+	FLOAT_EXPONENT,   // got 'e'
+	FLOAT_EXP_SIGN,   // got plus or minus after 'e'
+	FLOAT_EXP_DIGITS  // got exponent digits
+};
+
+static int nextFloatState(int state, char c) {
+	int digit = (c >= '0' && c <= '9');
+	int expon = (c == 'e' || c == 'E');
+	switch(state) {
+		case FLOAT_BEGIN:
+			if(c == '-') return FLOAT_MINUS;
+			if(digit) return FLOAT_DIGITS;
+			if(c == '.') return FLOAT_DOT;
+			return FLOAT_NONE;
+		case FLOAT_MINUS:
+			if(digit) return FLOAT_DIGITS;
+			if(c == '.') return FLOAT_DOT;
+			return FLOAT_NONE;
+		case FLOAT_DIGITS:
+			if(digit) return FLOAT_DIGITS;
+			if(c == '.') return FLOAT_DIGITS_DOT;
+			if(expon) return FLOAT_EXPONENT;
+			return FLOAT_NONE;
+		case FLOAT_DOT:
+			return (digit ? FLOAT_FRACTION : FLOAT_NONE);
+		case FLOAT_DIGITS_DOT:
+			if(digit) return FLOAT_FRACTION;
+			if(expon) return FLOAT_EXPONENT;
+			return FLOAT_NONE;
+		case FLOAT_FRACTION:
+			if(digit) return FLOAT_FRACTION;
+			if(expon) return FLOAT_EXPONENT;
+			return FLOAT_NONE;
+		case FLOAT_EXPONENT:
+			if(c == '-' || c == '+') return FLOAT_EXP_SIGN;
+			if(digit) return FLOAT_EXP_DIGITS;
+			return FLOAT_NONE;
+		case FLOAT_EXP_SIGN:
+		case FLOAT_EXP_DIGITS:
+			return (digit ? FLOAT_EXP_DIGITS : FLOAT_NONE);
+		default:
+			return FLOAT_NONE;
+	}
+}
+
+static int isFloatState(int state) {
+	return state == FLOAT_DIGITS || state == FLOAT_DIGITS_DOT ||
+	       state == FLOAT_FRACTION || state == FLOAT_EXP_DIGITS;
+}
+
+// append token, grows storage as needed, returns 0 on allocation failure
+static int addToken(PdTokenizer *tokenizer, int *count, PdTokenType type,
+                    const char *text, size_t length, int escaped) {
+	if(*count >= tokenizer->capacity) {
+		int capacity = (tokenizer->capacity ? tokenizer->capacity * 2 : DEFAULT_CAPACITY);
+		PdToken *tokens = (PdToken *)realloc(tokenizer->tokens, capacity * sizeof(PdToken));
+		if(!tokens) {
+			return 0;
+		}
+		tokenizer->tokens = tokens;
+		tokenizer->capacity = capacity;
+	}
+	PdToken *token = &tokenizer->tokens[(*count)++];
+	token->type = type;
+	token->text = text;
+	token->length = length;
+	token->escaped = escaped;
+	token->value = 0;
+	if(type == PD_TOKEN_FLOAT) {
+		char number[MAX_NUMBER];
+		if(length < MAX_NUMBER) {
+			memcpy(number, text, length);
+			number[length] = '\0';
+			token->value = strtod(number, NULL);
+		}
+		else {
+			token->type = PD_TOKEN_SYMBOL;
+		}
+	}
+	return 1;
+}
+
+int PdTokenizerParse(PdTokenizer *tokenizer, const char *text, size_t length,
+                     PdTokenizerCallback callback, void *userData) {
+	int lines = 0, count = 0;
+	const char *word = NULL; // current word start, NULL if between words
+	int escaped = 0, floatState = FLOAT_BEGIN;
+	size_t i = 0;
+	while(i <= length) {
+		char c = (i < length ? text[i] : ';'); // close a trailing line
+		int end = (i == length);
+
+		// backslash escapes the next char, which becomes part of the word
+		if(c == '\\' && !end) {
+			if(!word) {
+				word = text + i;
+				floatState = FLOAT_BEGIN;
+				escaped = 0;
+			}
+			escaped = 1;
+			i += (i + 1 < length ? 2 : 1);
+			continue;
+		}
+
+		int space = (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+		if(space || c == ';' || c == ',') {
+			if(word) {
+				size_t wordLength = (size_t)(text + i - word);
+				PdTokenType type = (!escaped && isFloatState(floatState) ?
+				                    PD_TOKEN_FLOAT : PD_TOKEN_SYMBOL);
+				if(!addToken(tokenizer, &count, type, word, wordLength, escaped)) {
+					return -1;
+				}
+				word = NULL;
+			}
+			if(c == ',') {
+				if(!addToken(tokenizer, &count, PD_TOKEN_COMMA, text + i, 1, 0)) {
+					return -1;
+				}
+			}
+			else if(c == ';') {
+				if(count > 0) {
+					callback(tokenizer->tokens, count, userData);
+					lines++;
+				}
+				count = 0;
+			}
+		}
+		else {
+			if(!word) {
+				word = text + i;
+				floatState = FLOAT_BEGIN;
+				escaped = 0;
+			}
+			floatState = nextFloatState(floatState, c);
+		}
+		i++;
+	}
+	return lines;
+}
+
+size_t PdTokenCopy(const PdToken *token, char *buffer, size_t size) {
+	size_t n = 0;
+	for(size_t i = 0; i < token->length; ++i) {
+		char c = token->text[i];
+		if(c == '\\' && token->escaped && i + 1 < token->length) {
+			c = token->text[++i];
+		}
+		if(n + 1 < size) {
+			buffer[n] = c;
+		}
+		n++;
+	}
+	if(size > 0) {
+		buffer[(n < size ? n : size - 1)] = '\0';
+	}
+	return n;
+}
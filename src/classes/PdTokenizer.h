@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#ifndef PDTOKENIZER_H
+#define PDTOKENIZER_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// token types
+typedef enum PdTokenType {
+	PD_TOKEN_FLOAT,  ///< number, value is set
+	PD_TOKEN_SYMBOL, ///< word
+	PD_TOKEN_COMMA   ///< unescaped comma
+} PdTokenType;
+
+/// a token within a patch line, text points into the patch text and is not
+/// null terminated, use PdTokenCopy() to get a symbol without escapes
+typedef struct PdToken {
+	PdTokenType type;
+	const char *text; ///< raw text, including any backslash escapes
+	size_t length;    ///< raw text length
+	int escaped;      ///< does the text contain backslash escapes?
+	double value;     ///< float value, 0 for other types
+} PdToken;
+
+/// line callback, tokens are valid for the duration of the callback only
+typedef void (*PdTokenizerCallback)(const PdToken *tokens, int count, void *userData);
+
+/// single pass Pd patch text tokenizer, splits text into lines on unescaped
+/// semicolons & lines into tokens on whitespace & unescaped commas,
+/// following the rules of pd's binbuf_text():
+///
+/// * a backslash escapes the next char, ie. "\;" "\," "\$" "\ "
+/// * words which look like numbers become floats unless escaped
+///
+/// tokens are views into the text, nothing is copied while tokenizing
+typedef struct PdTokenizer {
+	PdToken *tokens; ///< line token storage, grows as needed
+	int capacity;
+} PdTokenizer;
+
+/// init tokenizer
+void PdTokenizerInit(PdTokenizer *tokenizer);
+
+/// free token storage
+void PdTokenizerFree(PdTokenizer *tokenizer);
+
+/// tokenize text, calls back once per non-empty line, a trailing line
+/// without a semicolon is included, returns the number of lines or -1 if
+/// token storage could not be allocated
+int PdTokenizerParse(PdTokenizer *tokenizer, const char *text, size_t length,
+                     PdTokenizerCallback callback, void *userData);
+
+/// copy token text into buffer without escapes & null terminate, returns the
+/// unescaped length which may be larger than size - 1 if truncated
+size_t PdTokenCopy(const PdToken *token, char *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
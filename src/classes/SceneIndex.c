@@ -0,0 +1,590 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include "SceneIndex.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char magic[4] = {'P', 'd', 'S', 'I'};
+
+/// record string fields
+enum {
+	FIELD_PATH,
+	FIELD_NAME,
+	FIELD_AUTHOR,
+	FIELD_CATEGORY,
+	FIELD_OBJECTS,
+	FIELD_TEXT,
+	FIELD_COUNT
+};
+
+/// on disk record
+typedef struct SceneIndexFileRecord {
+	int64_t mtime;
+	uint32_t strings[FIELD_COUNT];
+	uint32_t type;
+	uint32_t reserved;
+} SceneIndexFileRecord;
+
+/// on disk term or trigram, key is a string offset or a trigram
+typedef struct {
+	uint32_t key;
+	uint32_t first;
+	uint32_t count;
+} FileEntry;
+
+/// on disk header
+typedef struct {
+	char magic[4];
+	uint32_t version;
+	uint32_t records;
+	uint32_t terms;
+	uint32_t trigrams;
+	uint32_t postings;
+	uint32_t stringsSize;
+	uint32_t reserved;
+} FileHeader;
+
+/// section pointers into the mapped file
+typedef struct {
+	const FileHeader *header;
+	const SceneIndexFileRecord *records;
+	const FileEntry *terms;
+	const FileEntry *trigrams;
+	const uint32_t *postings;
+	const char *strings;
+} Sections;
+
+static inline int isSpace(char c) {
+	return (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+}
+
+static inline uint32_t trigramAt(const char *c) {
+	return ((uint32_t)(uint8_t)c[0] << 16) | ((uint32_t)(uint8_t)c[1] << 8) | (uint8_t)c[2];
+}
+
+// set up section pointers, returns 0 if the sizes don't add up
+static int sections(const void *data, size_t size, Sections *s) {
+	if(size < sizeof(FileHeader)) {
+		return 0;
+	}
+	const FileHeader *h = (const FileHeader *)data;
+	uint64_t expected = sizeof(FileHeader) +
+		(uint64_t)h->records * sizeof(SceneIndexFileRecord) +
+		((uint64_t)h->terms + h->trigrams) * sizeof(FileEntry) +
+		(uint64_t)h->postings * sizeof(uint32_t) + h->stringsSize;
+	if(expected != size) {
+		return 0;
+	}
+	s->header = h;
+	s->records = (const SceneIndexFileRecord *)(h + 1);
+	s->terms = (const FileEntry *)(s->records + h->records);
+	s->trigrams = s->terms + h->terms;
+	s->postings = (const uint32_t *)(s->trigrams + h->trigrams);
+	s->strings = (const char *)(s->postings + h->postings);
+	return 1;
+}
+
+// reader
+
+// check strings end with a terminator & all offsets, ranges, & ids are in
+// bounds, terms & trigrams must be sorted for binary search
+static int validate(SceneIndex *index) {
+	Sections s;
+	if(!sections(index->data, index->size, &s)) {
+		return 0;
+	}
+	const FileHeader *h = s.header;
+	if(memcmp(h->magic, magic, 4) != 0 || h->version != SCENE_INDEX_VERSION ||
+	   h->stringsSize == 0 || s.strings[0] != '\0' ||
+	   s.strings[h->stringsSize - 1] != '\0') {
+		return 0;
+	}
+	for(uint32_t i = 0; i < h->records; ++i) {
+		for(int f = 0; f < FIELD_COUNT; ++f) {
+			if(s.records[i].strings[f] >= h->stringsSize) {
+				return 0;
+			}
+		}
+		if(s.records[i].type >= 32) {
+			return 0;
+		}
+	}
+	for(uint32_t i = 0; i < h->terms + h->trigrams; ++i) {
+		const FileEntry *e = &s.terms[i]; // trigrams follow terms
+		if(e->first > h->postings || e->count > h->postings - e->first) {
+			return 0;
+		}
+		if(i < h->terms) {
+			if(e->key >= h->stringsSize ||
+			   (i > 0 && strcmp(s.strings + s.terms[i - 1].key, s.strings + e->key) >= 0)) {
+				return 0;
+			}
+		}
+		else if(i > h->terms && s.terms[i - 1].key >= e->key) {
+			return 0;
+		}
+	}
+	for(uint32_t i = 0; i < h->postings; ++i) {
+		if(s.postings[i] >= h->records) {
+			return 0;
+		}
+	}
+	index->count = h->records;
+	return 1;
+}
+
+int SceneIndexOpen(SceneIndex *index, const char *path) {
+	struct stat st;
+	index->data = NULL;
+	index->size = 0;
+	index->count = 0;
+	int fd = open(path, O_RDONLY);
+	if(fd < 0) {
+		return 0;
+	}
+	if(fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return 0;
+	}
+	void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(data == MAP_FAILED) {
+		return 0;
+	}
+	index->data = data;
+	index->size = (size_t)st.st_size;
+	if(!validate(index)) {
+		SceneIndexClose(index);
+		return 0;
+	}
+	return 1;
+}
+
+void SceneIndexGetRecord(const SceneIndex *index, uint32_t i, SceneIndexRecord *record) {
+	Sections s;
+	sections(index->data, index->size, &s);
+	const SceneIndexFileRecord *r = &s.records[i];
+	record->path = s.strings + r->strings[FIELD_PATH];
+	record->name = s.strings + r->strings[FIELD_NAME];
+	record->author = s.strings + r->strings[FIELD_AUTHOR];
+	record->category = s.strings + r->strings[FIELD_CATEGORY];
+	record->objects = s.strings + r->strings[FIELD_OBJECTS];
+	record->text = s.strings + r->strings[FIELD_TEXT];
+	record->mtime = r->mtime;
+	record->type = r->type;
+}
+
+// set the bits of all records in a posting list
+static void markPostings(const Sections *s, const FileEntry *e, uint8_t *set) {
+	for(uint32_t i = 0; i < e->count; ++i) {
+		set[s->postings[e->first + i]] = 1;
+	}
+}
+
+// mark records with a word starting with prefix
+static void matchPrefix(const Sections *s, const char *prefix, size_t length, uint8_t *set) {
+	uint32_t lo = 0, hi = s->header->terms;
+	while(lo < hi) { // first term >= prefix
+		uint32_t mid = lo + (hi - lo) / 2;
+		if(strncmp(s->strings + s->terms[mid].key, prefix, length) < 0) {
+			lo = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
+	}
+	for(; lo < s->header->terms; ++lo) {
+		if(strncmp(s->strings + s->terms[lo].key, prefix, length) != 0) {
+			break;
+		}
+		markPostings(s, &s->terms[lo], set);
+	}
+}
+
+// find a trigram's postings, returns NULL if not found
+static const FileEntry *findTrigram(const Sections *s, uint32_t trigram) {
+	uint32_t lo = 0, hi = s->header->trigrams;
+	while(lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if(s->trigrams[mid].key < trigram) {
+			lo = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
+	}
+	if(lo < s->header->trigrams && s->trigrams[lo].key == trigram) {
+		return &s->trigrams[lo];
+	}
+	return NULL;
+}
+
+// mark records containing word: candidates are records with every trigram
+// of the word, checked against the text as the trigrams may be out of order
+static void matchSubstring(const Sections *s, const char *word, size_t length,
+                           uint8_t *set, uint8_t *scratch) {
+	uint32_t count = s->header->records;
+	char *needle = (char *)scratch + count; // scratch holds count + length + 1
+	memcpy(needle, word, length);
+	needle[length] = '\0';
+	for(size_t i = 0; i + 3 <= length; ++i) {
+		const FileEntry *e = findTrigram(s, trigramAt(word + i));
+		if(!e) {
+			memset(set, 0, count); // no matches
+			return;
+		}
+		if(i == 0) {
+			markPostings(s, e, set);
+		}
+		else {
+			memset(scratch, 0, count);
+			markPostings(s, e, scratch);
+			for(uint32_t r = 0; r < count; ++r) {
+				set[r] &= scratch[r];
+			}
+		}
+	}
+	for(uint32_t r = 0; r < count; ++r) {
+		if(set[r] && !strstr(s->strings + s->records[r].strings[FIELD_TEXT], needle)) {
+			set[r] = 0;
+		}
+	}
+}
+
+int SceneIndexSearch(const SceneIndex *index, const char *query, uint32_t typeMask,
+                     uint32_t *results, uint32_t max) {
+	Sections s;
+	if(index->count == 0 || !sections(index->data, index->size, &s)) {
+		return 0;
+	}
+	uint32_t count = index->count;
+	size_t queryLength = strlen(query);
+	uint8_t *matches = (uint8_t *)malloc(count);
+	uint8_t *word = (uint8_t *)malloc(count);
+	uint8_t *scratch = (uint8_t *)malloc(count + queryLength + 1);
+	if(!matches || !word || !scratch) {
+		free(matches);
+		free(word);
+		free(scratch);
+		return -1;
+	}
+	for(uint32_t r = 0; r < count; ++r) {
+		matches[r] = ((typeMask >> s.records[r].type) & 1);
+	}
+
+	// intersect the matches for each word
+	const char *c = query;
+	while(*c) {
+		while(isSpace(*c)) {
+			c++;
+		}
+		const char *start = c;
+		while(*c && !isSpace(*c)) {
+			c++;
+		}
+		size_t length = (size_t)(c - start);
+		if(length == 0) {
+			break;
+		}
+		memset(word, 0, count);
+		if(length < 3) {
+			matchPrefix(&s, start, length, word);
+		}
+		else {
+			matchSubstring(&s, start, length, word, scratch);
+		}
+		for(uint32_t r = 0; r < count; ++r) {
+			matches[r] &= word[r];
+		}
+	}
+
+	int found = 0;
+	for(uint32_t r = 0; r < count; ++r) {
+		if(matches[r]) {
+			if((uint32_t)found < max) {
+				results[found] = r;
+			}
+			found++;
+		}
+	}
+	free(matches);
+	free(word);
+	free(scratch);
+	return found;
+}
+
+void SceneIndexClose(SceneIndex *index) {
+	if(index->data) {
+		munmap(index->data, index->size);
+	}
+	index->data = NULL;
+	index->size = 0;
+	index->count = 0;
+}
+
+// builder
+
+/// a word in a record text, text points into the builder strings
+typedef struct {
+	const char *text;
+	uint32_t length;
+	uint32_t record;
+} TermPair;
+
+/// a trigram in a record text
+typedef struct {
+	uint32_t trigram;
+	uint32_t record;
+} TrigramPair;
+
+static int compareTermPairs(const void *a, const void *b) {
+	const TermPair *ta = (const TermPair *)a, *tb = (const TermPair *)b;
+	int result = memcmp(ta->text, tb->text, (ta->length < tb->length ? ta->length : tb->length));
+	if(result == 0 && ta->length != tb->length) {
+		result = (ta->length < tb->length ? -1 : 1);
+	}
+	if(result == 0 && ta->record != tb->record) {
+		result = (ta->record < tb->record ? -1 : 1);
+	}
+	return result;
+}
+
+static int compareTrigramPairs(const void *a, const void *b) {
+	const TrigramPair *ta = (const TrigramPair *)a, *tb = (const TrigramPair *)b;
+	if(ta->trigram != tb->trigram) {
+		return (ta->trigram < tb->trigram ? -1 : 1);
+	}
+	if(ta->record != tb->record) {
+		return (ta->record < tb->record ? -1 : 1);
+	}
+	return 0;
+}
+
+// grow a buffer to hold at least count elements, returns 0 on error
+static int reserve(void **buffer, size_t *capacity, size_t count, size_t elementSize) {
+	if(count <= *capacity) {
+		return 1;
+	}
+	size_t newCapacity = (*capacity ? *capacity * 2 : 64);
+	while(newCapacity < count) {
+		newCapacity *= 2;
+	}
+	void *newBuffer = realloc(*buffer, newCapacity * elementSize);
+	if(!newBuffer) {
+		return 0;
+	}
+	*buffer = newBuffer;
+	*capacity = newCapacity;
+	return 1;
+}
+
+// copy a string into the builder, returns its offset or 0 for "" & errors
+static uint32_t addString(SceneIndexBuilder *builder, const char *string, size_t length) {
+	if(!string || length == 0 || builder->error) {
+		return 0;
+	}
+	if(builder->stringsSize + length + 1 > UINT32_MAX ||
+	   !reserve((void **)&builder->strings, &builder->stringsCapacity,
+	            builder->stringsSize + length + 1, 1)) {
+		builder->error = 1;
+		return 0;
+	}
+	uint32_t offset = (uint32_t)builder->stringsSize;
+	memcpy(builder->strings + offset, string, length);
+	builder->strings[offset + length] = '\0';
+	builder->stringsSize += length + 1;
+	return offset;
+}
+
+void SceneIndexBuilderInit(SceneIndexBuilder *builder) {
+	memset(builder, 0, sizeof(SceneIndexBuilder));
+	if(!reserve((void **)&builder->strings, &builder->stringsCapacity, 1, 1)) {
+		builder->error = 1;
+		return;
+	}
+	builder->strings[0] = '\0'; // ""
+	builder->stringsSize = 1;
+}
+
+void SceneIndexBuilderAdd(SceneIndexBuilder *builder, const SceneIndexRecord *record) {
+	size_t capacity = builder->capacity;
+	if(builder->error ||
+	   !reserve((void **)&builder->records, &capacity, builder->count + 1, sizeof(SceneIndexFileRecord))) {
+		builder->error = 1;
+		return;
+	}
+	builder->capacity = (uint32_t)capacity;
+	const char *fields[FIELD_COUNT] = {
+		record->path, record->name, record->author,
+		record->category, record->objects, record->text
+	};
+	SceneIndexFileRecord *r = &builder->records[builder->count];
+	memset(r, 0, sizeof(SceneIndexFileRecord));
+	for(int f = 0; f < FIELD_COUNT; ++f) {
+		r->strings[f] = addString(builder, fields[f], fields[f] ? strlen(fields[f]) : 0);
+	}
+	r->mtime = record->mtime;
+	r->type = (record->type < 32 ? record->type : 31);
+	builder->count++;
+}
+
+static int writeBytes(FILE *file, const void *bytes, size_t length) {
+	return (length == 0 || fwrite(bytes, 1, length, file) == length);
+}
+
+int SceneIndexBuilderWrite(SceneIndexBuilder *builder, const char *path) {
+	TermPair *terms = NULL;
+	TrigramPair *trigrams = NULL;
+	FileEntry *entries = NULL;
+	uint32_t *postings = NULL;
+	size_t termCount = 0, termCapacity = 0;
+	size_t trigramCount = 0, trigramCapacity = 0;
+	size_t entryCount = 0, postingCount = 0;
+	uint32_t termEntries = 0;
+	char *tempPath = NULL;
+	FILE *file = NULL;
+	int ok = 0;
+	if(builder->error) {
+		return 0;
+	}
+
+	// room for the term strings up front as the pairs point into strings,
+	// the words of a text take at most its length + 1
+	size_t termBytes = 0;
+	for(uint32_t r = 0; r < builder->count; ++r) {
+		termBytes += strlen(builder->strings + builder->records[r].strings[FIELD_TEXT]) + 1;
+	}
+	if(builder->stringsSize + termBytes > UINT32_MAX ||
+	   !reserve((void **)&builder->strings, &builder->stringsCapacity,
+	            builder->stringsSize + termBytes, 1)) {
+		return 0;
+	}
+
+	// collect the words & trigrams of each record text
+	for(uint32_t r = 0; r < builder->count; ++r) {
+		const char *c = builder->strings + builder->records[r].strings[FIELD_TEXT];
+		while(*c) {
+			while(isSpace(*c)) {
+				c++;
+			}
+			const char *start = c;
+			while(*c && !isSpace(*c)) {
+				c++;
+			}
+			size_t length = (size_t)(c - start);
+			if(length == 0) {
+				break;
+			}
+			if(!reserve((void **)&terms, &termCapacity, termCount + 1, sizeof(TermPair)) ||
+			   !reserve((void **)&trigrams, &trigramCapacity, trigramCount + length, sizeof(TrigramPair))) {
+				goto done;
+			}
+			terms[termCount++] = (TermPair){start, (uint32_t)length, r};
+			for(size_t i = 0; i + 3 <= length; ++i) {
+				trigrams[trigramCount++] = (TrigramPair){trigramAt(start + i), r};
+			}
+		}
+	}
+	if(termCount) {
+		qsort(terms, termCount, sizeof(TermPair), compareTermPairs);
+	}
+	if(trigramCount) {
+		qsort(trigrams, trigramCount, sizeof(TrigramPair), compareTrigramPairs);
+	}
+
+	// group into entries with deduplicated postings, worst case one per pair
+	entries = (FileEntry *)malloc((termCount + trigramCount + 1) * sizeof(FileEntry));
+	postings = (uint32_t *)malloc((termCount + trigramCount + 1) * sizeof(uint32_t));
+	if(!entries || !postings) {
+		goto done;
+	}
+	for(size_t i = 0; i < termCount; ++i) {
+		if(i == 0 || terms[i].length != terms[i - 1].length ||
+		   memcmp(terms[i].text, terms[i - 1].text, terms[i].length) != 0) {
+			uint32_t key = addString(builder, terms[i].text, terms[i].length);
+			if(builder->error) {
+				goto done;
+			}
+			entries[entryCount++] = (FileEntry){key, (uint32_t)postingCount, 0};
+		}
+		else if(terms[i].record == terms[i - 1].record) {
+			continue; // duplicate word in record
+		}
+		postings[postingCount++] = terms[i].record;
+		entries[entryCount - 1].count++;
+	}
+	termEntries = (uint32_t)entryCount;
+	for(size_t i = 0; i < trigramCount; ++i) {
+		if(i == 0 || trigrams[i].trigram != trigrams[i - 1].trigram) {
+			entries[entryCount++] = (FileEntry){trigrams[i].trigram, (uint32_t)postingCount, 0};
+		}
+		else if(trigrams[i].record == trigrams[i - 1].record) {
+			continue;
+		}
+		postings[postingCount++] = trigrams[i].record;
+		entries[entryCount - 1].count++;
+	}
+
+	// write & move into place
+	tempPath = (char *)malloc(strlen(path) + 5);
+	if(!tempPath) {
+		goto done;
+	}
+	strcpy(tempPath, path);
+	strcat(tempPath, ".tmp");
+	file = fopen(tempPath, "wb");
+	if(!file) {
+		goto done;
+	}
+	FileHeader header;
+	memcpy(header.magic, magic, 4);
+	header.version = SCENE_INDEX_VERSION;
+	header.records = builder->count;
+	header.terms = termEntries;
+	header.trigrams = (uint32_t)(entryCount - termEntries);
+	header.postings = (uint32_t)postingCount;
+	header.stringsSize = (uint32_t)builder->stringsSize;
+	header.reserved = 0;
+	ok = (writeBytes(file, &header, sizeof(FileHeader)) &&
+	      writeBytes(file, builder->records, builder->count * sizeof(SceneIndexFileRecord)) &&
+	      writeBytes(file, entries, entryCount * sizeof(FileEntry)) &&
+	      writeBytes(file, postings, postingCount * sizeof(uint32_t)) &&
+	      writeBytes(file, builder->strings, builder->stringsSize));
+	if(fclose(file) != 0) {
+		ok = 0;
+	}
+	if(ok) {
+		ok = (rename(tempPath, path) == 0);
+	}
+	if(!ok) {
+		unlink(tempPath);
+	}
+
+done:
+	free(terms);
+	free(trigrams);
+	free(entries);
+	free(postings);
+	free(tempPath);
+	return ok;
+}
+
+void SceneIndexBuilderFree(SceneIndexBuilder *builder) {
+	free(builder->records);
+	free(builder->strings);
+	memset(builder, 0, sizeof(SceneIndexBuilder));
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#ifndef SCENEINDEX_H
+#define SCENEINDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// index file format version, bump when the format changes
+#define SCENE_INDEX_VERSION 2
+
+/// a scene record, strings are null terminated & point into the mapped index
+/// file when read, text is the folded search text for the record: lowercase
+/// words separated by whitespace which queries are matched against
+typedef struct SceneIndexRecord {
+	const char *path;     ///< scene path relative to the indexed directory
+	const char *name;     ///< display name
+	const char *author;   ///< author or ""
+	const char *category; ///< category or ""
+	const char *objects;  ///< space separated object names used or ""
+	const char *text;     ///< folded search text
+	int64_t mtime;        ///< modification stamp for incremental updates
+	uint32_t type;        ///< scene type, < 32 for type masks
+} SceneIndexRecord;
+
+/// compact scene library index with word prefix & trigram search, memory
+/// mapped & validated in full when opened so reading cannot fail
+///
+/// format, native byte order, sections in this order:
+///
+///   header:   "PdSI" magic, u32 version, u32 record count, u32 term count,
+///             u32 trigram count, u32 posting count, u32 strings size,
+///             u32 reserved
+///   records:  i64 mtime, u32 string offsets for path, name, author, category,
+///             objects, & text, u32 type, u32 reserved
+///   terms:    u32 string offset, u32 first posting, u32 posting count,
+///             sorted by term
+///   trigrams: u32 trigram, u32 first posting, u32 posting count, sorted by
+///             trigram
+///   postings: u32 record indices, ascending per term or trigram
+///   strings:  null terminated strings, starting with ""
+///
+/// terms are the distinct words of the record texts, trigrams are all 3 byte
+/// sequences within the words
+typedef struct SceneIndex {
+	void *data;
+	size_t size;
+	uint32_t count; ///< number of records
+} SceneIndex;
+
+/// map & validate the index file at path,
+/// returns 1 on success or 0 if the index is missing or invalid
+int SceneIndexOpen(SceneIndex *index, const char *path);
+
+/// get a record by index, i must be < count
+void SceneIndexGetRecord(const SceneIndex *index, uint32_t i, SceneIndexRecord *record);
+
+/// search for records matching all words in the query, the query must be
+/// folded the same way as the record texts: words shorter than 3 bytes match
+/// the start of a record word, longer words match anywhere in the record text,
+/// an empty query matches all records
+///
+/// only records whose type bit is set in typeMask are matched, ie.
+/// (1 << type), the matching record indices are written to results in
+/// ascending order up to max, returns the number of matches which may be
+/// larger than max or -1 if memory could not be allocated
+int SceneIndexSearch(const SceneIndex *index, const char *query, uint32_t typeMask,
+                     uint32_t *results, uint32_t max);
+
+/// unmap index file
+void SceneIndexClose(SceneIndex *index);
+
+struct SceneIndexFileRecord;
+
+/// index file builder, records are kept in memory in the order added until
+/// written
+typedef struct SceneIndexBuilder {
+	struct SceneIndexFileRecord *records; ///< string offsets into strings
+	uint32_t count;
+	uint32_t capacity;
+	char *strings;     ///< string storage
+	size_t stringsSize;
+	size_t stringsCapacity;
+	int error;
+} SceneIndexBuilder;
+
+/// init builder
+void SceneIndexBuilderInit(SceneIndexBuilder *builder);
+
+/// add a record, strings are copied & NULL strings are stored as ""
+void SceneIndexBuilderAdd(SceneIndexBuilder *builder, const SceneIndexRecord *record);
+
+/// build the search tables & write the index to a temporary file which
+/// replaces the file at path when finished so readers never see a partial
+/// index, returns 0 on error
+int SceneIndexBuilderWrite(SceneIndexBuilder *builder, const char *path);
+
+/// free records & strings
+void SceneIndexBuilderFree(SceneIndexBuilder *builder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
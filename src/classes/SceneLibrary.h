@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#import <Foundation/Foundation.h>
+
+/// posted on the main queue when an update has finished & the new index is
+/// in use, object is the library
+extern NSString *const SceneLibraryDidUpdateNotification;
+
+/// scene types
+typedef enum {
+	SceneLibraryTypePatch,      ///< single .pd file
+	SceneLibraryTypeRjScene,    ///< RjDj .rj directory
+	SceneLibraryTypeDroidScene, ///< DroidParty directory
+	SceneLibraryTypePartyScene  ///< PdParty directory
+} SceneLibraryType;
+
+/// type mask bit for a scene type
+#define SCENE_LIBRARY_TYPE_MASK(type) (1 << (type))
+
+/// type mask matching all scene types
+#define SCENE_LIBRARY_ALL_TYPES 0xFFFFFFFF
+
+/// an indexed scene
+@interface SceneLibraryItem : NSObject
+
+/// full path to the scene directory or patch
+@property (readonly, nonatomic) NSString *path;
+
+@property (readonly, nonatomic) SceneLibraryType type;
+
+/// info name or file name
+@property (readonly, nonatomic) NSString *name;
+
+/// info author or nil
+@property (readonly, nonatomic) NSString *author;
+
+/// info category or nil
+@property (readonly, nonatomic) NSString *category;
+
+/// sorted names of the objects created in the main patch, ie. "osc~"
+@property (readonly, nonatomic) NSArray<NSString *> *objects;
+
+@end
+
+/// persistent index of the scenes within a directory tree for instant search
+/// & type filtering, ie. for all of Documents
+///
+/// the index is a SceneIndex file which is memory mapped when opened, so the
+/// index from the last run is searchable right away, updates walk the tree on
+/// a background queue & only re-read the info & main patch of scenes whose
+/// modification stamp has changed
+///
+/// scene paths are stored relative to the directory, so the index survives the
+/// app container moving, ie. after an app update
+///
+/// the tree is not walked until searched: call setNeedsUpdate when files may
+/// have changed & the next search starts an update
+@interface SceneLibrary : NSObject
+
+/// indexed directory
+@property (readonly, nonatomic) NSString *directory;
+
+/// index file path
+@property (readonly, nonatomic) NSString *indexPath;
+
+/// number of indexed scenes
+@property (readonly, nonatomic) NSUInteger count;
+
+/// is an update running?
+@property (readonly, getter=isUpdating, nonatomic) BOOL updating;
+
+/// create a library for a directory, opens an existing index file
+- (instancetype)initWithDirectory:(NSString *)directory indexPath:(NSString *)indexPath;
+
+/// update the index in the background, an update requested while one is
+/// running is started once it finishes, posts SceneLibraryDidUpdateNotification
+- (void)update;
+
+/// mark the index as out of date so the next search starts an update, cheap
+/// to call whenever files may have changed, main queue only
+- (void)setNeedsUpdate;
+
+/// search scene names, authors, categories, file names, & object names,
+/// case & diacritic insensitive, all words in the query must match:
+/// words shorter than 3 characters match the start of a word, longer words
+/// match anywhere, an empty query matches all scenes of the given types
+///
+/// results are sorted by name, limit 0 for no limit, main queue only
+///
+/// searches the current index, starts an update if it is out of date: search
+/// again on SceneLibraryDidUpdateNotification for the updated results
+- (NSArray<SceneLibraryItem *> *)search:(NSString *)query
+                                  types:(uint32_t)typeMask
+                                  limit:(NSUInteger)limit;
+
+@end
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#import "SceneLibrary.h"
+
+#include <sys/stat.h>
+#include "SceneIndex.h"
+#include "PdTokenizer.h"
+#import "AllScenes.h"
+#import "Log.h"
+
+NSString *const SceneLibraryDidUpdateNotification = @"SceneLibraryDidUpdateNotification";
+
+/// max object name length in bytes
+#define SCENE_LIBRARY_OBJECT_LENGTH 256
+
+// returns the latest modification time of the given paths in ns,
+// missing paths are ignored
+static int64_t modificationStamp(NSArray<NSString *> *paths) {
+	int64_t stamp = 0;
+	for(NSString *path in paths) {
+		struct stat st;
+		if(stat(path.fileSystemRepresentation, &st) == 0) {
+			int64_t mtime = (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+			stamp = MAX(stamp, mtime);
+		}
+	}
+	return stamp;
+}
+
+// case, diacritic, & width folded lowercase text, not localized so the index
+// & queries fold the same regardless of the current locale
+static NSString *foldedString(NSString *string) {
+	return [string stringByFoldingWithOptions:(NSCaseInsensitiveSearch |
+	                                           NSDiacriticInsensitiveSearch |
+	                                           NSWidthInsensitiveSearch)
+	                                   locale:nil].lowercaseString;
+}
+
+// returns a string value from a scene info dictionary or nil
+static NSString *infoString(NSDictionary *info, NSString *key) {
+	id value = info[key];
+	return ([value isKindOfClass:NSString.class] && [value length] > 0 ? value : nil);
+}
+
+// PdTokenizer callback, adds the names of "#X obj x y name ..." lines
+static void SceneLibraryObjectLine(const PdToken *tokens, int count, void *userData) {
+	if(count < 5 || tokens[4].type != PD_TOKEN_SYMBOL ||
+	   tokens[0].length != 2 || strncmp(tokens[0].text, "#X", 2) != 0 ||
+	   tokens[1].length != 3 || strncmp(tokens[1].text, "obj", 3) != 0) {
+		return;
+	}
+	char name[SCENE_LIBRARY_OBJECT_LENGTH];
+	PdTokenCopy(&tokens[4], name, SCENE_LIBRARY_OBJECT_LENGTH);
+	NSString *string = [NSString stringWithUTF8String:name];
+	if(string) {
+		[(__bridge NSMutableSet *)userData addObject:string];
+	}
+}
+
+#pragma mark - SceneLibraryItem
+
+@interface SceneLibraryItem ()
+@property (readwrite, nonatomic) NSString *path;
+@property (readwrite, nonatomic) SceneLibraryType type;
+@property (readwrite, nonatomic) NSString *name;
+@property (readwrite, nonatomic) NSString *author;
+@property (readwrite, nonatomic) NSString *category;
+@property (readwrite, nonatomic) NSArray<NSString *> *objects;
+@property (strong, nonatomic) NSString *relativePath; ///< path in the index
+@property (strong, nonatomic) NSString *text; ///< folded search text
+@property (assign, nonatomic) int64_t stamp;  ///< modification stamp
+@end
+
+@implementation SceneLibraryItem
+
+// copy an index record, the record path is relative to the directory
++ (instancetype)itemWithRecord:(const SceneIndexRecord *)record directory:(NSString *)directory {
+	SceneLibraryItem *item = [[SceneLibraryItem alloc] init];
+	item.relativePath = [NSString stringWithUTF8String:record->path];
+	item.path = [directory stringByAppendingPathComponent:item.relativePath];
+	item.type = (SceneLibraryType)record->type;
+	item.name = [NSString stringWithUTF8String:record->name];
+	item.author = (record->author[0] ? [NSString stringWithUTF8String:record->author] : nil);
+	item.category = (record->category[0] ? [NSString stringWithUTF8String:record->category] : nil);
+	item.objects = (record->objects[0] ?
+		[[NSString stringWithUTF8String:record->objects] componentsSeparatedByString:@" "] : @[]);
+	item.text = [NSString stringWithUTF8String:record->text];
+	item.stamp = record->mtime;
+	return item;
+}
+
+@end
+
+#pragma mark - SceneLibrary
+
+@interface SceneLibrary () {
+	SceneIndex index;       ///< current index, main queue only
+	dispatch_queue_t queue; ///< update queue
+	BOOL needsUpdate;       ///< update again when finished?
+	BOOL stale;             ///< update on the next search?
+}
+@end
+
+@implementation SceneLibrary
+
+- (instancetype)initWithDirectory:(NSString *)directory indexPath:(NSString *)indexPath {
+	self = [super init];
+	if(self) {
+		_directory = directory;
+		_indexPath = indexPath;
+		queue = dispatch_queue_create("com.danomatika.PdParty.SceneLibrary", DISPATCH_QUEUE_SERIAL);
+		stale = YES; // pick up changes since the last run when first searched
+		if(!SceneIndexOpen(&index, indexPath.fileSystemRepresentation)) {
+			LogVerbose(@"SceneLibrary: no index at %@", indexPath);
+		}
+	}
+	return self;
+}
+
+- (void)dealloc {
+	SceneIndexClose(&index);
+}
+
+- (void)update {
+	if(_updating) {
+		needsUpdate = YES;
+		return;
+	}
+	_updating = YES;
+	dispatch_async(queue, ^{
+		BOOL changed = [self writeIndex];
+		dispatch_async(dispatch_get_main_queue(), ^{
+			if(changed) {
+				SceneIndexClose(&self->index);
+				if(!SceneIndexOpen(&self->index, self.indexPath.fileSystemRepresentation)) {
+					LogError(@"SceneLibrary: couldn't open index %@", self.indexPath);
+				}
+			}
+			self->_updating = NO;
+			[NSNotificationCenter.defaultCenter postNotificationName:SceneLibraryDidUpdateNotification
+			                                                  object:self];
+			if(self->needsUpdate) {
+				self->needsUpdate = NO;
+				[self update];
+			}
+		});
+	});
+}
+
+- (void)setNeedsUpdate {
+	stale = YES;
+}
+
+- (NSArray<SceneLibraryItem *> *)search:(NSString *)query
+                                  types:(uint32_t)typeMask
+                                  limit:(NSUInteger)limit {
+	if(stale) {
+		stale = NO;
+		[self update];
+	}
+	if(index.count == 0) {
+		return @[];
+	}
+	uint32_t max = ((limit == 0 || limit > index.count) ? index.count : (uint32_t)limit);
+	uint32_t *results = (uint32_t *)malloc(max * sizeof(uint32_t));
+	int found = (results ? SceneIndexSearch(&index, foldedString(query ?: @"").UTF8String,
+	                                        typeMask, results, max) : -1);
+	if(found < 0) {
+		LogError(@"SceneLibrary: couldn't allocate search results");
+		free(results);
+		return @[];
+	}
+	NSMutableArray *items = [NSMutableArray arrayWithCapacity:MIN((uint32_t)found, max)];
+	for(uint32_t i = 0; i < (uint32_t)found && i < max; ++i) {
+		SceneIndexRecord record;
+		SceneIndexGetRecord(&index, results[i], &record);
+		[items addObject:[SceneLibraryItem itemWithRecord:&record directory:self.directory]];
+	}
+	free(results);
+	return items;
+}
+
+#pragma mark Overridden Getters / Setters
+
+- (NSUInteger)count {
+	return index.count;
+}
+
+#pragma mark Private
+
+// walk the directory & write a new index if anything has changed, reusing
+// the records of unchanged scenes from the current index file,
+// returns YES if a new index was written
+- (BOOL)writeIndex {
+	NSDate *start = [NSDate date];
+
+	// current records by relative path, opened separately as the main queue's index
+	// may be replaced while walking
+	SceneIndex current;
+	SceneIndexRecord record;
+	BOOL hasCurrent = SceneIndexOpen(&current, self.indexPath.fileSystemRepresentation);
+	NSMutableDictionary<NSString *, NSNumber *> *currentRecords = [NSMutableDictionary dictionary];
+	for(uint32_t i = 0; hasCurrent && i < current.count; ++i) {
+		SceneIndexGetRecord(&current, i, &record);
+		currentRecords[[NSString stringWithUTF8String:record.path]] = @(i);
+	}
+
+	// find scene directories & patches, scene directories are not descended
+	NSMutableArray<SceneLibraryItem *> *items = [NSMutableArray array];
+	NSUInteger reused = 0;
+	NSDirectoryEnumerator *enumerator = [NSFileManager.defaultManager enumeratorAtPath:self.directory];
+	NSString *relativePath;
+	while((relativePath = enumerator.nextObject)) {
+		NSString *file = relativePath.lastPathComponent;
+		if([file hasPrefix:@"."] || [file isEqualToString:@"__MACOSX"] ||
+		   (enumerator.level == 1 && [file isEqualToString:@"Inbox"])) {
+			[enumerator skipDescendants];
+			continue;
+		}
+		NSString *path = [self.directory stringByAppendingPathComponent:relativePath];
+		NSString *fileType = enumerator.fileAttributes[NSFileType];
+		SceneLibraryType type;
+		NSArray *stampPaths; // scene modified if any of these are
+		NSString *mainPatch;
+		if([fileType isEqualToString:NSFileTypeDirectory]) {
+			if([RjScene isRjDjDirectory:path]) {
+				type = SceneLibraryTypeRjScene;
+				mainPatch = [path stringByAppendingPathComponent:@"_main.pd"];
+				stampPaths = @[path, mainPatch,
+				               [path stringByAppendingPathComponent:@"Info.plist"],
+				               [path stringByAppendingPathComponent:@"info.plist"]];
+			}
+			else if([DroidScene isDroidPartyDirectory:path]) {
+				type = SceneLibraryTypeDroidScene;
+				mainPatch = [path stringByAppendingPathComponent:@"droidparty_main.pd"];
+				stampPaths = @[path, mainPatch];
+			}
+			else if([PartyScene isPdPartyDirectory:path]) {
+				type = SceneLibraryTypePartyScene;
+				mainPatch = [path stringByAppendingPathComponent:@"_main.pd"];
+				stampPaths = @[path, mainPatch,
+				               [path stringByAppendingPathComponent:@"info.json"],
+				               [path stringByAppendingPathComponent:@"Info.json"]];
+			}
+			else {
+				continue;
+			}
+			[enumerator skipDescendants];
+		}
+		else if([fileType isEqualToString:NSFileTypeRegular] && [PatchScene isPatchFile:path]) {
+			type = SceneLibraryTypePatch;
+			mainPatch = path;
+			stampPaths = @[path];
+		}
+		else {
+			continue;
+		}
+
+		int64_t stamp = modificationStamp(stampPaths);
+		SceneLibraryItem *item = nil;
+		NSNumber *i = currentRecords[relativePath];
+		if(i) {
+			SceneIndexGetRecord(&current, i.unsignedIntValue, &record);
+			if(record.mtime == stamp && record.type == type) {
+				item = [SceneLibraryItem itemWithRecord:&record directory:self.directory];
+				reused++;
+			}
+		}
+		if(!item) {
+			item = [self itemForScene:path type:type mainPatch:mainPatch];
+			item.relativePath = relativePath;
+			item.stamp = stamp;
+		}
+		[items addObject:item];
+	}
+	NSUInteger currentCount = current.count;
+	SceneIndexClose(&current);
+	if(hasCurrent && reused == items.count && items.count == currentCount) {
+		LogVerbose(@"SceneLibrary: %lu scenes unchanged", (unsigned long)items.count);
+		return NO;
+	}
+
+	// write sorted by name so search results are too
+	[items sortUsingComparator:^NSComparisonResult(SceneLibraryItem *a, SceneLibraryItem *b) {
+		NSComparisonResult result = [a.name localizedStandardCompare:b.name];
+		return (result == NSOrderedSame ? [a.path compare:b.path] : result);
+	}];
+	SceneIndexBuilder builder;
+	SceneIndexBuilderInit(&builder);
+	for(SceneLibraryItem *item in items) {
+		record.path = item.relativePath.UTF8String;
+		record.name = item.name.UTF8String;
+		record.author = item.author.UTF8String;
+		record.category = item.category.UTF8String;
+		record.objects = [item.objects componentsJoinedByString:@" "].UTF8String;
+		record.text = item.text.UTF8String;
+		record.mtime = item.stamp;
+		record.type = item.type;
+		SceneIndexBuilderAdd(&builder, &record);
+	}
+	BOOL written = SceneIndexBuilderWrite(&builder, self.indexPath.fileSystemRepresentation);
+	SceneIndexBuilderFree(&builder);
+	if(!written) {
+		LogError(@"SceneLibrary: couldn't write index %@", self.indexPath);
+		return NO;
+	}
+	LogVerbose(@"SceneLibrary: indexed %lu scenes, %lu reused, in %.3f s",
+		(unsigned long)items.count, (unsigned long)reused, -start.timeIntervalSinceNow);
+	return YES;
+}
+
+// read the info & main patch of a scene
+- (SceneLibraryItem *)itemForScene:(NSString *)path type:(SceneLibraryType)type mainPatch:(NSString *)mainPatch {
+	SceneLibraryItem *item = [[SceneLibraryItem alloc] init];
+	NSDictionary *info = nil;
+	item.path = path;
+	item.type = type;
+	switch(type) {
+		case SceneLibraryTypeRjScene:
+			info = [RjScene infoForSceneAt:path];
+			item.name = path.lastPathComponent.stringByDeletingPathExtension;
+			break;
+		case SceneLibraryTypePartyScene:
+			info = [PartyScene infoForSceneAt:path];
+			item.name = path.lastPathComponent;
+			break;
+		case SceneLibraryTypeDroidScene:
+			item.name = path.lastPathComponent;
+			break;
+		case SceneLibraryTypePatch:
+			item.name = path.lastPathComponent.stringByDeletingPathExtension;
+			break;
+	}
+	if(infoString(info, @"name")) {
+		item.name = infoString(info, @"name");
+	}
+	item.author = infoString(info, @"author");
+	item.category = infoString(info, @"category");
+
+	// object names used by the main patch, abstractions are not opened
+	NSMutableSet *objects = [NSMutableSet set];
+	NSData *data = [NSData dataWithContentsOfFile:mainPatch options:NSDataReadingMappedIfSafe error:nil];
+	if(data.length > 0) {
+		PdTokenizer tokenizer;
+		PdTokenizerInit(&tokenizer);
+		PdTokenizerParse(&tokenizer, (const char *)data.bytes, data.length,
+		                 SceneLibraryObjectLine, (__bridge void *)objects);
+		PdTokenizerFree(&tokenizer);
+	}
+	item.objects = [objects.allObjects sortedArrayUsingSelector:@selector(compare:)];
+
+	NSMutableArray *words = [NSMutableArray arrayWithObjects:item.name, path.lastPathComponent, nil];
+	if(item.author) {
+		[words addObject:item.author];
+	}
+	if(item.category) {
+		[words addObject:item.category];
+	}
+	[words addObjectsFromArray:item.objects];
+	item.text = foldedString([words componentsJoinedByString:@" "]);
+	return item;
+}
+
+@end
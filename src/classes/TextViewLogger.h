@@ -2,27 +2,41 @@
 
 #import "Log.h"
 
-/// a threadsafe Lumberjack logger that writes to a given text view
+/// max number of lines kept
+#define TEXTVIEWLOGGER_MAX_LINES 1000
+
+/// a threadsafe logger that writes to a given text view
+///
+/// lines are kept in a fixed size ring buffer, the oldest lines are dropped
+/// when full, the text view is refreshed at most once per frame by appending
+/// the new lines to its text storage & removing the dropped ones from the top
 @interface TextViewLogger : Logger <UIScrollViewDelegate>
 
 /// set this as the target for text updates
 @property (weak, nonatomic) UITextView *textView;
 
-/// backing log line data
-@property (strong, readonly, atomic) NSMutableString *text;
+/// current log lines joined by newlines
+@property (readonly, atomic) NSString *text;
+
+/// number of lines in the buffer
 @property (readonly, atomic) NSInteger lineCount;
 
+/// number of old lines dropped as the buffer was full since the last clear
+@property (readonly, atomic) NSUInteger droppedLineCount;
+
 /// is the automatic scroll animated? (default: NO),
 /// animated scrolling looks nicer but can lose track of the contentOffset
 /// if log lines are coming in very quickly while the textView is scrolling
 @property (assign, nonatomic) BOOL animateScroll;
 
-/// adds a line to the log data, appends to textView if set
-/// removes oldest line if we're at the limit
+/// adds a line to the log data, lines with embedded endlines are split,
+/// removes the oldest line if we're at the limit & schedules a text view
+/// refresh if set
 - (void)addLine:(NSString *)line;
 
-/// update the text view if set, scrolls to bottom if the textView is not
-/// currenly scrolling and at the contentOffset is close to the bottom already
+/// refresh the whole text view on the next frame if set, scrolls to bottom
+/// if the textView is not currenly scrolling and the contentOffset is close
+/// to the bottom already
 - (void)update;
 
 /// clear the buffer and textView if set
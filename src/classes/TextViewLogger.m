@@ -1,10 +1,19 @@
 #import "TextViewLogger.h"
 
-#define MAX_LINES 1000
+@interface TextViewLogger () {
+	// ring buffer of lines, guarded by @synchronized(self)
+	NSMutableArray<NSString *> *lines;
+	NSUInteger start;     ///< index of the oldest line once full
+	NSUInteger pending;   ///< lines added since the last refresh
+	BOOL needsReset;      ///< replace the whole text on the next refresh?
+	BOOL attached;        ///< is a text view set?
+	BOOL scheduled;       ///< is a refresh scheduled?
 
-@interface TextViewLogger () {}
-@property (strong, readwrite, atomic) NSMutableString *text;
-@property (readwrite, atomic) NSInteger lineCount;
+	// main queue only
+	CADisplayLink *refreshLink; ///< refreshes once per frame while scheduled
+	NSUInteger displayedLines;  ///< number of lines in the text view
+}
+@property (readwrite, atomic) NSUInteger droppedLineCount;
 @end
 
 @implementation TextViewLogger
@@ -12,67 +21,53 @@
 - (id)init {
 	self = [super init];
 	if(self) {
-		self.text = [NSMutableString string];
-		self.lineCount = 0;
+		lines = [NSMutableArray arrayWithCapacity:TEXTVIEWLOGGER_MAX_LINES];
 		self.animateScroll = NO;
 	}
 	return self;
 }
 
-- (void)addLine:(NSString*)line {
+- (void)dealloc {
+	[refreshLink invalidate];
+}
+
+- (void)addLine:(NSString *)line {
+	NSArray *split = ([line rangeOfString:@"\n"].location == NSNotFound ?
+		@[line] : [line componentsSeparatedByString:@"\n"]);
 	@synchronized(self) {
-		// append & catch any embedded endlines
-		[self.text appendFormat:@"%@%@", (self.lineCount > 0 ? @"\n" : @""), line];
-		self.lineCount += [[line componentsSeparatedByString:@"\n"] count];
-		
-		// pop oldest lines
-		while(self.lineCount >= MAX_LINES) {
-			NSRange endline = [self.text rangeOfString:@"\n"];
-			[self.text deleteCharactersInRange:NSMakeRange(0, endline.location+1)];
-			self.lineCount--;
+		for(NSString *l in split) {
+			if(lines.count < TEXTVIEWLOGGER_MAX_LINES) {
+				[lines addObject:l];
+			}
+			else { // overwrite oldest
+				lines[start] = l;
+				start = (start + 1) % TEXTVIEWLOGGER_MAX_LINES;
+				_droppedLineCount++;
+			}
 		}
-		
-		// update textview, if any
-		[self update];
+		pending = MIN(pending + split.count, TEXTVIEWLOGGER_MAX_LINES);
+		if(pending == TEXTVIEWLOGGER_MAX_LINES) {
+			needsReset = YES; // nothing displayed is left
+		}
+		[self scheduleRefresh];
 	}
 }
 
 - (void)update {
 	@synchronized(self) {
-		if(self.textView) {
-			dispatch_async(dispatch_get_main_queue(), ^{
-				BOOL scroll = NO;
-				int contentHeight = self.textView.contentSize.height - self.textView.font.lineHeight*2;
-				// scroll up for new lines if we're not scrolling and within the last 2 lines
-				if((contentHeight >= CGRectGetHeight(self.textView.bounds)) &&
-				   (!self.textView.tracking && !self.textView.dragging &&
-				    !self.textView.decelerating && !self.textView.zooming) &&
-				   (CGRectGetHeight(self.textView.bounds) + self.textView.contentOffset.y >= contentHeight)) {
-					scroll = YES;
-				}
-				[self updateText];
-				if(scroll) {
-					if(self.animateScroll) {
-						[self.textView scrollRangeToVisible:NSMakeRange(self.textView.text.length-1, 1)];
-					}
-					else {
-						// from http://stackoverflow.com/questions/29022962/scroll-uitextview-to-bottom-without-animation
-						CGPoint bottomOffset = CGPointMake(0, self.textView.contentSize.height - self.textView.bounds.size.height);
-						[self.textView setContentOffset:bottomOffset animated:NO];
-					}
-				}
-			});
-		}
+		needsReset = YES;
+		[self scheduleRefresh];
 	}
 }
 
 - (void)clear {
 	@synchronized(self) {
-		if(self.textView) {
-			self.textView.text = @"";
-		}
-		[self.text setString:@""];
-		self.lineCount = 0;
+		[lines removeAllObjects];
+		start = 0;
+		pending = 0;
+		_droppedLineCount = 0;
+		needsReset = YES;
+		[self scheduleRefresh];
 	}
 }
 
@@ -80,27 +75,145 @@
 
 - (void)logMessage:(NSString *)message {
 	if(!message) {return;}
-	@synchronized(self) {
-		[self addLine:message];
-	}
+	[self addLine:message];
 }
 
 #pragma mark Overridden Getters/Setters
 
 - (void)setTextView:(UITextView *)textView {
 	_textView = textView;
+	if(textView) {
+		if(!refreshLink) {
+			refreshLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(refresh:)];
+			refreshLink.paused = YES;
+			[refreshLink addToRunLoop:NSRunLoop.mainRunLoop forMode:NSRunLoopCommonModes];
+		}
+	}
+	else {
+		[refreshLink invalidate]; // link retains self
+		refreshLink = nil;
+	}
+	@synchronized(self) {
+		attached = (textView != nil);
+		scheduled = NO;
+	}
+	displayedLines = 0;
 	[self update];
 }
 
+- (NSString *)text {
+	@synchronized(self) {
+		return [[self linesFromIndex:0] componentsJoinedByString:@"\n"];
+	}
+}
+
+- (NSInteger)lineCount {
+	@synchronized(self) {
+		return lines.count;
+	}
+}
+
 #pragma mark Private
 
-- (void)updateText {
+// wake the refresh link if a text view is set, call while synchronized
+- (void)scheduleRefresh {
+	if(!attached || scheduled) {
+		return;
+	}
+	scheduled = YES;
+	dispatch_async(dispatch_get_main_queue(), ^{
+		self->refreshLink.paused = NO;
+	});
+}
+
+// lines from the given logical index to the newest, call while synchronized
+- (NSArray<NSString *> *)linesFromIndex:(NSUInteger)index {
+	NSUInteger count = lines.count;
+	NSMutableArray *result = [NSMutableArray arrayWithCapacity:count - index];
+	for(NSUInteger i = index; i < count; ++i) {
+		[result addObject:lines[(start + i) % count]];
+	}
+	return result;
+}
+
+// apply the lines added since the last refresh to the text view, called by
+// the refresh link at most once per frame
+- (void)refresh:(CADisplayLink *)link {
+	NSArray *newLines;
+	BOOL reset;
+	@synchronized(self) {
+		reset = needsReset;
+		newLines = [self linesFromIndex:(reset ? 0 : lines.count - pending)];
+		pending = 0;
+		needsReset = NO;
+		scheduled = NO;
+	}
+	link.paused = YES;
+	UITextView *textView = self.textView;
+	if(!textView) {
+		return;
+	}
+
+	// scroll up for new lines if we're not scrolling and within the last 2 lines
+	BOOL scroll = NO;
+	CGFloat contentHeight = textView.contentSize.height - textView.font.lineHeight * 2;
+	if((contentHeight >= CGRectGetHeight(textView.bounds)) &&
+	   (!textView.tracking && !textView.dragging &&
+	    !textView.decelerating && !textView.zooming) &&
+	   (CGRectGetHeight(textView.bounds) + textView.contentOffset.y >= contentHeight)) {
+		scroll = YES;
+	}
+
 	// temporarily disable scrolling to avoid occasional bug that causes text
 	// view being cut off towards the top: http://stackoverflow.com/a/19797795/2146055
-	BOOL enabled = self.textView.scrollEnabled;
-		self.textView.scrollEnabled = NO;
-		self.textView.text = self.text;
-	self.textView.scrollEnabled = enabled;
+	BOOL enabled = textView.scrollEnabled;
+	textView.scrollEnabled = NO;
+	NSTextStorage *storage = textView.textStorage;
+	NSDictionary *attributes = textView.typingAttributes;
+	[storage beginEditing];
+	if(reset) {
+		NSString *string = [newLines componentsJoinedByString:@"\n"];
+		[storage setAttributedString:[[NSAttributedString alloc] initWithString:string attributes:attributes]];
+		displayedLines = newLines.count;
+	}
+	else if(newLines.count > 0) {
+		NSString *string = [newLines componentsJoinedByString:@"\n"];
+		if(displayedLines > 0) {
+			string = [@"\n" stringByAppendingString:string];
+		}
+		[storage appendAttributedString:[[NSAttributedString alloc] initWithString:string attributes:attributes]];
+		displayedLines += newLines.count;
+
+		// remove the lines dropped from the buffer from the top
+		if(displayedLines > TEXTVIEWLOGGER_MAX_LINES) {
+			NSString *text = storage.string;
+			NSUInteger end = 0;
+			for(NSUInteger i = displayedLines - TEXTVIEWLOGGER_MAX_LINES; i > 0; --i) {
+				NSRange endline = [text rangeOfString:@"\n" options:NSLiteralSearch
+				                                range:NSMakeRange(end, text.length - end)];
+				if(endline.location == NSNotFound) {
+					end = text.length;
+					break;
+				}
+				end = NSMaxRange(endline);
+			}
+			[storage deleteCharactersInRange:NSMakeRange(0, end)];
+			displayedLines = TEXTVIEWLOGGER_MAX_LINES;
+		}
+	}
+	[storage endEditing];
+	textView.scrollEnabled = enabled;
+
+	if(scroll && storage.length > 0) {
+		if(self.animateScroll) {
+			[textView scrollRangeToVisible:NSMakeRange(storage.length - 1, 1)];
+		}
+		else {
+			// from http://stackoverflow.com/questions/29022962/scroll-uitextview-to-bottom-without-animation
+			CGPoint bottomOffset = CGPointMake(0, textView.contentSize.height - textView.bounds.size.height);
+			[textView setContentOffset:bottomOffset animated:NO];
+		}
+	}
 }
 
 @end
@@ -20,7 +20,8 @@
 /// returns YES when opened successfully
 - (BOOL)open:(NSString *)path;
 
-/// unzip to a given location,
+/// unzip to a given location, entries are extracted concurrently,
+/// existing files are skipped unless overwrite is set,
 /// returns YES on success
 - (BOOL)unzipTo:(NSString *)path overwrite:(BOOL)overwrite;
 
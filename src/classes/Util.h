@@ -72,6 +72,12 @@
 /// full path to the Documents directory
 + (NSString *)documentsPath;
 
+/// full path to the Library/Caches directory
++ (NSString *)cachesPath;
+
+/// full path to the Library/Application Support directory, may not exist yet
++ (NSString *)applicationSupportPath;
+
 /// returns YES if given path exists and is a directory
 + (BOOL)isDirectory:(NSString *)path;
 
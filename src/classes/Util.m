@@ -11,6 +11,7 @@
 #import "Util.h"
 
 #import "Log.h"
+#import "ZipMount.h"
 #import <CoreText/CoreText.h>
 #import <CoreLocation/CoreLocation.h>
 
@@ -118,6 +119,16 @@
 	return searchPaths.firstObject;
 }
 
++ (NSString *)cachesPath {
+	NSArray *searchPaths = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES);
+	return searchPaths.firstObject;
+}
+
++ (NSString *)applicationSupportPath {
+	NSArray *searchPaths = NSSearchPathForDirectoriesInDomains(NSApplicationSupportDirectory, NSUserDomainMask, YES);
+	return searchPaths.firstObject;
+}
+
 + (BOOL)isDirectory:(NSString *)path {
 	BOOL isDir = NO;
 	[NSFileManager.defaultManager fileExistsAtPath:path isDirectory:&isDir];
@@ -193,7 +204,7 @@
 	NSMutableArray *found = [NSMutableArray array];
 	for(NSString *file in filenames) {
 		NSString *filePath = [dir stringByAppendingPathComponent:file];
-		if([NSFileManager.defaultManager fileExistsAtPath:filePath]) {
+		if([ZipMount fileExistsAtPath:filePath]) {
 			[found addObject:file];
 		}
 	}
@@ -255,7 +266,7 @@
 /// try loading first as registration fails if the font is already available
 + (NSString *)registerFont:(NSString *)fontPath {
 	NSString *name = nil;
-	NSData *inData = [NSData dataWithContentsOfFile:fontPath];
+	NSData *inData = [ZipMount dataWithContentsOfFile:fontPath];
 	if(!inData) {return nil;}
 	CFErrorRef error;
 	CGDataProviderRef provider = CGDataProviderCreateWithCFData((__bridge CFDataRef)inData);
@@ -291,8 +302,13 @@
 #pragma mark JSON
 
 + (id)parseJSONFromFile:(NSString *)path {
+	NSData *json = [ZipMount dataWithContentsOfFile:path];
+	if(!json) {
+		LogError(@"Util: couldn't read JSON from %@", path);
+		return nil;
+	}
 	NSError *error;
-	id data = [NSJSONSerialization JSONObjectWithData:[NSData dataWithContentsOfFile:path] options:0 error:&error];
+	id data = [NSJSONSerialization JSONObjectWithData:json options:0 error:&error];
 	if(!data) {
 		LogError(@"Util: parsing JSON from %@ failed: %@", path, error.debugDescription);
 	}
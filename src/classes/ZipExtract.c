@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include "ZipExtract.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include "minizip/unzip.h"
+#include "minizip/iommap.h"
+
+// min file entries per worker, small archives aren't worth the threads
+#define MIN_ENTRIES_PER_THREAD 8
+
+// central directory entry
+typedef struct Entry {
+	char *path;          // destination path
+	unz64_file_pos pos;  // central directory position
+	int directory;       // is this a directory?
+	tm_unz date;         // modification date
+	unsigned long crc;   // data crc32
+} Entry;
+
+// shared extraction state
+typedef struct Extractor {
+	const char *zipPath;
+	Entry *entries;
+	unsigned long count;
+	unsigned long next;  // next entry to claim, atomic
+	int overwrite;
+} Extractor;
+
+// worker thread & its own results
+typedef struct Worker {
+	pthread_t thread;
+	Extractor *extractor;
+	ZipExtractStats stats;
+} Worker;
+
+enum {
+	RESULT_OK,
+	RESULT_SKIPPED,
+	RESULT_ERROR
+};
+
+int ZipExtractSanitizePath(const char *name, char *path, size_t size) {
+	size_t n = 0;
+	const char *c = name;
+	while(*c) {
+		// next component, either separator ends it
+		const char *start = c;
+		while(*c && *c != '/' && *c != '\\') {
+			c++;
+		}
+		size_t length = (size_t)(c - start);
+		if(*c) {
+			c++;
+		}
+		if(length == 0 || (length == 1 && start[0] == '.')) {
+			continue; // leading, doubled, or trailing separator or "."
+		}
+		if(length == 2 && start[0] == '.' && start[1] == '.') {
+			return 0; // escapes the destination
+		}
+		if(n + (n > 0) + length + 1 > size) {
+			return 0;
+		}
+		if(n > 0) {
+			path[n++] = '/';
+		}
+		memcpy(path + n, start, length);
+		n += length;
+	}
+	if(n == 0) {
+		return 0;
+	}
+	path[n] = '\0';
+	return 1;
+}
+
+// create a directory & any missing parents, the path is not modified
+static int makeDirectories(const char *path) {
+	char buffer[PATH_MAX];
+	size_t length = strlen(path);
+	if(length >= PATH_MAX) {
+		return 0;
+	}
+	memcpy(buffer, path, length + 1);
+	for(size_t i = 1; i <= length; ++i) {
+		if(buffer[i] == '/' || buffer[i] == '\0') {
+			char c = buffer[i];
+			buffer[i] = '\0';
+			if(mkdir(buffer, 0755) != 0 && errno != EEXIST) {
+				return 0;
+			}
+			buffer[i] = c;
+		}
+	}
+	return 1;
+}
+
+// set file modification time from the zip entry, local time
+static void setDate(const char *path, const tm_unz *date) {
+	struct tm t;
+	memset(&t, 0, sizeof(struct tm));
+	t.tm_sec = (int)date->tm_sec;
+	t.tm_min = (int)date->tm_min;
+	t.tm_hour = (int)date->tm_hour;
+	t.tm_mday = (int)date->tm_mday;
+	t.tm_mon = (int)date->tm_mon;
+	t.tm_year = (int)date->tm_year - 1900;
+	t.tm_isdst = -1;
+	time_t seconds = mktime(&t);
+	if(seconds != (time_t)-1) {
+		struct timeval times[2] = {{seconds, 0}, {seconds, 0}};
+		utimes(path, times);
+	}
+}
+
+// write all bytes, retrying short writes
+static int writeAll(int fd, const unsigned char *bytes, size_t length) {
+	while(length > 0) {
+		ssize_t written = write(fd, bytes, length);
+		if(written < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			return 0;
+		}
+		bytes += written;
+		length -= (size_t)written;
+	}
+	return 1;
+}
+
+// write stored entry data straight from the archive mapping & check its crc,
+// returns 1 on success
+static int writeStored(int fd, const unsigned char *data, unsigned long long size,
+                       unsigned long crc, unsigned long long *written) {
+	uLong check = crc32(0L, Z_NULL, 0);
+	while(size > 0) {
+		uInt length = (size > ZIP_EXTRACT_BUFFER_SIZE ? ZIP_EXTRACT_BUFFER_SIZE : (uInt)size);
+		check = crc32(check, data, length);
+		if(!writeAll(fd, data, length)) {
+			return 0;
+		}
+		data += length;
+		size -= length;
+		*written += length;
+	}
+	return (check == crc);
+}
+
+// inflate entry data through a buffer, returns 1 on success
+static int writeInflated(int fd, unzFile zip, unsigned char *buffer,
+                         unsigned long long *written) {
+	if(unzOpenCurrentFile(zip) != UNZ_OK) {
+		return 0;
+	}
+	int ok = 1, read;
+	while((read = unzReadCurrentFile(zip, buffer, ZIP_EXTRACT_BUFFER_SIZE)) > 0) {
+		if(!writeAll(fd, buffer, (size_t)read)) {
+			ok = 0;
+			break;
+		}
+		*written += (unsigned long long)read;
+	}
+	if(read < 0) {
+		ok = 0;
+	}
+	if(unzCloseCurrentFile(zip) != UNZ_OK) {
+		ok = 0; // crc mismatch
+	}
+	return ok;
+}
+
+static int extractEntry(Extractor *extractor, unzFile zip, const mmap_filefunc_mapping *mapping,
+                        const Entry *entry, unsigned char *buffer, unsigned long long *bytes) {
+	unz64_file_pos pos = entry->pos;
+	if(unzGoToFilePos64(zip, &pos) != UNZ_OK) {
+		return RESULT_ERROR;
+	}
+	int flags = O_WRONLY | O_CREAT | (extractor->overwrite ? O_TRUNC : O_EXCL);
+	int fd = open(entry->path, flags, 0644);
+	if(fd < 0) {
+		return (errno == EEXIST ? RESULT_SKIPPED : RESULT_ERROR);
+	}
+	int ok;
+	unsigned long long written = 0;
+	ZPOS64_T dataPos, dataSize;
+	if(mapping->data &&
+	   unzGetCurrentFileStoredPos64(zip, &dataPos, &dataSize) == UNZ_OK &&
+	   dataPos <= mapping->size && dataSize <= mapping->size - dataPos) {
+		// stored, no need to copy through the buffer
+		ok = writeStored(fd, mapping->data + dataPos, dataSize, entry->crc, &written);
+	}
+	else {
+		ok = writeInflated(fd, zip, buffer, &written);
+	}
+	if(close(fd) != 0) {
+		ok = 0;
+	}
+	if(!ok) {
+		unlink(entry->path); // don't leave a partial file behind
+		return RESULT_ERROR;
+	}
+	setDate(entry->path, &entry->date);
+	*bytes += written;
+	return RESULT_OK;
+}
+
+// claim & extract file entries until there are none left
+static void *work(void *userData) {
+	Worker *worker = (Worker *)userData;
+	Extractor *extractor = worker->extractor;
+	zlib_filefunc64_def filefunc;
+	mmap_filefunc_mapping mapping = {NULL, 0};
+	fill_mmap_filefunc64(&filefunc, &mapping);
+	unzFile zip = unzOpen2_64(extractor->zipPath, &filefunc);
+	if(!zip) {
+		zip = unzOpen64(extractor->zipPath); // couldn't map, use stdio
+	}
+	unsigned char *buffer = (unsigned char *)malloc(ZIP_EXTRACT_BUFFER_SIZE);
+	if(!zip || !buffer) {
+		// other workers take the remaining entries
+		if(zip) {unzClose(zip);}
+		free(buffer);
+		return NULL;
+	}
+	while(1) {
+		unsigned long i = __atomic_fetch_add(&extractor->next, 1, __ATOMIC_RELAXED);
+		if(i >= extractor->count) {
+			break;
+		}
+		const Entry *entry = &extractor->entries[i];
+		if(entry->directory || !entry->path) {
+			continue; // created beforehand or rejected
+		}
+		switch(extractEntry(extractor, zip, &mapping, entry, buffer, &worker->stats.bytes)) {
+			case RESULT_OK:
+				worker->stats.files++;
+				break;
+			case RESULT_SKIPPED:
+				worker->stats.skipped++;
+				break;
+			default:
+				worker->stats.errors++;
+				break;
+		}
+	}
+	free(buffer);
+	unzClose(zip);
+	return NULL;
+}
+
+// read the central directory into entries & create directories in order,
+// entries outside of directory are left out if it's set
+static int readEntries(unzFile zip, const char *directory, const char *destPath,
+                       Extractor *extractor, ZipExtractStats *stats, unsigned long *files) {
+	unz_global_info64 info;
+	if(unzGetGlobalInfo64(zip, &info) != UNZ_OK) {
+		return 0;
+	}
+	extractor->entries = (Entry *)calloc(info.number_entry ? info.number_entry : 1, sizeof(Entry));
+	if(!extractor->entries) {
+		return 0;
+	}
+	char name[PATH_MAX], relative[PATH_MAX], path[PATH_MAX], lastDirectory[PATH_MAX];
+	size_t destLength = strlen(destPath);
+	size_t directoryLength = (directory ? strlen(directory) : 0);
+	lastDirectory[0] = '\0';
+	int ret = unzGoToFirstFile(zip);
+	for(ZPOS64_T i = 0; ret == UNZ_OK && i < info.number_entry; ++i) {
+		unz_file_info64 fileInfo;
+		if(unzGetCurrentFileInfo64(zip, &fileInfo, name, sizeof(name), NULL, 0, NULL, 0) != UNZ_OK) {
+			return 0;
+		}
+		if(directoryLength > 0 && strncmp(name, directory, directoryLength) != 0) {
+			ret = unzGoToNextFile(zip);
+			continue;
+		}
+		Entry *entry = &extractor->entries[extractor->count++];
+		if(unzGetFilePos64(zip, &entry->pos) != UNZ_OK) {
+			return 0;
+		}
+		size_t nameLength = strlen(name);
+		entry->directory = (nameLength > 0 && (name[nameLength-1] == '/' || name[nameLength-1] == '\\'));
+		entry->date = fileInfo.tmu_date;
+		entry->crc = fileInfo.crc;
+		if(fileInfo.size_filename >= sizeof(name) ||
+		   !ZipExtractSanitizePath(name, relative, sizeof(relative)) ||
+		   destLength + 1 + strlen(relative) + 1 > sizeof(path)) {
+			stats->rejected++;
+			ret = unzGoToNextFile(zip);
+			continue;
+		}
+		snprintf(path, sizeof(path), "%s/%s", destPath, relative);
+		entry->path = strdup(path);
+		if(!entry->path) {
+			return 0;
+		}
+
+		// create directory or file parent, skip repeats as entries are
+		// usually grouped by directory
+		if(!entry->directory) {
+			*strrchr(path, '/') = '\0';
+		}
+		if(strcmp(path, lastDirectory) != 0) {
+			if(!makeDirectories(path)) {
+				stats->errors++;
+				free(entry->path);
+				entry->path = NULL;
+			}
+			else {
+				strcpy(lastDirectory, path);
+			}
+		}
+		if(entry->path && !entry->directory) {
+			(*files)++;
+		}
+		ret = unzGoToNextFile(zip);
+	}
+	stats->entries = extractor->count;
+	return (ret == UNZ_OK || ret == UNZ_END_OF_LIST_OF_FILE);
+}
+
+int ZipExtract(const char *zipPath, const char *destPath, int overwrite,
+               int threads, ZipExtractStats *stats) {
+	return ZipExtractDirectory(zipPath, NULL, destPath, overwrite, threads, stats);
+}
+
+int ZipExtractDirectory(const char *zipPath, const char *directory, const char *destPath,
+                        int overwrite, int threads, ZipExtractStats *stats) {
+	ZipExtractStats results;
+	memset(&results, 0, sizeof(ZipExtractStats));
+	Extractor extractor;
+	memset(&extractor, 0, sizeof(Extractor));
+	extractor.zipPath = zipPath;
+	extractor.overwrite = overwrite;
+
+	// read central directory once
+	unsigned long files = 0;
+	unzFile zip = unzOpen64(zipPath);
+	if(!zip) {
+		if(stats) {*stats = results;}
+		return 0;
+	}
+	int ok = readEntries(zip, directory, destPath, &extractor, &results, &files);
+	unzClose(zip);
+
+	if(ok) {
+		// choose worker count, calling thread is a worker too
+		if(threads <= 0) {
+			long cores = sysconf(_SC_NPROCESSORS_ONLN);
+			threads = (cores > 0 ? (int)cores : 1);
+		}
+		if(threads > ZIP_EXTRACT_MAX_THREADS) {
+			threads = ZIP_EXTRACT_MAX_THREADS;
+		}
+		if((unsigned long)threads > files / MIN_ENTRIES_PER_THREAD) {
+			threads = (int)(files / MIN_ENTRIES_PER_THREAD);
+		}
+		if(threads < 1) {
+			threads = 1;
+		}
+		Worker workers[ZIP_EXTRACT_MAX_THREADS];
+		memset(workers, 0, sizeof(workers));
+		int started = 1;
+		for(int i = 0; i < threads; ++i) {
+			workers[i].extractor = &extractor;
+		}
+		for(int i = 1; i < threads; ++i) {
+			if(pthread_create(&workers[i].thread, NULL, work, &workers[i]) != 0) {
+				break;
+			}
+			started++;
+		}
+		work(&workers[0]);
+		for(int i = 1; i < started; ++i) {
+			pthread_join(workers[i].thread, NULL);
+		}
+		unsigned long done = 0;
+		for(int i = 0; i < started; ++i) {
+			results.files += workers[i].stats.files;
+			results.skipped += workers[i].stats.skipped;
+			results.errors += workers[i].stats.errors;
+			results.bytes += workers[i].stats.bytes;
+			done += workers[i].stats.files + workers[i].stats.skipped + workers[i].stats.errors;
+		}
+		results.threads = started;
+
+		// entries left unclaimed if no worker could open the zip
+		if(done < files) {
+			results.errors += files - done;
+		}
+	}
+
+	for(unsigned long i = 0; i < extractor.count; ++i) {
+		free(extractor.entries[i].path);
+	}
+	free(extractor.entries);
+	if(stats) {*stats = results;}
+	return (ok && results.errors == 0);
+}
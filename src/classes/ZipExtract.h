@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#ifndef ZIPEXTRACT_H
+#define ZIPEXTRACT_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// max worker threads
+#define ZIP_EXTRACT_MAX_THREADS 8
+
+/// read & write buffer size per worker
+#define ZIP_EXTRACT_BUFFER_SIZE (256 * 1024)
+
+/// extraction results
+typedef struct ZipExtractStats {
+	unsigned long entries;  ///< entries read, within the directory if set
+	unsigned long files;    ///< files written
+	unsigned long skipped;  ///< existing files which were not overwritten
+	unsigned long rejected; ///< entries with unsafe paths, ie. "../file"
+	unsigned long errors;   ///< entries which could not be extracted
+	unsigned long long bytes; ///< bytes written
+	int threads;            ///< worker threads used
+} ZipExtractStats;
+
+/// extract all entries of a zip file into a destination directory
+///
+/// the central directory is read once, then directories are created in
+/// order & file entries are inflated concurrently by a pool of workers,
+/// each with its own memory-mapped handle to the zip file which jumps
+/// directly to an entry, file data is written in large blocks & stored
+/// entries are written straight from the mapping
+///
+/// entry paths are sanitized: backslashes become slashes, leading slashes
+/// & "." components are removed, & entries with ".." components are
+/// rejected so nothing is written outside of the destination
+///
+/// threads is the number of workers, 0 chooses from the number of cores,
+/// existing files are skipped unless overwrite is set,
+/// stats are optional, returns 1 on success or 0 if the zip file could not
+/// be read or any entry failed
+int ZipExtract(const char *zipPath, const char *destPath, int overwrite,
+               int threads, ZipExtractStats *stats);
+
+/// extract only the entries within a directory of a zip file, ie. "Scene/",
+/// into the destination directory keeping their paths, matching is done on
+/// the entry names as stored, NULL or "" extracts all entries, see ZipExtract()
+int ZipExtractDirectory(const char *zipPath, const char *directory, const char *destPath,
+                        int overwrite, int threads, ZipExtractStats *stats);
+
+/// sanitize a zip entry name into a relative path, see ZipExtract(),
+/// returns 1 if the path is safe & fits into size or 0 if not
+int ZipExtractSanitizePath(const char *name, char *path, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#import <Foundation/Foundation.h>
+
+/// archive cache size limit in bytes
+#define ZIPMOUNT_CACHE_SIZE (256 * 1024 * 1024)
+
+/// read-only view of a zip archive so scenes can be run without importing
+///
+/// members are read straight out of the memory-mapped archive & located by
+/// its hashed name index, libpd opens patches, abstractions, & sound files by
+/// path so only those are extracted, one by one, into the archive's cache
+/// directory in Library/Application Support/Archives, least recently used
+/// archives are removed when the cache grows past its size limit unless a
+/// scene has written files into its directory
+///
+/// paths within the cache directory of a live mount are backed by the
+/// archive, see fileExistsAtPath: & dataWithContentsOfFile:, so the scene
+/// classes & PdParser read info, images, & patches which were not extracted
+/// straight from the archive
+@interface ZipMount : NSObject
+
+/// archive path
+@property (readonly, nonatomic) NSString *path;
+
+/// shallowest directory holding a scene main patch, ie. "_main.pd" or
+/// "droidparty_main.pd", with a trailing slash, "" for the archive root or
+/// nil if there is no scene
+@property (readonly, nonatomic) NSString *sceneDirectory;
+
+/// cache directory for this version of the archive, members are extracted
+/// into it keeping their archive paths
+@property (readonly, nonatomic) NSString *cachePath;
+
+/// returns the shared mount for an archive, reopened if the archive has
+/// changed since, or nil if it couldn't be opened
++ (instancetype)mountForArchive:(NSString *)path;
+
+/// returns YES if the archive has a member with the given name
+- (BOOL)hasEntry:(NSString *)name;
+
+/// read a member without extracting it, stored members reference the
+/// mapping instead of being copied, returns nil if not found or corrupt
+- (NSData *)dataForEntry:(NSString *)name;
+
+/// returns the real path of a member, extracting it first if needed,
+/// or nil on failure
+- (NSString *)pathForEntry:(NSString *)name;
+
+/// extract the scene main patch & the members its patches reference for
+/// libpd: abstractions & files named in the patches, relative to the patch,
+/// the scene directory, or [declare -path] directories, & the files matching
+/// "%" patterns, ie. "samples/%d.wav", returns the real path of the scene
+/// directory or nil on failure
+- (NSString *)extractScene;
+
+#pragma mark Mounted Paths
+
+/// returns YES if a file exists at path, on disk or as a member of a live
+/// mount which was not extracted
++ (BOOL)fileExistsAtPath:(NSString *)path;
+
+/// read a file on disk or a member of a live mount without extracting it,
+/// returns nil if not found
++ (NSData *)dataWithContentsOfFile:(NSString *)path;
+
+#pragma mark Cache
+
+/// remove least recently used archive caches until the cache fits within
+/// ZIPMOUNT_CACHE_SIZE, archives with a live mount or files written by a
+/// scene are kept
++ (void)trimCache;
+
+@end
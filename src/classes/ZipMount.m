@@ -0,0 +1,615 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#import "ZipMount.h"
+
+#include <limits.h>
+#include <sys/stat.h>
+#include "minizip/unzip.h"
+#include "minizip/iommap.h"
+#include "ZipExtract.h"
+#include "PatchCache.h"
+#include "PdTokenizer.h"
+#import "Log.h"
+#import "Util.h"
+
+/// marks a cache directory, dated like the archive as are the extracted
+/// members, so files newer than the stamp were written by the scene
+#define EXTRACTED_STAMP @".extracted"
+
+/// max length in bytes of a patch symbol checked for a member name
+#define ZIPMOUNT_SYMBOL_LENGTH 1024
+
+static NSMapTable *s_mounts = nil; ///< live mounts by archive path, weak
+
+// returns YES if a token is the given symbol
+static BOOL tokenIs(const PdToken *token, const char *symbol) {
+	size_t length = strlen(symbol);
+	return token->type == PD_TOKEN_SYMBOL && token->length == length &&
+	       strncmp(token->text, symbol, length) == 0;
+}
+
+// PdTokenizer callback, collects the symbols of a patch into the "symbols"
+// set & [declare -path] directories into the "paths" set of a dictionary
+static void ZipMountPatchLine(const PdToken *tokens, int count, void *userData) {
+	NSDictionary *references = (__bridge NSDictionary *)userData;
+	BOOL declare = (count > 1 && tokenIs(&tokens[1], "declare"));
+	char text[ZIPMOUNT_SYMBOL_LENGTH];
+	for(int i = 1; i < count; ++i) {
+		if(tokens[i].type != PD_TOKEN_SYMBOL ||
+		   PdTokenCopy(&tokens[i], text, ZIPMOUNT_SYMBOL_LENGTH) >= ZIPMOUNT_SYMBOL_LENGTH) {
+			continue;
+		}
+		NSString *symbol = [NSString stringWithUTF8String:text];
+		if(!symbol) {
+			continue;
+		}
+		if(declare && tokenIs(&tokens[i - 1], "-path")) {
+			[references[@"paths"] addObject:symbol];
+		}
+		else {
+			[references[@"symbols"] addObject:symbol];
+		}
+	}
+}
+
+// resolve a name relative to an archive directory into a member name,
+// returns nil for absolute names, dollar args, or ".." leaving the archive
+static NSString *memberName(NSString *directory, NSString *name) {
+	if(name.length == 0 || [name hasPrefix:@"/"] || [name rangeOfString:@"$"].location != NSNotFound) {
+		return nil;
+	}
+	NSMutableArray *components = [NSMutableArray array];
+	NSString *path = [NSString stringWithFormat:@"%@/%@", directory, name];
+	for(NSString *component in [path componentsSeparatedByString:@"/"]) {
+		if(component.length == 0 || [component isEqualToString:@"."]) {
+			continue;
+		}
+		if([component isEqualToString:@".."]) {
+			if(components.count == 0) {
+				return nil;
+			}
+			[components removeLastObject];
+			continue;
+		}
+		[components addObject:component];
+	}
+	return (components.count > 0 ? [components componentsJoinedByString:@"/"] : nil);
+}
+
+@interface ZipMount () {
+	unzFile zip;
+	mmap_filefunc_mapping mapping; ///< set while the archive is mapped
+	off_t size;                    ///< archive size when opened
+	struct timespec mtime;         ///< archive modification time when opened
+	NSArray<NSString *> *members;  ///< file member names, listed when needed
+}
+@end
+
+@implementation ZipMount
+
++ (instancetype)mountForArchive:(NSString *)path {
+	struct stat st;
+	if(stat(path.fileSystemRepresentation, &st) != 0) {
+		return nil;
+	}
+	@synchronized(ZipMount.class) {
+		if(!s_mounts) {
+			s_mounts = [NSMapTable strongToWeakObjectsMapTable];
+		}
+		ZipMount *mount = [s_mounts objectForKey:path];
+		if(mount && mount->size == st.st_size &&
+		   mount->mtime.tv_sec == st.st_mtimespec.tv_sec &&
+		   mount->mtime.tv_nsec == st.st_mtimespec.tv_nsec) {
+			return mount;
+		}
+		mount = [[ZipMount alloc] initWithPath:path stat:&st];
+		if(mount) {
+			[s_mounts setObject:mount forKey:path];
+		}
+		return mount;
+	}
+}
+
+- (instancetype)initWithPath:(NSString *)path stat:(const struct stat *)st {
+	self = [super init];
+	if(self) {
+		zlib_filefunc64_def filefunc;
+		fill_mmap_filefunc64(&filefunc, &mapping);
+		zip = unzOpen2_64(path.fileSystemRepresentation, &filefunc);
+		if(!zip) {
+			zip = unzOpen64(path.fileSystemRepresentation); // couldn't map, use stdio
+		}
+		if(!zip) {
+			LogError(@"ZipMount: couldn't open %@", path.lastPathComponent);
+			return nil;
+		}
+		_path = path;
+		size = st->st_size;
+		mtime = st->st_mtimespec;
+		_sceneDirectory = [self findSceneDirectory];
+
+		// cache directory name is a hash of the archive path, size, and
+		// modification time, so a changed archive gets a fresh directory
+		NSString *key = [NSString stringWithFormat:@"%@:%lld:%ld.%09ld",
+			path, (long long)size, (long)mtime.tv_sec, (long)mtime.tv_nsec];
+		NSString *name = [NSString stringWithFormat:@"%@-%016llx",
+			path.lastPathComponent.stringByDeletingPathExtension,
+			(unsigned long long)PatchCacheHash(key.UTF8String)];
+		_cachePath = [[ZipMount archivesPath] stringByAppendingPathComponent:name];
+	}
+	return self;
+}
+
+- (void)dealloc {
+	if(zip) {
+		unzClose(zip);
+	}
+}
+
+- (BOOL)hasEntry:(NSString *)name {
+	@synchronized(self) {
+		return unzLocateFileIndexed(zip, name.UTF8String, 1) == UNZ_OK;
+	}
+}
+
+- (NSData *)dataForEntry:(NSString *)name {
+	@synchronized(self) {
+		unz_file_info64 info;
+		if(unzLocateFileIndexed(zip, name.UTF8String, 1) != UNZ_OK ||
+		   unzGetCurrentFileInfo64(zip, &info, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK) {
+			return nil;
+		}
+
+		// stored, reference the mapping & keep the mount alive with the data
+		ZPOS64_T pos, length;
+		if(mapping.data &&
+		   unzGetCurrentFileStoredPos64(zip, &pos, &length) == UNZ_OK &&
+		   pos <= mapping.size && length <= mapping.size - pos) {
+			const unsigned char *bytes = mapping.data + pos;
+			uLong crc = crc32(0L, Z_NULL, 0);
+			for(ZPOS64_T offset = 0; offset < length; offset += ZIP_EXTRACT_BUFFER_SIZE) {
+				uInt chunk = (uInt)MIN(length - offset, ZIP_EXTRACT_BUFFER_SIZE);
+				crc = crc32(crc, bytes + offset, chunk);
+			}
+			if(crc != info.crc) {
+				LogError(@"ZipMount: crc mismatch for %@ in %@", name, self.path.lastPathComponent);
+				return nil;
+			}
+			ZipMount *mount = self;
+			return [[NSData alloc] initWithBytesNoCopy:(void *)bytes
+			                                    length:(NSUInteger)length
+			                               deallocator:^(void *mapped, NSUInteger mappedLength) {
+				(void)mount;
+			}];
+		}
+
+		// compressed, inflate into a new buffer
+		NSMutableData *data = [NSMutableData dataWithLength:(NSUInteger)info.uncompressed_size];
+		if(!data || unzOpenCurrentFile(zip) != UNZ_OK) {
+			return nil;
+		}
+		unsigned char *bytes = data.mutableBytes;
+		NSUInteger offset = 0;
+		int read = 0;
+		while(offset < data.length) {
+			unsigned chunk = (unsigned)MIN(data.length - offset, ZIP_EXTRACT_BUFFER_SIZE);
+			read = unzReadCurrentFile(zip, bytes + offset, chunk);
+			if(read <= 0) {
+				break;
+			}
+			offset += read;
+		}
+		if(unzCloseCurrentFile(zip) != UNZ_OK || read < 0 || offset != data.length) {
+			LogError(@"ZipMount: couldn't read %@ in %@", name, self.path.lastPathComponent);
+			return nil;
+		}
+		return data;
+	}
+}
+
+- (NSString *)pathForEntry:(NSString *)name {
+	NSString *path = [self extractEntry:name];
+	if(path) {
+		[self touch];
+	}
+	return path;
+}
+
+- (NSString *)extractScene {
+	if(!self.sceneDirectory) {
+		return nil;
+	}
+	NSDate *start = [NSDate date];
+	NSString *scene = self.sceneDirectory;
+	NSString *sceneDir = (scene.length > 0 ? [scene substringToIndex:scene.length - 1] : @"");
+	NSString *mainPatch = [scene stringByAppendingString:@"_main.pd"];
+	if(![self hasEntry:mainPatch]) {
+		mainPatch = [scene stringByAppendingString:@"droidparty_main.pd"];
+	}
+
+	// find the members the patches reference, abstractions are followed
+	NSMutableSet *found = [NSMutableSet setWithObject:mainPatch];
+	NSMutableArray *patches = [NSMutableArray arrayWithObject:mainPatch];
+	PdTokenizer tokenizer;
+	PdTokenizerInit(&tokenizer);
+	while(patches.count > 0) {
+		NSString *patch = patches.lastObject;
+		[patches removeLastObject];
+		NSData *data = [self dataForEntry:patch];
+		if(data.length == 0) {
+			continue;
+		}
+		NSDictionary *references = @{@"symbols": [NSMutableSet set], @"paths": [NSMutableSet set]};
+		PdTokenizerParse(&tokenizer, (const char *)data.bytes, data.length,
+		                 ZipMountPatchLine, (__bridge void *)references);
+
+		// names are opened relative to the patch, the scene directory search
+		// path, & declared paths
+		NSString *patchDir = patch.stringByDeletingLastPathComponent;
+		NSMutableOrderedSet *directories = [NSMutableOrderedSet orderedSetWithObjects:patchDir, sceneDir, nil];
+		for(NSString *path in references[@"paths"]) {
+			NSString *directory = memberName(patchDir, path);
+			if(directory) {
+				[directories addObject:directory];
+			}
+		}
+		for(NSString *symbol in references[@"symbols"]) {
+			for(NSString *directory in directories) {
+				NSArray *names;
+				if([symbol rangeOfString:@"%"].location != NSNotFound) {
+					names = [self membersMatchingPattern:symbol inDirectory:directory];
+				}
+				else {
+					names = @[symbol, [symbol stringByAppendingPathExtension:@"pd"]];
+				}
+				for(NSString *name in names) {
+					NSString *member = memberName(directory, name);
+					if(!member || [found containsObject:member] || ![self hasEntry:member]) {
+						continue;
+					}
+					[found addObject:member];
+					if([member.pathExtension isEqualToString:@"pd"]) {
+						[patches addObject:member];
+					}
+				}
+			}
+		}
+	}
+	PdTokenizerFree(&tokenizer);
+
+	// make room first, members already extracted are kept as is
+	[ZipMount trimCache];
+	if(![self extractEntry:mainPatch]) {
+		LogError(@"ZipMount: couldn't extract %@ from %@", mainPatch, self.path.lastPathComponent);
+		return nil;
+	}
+	NSUInteger errors = 0;
+	for(NSString *member in found) {
+		if(![self extractEntry:member]) {
+			errors++;
+		}
+	}
+	[self touch];
+	LogVerbose(@"ZipMount: %lu members for %@ in %@ ready in %.3f s, %lu errors",
+		(unsigned long)found.count, mainPatch.lastPathComponent, self.path.lastPathComponent,
+		-start.timeIntervalSinceNow, (unsigned long)errors);
+	return [self.cachePath stringByAppendingPathComponent:sceneDir];
+}
+
+#pragma mark Mounted Paths
+
++ (BOOL)fileExistsAtPath:(NSString *)path {
+	if([NSFileManager.defaultManager fileExistsAtPath:path]) {
+		return YES;
+	}
+	NSString *entry = nil;
+	ZipMount *mount = [ZipMount mountForPath:path entry:&entry];
+	return (mount && [mount hasEntry:entry]);
+}
+
++ (NSData *)dataWithContentsOfFile:(NSString *)path {
+	NSData *data = [NSData dataWithContentsOfFile:path];
+	if(data) {
+		return data;
+	}
+	NSString *entry = nil;
+	ZipMount *mount = [ZipMount mountForPath:path entry:&entry];
+	return (mount ? [mount dataForEntry:entry] : nil);
+}
+
+#pragma mark Cache
+
++ (void)trimCache {
+	[self trimCacheToSize:ZIPMOUNT_CACHE_SIZE];
+}
+
+#pragma mark Private
+
+// find the shallowest directory holding a scene main patch, the archive root
+// & a directory named like the archive are looked up in the name index, any
+// other layout is found in the member list
+- (NSString *)findSceneDirectory {
+	NSString *name = self.path.lastPathComponent.stringByDeletingPathExtension;
+	for(NSString *directory in @[@"", [name stringByAppendingString:@"/"],
+	                             [name stringByAppendingString:@".rj/"]]) {
+		if([self hasEntry:[directory stringByAppendingString:@"_main.pd"]] ||
+		   [self hasEntry:[directory stringByAppendingString:@"droidparty_main.pd"]]) {
+			return directory;
+		}
+	}
+	NSString *scene = nil;
+	NSUInteger sceneDepth = NSUIntegerMax;
+	for(NSString *member in [self members]) {
+		NSString *file = member.lastPathComponent;
+		if([file isEqualToString:@"_main.pd"] || [file isEqualToString:@"droidparty_main.pd"]) {
+			NSUInteger depth = member.pathComponents.count;
+			if(depth < sceneDepth) {
+				sceneDepth = depth;
+				scene = [member substringToIndex:member.length - file.length];
+			}
+		}
+	}
+	return scene;
+}
+
+// file member names without macOS resource forks, listed once
+- (NSArray<NSString *> *)members {
+	@synchronized(self) {
+		if(members) {
+			return members;
+		}
+		NSMutableArray *list = [NSMutableArray array];
+		char name[PATH_MAX];
+		int ret = unzGoToFirstFile(zip);
+		while(ret == UNZ_OK) {
+			unz_file_info64 info;
+			if(unzGetCurrentFileInfo64(zip, &info, name, sizeof(name), NULL, 0, NULL, 0) != UNZ_OK) {
+				break;
+			}
+			ret = unzGoToNextFile(zip);
+			NSString *member = [[NSString stringWithUTF8String:name] stringByReplacingOccurrencesOfString:@"\\" withString:@"/"];
+			if(member.length > 0 && ![member hasSuffix:@"/"] && ![member hasPrefix:@"__MACOSX/"]) {
+				[list addObject:member];
+			}
+		}
+		members = list;
+		return members;
+	}
+}
+
+// names of the files in the directory of a "%" pattern relative to directory,
+// ie. "samples/%d.wav", with the same extension, or all if it has none
+- (NSArray<NSString *> *)membersMatchingPattern:(NSString *)pattern inDirectory:(NSString *)directory {
+	NSString *patternDir = pattern.stringByDeletingLastPathComponent;
+	NSString *memberDir = (patternDir.length > 0 ? memberName(directory, patternDir) : directory);
+	if(!memberDir) {
+		return @[];
+	}
+	NSString *prefix = (memberDir.length > 0 ? [memberDir stringByAppendingString:@"/"] : @"");
+	NSString *extension = pattern.pathExtension;
+	NSMutableArray *names = [NSMutableArray array];
+	for(NSString *member in [self members]) {
+		if(![member hasPrefix:prefix] || [[member substringFromIndex:prefix.length] rangeOfString:@"/"].location != NSNotFound) {
+			continue;
+		}
+		if(extension.length == 0 || [member.pathExtension isEqualToString:extension]) {
+			[names addObject:[patternDir stringByAppendingPathComponent:member.lastPathComponent]];
+		}
+	}
+	return names;
+}
+
+// extract a member into the cache directory unless it's there, dated like
+// the archive, returns the real path or nil on failure
+- (NSString *)extractEntry:(NSString *)name {
+	char relative[PATH_MAX];
+	if(!ZipExtractSanitizePath(name.UTF8String, relative, sizeof(relative))) {
+		return nil;
+	}
+	NSString *path = [self.cachePath stringByAppendingPathComponent:@(relative)];
+	NSFileManager *fm = NSFileManager.defaultManager;
+	if([fm fileExistsAtPath:path]) {
+		return path;
+	}
+	if(![self createCachePath]) {
+		return nil;
+	}
+	NSError *error;
+	if(![fm createDirectoryAtPath:path.stringByDeletingLastPathComponent
+	  withIntermediateDirectories:YES
+	                   attributes:nil
+	                        error:&error]) {
+		LogError(@"ZipMount: couldn't create directory for %@, error: %@", name, error.localizedDescription);
+		return nil;
+	}
+
+	// stream in chunks so large members aren't held in memory
+	NSString *tempPath = [path stringByAppendingString:@".part"];
+	FILE *file = fopen(tempPath.fileSystemRepresentation, "wb");
+	if(!file) {
+		LogError(@"ZipMount: couldn't write %@", tempPath);
+		return nil;
+	}
+	BOOL success = NO;
+	@synchronized(self) {
+		if(unzLocateFileIndexed(zip, name.UTF8String, 1) == UNZ_OK && unzOpenCurrentFile(zip) == UNZ_OK) {
+			unsigned char *buffer = malloc(ZIP_EXTRACT_BUFFER_SIZE);
+			int read = 0;
+			success = (buffer != NULL);
+			while(success && (read = unzReadCurrentFile(zip, buffer, ZIP_EXTRACT_BUFFER_SIZE)) > 0) {
+				success = (fwrite(buffer, 1, read, file) == (size_t)read);
+			}
+			free(buffer);
+			success = (unzCloseCurrentFile(zip) == UNZ_OK && success && read == 0); // checks the crc
+		}
+	}
+	success = (fclose(file) == 0 && success);
+	if(!success || rename(tempPath.fileSystemRepresentation, path.fileSystemRepresentation) != 0) {
+		LogError(@"ZipMount: couldn't extract %@ from %@", name, self.path.lastPathComponent);
+		unlink(tempPath.fileSystemRepresentation);
+		return nil;
+	}
+	[fm setAttributes:@{NSFileModificationDate: [self archiveDate]} ofItemAtPath:path error:nil];
+	return path;
+}
+
+// archive modification date when opened
+- (NSDate *)archiveDate {
+	return [NSDate dateWithTimeIntervalSince1970:mtime.tv_sec + mtime.tv_nsec * 1e-9];
+}
+
+// create the cache directory & its stamp dated like the archive
+- (BOOL)createCachePath {
+	NSFileManager *fm = NSFileManager.defaultManager;
+	NSString *stamp = [self.cachePath stringByAppendingPathComponent:EXTRACTED_STAMP];
+	if([fm fileExistsAtPath:stamp]) {
+		return YES;
+	}
+	[ZipMount createArchivesPath];
+	NSError *error;
+	if(![fm createDirectoryAtPath:self.cachePath withIntermediateDirectories:YES attributes:nil error:&error] ||
+	   ![NSData.data writeToFile:stamp options:0 error:&error]) {
+		LogError(@"ZipMount: couldn't create cache %@, error: %@", self.cachePath, error.localizedDescription);
+		return NO;
+	}
+	[fm setAttributes:@{NSFileModificationDate: [self archiveDate]} ofItemAtPath:stamp error:nil];
+	return YES;
+}
+
+// live mount whose cache directory holds path & the member name for it
++ (ZipMount *)mountForPath:(NSString *)path entry:(NSString **)entry {
+	path = path.stringByStandardizingPath;
+	@synchronized(ZipMount.class) {
+		for(ZipMount *mount in s_mounts.objectEnumerator) {
+			NSString *prefix = [mount.cachePath.stringByStandardizingPath stringByAppendingString:@"/"];
+			if([path hasPrefix:prefix]) {
+				*entry = [path substringFromIndex:prefix.length];
+				return mount;
+			}
+		}
+	}
+	return nil;
+}
+
+// archive caches live in Application Support, not Caches, so the system
+// doesn't purge files a scene writes next to its patches
++ (NSString *)archivesPath {
+	return [Util.applicationSupportPath stringByAppendingPathComponent:@"Archives"];
+}
+
+// create the archive caches dir, excluded from backups as the archives
+// themselves are backed up
++ (void)createArchivesPath {
+	NSString *path = [self archivesPath];
+	if([NSFileManager.defaultManager fileExistsAtPath:path]) {
+		return;
+	}
+	NSError *error;
+	if(![NSFileManager.defaultManager createDirectoryAtPath:path
+	                            withIntermediateDirectories:YES
+	                                             attributes:nil
+	                                                  error:&error]) {
+		LogError(@"ZipMount: couldn't create %@, error: %@", path, error.localizedDescription);
+		return;
+	}
+	[[NSURL fileURLWithPath:path] setResourceValue:@YES forKey:NSURLIsExcludedFromBackupKey error:nil];
+}
+
+// mark cache as recently used
+- (void)touch {
+	[NSFileManager.defaultManager setAttributes:@{NSFileModificationDate: NSDate.date}
+	                               ofItemAtPath:self.cachePath
+	                                      error:nil];
+}
+
+// remove least recently used archive caches without a live mount or scene
+// written files until the total size is within limit
++ (void)trimCacheToSize:(unsigned long long)limit {
+	NSMutableSet *live = [NSMutableSet set];
+	@synchronized(ZipMount.class) {
+		for(ZipMount *mount in s_mounts.objectEnumerator) {
+			[live addObject:mount.cachePath.lastPathComponent];
+		}
+	}
+	NSFileManager *fm = NSFileManager.defaultManager;
+	NSURL *cacheDir = [NSURL fileURLWithPath:[self archivesPath]];
+	NSArray *urls = [fm contentsOfDirectoryAtURL:cacheDir
+	                  includingPropertiesForKeys:@[NSURLContentModificationDateKey]
+	                                     options:NSDirectoryEnumerationSkipsHiddenFiles
+	                                       error:nil];
+	NSMutableArray *caches = [NSMutableArray array];
+	unsigned long long total = 0;
+	for(NSURL *url in urls) {
+		BOOL written = NO;
+		unsigned long long bytes = [self sizeOfDirectory:url written:&written];
+		total += bytes;
+		if([live containsObject:url.lastPathComponent]) {
+			continue;
+		}
+		if(written) {
+			LogVerbose(@"ZipMount: keeping cache %@ with scene written files", url.lastPathComponent);
+			continue;
+		}
+		NSDate *date = nil;
+		[url getResourceValue:&date forKey:NSURLContentModificationDateKey error:nil];
+		[caches addObject:@{@"url": url, @"date": (date ? date : NSDate.distantPast), @"size": @(bytes)}];
+	}
+	[caches sortUsingComparator:^NSComparisonResult(NSDictionary *a, NSDictionary *b) {
+		return [a[@"date"] compare:b[@"date"]];
+	}];
+	for(NSDictionary *cache in caches) {
+		if(total <= limit) {
+			break;
+		}
+		NSError *error;
+		if(![fm removeItemAtURL:cache[@"url"] error:&error]) {
+			LogError(@"ZipMount: couldn't remove cache %@, error: %@",
+				[cache[@"url"] lastPathComponent], error.localizedDescription);
+			continue;
+		}
+		LogVerbose(@"ZipMount: removed cache %@", [cache[@"url"] lastPathComponent]);
+		total -= [cache[@"size"] unsignedLongLongValue];
+	}
+}
+
+// total allocated size of the files in a directory, written is set to YES if
+// any file is newer than the newest extracted stamp, ie. written by the scene
++ (unsigned long long)sizeOfDirectory:(NSURL *)url written:(BOOL *)written {
+	unsigned long long total = 0;
+	NSDate *newestStamp = nil, *newestFile = nil;
+	NSDirectoryEnumerator *enumerator = [NSFileManager.defaultManager enumeratorAtURL:url
+		includingPropertiesForKeys:@[NSURLTotalFileAllocatedSizeKey, NSURLIsRegularFileKey,
+		                             NSURLContentModificationDateKey]
+		options:0 errorHandler:nil];
+	for(NSURL *file in enumerator) {
+		NSNumber *bytes = nil, *regular = nil;
+		NSDate *date = nil;
+		[file getResourceValue:&bytes forKey:NSURLTotalFileAllocatedSizeKey error:nil];
+		[file getResourceValue:&regular forKey:NSURLIsRegularFileKey error:nil];
+		[file getResourceValue:&date forKey:NSURLContentModificationDateKey error:nil];
+		total += bytes.unsignedLongLongValue;
+		if(!regular.boolValue || !date) {
+			continue;
+		}
+		if([file.lastPathComponent isEqualToString:EXTRACTED_STAMP]) {
+			if(!newestStamp || [date compare:newestStamp] == NSOrderedDescending) {
+				newestStamp = date;
+			}
+		}
+		else if(!newestFile || [date compare:newestFile] == NSOrderedDescending) {
+			newestFile = date;
+		}
+	}
+	*written = (newestStamp && newestFile && [newestFile compare:newestStamp] == NSOrderedDescending);
+	return total;
+}
+
+@end
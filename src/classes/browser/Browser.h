@@ -13,6 +13,7 @@
  *   - http://stackoverflow.com/questions/8848857/how-do-i-change-initwithnibname-in-storyboard
  */
 #import "BrowserLayer.h"
+#import "BrowserEnumerator.h"
 
 @class Browser;
 
@@ -61,6 +62,18 @@
                                        isDir:(BOOL)isDir
                                 isSelectable:(BOOL)isSelectable;
 
+@optional
+
+/// returns a custom type for a path, ie. a scene type, which is cached with
+/// the directory listing until the path changes, see typeForPath:isDir:
+///
+/// note: called on a background queue when listing so it must be thread safe
+- (int)browser:(Browser *)browser typeForPath:(NSString *)path isDir:(BOOL)isDir;
+
+/// full path has been created, renamed, copied, moved, or deleted by an edit,
+/// called for both the old & new paths of renames & moves
+- (void)browser:(Browser *)browser changedPath:(NSString *)path;
+
 @end
 
 /// drill-down file browser with basic editing functions: move, rename, & delete
@@ -167,16 +180,26 @@
 - (BOOL)deletePath:(NSString *)path
         completion:(void (^)(BOOL failed))completion;
 
-/// get the number of files for the current file extensions
+/// get the number of listed files for the current file extensions in the top
+/// layer, 0 until listed, see whenListed:
 - (unsigned int)fileCountForExtensions;
 
-/// get the number of files for a file extension
+/// get the number of listed files for a file extension in the top layer,
+/// 0 until listed, see whenListed:
 - (unsigned int)fileCountForExtension:(NSString *)extension;
 
 /// returns YES if the given path has one of the allowed file extensions,
 /// also returns NO if extensions are not set
 - (BOOL)pathHasAllowedExtension:(NSString *)path;
 
+/// returns the data delegate type for a path from the cached directory
+/// listing, asks the data delegate directly if not cached, or 0 if the data
+/// delegate doesn't provide types
+- (int)typeForPath:(NSString *)path isDir:(BOOL)isDir;
+
+/// returns the data delegate type block for directory listings or nil
+- (BrowserEntryTypeBlock)entryTypeBlock;
+
 #pragma mark Subclassing
 
 /// creates the Cancel button in browse mode, override to provide a custom button
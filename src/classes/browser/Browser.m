@@ -27,6 +27,9 @@
 // move/overwrite a file path to a new dir, does not check existence
 - (BOOL)_movePath:(NSString *)path toPath:(NSString *)newPath completion:(void (^)(BOOL failed))completion;
 
+// notify the data delegate of an edited path
+- (void)changedPath:(NSString *)path;
+
 /// show a file exist dialog for a path in a given directory,
 /// completion block indicates button choice: 0 Skip, 1 Keep, 2 Overwrite
 - (void)showExistsDialogForPath:(NSString *)path inDirectory:(NSString *)directory
@@ -108,7 +111,9 @@
 		LogVerbose(@"Browser: now pushing folder %@", path.lastPathComponent);
 		if(i == count) { // load first layer, don't push
 			path = [components componentsJoinedByString:@"/"];
-			[self loadDirectory:path];
+			if(![self loadDirectory:path]) {
+				return NO;
+			}
 		}
 		else { // push browser layer
 			UINavigationController *navigationController = self.navigationController;
@@ -119,7 +124,9 @@
 			browserLayer.root = self.root;
 			browserLayer.mode = self.mode;
 			browserLayer.title = self.title;
-			[browserLayer loadDirectory:path];
+			if(![browserLayer loadDirectory:path]) {
+				return NO;
+			}
 			[navigationController pushViewController:browserLayer animated:NO];
 		}
 	}
@@ -359,6 +366,7 @@
 		                           cancelButtonTitle:@"Ok"] show];
 		return NO;
 	}
+	[self changedPath:path];
 	[self.top reloadDirectory];
 	if([self.root.delegate respondsToSelector:@selector(browser:createdDirectory:)]) {
 		[self.root.delegate browser:self.root createdDirectory:path];
@@ -387,6 +395,8 @@
 		}
 		else {
 			LogVerbose(@"Browser: renamed %@ to %@", path, newPath);
+			[self changedPath:path];
+			[self changedPath:newPath];
 		}
 	}
 	else {
@@ -520,6 +530,7 @@
 		}
 		else {
 			LogVerbose(@"Browser: deleted %@", path);
+			[self changedPath:path];
 		}
 	}
 	else {
@@ -531,6 +542,15 @@
 	return YES;
 }
 
+// wait on the top layer as files are counted there
+- (void)whenListed:(void (^)(BOOL success))block {
+	if(self.top != self) {
+		[self.top whenListed:block];
+		return;
+	}
+	[super whenListed:block];
+}
+
 - (unsigned int)fileCountForExtension:(NSString *)extension {
 	unsigned int i = 0;
 	for(NSString *p in self.top.paths) {
@@ -553,6 +573,26 @@
 	return self.extensions ? [self.extensions containsObject:path.pathExtension] : NO;
 }
 
+- (int)typeForPath:(NSString *)path isDir:(BOOL)isDir {
+	BrowserEntryTypeBlock type = [self entryTypeBlock];
+	if(!type) {
+		return 0;
+	}
+	BrowserEntry *entry = [BrowserEnumerator cachedEntryForPath:path type:type];
+	return (entry ? entry.type : type(path, isDir));
+}
+
+- (BrowserEntryTypeBlock)entryTypeBlock {
+	Browser *root = self.root;
+	id<BrowserDataDelegate> dataDelegate = root.dataDelegate;
+	if(![dataDelegate respondsToSelector:@selector(browser:typeForPath:isDir:)]) {
+		return nil;
+	}
+	return ^int(NSString *path, BOOL isDir) {
+		return [dataDelegate browser:root typeForPath:path isDir:isDir];
+	};
+}
+
 #pragma mark Subclassing
 
 - (UIBarButtonItem *)browsingModeRightBarItemForLayer:(BrowserLayer *)layer {
@@ -664,6 +704,7 @@
 		[alert show];
 		return NO;
 	}
+	[self changedPath:path];
 	if(completion) {
 		completion(NO);
 	}
@@ -688,6 +729,7 @@
 		[alert show];
 		return NO;
 	}
+	[self changedPath:newPath];
 	if(completion) {
 		completion(NO);
 	}
@@ -712,12 +754,21 @@
 		[alert show];
 		return NO;
 	}
+	[self changedPath:path];
+	[self changedPath:newPath];
 	if(completion) {
 		completion(NO);
 	}
 	return YES;
 }
 
+- (void)changedPath:(NSString *)path {
+	id<BrowserDataDelegate> dataDelegate = self.root.dataDelegate;
+	if([dataDelegate respondsToSelector:@selector(browser:changedPath:)]) {
+		[dataDelegate browser:self.root changedPath:path];
+	}
+}
+
 - (void)showExistsDialogForPath:(NSString *)path inDirectory:(NSString *)directory
 					 completion:(void (^)(BOOL failed, NSUInteger button))completion {
 	LogVerbose(@"Browser: exists dialog for %@", path.lastPathComponent);
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#import <Foundation/Foundation.h>
+
+/// number of entries delivered to the main queue at a time
+#define BROWSER_ENUMERATOR_BATCH_SIZE 256
+
+/// returns a custom type for a path, ie. a scene type, called on a background
+/// queue so it must be thread safe
+typedef int (^BrowserEntryTypeBlock)(NSString *path, BOOL isDir);
+
+/// cached metadata for a single directory item
+@interface BrowserEntry : NSObject
+
+/// full path
+@property (readonly, nonatomic) NSString *path;
+
+/// file name
+@property (readonly, nonatomic) NSString *name;
+
+/// path extension, without period
+@property (readonly, nonatomic) NSString *extension;
+
+/// is the path a directory? follows symlinks
+@property (readonly, nonatomic) BOOL isDir;
+
+/// custom type from the type block or 0
+@property (readonly, nonatomic) int type;
+
+@end
+
+/// background directory enumeration for the browser
+///
+/// listings are read on a background queue: items are stat'd, typed, & sorted
+/// using a precomputed collation key approximating localizedStandardCompare:,
+/// then delivered to the main queue in batches
+///
+/// listings are cached per directory & reused while the directory's
+/// modification date is unchanged, item metadata is reused while the item's
+/// own modification date is unchanged, so reloading an unchanged directory
+/// only costs a stat per item
+@interface BrowserEnumerator : NSObject
+
+/// returns the cached listing for a directory if the directory is unchanged,
+/// otherwise nil, this only stats the directory itself so it's cheap enough
+/// to show a listing right away on the main thread, items changed in place
+/// are picked up by enumerating again
++ (NSArray<BrowserEntry *> *)cachedEntriesForDirectory:(NSString *)dirPath
+                                                  type:(BrowserEntryTypeBlock)type;
+
+/// returns the cached entry for a path as of the last listing of its
+/// directory or nil if not listed, also nil if a type block is given and the
+/// listing was made without one
++ (BrowserEntry *)cachedEntryForPath:(NSString *)path type:(BrowserEntryTypeBlock)type;
+
+/// list a directory synchronously, reusing the cached listing & item metadata
+/// where valid, returns nil on error
++ (NSArray<BrowserEntry *> *)entriesForDirectory:(NSString *)dirPath
+                                            type:(BrowserEntryTypeBlock)type
+                                           error:(NSError **)error;
+
+/// list a directory on a background queue, see entriesForDirectory:type:error:
+///
+/// the sorted entries are passed to the optional batch block on the main queue
+/// BROWSER_ENUMERATOR_BATCH_SIZE at a time, then the whole listing or nil on
+/// error is passed to completion, the listing is the identical array returned
+/// by cachedEntriesForDirectory:type: if nothing has changed
+///
+/// nothing is called once cancelled
+- (void)enumerateDirectory:(NSString *)dirPath
+                      type:(BrowserEntryTypeBlock)type
+                     batch:(void (^)(NSArray<BrowserEntry *> *entries))batch
+                completion:(void (^)(NSArray<BrowserEntry *> *entries, NSError *error))completion;
+
+/// stop delivering the current enumeration
+- (void)cancel;
+
+/// remove all cached listings
++ (void)clearCache;
+
+@end
@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#import "BrowserEnumerator.h"
+
+#include <sys/stat.h>
+
+#import "Log.h"
+
+/// max number of cached directory listings
+#define BROWSER_ENUMERATOR_CACHE_COUNT 32
+
+static inline BOOL timespecEqual(struct timespec a, struct timespec b) {
+	return a.tv_sec == b.tv_sec && a.tv_nsec == b.tv_nsec;
+}
+
+// byte string sort key approximating localizedStandardCompare: which is case,
+// diacritic, & width insensitive & compares runs of digits by value, ie.
+// "take 2" < "take 10": names are folded, then each digit run is written as
+// a '0' marker, its length without leading zeros, & its digits so longer
+// numbers sort after shorter ones while comparing the keys bytewise
+static NSData *collationKey(NSString *name) {
+	NSString *folded = [name stringByFoldingWithOptions:(NSCaseInsensitiveSearch |
+	                                                     NSDiacriticInsensitiveSearch |
+	                                                     NSWidthInsensitiveSearch)
+	                                             locale:NSLocale.currentLocale];
+	const char *c = folded.UTF8String;
+	NSMutableData *key = [NSMutableData dataWithCapacity:strlen(c) + 8];
+	while(*c) {
+		if(*c >= '0' && *c <= '9') {
+			const char *digits = c;
+			while(*c >= '0' && *c <= '9') {
+				c++;
+			}
+			while(digits < c - 1 && *digits == '0') {
+				digits++;
+			}
+			uint8_t marker[2] = {'0', (uint8_t)MIN(c - digits, 255)};
+			[key appendBytes:marker length:2];
+			[key appendBytes:digits length:c - digits];
+		}
+		else {
+			[key appendBytes:c length:1];
+			c++;
+		}
+	}
+	return key;
+}
+
+#pragma mark - BrowserEntry
+
+@interface BrowserEntry ()
+@property (readwrite, nonatomic) NSString *path;
+@property (readwrite, nonatomic) NSString *name;
+@property (readwrite, nonatomic) NSString *extension;
+@property (readwrite, nonatomic) BOOL isDir;
+@property (readwrite, nonatomic) int type;
+@property (assign, nonatomic) struct timespec modified; ///< mtime
+@property (assign, nonatomic) struct timespec changed; ///< ctime
+@property (strong, nonatomic) NSData *collationKey;
+@end
+
+@implementation BrowserEntry
+@end
+
+#pragma mark - BrowserListing
+
+// immutable cached listing of a single directory, replaced as a whole when
+// anything changes so it can be shared between threads
+@interface BrowserListing : NSObject
+@property (assign, nonatomic) struct timespec modified; ///< directory mtime
+@property (assign, nonatomic) BOOL typed; ///< were the entries typed?
+@property (strong, nonatomic) NSArray<BrowserEntry *> *entries; ///< sorted
+@property (strong, nonatomic) NSDictionary<NSString *, BrowserEntry *> *entriesByName;
+@end
+
+@implementation BrowserListing
+@end
+
+#pragma mark - BrowserEnumerator
+
+@interface BrowserEnumerator () {
+	NSUInteger generation; ///< current enumeration, main queue only
+}
+@end
+
+@implementation BrowserEnumerator
+
++ (NSCache<NSString *, BrowserListing *> *)cache {
+	static NSCache *cache = nil;
+	static dispatch_once_t once;
+	dispatch_once(&once, ^{
+		cache = [[NSCache alloc] init];
+		cache.countLimit = BROWSER_ENUMERATOR_CACHE_COUNT;
+	});
+	return cache;
+}
+
++ (NSArray<BrowserEntry *> *)cachedEntriesForDirectory:(NSString *)dirPath
+                                                  type:(BrowserEntryTypeBlock)type {
+	BrowserListing *listing = [BrowserEnumerator.cache objectForKey:dirPath];
+	if(!listing || (type && !listing.typed)) {
+		return nil;
+	}
+	struct stat info;
+	if(stat(dirPath.fileSystemRepresentation, &info) != 0 ||
+	   !timespecEqual(listing.modified, info.st_mtimespec)) {
+		return nil;
+	}
+	return listing.entries;
+}
+
++ (BrowserEntry *)cachedEntryForPath:(NSString *)path type:(BrowserEntryTypeBlock)type {
+	BrowserListing *listing = [BrowserEnumerator.cache objectForKey:path.stringByDeletingLastPathComponent];
+	if(!listing || (type && !listing.typed)) {
+		return nil;
+	}
+	return listing.entriesByName[path.lastPathComponent];
+}
+
++ (NSArray<BrowserEntry *> *)entriesForDirectory:(NSString *)dirPath
+                                            type:(BrowserEntryTypeBlock)type
+                                           error:(NSError **)error {
+	return [BrowserEnumerator listingForDirectory:dirPath type:type error:error].entries;
+}
+
+- (void)enumerateDirectory:(NSString *)dirPath
+                      type:(BrowserEntryTypeBlock)type
+                     batch:(void (^)(NSArray<BrowserEntry *> *entries))batch
+                completion:(void (^)(NSArray<BrowserEntry *> *entries, NSError *error))completion {
+	NSUInteger current = ++generation;
+	dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+		NSError *error = nil;
+		BrowserListing *listing = [BrowserEnumerator listingForDirectory:dirPath type:type error:&error];
+		NSArray *entries = listing.entries;
+
+		// main queue is serial, so batches arrive in order & before completion
+		if(batch) {
+			for(NSUInteger i = 0; i < entries.count; i += BROWSER_ENUMERATOR_BATCH_SIZE) {
+				NSRange range = NSMakeRange(i, MIN(BROWSER_ENUMERATOR_BATCH_SIZE, entries.count - i));
+				NSArray *batchEntries = [entries subarrayWithRange:range];
+				dispatch_async(dispatch_get_main_queue(), ^{
+					if(self->generation == current) {
+						batch(batchEntries);
+					}
+				});
+			}
+		}
+		dispatch_async(dispatch_get_main_queue(), ^{
+			if(self->generation == current) {
+				completion(entries, error);
+			}
+		});
+	});
+}
+
+- (void)cancel {
+	generation++;
+}
+
++ (void)clearCache {
+	[BrowserEnumerator.cache removeAllObjects];
+}
+
+#pragma mark Private
+
+// read a directory listing or reuse the cached one: names are only re-read
+// & sorted when the directory has changed & entries are only rebuilt when
+// their item has changed, returns the cached listing if nothing has changed
++ (BrowserListing *)listingForDirectory:(NSString *)dirPath
+                                   type:(BrowserEntryTypeBlock)type
+                                  error:(NSError **)error {
+	struct stat info;
+	if(stat(dirPath.fileSystemRepresentation, &info) != 0) {
+		if(error) {
+			*error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+		}
+		return nil;
+	}
+	BrowserListing *cached = [BrowserEnumerator.cache objectForKey:dirPath];
+	if(cached && type && !cached.typed) {
+		cached = nil; // entries need types
+	}
+
+	NSArray<NSString *> *names;
+	BOOL changed = (!cached || !timespecEqual(cached.modified, info.st_mtimespec));
+	if(changed) {
+		names = [NSFileManager.defaultManager contentsOfDirectoryAtPath:dirPath error:error];
+		if(!names) {
+			return nil;
+		}
+	}
+	else {
+		names = [cached.entries valueForKey:@"name"]; // already sorted
+	}
+
+	NSMutableArray *entries = [NSMutableArray arrayWithCapacity:names.count];
+	for(NSString *name in names) {
+		NSString *path = [dirPath stringByAppendingPathComponent:name];
+		struct stat itemInfo;
+		if(stat(path.fileSystemRepresentation, &itemInfo) != 0 &&
+		   lstat(path.fileSystemRepresentation, &itemInfo) != 0) { // broken link?
+			changed = YES; // removed since listed
+			continue;
+		}
+		BrowserEntry *entry = cached.entriesByName[name];
+		if(!entry ||
+		   !timespecEqual(entry.modified, itemInfo.st_mtimespec) ||
+		   !timespecEqual(entry.changed, itemInfo.st_ctimespec)) {
+			BrowserEntry *newEntry = [[BrowserEntry alloc] init];
+			newEntry.path = path;
+			newEntry.name = name;
+			newEntry.extension = name.pathExtension;
+			newEntry.isDir = S_ISDIR(itemInfo.st_mode);
+			newEntry.type = (type ? type(path, newEntry.isDir) : 0);
+			newEntry.modified = itemInfo.st_mtimespec;
+			newEntry.changed = itemInfo.st_ctimespec;
+			newEntry.collationKey = (entry ? entry.collationKey : collationKey(name));
+			entry = newEntry;
+			changed = YES;
+		}
+		[entries addObject:entry];
+	}
+	if(!changed) {
+		return cached;
+	}
+	if(!timespecEqual(cached.modified, info.st_mtimespec)) {
+		[entries sortUsingComparator:^NSComparisonResult(BrowserEntry *a, BrowserEntry *b) {
+			NSData *ka = a.collationKey, *kb = b.collationKey;
+			int result = memcmp(ka.bytes, kb.bytes, MIN(ka.length, kb.length));
+			if(result == 0) {
+				if(ka.length != kb.length) {
+					return (ka.length < kb.length ? NSOrderedAscending : NSOrderedDescending);
+				}
+				return [a.name compare:b.name];
+			}
+			return (result < 0 ? NSOrderedAscending : NSOrderedDescending);
+		}];
+	}
+
+	BrowserListing *listing = [[BrowserListing alloc] init];
+	listing.modified = info.st_mtimespec;
+	listing.typed = (type != nil);
+	listing.entries = entries;
+	NSMutableDictionary *entriesByName = [NSMutableDictionary dictionaryWithCapacity:entries.count];
+	for(BrowserEntry *entry in entries) {
+		entriesByName[entry.name] = entry;
+	}
+	listing.entriesByName = entriesByName;
+	[BrowserEnumerator.cache setObject:listing forKey:dirPath];
+	return listing;
+}
+
+@end
@@ -45,8 +45,8 @@ typedef enum {
 
 #pragma mark Location
 
-/// change to and load a new current dir
-/// returns YES on success
+/// change to and load a new current dir, listed in the background
+/// returns YES on success or NO if the dir can't be read
 - (BOOL)loadDirectory:(NSString *)dirPath;
 
 /// reload the current directory
@@ -58,6 +58,10 @@ typedef enum {
 /// clear current directory, paths, & cells
 - (void)clearDirectory;
 
+/// call a block on the main queue once the current dir is listed, right away
+/// if it already is, success is NO if the listing failed or was cancelled
+- (void)whenListed:(void (^)(BOOL success))block;
+
 #pragma mark Subclassing
 
 /// setup resources during init, make sure to call [super setup] if overriding
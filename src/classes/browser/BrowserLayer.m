@@ -11,6 +11,8 @@
 #import "BrowserLayer.h"
 #import "Browser.h"
 
+#include <dirent.h>
+
 #import "Log.h"
 #import "Util.h"
 
@@ -37,6 +39,10 @@ static NSMutableArray *s_movePaths; ///< paths to move/copy
 	CGPoint scrollPos;
 	BOOL scrollPosSet;
 	NSMutableSet *nonSelectableRows;
+	BrowserEnumerator *enumerator; ///< background directory listing
+	NSMutableDictionary<NSString *, BrowserEntry *> *entries; ///< path -> entry
+	BOOL isListed; ///< is the current dir completely listed?
+	NSMutableArray *listedBlocks; ///< called once listed
 }
 @end
 
@@ -148,28 +154,63 @@ static NSMutableArray *s_movePaths; ///< paths to move/copy
 // https://developer.apple.com/library/mac/#documentation/Cocoa/Reference/Foundation/Miscellaneous/Foundation_Constants/Reference/reference.html
 
 - (BOOL)loadDirectory:(NSString *)dirPath {
-	NSError *error;
 	LogVerbose(@"Browser: loading directory %@", dirPath);
-
-	// search for files in the given path and sort
-	NSArray *contents = [NSFileManager.defaultManager contentsOfDirectoryAtPath:dirPath error:&error];
-	if(!contents) {
-		LogError(@"Browser: couldn't load directory %@, error: %@", dirPath, error.localizedDescription);
+	if(![Util isDirectory:dirPath]) {
+		LogError(@"Browser: couldn't load directory %@, not found", dirPath);
 		return NO;
 	}
-	contents = [contents sortedArrayUsingSelector:@selector(localizedStandardCompare:)];
-	
-	// add contents to pathArray as absolute paths
-	LogVerbose(@"Browser: found %d paths", (int) contents.count);
-	for(NSString *p in contents) {
-		LogVerbose(@"Browser: 	%@", p);
-		NSString *fullPath = [dirPath stringByAppendingPathComponent:p];
-		if([self.root.dataDelegate browser:self.root shouldAddPath:fullPath isDir:[Util isDirectory:fullPath]]) {
-			[_paths addObject:fullPath];
+
+	// show the cached listing right away if the dir is unchanged, otherwise
+	// keep the current paths when reloading until the first batch arrives
+	BrowserEntryTypeBlock type = [self.root entryTypeBlock];
+	NSArray *cached = [BrowserEnumerator cachedEntriesForDirectory:dirPath type:type];
+	if(!cached) {
+		// cheap check the dir can be read so failure can be returned
+		DIR *dir = opendir(dirPath.fileSystemRepresentation);
+		if(!dir) {
+			LogError(@"Browser: couldn't load directory %@, error: %s", dirPath, strerror(errno));
+			return NO;
+		}
+		closedir(dir);
+	}
+	[self finishListing:NO]; // previous listing
+	isListed = (cached != nil);
+	__block BOOL replace = (!cached && [dirPath isEqualToString:_directory]);
+	if(!replace) {
+		[self removeAllPaths];
+		if(cached) {
+			[self addEntries:cached];
 		}
 	}
 	_directory = dirPath;
 	[self.tableView reloadData];
+
+	// search for files in the given path and sort in the background,
+	// revalidates items changed in place when showing the cached listing
+	[enumerator enumerateDirectory:dirPath type:type batch:(cached ? nil : ^(NSArray *batch) {
+		if(replace) {
+			[self removeAllPaths];
+			replace = NO;
+		}
+		[self addEntries:batch];
+		[self.tableView reloadData];
+	}) completion:^(NSArray *listed, NSError *error) {
+		if(!listed) {
+			LogError(@"Browser: couldn't load directory %@, error: %@", dirPath, error.localizedDescription);
+			[self removeAllPaths];
+			[self.tableView reloadData];
+			[self finishListing:NO];
+			return;
+		}
+		LogVerbose(@"Browser: found %d paths", (int)listed.count);
+		if(replace || (cached && listed != cached)) {
+			[self removeAllPaths];
+			[self addEntries:listed];
+			[self.tableView reloadData];
+		}
+		[self finishListing:YES];
+	}];
+
 	// custom back button with current dir to show on layer above
 	self.navigationItem.backBarButtonItem = [[UIBarButtonItem alloc]
 	                                     initWithTitle:_directory.lastPathComponent
@@ -181,26 +222,35 @@ static NSMutableArray *s_movePaths; ///< paths to move/copy
 }
 
 - (void)reloadDirectory {
-	[_paths removeAllObjects];
-	nonSelectableRows = nil;
 	[self loadDirectory:_directory];
-	[self.tableView reloadData];
 }
 
 - (void)unloadDirectory {
-	[_paths removeAllObjects];
-	nonSelectableRows = nil;
+	[enumerator cancel];
+	[self finishListing:NO];
+	[self removeAllPaths];
 	[self.tableView reloadData];
 }
 
 - (void)clearDirectory {
-	[_paths removeAllObjects];
-	nonSelectableRows = nil;
+	[enumerator cancel];
+	[self finishListing:NO];
+	[self removeAllPaths];
 	[self.tableView reloadData];
 	_directory = nil;
 	self.navigationItem.backBarButtonItem = nil;
 }
 
+- (void)whenListed:(void (^)(BOOL success))block {
+	if(isListed) {
+		dispatch_async(dispatch_get_main_queue(), ^{
+			block(YES);
+		});
+		return;
+	}
+	[listedBlocks addObject:[block copy]];
+}
+
 #pragma mark Subclassing
 
 - (void)setup {
@@ -208,6 +258,10 @@ static NSMutableArray *s_movePaths; ///< paths to move/copy
 	scrollPosSet = NO;
 	nonSelectableRows = nil;
 	_paths = [NSMutableArray array];
+	enumerator = [[BrowserEnumerator alloc] init];
+	entries = [NSMutableDictionary dictionary];
+	isListed = NO;
+	listedBlocks = [NSMutableArray array];
 	_mode = BrowserModeBrowse;
 }
 
@@ -362,7 +416,11 @@ static NSMutableArray *s_movePaths; ///< paths to move/copy
 	}
 	BOOL isDir;
 	NSString *path = _paths[indexPath.row];
-	if([NSFileManager.defaultManager fileExistsAtPath:path isDirectory:&isDir]) {
+	BrowserEntry *entry = entries[path];
+	if(entry) {
+		isDir = entry.isDir; // avoid a stat per cell
+	}
+	if(entry || [NSFileManager.defaultManager fileExistsAtPath:path isDirectory:&isDir]) {
 		BOOL isSelectable = YES;
 		if(isDir) {
 			isSelectable = [self.root.dataDelegate browser:self.root isPathSelectable:path isDir:isDir];
@@ -626,6 +684,37 @@ static NSMutableArray *s_movePaths; ///< paths to move/copy
 
 #pragma mark Private
 
+// add listed entries which pass the data delegate filter
+- (void)addEntries:(NSArray<BrowserEntry *> *)listed {
+	for(BrowserEntry *entry in listed) {
+		if([self.root.dataDelegate browser:self.root shouldAddPath:entry.path isDir:entry.isDir]) {
+			[_paths addObject:entry.path];
+			entries[entry.path] = entry;
+		}
+	}
+}
+
+// mark the current listing as finished & call the listed blocks, isListed
+// stays NO on failure or cancel
+- (void)finishListing:(BOOL)success {
+	isListed = success;
+	if(listedBlocks.count == 0) {
+		return;
+	}
+	NSArray *blocks = listedBlocks;
+	listedBlocks = [NSMutableArray array];
+	for(void (^block)(BOOL) in blocks) {
+		block(success);
+	}
+}
+
+// clear paths & entries, does not reload table view
+- (void)removeAllPaths {
+	[_paths removeAllObjects];
+	[entries removeAllObjects];
+	nonSelectableRows = nil;
+}
+
 - (void)showEditBrowserForMode:(BrowserMode)mode {
 	NSArray *indexPaths = [self.tableView indexPathsForSelectedRows];
 	if(indexPaths.count < 1) {
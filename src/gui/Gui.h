@@ -37,6 +37,10 @@ typedef enum {
 } GuiScaleMode;
 
 @class PdFile;
+@class Gui;
+
+/// adds a widget for an object atom line
+typedef void (^GuiObjectFactory)(Gui *gui, NSArray *atomLine);
 
 /// Widget array wrapper, loads Widgets from atom line string arrays
 @interface Gui : NSObject
@@ -111,14 +115,21 @@ typedef enum {
 - (void)addVUMeter:(NSArray *)atomLine;
 - (void)addCanvas:(NSArray *)atomLine;
 
-/// add a widget using the object type name, returns YES if type handled
-/// subclass this to add additional type creation & don't forget to call super
+/// object widget registry for the top level canvas: object type name ->
+/// GuiObjectFactory, subclasses add their own types to a mutable copy of the
+/// super class registry, read once when the Gui is created
++ (NSDictionary *)objectFactories;
+
+/// object widget registry for sub patches, ie. non-drawable send/receive
+/// widgets, empty by default
++ (NSDictionary *)subpatchObjectFactories;
+
+/// add a widget using the object type name from the registries,
+/// returns YES if type handled
 ///
 /// level refers to the patch canvas level where:
 ///   - 1 is the top level canvas
 ///   - >1 are sub patches
-///
-/// this allows for detecting non-drawable send/receive widgets in sub patches
 - (BOOL)addObjectType:(NSString *)type fromAtomLine:(NSArray *)atomLine atLevel:(int)level;
 
 /// add widgets from an array of atom lines
@@ -149,6 +160,10 @@ typedef enum {
 /// replace any occurrances of "//$0" or "#0" with the given patches' dollar zero id
 - (NSString *)replaceDollarZeroStringsIn:(NSString *)string fromPatch:(PdFile *)patch;
 
+/// returns YES if the atom line is used by addWidgetsFromAtomLines:,
+/// ie. canvas begin/end, atoms, comments, & objects
++ (BOOL)isWidgetAtomLine:(NSArray *)atomLine;
+
 /// convert atom string empty values to an empty string
 /// nil, @"-", & @"empty" -> @""
 + (NSString *)filterEmptyStringValues:(NSString *)atom;
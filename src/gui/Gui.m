@@ -28,7 +28,42 @@
 #import "VUMeter.h"
 #import "Canvas.h"
 
+// atom line types
+typedef enum {
+	GuiLineCanvas,
+	GuiLineRestore,
+	GuiLineObject,
+	GuiLineNumber,
+	GuiLineSymbol,
+	GuiLineList,
+	GuiLineComment
+} GuiLineType;
+
+// version of the widget line filter in the patch cache, bump whenever
+// GuiLineTypes() or isWidgetAtomLine: change which lines are kept
+#define GUI_LINE_FILTER_VERSION 1
+
+// atom line type name -> GuiLineType, ie. "#X floatatom ..."
+static NSDictionary *GuiLineTypes(void) {
+	static NSDictionary *lineTypes = nil;
+	static dispatch_once_t once;
+	dispatch_once(&once, ^{
+		lineTypes = @{
+			@"canvas": @(GuiLineCanvas),
+			@"restore": @(GuiLineRestore),
+			@"obj": @(GuiLineObject),
+			@"floatatom": @(GuiLineNumber),
+			@"symbolatom": @(GuiLineSymbol),
+			@"listbox": @(GuiLineList),
+			@"text": @(GuiLineComment)
+		};
+	});
+	return lineTypes;
+}
+
 @interface Gui () {
+	NSDictionary *objectFactories; ///< top level object type -> factory
+	NSDictionary *subpatchObjectFactories; ///< sub patch object type -> factory
 	float patchScaleX; ///< x scale between viewport and original patch
 	float patchScaleY; ///< y scale between viewport and original patch
 	float viewportScaleX; ///< x scale between parent view and viewport
@@ -59,6 +94,8 @@
 		_lineWidth = 1.0;
 		patchScaleX = 1.0;
 		patchScaleY = 1.0;
+		objectFactories = [self.class objectFactories];
+		subpatchObjectFactories = [self.class subpatchObjectFactories];
 		[self resetViewport];
     }
     return self;
@@ -163,56 +200,65 @@
 	}
 }
 
+#pragma mark Widget Registry
+
 // iem gui objects
++ (NSDictionary *)objectFactories {
+	return @{
+		@"bng": ^(Gui *gui, NSArray *atomLine) {
+			[gui addBang:atomLine];
+		},
+		@"tgl": ^(Gui *gui, NSArray *atomLine) {
+			[gui addToggle:atomLine];
+		},
+		@"nbx": ^(Gui *gui, NSArray *atomLine) {
+			[gui addNumber2:atomLine];
+		},
+		@"hsl": ^(Gui *gui, NSArray *atomLine) {
+			[gui addSlider:atomLine withOrientation:WidgetOrientationHorizontal];
+		},
+		@"vsl": ^(Gui *gui, NSArray *atomLine) {
+			[gui addSlider:atomLine withOrientation:WidgetOrientationVertical];
+		},
+		@"hradio": ^(Gui *gui, NSArray *atomLine) {
+			[gui addRadio:atomLine withOrientation:WidgetOrientationHorizontal];
+		},
+		@"vradio": ^(Gui *gui, NSArray *atomLine) {
+			[gui addRadio:atomLine withOrientation:WidgetOrientationVertical];
+		},
+		@"vu": ^(Gui *gui, NSArray *atomLine) {
+			[gui addVUMeter:atomLine];
+		},
+		@"cnv": ^(Gui *gui, NSArray *atomLine) {
+			[gui addCanvas:atomLine];
+		}
+	};
+}
+
++ (NSDictionary *)subpatchObjectFactories {
+	return @{};
+}
+
 - (BOOL)addObjectType:(NSString *)type fromAtomLine:(NSArray *)atomLine atLevel:(int)level {
-	if(level != 1) {return NO;} // ignore sub patches
-	if([type isEqualToString:@"bng"]) {
-		[self addBang:atomLine];
-		return YES;
-	}
-	else if([type isEqualToString:@"tgl"]) {
-		[self addToggle:atomLine];
-		return YES;
-	}
-	else if([type isEqualToString:@"nbx"]) {
-		[self addNumber2:atomLine];
-		return YES;
-	}
-	else if([type isEqualToString:@"hsl"]) {
-		[self addSlider:atomLine withOrientation:WidgetOrientationHorizontal];
-		return YES;
-	}
-	else if([type isEqualToString:@"vsl"]) {
-		[self addSlider:atomLine withOrientation:WidgetOrientationVertical];
-		return YES;
-	}
-	else if([type isEqualToString:@"hradio"]) {
-		[self addRadio:atomLine withOrientation:WidgetOrientationHorizontal];
-		return YES;
-	}
-	else if([type isEqualToString:@"vradio"]) {
-		[self addRadio:atomLine withOrientation:WidgetOrientationVertical];
-		return YES;
-	}
-	else if([type isEqualToString:@"vu"]) {
-		[self addVUMeter:atomLine];
-		return YES;
-	}
-	else if([type isEqualToString:@"cnv"]) {
-		[self addCanvas:atomLine];
-		return YES;
-	}
-	return NO;
+	GuiObjectFactory factory = (level == 1 ? objectFactories[type] : subpatchObjectFactories[type]);
+	if(!factory) {return NO;}
+	factory(self, atomLine);
+	return YES;
 }
 
+#pragma mark Load Widgets
+
 - (void)addWidgetsFromAtomLines:(NSArray *)lines {
+	NSDictionary *lineTypes = GuiLineTypes();
 	int level = 0;
 	for(NSArray *line in lines) {
-		if(line.count >= 4) {
-			NSString *lineType = line[1];
-			
+		if(line.count < 4) {continue;}
+		NSNumber *lineType = lineTypes[line[1]];
+		if(!lineType) {continue;}
+		switch(lineType.intValue) {
+
 			// find canvas begin and end line
-			if([lineType isEqualToString:@"canvas"]) {
+			case GuiLineCanvas:
 				level++;
 				if(level == 1) {
 					self.patchWidth = [line[4] intValue];
@@ -235,47 +281,47 @@
 					if(patchScaleX <= 0) {patchScaleX = 1.0;}
 					if(patchScaleY <= 0) {patchScaleY = 1.0;}
 				}
-			}
-			else if([lineType isEqualToString:@"restore"]) {
+				break;
+			case GuiLineRestore:
 				level -= 1;
-			}
-			// find different types of UI elements in the top level patch
-			else if(level == 1) {
-				if(line.count >= 2) {
-				
-					// built in pd things
-					if([lineType isEqualToString:@"floatatom"]) {
-						[self addNumber:line];
-					}
-					else if([lineType isEqualToString:@"symbolatom"]) {
-						[self addSymbol:line];
-					}
-					else if([lineType isEqualToString:@"listbox"]) {
-						[self addList:line];
-					}
-					else if([lineType isEqualToString:@"text"]) {
-						[self addComment:line];
-					}
-					else if([lineType isEqualToString:@"obj"] && line.count >= 5) {
-						// iem GUIs and other objects
-						[self addObject:line atLevel:level];
-					}
-				}
-			}
-			// find non-UI elements in sub patches
-			else {
-				if(line.count >= 2) {
-					if([lineType isEqualToString:@"obj"] && line.count >= 5) {
-						[self addObject:line atLevel:level];
-					}
+				break;
+
+			// iem GUIs and other objects, non-UI elements in sub patches
+			case GuiLineObject:
+				if(line.count >= 5) {
+					[self addObject:line atLevel:level];
 				}
-			}
+				break;
+
+			// built in pd things in the top level patch
+			case GuiLineNumber:
+				if(level == 1) {[self addNumber:line];}
+				break;
+			case GuiLineSymbol:
+				if(level == 1) {[self addSymbol:line];}
+				break;
+			case GuiLineList:
+				if(level == 1) {[self addList:line];}
+				break;
+			case GuiLineComment:
+				if(level == 1) {[self addComment:line];}
+				break;
 		}
 	}
 }
 
 - (void)addWidgetsFromPatch:(NSString *)patch {
-	[self addWidgetsFromAtomLines:[PdParser getAtomLines:[PdParser readPatch:patch]]];
+	NSArray *lines = [PdParser readCachedAtomLines:patch filterVersion:GUI_LINE_FILTER_VERSION];
+	if(!lines) {
+		// only keep and cache lines which may describe widgets,
+		// skips connections, array data, etc
+		lines = [[PdParser getAtomLines:[PdParser readPatch:patch]] filteredArrayUsingPredicate:
+			[NSPredicate predicateWithBlock:^BOOL(NSArray *line, NSDictionary *bindings) {
+				return [Gui isWidgetAtomLine:line];
+			}]];
+		[PdParser writeCachedAtomLines:lines forPatch:patch filterVersion:GUI_LINE_FILTER_VERSION];
+	}
+	[self addWidgetsFromAtomLines:lines];
 }
 
 #pragma mark Manipulate Widgets
@@ -330,6 +376,10 @@
 	return newString;
 }
 
++ (BOOL)isWidgetAtomLine:(NSArray *)atomLine {
+	return atomLine.count >= 4 && GuiLineTypes()[atomLine[1]] != nil;
+}
+
 + (NSString *)filterEmptyStringValues:(NSString *)atom {
 	if(!atom || [atom isEqualToString:@"-"] || [atom isEqualToString:@"empty"]) {
 		return @"";
@@ -107,62 +107,59 @@
 	}
 }
 
-#pragma mark Gui
+#pragma mark Widget Registry
 
 // droidparty objects
-- (BOOL)addObjectType:(NSString *)type fromAtomLine:(NSArray *)atomLine atLevel:(int)level {
-	if(level == 1) { // GUIs in the top level canvas
-		if([type isEqualToString:@"display"]) {
-			[self addDisplay:atomLine];
-			return YES;
++ (NSDictionary *)objectFactories {
+	NSMutableDictionary *factories = [[super objectFactories] mutableCopy]; // iem GUIs, etc
+	[factories addEntriesFromDictionary:@{
+		@"display": ^(Gui *gui, NSArray *atomLine) {
+			[(PartyGui *)gui addDisplay:atomLine];
+		},
+		@"numberbox": ^(Gui *gui, NSArray *atomLine) {
+			[(PartyGui *)gui addNumberbox:atomLine];
+		},
+		@"ribbon": ^(Gui *gui, NSArray *atomLine) {
+			[(PartyGui *)gui addRibbon:atomLine];
+		},
+		@"taplist": ^(Gui *gui, NSArray *atomLine) {
+			[(PartyGui *)gui addTaplist:atomLine];
+		},
+		@"touch": ^(Gui *gui, NSArray *atomLine) {
+			[(PartyGui *)gui addTouch:atomLine];
+		},
+		@"wordbutton": ^(Gui *gui, NSArray *atomLine) {
+			[(PartyGui *)gui addWordbutton:atomLine];
+		},
+		@"loadsave": ^(Gui *gui, NSArray *atomLine) {
+			[(PartyGui *)gui addLoadsave:atomLine];
+		},
+		@"mknob": ^(Gui *gui, NSArray *atomLine) {
+			[(PartyGui *)gui addKnob:atomLine];
+		},
+		@"menubang": ^(Gui *gui, NSArray *atomLine) {
+			[(PartyGui *)gui addMenubang:atomLine];
+		},
+		@"cnv": ^(Gui *gui, NSArray *atomLine) {
+			if(atomLine.count > 9 && [atomLine[9] isEqual:@"ViewPort"]) {
+				// special ViewPort canvas
+				[(PartyGui *)gui addViewPortCanvas:atomLine];
+			}
+			else {
+				[gui addCanvas:atomLine];
+			}
 		}
-		else if([type isEqualToString:@"numberbox"]) {
-			[self addNumberbox:atomLine];
-			return YES;
-		}
-		else if([type isEqualToString:@"ribbon"]) {
-			[self addRibbon:atomLine];
-			return YES;
-		}
-		else if([type isEqualToString:@"taplist"]) {
-			[self addTaplist:atomLine];
-			return YES;
-		}
-		else if([type isEqualToString:@"touch"]) {
-			[self addTouch:atomLine];
-			return YES;
-		}
-		else if([type isEqualToString:@"wordbutton"]) {
-			[self addWordbutton:atomLine];
-			return YES;
-		}
-		if([type isEqualToString:@"loadsave"]) {
-			[self addLoadsave:atomLine];
-			return YES;
-		}
-		else if([type isEqualToString:@"mknob"]) {
-			[self addKnob:atomLine];
-			return YES;
-		}
-		else if([type isEqualToString:@"menubang"]) {
-			[self addMenubang:atomLine];
-			return YES;
-		}
-		else if([type isEqualToString:@"cnv"] && atomLine.count > 9 && [atomLine[9] isEqualToString:@"ViewPort"]) {
-			// special ViewPort canvas
-			[self addViewPortCanvas:atomLine];
-			return  YES;
-		}
-		// iem GUIs, etc
-		return [super addObjectType:type fromAtomLine:atomLine atLevel:level];
-	}
+	}];
+	return factories;
+}
 
-	// non-GUIs in subpatches
-	if([type isEqualToString:@"loadsave"]) {
-		[self addLoadsave:atomLine];
-		return YES;
-	}
-	return NO;
+// non-GUIs in subpatches
++ (NSDictionary *)subpatchObjectFactories {
+	NSMutableDictionary *factories = [[super subpatchObjectFactories] mutableCopy];
+	factories[@"loadsave"] = ^(Gui *gui, NSArray *atomLine) {
+		[(PartyGui *)gui addLoadsave:atomLine];
+	};
+	return factories;
 }
 
 @end
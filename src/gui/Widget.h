@@ -39,6 +39,7 @@ typedef enum {
 @end
 
 @class PdDispatcher;
+@class WidgetMailbox;
 
 /// a widget baseclass
 ///
@@ -76,6 +77,10 @@ typedef enum {
 /// text label
 @property (strong, nonatomic) UILabel *label;
 
+/// returns YES if a received float only updates the display, so only the
+/// newest float per frame needs to be applied, default NO
+@property (readonly, nonatomic) BOOL coalescesFloats;
+
 /// get the widget type as a string, overridden by other widgets
 @property (readonly, nonatomic) NSString *type;
 
@@ -132,6 +137,11 @@ typedef enum {
 + (PdDispatcher *) dispatcher;
 + (void)setDispatcher:(PdDispatcher *)d;
 
+/// static receive mailbox, widgets receive through the mailbox instead of the
+/// dispatcher when set so display only floats are applied once per frame
++ (WidgetMailbox *)mailbox;
++ (void)setMailbox:(WidgetMailbox *)m;
+
 #pragma mark Number Formatting
 
 /// convert a float to a string of the given max length
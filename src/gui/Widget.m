@@ -13,6 +13,7 @@
 #import "Gui.h"
 #import "PdFile.h"
 #import "PdDispatcher.h"
+#import "WidgetMailbox.h"
 
 @implementation Widget
 
@@ -251,12 +252,22 @@
 	if([_receiveName isEqualToString:name]) {
 		return;
 	}
-	if([self hasValidReceiveName]) {
-		[dispatcher removeListener:self forSource:self.receiveName]; // remove old name
+	if([self hasValidReceiveName]) { // remove old name
+		if(mailbox) {
+			[mailbox removeWidget:self forSource:self.receiveName];
+		}
+		else {
+			[dispatcher removeListener:self forSource:self.receiveName];
+		}
 	}
 	_receiveName = name;
-	if(name && ![name isEqualToString:@""]) {
-		[dispatcher addListener:self forSource:self.receiveName]; // add new one
+	if(name && ![name isEqualToString:@""]) { // add new one
+		if(mailbox) {
+			[mailbox addWidget:self forSource:self.receiveName];
+		}
+		else {
+			[dispatcher addListener:self forSource:self.receiveName];
+		}
 	}
 }
 
@@ -264,6 +275,10 @@
 	return @"Widget";
 }
 
+- (BOOL)coalescesFloats {
+	return NO;
+}
+
 #pragma mark Static Dispatcher
 
 static PdDispatcher *dispatcher = nil;
@@ -276,6 +291,18 @@ static PdDispatcher *dispatcher = nil;
 	dispatcher = d;
 }
 
+#pragma mark Static Mailbox
+
+static WidgetMailbox *mailbox = nil;
+
++ (WidgetMailbox *)mailbox {
+	return mailbox;
+}
+
++ (void)setMailbox:(WidgetMailbox *)m {
+	mailbox = m;
+}
+
 #pragma mark Number Formatting
 
 // adapted from void my_numbox_ftoa(t_my_numbox *x) in g_numbox.c
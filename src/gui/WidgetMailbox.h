@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#import <Foundation/Foundation.h>
+#import "PdBase.h"
+
+@class Widget;
+@class PdDispatcher;
+
+/// latest value mailbox between the pd message queue & widgets
+///
+/// listens to the dispatcher for each widget receive name & forwards messages
+/// to the widgets, except for floats to widgets which only display them,
+/// ie. vu meters or sliders without a send name fed from [snapshot~]: these
+/// are stored in a table slot per widget & only the newest value is applied
+/// when the mailbox is delivered once per frame
+///
+/// any other message for a widget delivers its pending float first, so the
+/// order of messages per widget is kept
+///
+/// note: main thread only, the table is written while the pd message queue is
+///       drained & read when delivering, so no locking is needed
+@interface WidgetMailbox : NSObject <PdListener>
+
+/// floats applied to widgets by deliver
+@property (readonly, nonatomic) unsigned long deliveredCount;
+
+/// floats replaced by a newer value before they were delivered
+@property (readonly, nonatomic) unsigned long coalescedCount;
+
+/// pending floats dropped as their widget was removed
+@property (readonly, nonatomic) unsigned long droppedCount;
+
+/// init with the dispatcher to listen to
+- (id)initWithDispatcher:(PdDispatcher *)dispatcher;
+
+/// add widget as a receiver for a source, the widget is retained until removed
+- (void)addWidget:(Widget *)widget forSource:(NSString *)source;
+
+/// remove widget receiver for a source, drops any pending float
+- (void)removeWidget:(Widget *)widget forSource:(NSString *)source;
+
+/// apply the newest pending float for each widget, call once per frame after
+/// receiving messages
+- (void)deliver;
+
+/// reset counts
+- (void)resetCounts;
+
+@end
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#import "WidgetMailbox.h"
+
+#import "Widget.h"
+#import "PdDispatcher.h"
+#import "Log.h"
+
+/// table slot per widget
+typedef struct MailboxSlot {
+	float value;  ///< newest float
+	BOOL pending; ///< is the value waiting to be delivered?
+} MailboxSlot;
+
+@interface WidgetMailbox () {
+	__weak PdDispatcher *dispatcher;
+	NSMutableDictionary *sources; ///< slot number arrays by source name
+	NSMutableArray *widgets;      ///< widgets by slot, NSNull if free
+	NSMutableIndexSet *freeSlots;
+	MailboxSlot *slots;
+	int *queue;   ///< pending slots in the order they were first written
+	int count;    ///< queued slots
+	int capacity; ///< slot & queue size, a slot is queued at most once
+}
+@end
+
+@implementation WidgetMailbox
+
+- (id)initWithDispatcher:(PdDispatcher *)d {
+	self = [super init];
+	if(self) {
+		dispatcher = d;
+		sources = [NSMutableDictionary dictionary];
+		widgets = [NSMutableArray array];
+		freeSlots = [NSMutableIndexSet indexSet];
+	}
+	return self;
+}
+
+- (void)dealloc {
+	for(NSString *source in sources) {
+		[dispatcher removeListener:self forSource:source];
+	}
+	free(slots);
+	free(queue);
+}
+
+- (void)addWidget:(Widget *)widget forSource:(NSString *)source {
+	int slot;
+	if(freeSlots.count > 0) {
+		slot = (int)freeSlots.firstIndex;
+		[freeSlots removeIndex:slot];
+		widgets[slot] = widget;
+	}
+	else {
+		slot = (int)widgets.count;
+		if(slot >= capacity) {
+			int size = (capacity ? capacity * 2 : 64);
+			MailboxSlot *s = realloc(slots, size * sizeof(MailboxSlot));
+			if(s) {slots = s;}
+			int *q = realloc(queue, size * sizeof(int));
+			if(q) {queue = q;}
+			if(!s || !q) {
+				LogError(@"WidgetMailbox: couldn't grow table to %d slots", size);
+				return;
+			}
+			capacity = size;
+		}
+		[widgets addObject:widget];
+	}
+	slots[slot].value = 0;
+	slots[slot].pending = NO;
+	NSMutableArray *list = sources[source];
+	if(!list) {
+		list = [NSMutableArray array];
+		sources[source] = list;
+		[dispatcher addListener:self forSource:source];
+	}
+	[list addObject:@(slot)];
+}
+
+- (void)removeWidget:(Widget *)widget forSource:(NSString *)source {
+	NSMutableArray *list = sources[source];
+	for(NSUInteger i = 0; i < list.count; ++i) {
+		int slot = [list[i] intValue];
+		if(widgets[slot] != widget) {
+			continue;
+		}
+		if(slots[slot].pending) {
+			[self unqueueSlot:slot];
+			_droppedCount++;
+		}
+		widgets[slot] = NSNull.null;
+		[freeSlots addIndex:slot];
+		[list removeObjectAtIndex:i];
+		break;
+	}
+	if(list && list.count == 0) {
+		[sources removeObjectForKey:source];
+		[dispatcher removeListener:self forSource:source];
+	}
+}
+
+- (void)deliver {
+	int n = count;
+	count = 0;
+	for(int i = 0; i < n; ++i) {
+		int slot = queue[i];
+		if(!slots[slot].pending) {
+			continue;
+		}
+		slots[slot].pending = NO;
+		_deliveredCount++;
+		Widget *widget = widgets[slot];
+		[widget receiveFloat:slots[slot].value fromSource:widget.receiveName];
+	}
+}
+
+- (void)resetCounts {
+	_deliveredCount = 0;
+	_coalescedCount = 0;
+	_droppedCount = 0;
+}
+
+#pragma mark PdListener
+
+- (void)receiveBangFromSource:(NSString *)source {
+	for(NSNumber *slot in [sources[source] copy]) {
+		Widget *widget = [self flushSlot:slot.intValue];
+		[widget receiveBangFromSource:source];
+	}
+}
+
+// only floats are stored, the source list isn't copied as forwarding a float
+// doesn't change receive names
+- (void)receiveFloat:(float)received fromSource:(NSString *)source {
+	NSArray *list = sources[source];
+	for(NSUInteger i = 0; i < list.count; ++i) {
+		int slot = [list[i] intValue];
+		Widget *widget = widgets[slot];
+		if(widget.coalescesFloats) {
+			if(slots[slot].pending) {
+				_coalescedCount++;
+			}
+			else {
+				slots[slot].pending = YES;
+				queue[count++] = slot;
+			}
+			slots[slot].value = received;
+		}
+		else {
+			[self flushSlot:slot];
+			[widget receiveFloat:received fromSource:source];
+		}
+	}
+}
+
+- (void)receiveSymbol:(NSString *)symbol fromSource:(NSString *)source {
+	for(NSNumber *slot in [sources[source] copy]) {
+		Widget *widget = [self flushSlot:slot.intValue];
+		[widget receiveSymbol:symbol fromSource:source];
+	}
+}
+
+- (void)receiveList:(NSArray *)list fromSource:(NSString *)source {
+	for(NSNumber *slot in [sources[source] copy]) {
+		Widget *widget = [self flushSlot:slot.intValue];
+		[widget receiveList:list fromSource:source];
+	}
+}
+
+- (void)receiveMessage:(NSString *)message withArguments:(NSArray *)arguments fromSource:(NSString *)source {
+	for(NSNumber *slot in [sources[source] copy]) {
+		Widget *widget = [self flushSlot:slot.intValue];
+		[widget receiveMessage:message withArguments:arguments fromSource:source];
+	}
+}
+
+#pragma mark Private
+
+// deliver pending float for a slot right away, returns the slot's widget or
+// nil if it was removed while forwarding
+- (Widget *)flushSlot:(int)slot {
+	Widget *widget = widgets[slot];
+	if((id)widget == NSNull.null) {
+		return nil;
+	}
+	if(slots[slot].pending) {
+		[self unqueueSlot:slot];
+		_deliveredCount++;
+		[widget receiveFloat:slots[slot].value fromSource:widget.receiveName];
+	}
+	return widget;
+}
+
+// clear pending flag & remove slot from the queue
+- (void)unqueueSlot:(int)slot {
+	slots[slot].pending = NO;
+	for(int i = 0; i < count; ++i) {
+		if(queue[i] == slot) {
+			memmove(queue + i, queue + i + 1, (count - i - 1) * sizeof(int));
+			count--;
+			break;
+		}
+	}
+}
+
+@end
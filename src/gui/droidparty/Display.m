@@ -74,6 +74,10 @@
 	return @"Display";
 }
 
+- (BOOL)coalescesFloats {
+	return YES;
+}
+
 #pragma mark WidgetListener
 
 - (void)receiveBangFromSource:(NSString *)source {
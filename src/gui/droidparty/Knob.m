@@ -185,6 +185,10 @@
 	return @"Knob";
 }
 
+- (BOOL)coalescesFloats {
+	return ![self hasValidSendName];
+}
+
 #pragma mark Touches
 
 - (void)touchesBegan:(NSSet *)touches withEvent:(UIEvent *)event {
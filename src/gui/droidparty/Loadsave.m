@@ -121,27 +121,20 @@
 				[alert show];
 				return YES;
 			}
-			else {
-				[browser loadDirectory:path];
+			else if(![browser loadDirectory:path]) {
+				return YES;
 			}
 		}
-		else {
-			[browser loadDirectory:app.sceneManager.currentPath relativeTo:Util.documentsPath];
+		else if(![browser loadDirectory:app.sceneManager.currentPath relativeTo:Util.documentsPath]) {
+			return YES;
 		}
-		if(self.directory && self.extension && [browser fileCountForExtensions] == 0) {
-			if([message isEqualToString:@"load"]) {
-				LogVerbose(@"Loadsave: dir & extension set when loading, but no files to load");
-				NSString *title = [NSString stringWithFormat:@"No .%@ files found", self.extension];
-				UIAlertController *alert = [UIAlertController alertControllerWithTitle:title
-				                                                               message:@"Save one first?"
-				                                                        preferredStyle:UIAlertControllerStyleAlert];
-				UIAlertAction *okAction = [UIAlertAction actionWithTitle:@"Ok" style:UIAlertActionStyleDefault handler:nil];
-				[alert addAction:okAction];
-				[alert show];
-			}
-			else { // @"save"
-				[browser showNewFileDialog];
-			}
+		if(self.directory && self.extension) {
+			// files are counted once the dir is listed in the background
+			[browser whenListed:^(BOOL success) {
+				if(success) {
+					[self showBrowser:browser forMessage:message];
+				}
+			}];
 		}
 		else {
 			[browser presentAnimated:YES];
@@ -165,6 +158,28 @@
 
 #pragma mark Private
 
+// present the browser or, if there are no files with the extension, show a
+// load alert or the new file dialog
+- (void)showBrowser:(PartyBrowser *)browser forMessage:(NSString *)message {
+	if([browser fileCountForExtensions] > 0) {
+		[browser presentAnimated:YES];
+		return;
+	}
+	if([message isEqualToString:@"load"]) {
+		LogVerbose(@"Loadsave: dir & extension set when loading, but no files to load");
+		NSString *title = [NSString stringWithFormat:@"No .%@ files found", self.extension];
+		UIAlertController *alert = [UIAlertController alertControllerWithTitle:title
+		                                                               message:@"Save one first?"
+		                                                        preferredStyle:UIAlertControllerStyleAlert];
+		UIAlertAction *okAction = [UIAlertAction actionWithTitle:@"Ok" style:UIAlertActionStyleDefault handler:nil];
+		[alert addAction:okAction];
+		[alert show];
+	}
+	else { // @"save"
+		[browser showNewFileDialog];
+	}
+}
+
 - (void)sendPath:(NSString *)path {
 	LogVerbose(@"Loadsave %@: sending %@", self.sendName, path);
 	NSArray *detail = @[ // ext file dir
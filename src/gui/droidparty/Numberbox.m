@@ -109,6 +109,10 @@
 	return @"Numberbox";
 }
 
+- (BOOL)coalescesFloats {
+	return YES;
+}
+
 #pragma mark Touches
 
 - (void)touchesBegan:(NSSet *)touches withEvent:(UIEvent *)event {
@@ -208,6 +208,10 @@
 	return @"Number2";
 }
 
+- (BOOL)coalescesFloats {
+	return ![self hasValidSendName];
+}
+
 #pragma mark Touches
 
 - (void)touchesBegan:(NSSet *)touches withEvent:(UIEvent *)event {
@@ -151,6 +151,10 @@
 	return @"VRadio";
 }
 
+- (BOOL)coalescesFloats {
+	return ![self hasValidSendName];
+}
+
 #pragma mark Touches
 
 - (void)touchesBegan:(NSSet *)touches withEvent:(UIEvent *)event {
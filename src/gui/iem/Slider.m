@@ -208,6 +208,11 @@
 	return @"VSlider";
 }
 
+// received floats are passed through, so only coalesce without a send name
+- (BOOL)coalescesFloats {
+	return ![self hasValidSendName];
+}
+
 #pragma mark Touches
 
 // from g_hslider.c & g_vslider.c
@@ -136,6 +136,10 @@
 	return @"Toggle";
 }
 
+- (BOOL)coalescesFloats {
+	return ![self hasValidSendName];
+}
+
 #pragma mark Touches
 
 - (void)touchesBegan:(NSSet *)touches withEvent:(UIEvent *)event {
@@ -230,6 +230,10 @@
 	return @"VUMeter";
 }
 
+- (BOOL)coalescesFloats {
+	return YES;
+}
+
 #pragma mark WidgetListener
 
 - (void)receiveBangFromSource:(NSString *)source {
@@ -10,6 +10,7 @@
  */
 #import "Midi.h"
 #import "PdBase.h"
+#import "MidiScheduler.h"
 
 // max allowed input & output ports (to show)
 #define MIDI_MAX_IO 16
@@ -46,6 +47,14 @@
 @property (nonatomic, readonly) NSArray *inputs;
 @property (nonatomic, readonly) NSArray *outputs;
 
+/// input scheduling timing stats, reset when enabled
+@property (nonatomic, readonly) MidiSchedulerStats inputStats;
+
+/// send MIDI output from pd collected since the last call as one packet list
+/// per port, call after each [PdBase receiveMidi] on the same thread,
+/// returns YES if there was any output
+- (BOOL)sendPendingOutput;
+
 /// move MidiInput/MidiOutput port indices
 - (BOOL)moveInputPort:(int)port toPort:(int)newPort;
 - (BOOL)moveOutputPort:(int)port toPort:(int)newPort;
@@ -13,15 +13,51 @@
 #import "Log.h"
 #import "PdBase.h"
 #import "Util.h"
+#import "MidiWriter.h"
+
+#include <mach/mach_time.h>
+#import "z_libpd.h"
+#import "m_pd.h"
+#import "s_stuff.h" // for inmidi_*
 
 // verbose prints for testing MIDI IO
 //#define DEBUG_MIDI
 
+/// input scheduler run by a pd clock once per DSP tick, events pushed after
+/// the last tick are flushed by a one-shot timer once the scheduler is idle
+typedef struct MidiBridgeTicker {
+	MidiScheduler scheduler;
+	t_clock *clock;
+	t_float sampleRate;
+	__unsafe_unretained dispatch_source_t flushTimer; ///< owned by the bridge
+	int flushArmed; ///< is the flush timer pending?
+} MidiBridgeTicker;
+
+static void MidiBridgeTick(MidiBridgeTicker *ticker);
+static void MidiBridgeArmFlush(MidiBridgeTicker *ticker);
+static void MidiBridgeFlushIdle(MidiBridgeTicker *ticker);
+static void MidiBridgeSendEvent(const MidiEvent *event, int port, void *userData);
+
+/// per port output accumulator
+typedef struct MidiBridgeWriter {
+	MidiWriter writer;
+	int port;
+	__unsafe_unretained MidiBridge *bridge;
+} MidiBridgeWriter;
+
+static void MidiBridgeWrite(const uint8_t *bytes, size_t length, void *userData);
+
 @interface MidiBridge () {
-	NSMutableData *message;
 	NSTimer *connectionEventTimer;
+	MidiBridgeWriter writers[MIDI_MAX_PORT]; ///< output, sent once per cycle
+	MidiBridgeTicker *ticker; ///< input event scheduling, nil when disabled
+	dispatch_queue_t flushQueue;  ///< runs the ticker flush timer
+	dispatch_source_t flushTimer; ///< ticker flush timer
 }
 @property (nonatomic, strong) Midi *midi; ///< underlying midi object
+/// outputs copy for sending, atomic as output may be sent from a background
+/// queue while connections change on the main thread
+@property (atomic, strong) NSArray *sendOutputs;
 @end
 
 @implementation MidiBridge
@@ -29,7 +65,12 @@
 - (id)init {
 	self = [super init];
 	if(self) {
-		message = [NSMutableData data];
+		for(int i = 0; i < MIDI_MAX_PORT; ++i) {
+			// no running status as CoreMIDI packets must not use it
+			MidiWriterInit(&writers[i].writer, MidiBridgeWrite, &writers[i], 0);
+			writers[i].port = i;
+			writers[i].bridge = self;
+		}
 
 		NSUserDefaults *defaults = NSUserDefaults.standardUserDefaults;
 		_multiDeviceMode = [defaults boolForKey:@"multiMidiDeviceMode"];
@@ -41,6 +82,7 @@
 - (void)dealloc {
 	[connectionEventTimer invalidate];
 	self.midi.delegate = nil;
+	[self stopScheduler];
 }
 
 - (NSString *)description {
@@ -56,7 +98,18 @@
 }
 
 - (BOOL)moveOutputPort:(int)port toPort:(int)newPort {
-	return [self.midi moveOutputPort:port toPort:newPort];
+	BOOL moved = [self.midi moveOutputPort:port toPort:newPort];
+	self.sendOutputs = [self.midi.outputs copy];
+	return moved;
+}
+
+- (BOOL)sendPendingOutput {
+	BOOL output = NO;
+	for(int i = 0; i < MIDI_MAX_PORT; ++i) {
+		output |= (writers[i].writer.length > 0);
+		MidiWriterFlush(&writers[i].writer);
+	}
+	return output;
 }
 
 #pragma mark Overridden Getters / Setters
@@ -70,10 +123,12 @@
 		if([Midi available]) {
 			LogVerbose(@"MidiBridge: midi enabled");
 			self.midi = nil;
+			[self startScheduler]; // before any input arrives
 			self.midi = [[Midi alloc] initWithName:@"PdParty" andMaxIO:MIDI_MAX_IO];
 			self.midi.delegate = self;
 			self.midi.virtualEnabled = [defaults boolForKey:@"virtualMidiEnabled"];
 			self.midi.networkEnabled = [defaults boolForKey:@"networkMidiEnabled"];
+			self.sendOutputs = [self.midi.outputs copy];
 			[defaults setBool:YES forKey:@"midiEnabled"];
 		}
 		else {
@@ -82,7 +137,9 @@
 	}
 	else {
 		self.midi.delegate = nil;
+		self.sendOutputs = nil;
 		self.midi = nil;
+		[self stopScheduler];
 		[defaults setBool:NO forKey:@"midiEnabled"];
 		LogVerbose(@"MidiBridge: midi disabled");
 	}
@@ -132,6 +189,16 @@
 	return self.midi.outputs;
 }
 
+- (MidiSchedulerStats)inputStats {
+	MidiSchedulerStats stats = {0};
+	if(ticker) {
+		sys_lock(); // released on the audio thread while pd is locked
+		stats = ticker->scheduler.stats;
+		sys_unlock();
+	}
+	return stats;
+}
+
 #pragma mark PGMidiDelegate
 
 -(void)midi:(Midi *)midi inputAdded:(MidiInput *)input {
@@ -147,111 +214,49 @@
 }
 
 - (void)midi:(Midi *)midi outputAdded:(MidiOutput *)output {
+	self.sendOutputs = [midi.outputs copy];
 	[self connectionEventReceived];
 	LogVerbose(@"MidiBridge: output added: \"%@\"", output.name);
 }
 
 - (void)midi:(Midi *)midi outputRemoved:(MidiOutput *)output {
+	self.sendOutputs = [midi.outputs copy];
 	[self connectionEventReceived];
 	LogVerbose(@"MidiBridge: output removed: \"%@\"", output.name);
 }
 
 #pragma mark MidiInputDelegate
 
-- (void)midiInput:(MidiInput *)input receivedMessage:(NSData *)message {
+// called on the MIDI thread, events are queued with their timestamps and sent
+// to pd on the audio thread at the matching DSP tick or sent right away when
+// audio is stopped and no ticks are run
+- (void)midiInput:(MidiInput *)input receivedEvent:(const MidiEvent *)event {
 	if(_multiDeviceMode && input.port >= MIDI_MAX_PORT) {return;}
-
-	const unsigned char *bytes = (const unsigned char *)[message bytes];
-	int statusByte = bytes[0];
-	int channel = 0;
 	int port = (_multiDeviceMode ? input.port : 0);
 
-	if(bytes[0] >= MIDI_SYSEX) {
-		statusByte = bytes[0] & 0xFF;
-	}
-	else {
-		statusByte = bytes[0] & 0xF0;
-		channel = (int) (bytes[0] & 0x0F);
-		if(self.multiDeviceMode) {
-			// add port offset
-			channel += port * 16;
-		}
-	}
-
 	#ifdef DEBUG_MIDI
-		[Util logData:message withHeader:[NSString stringWithFormat:@"MidiBridge: input %d received ", input.port]];
+		const unsigned char *bytes = (event->sysex ? event->sysex : event->bytes);
+		size_t length = (event->sysex ? event->sysexLength : event->length);
+		[Util logData:[NSData dataWithBytes:bytes length:length] withHeader:[NSString stringWithFormat:@"MidiBridge: input %d received ", input.port]];
 	#endif
 
-	// send message to appropriate object: [notein], [ctlin], [pgmin], etc
-	switch(statusByte) {
-		case MIDI_NOTE_ON:
-			[PdBase sendNoteOn:channel pitch:bytes[1] velocity:bytes[2]];
-			#ifdef DEBUG_MIDI
-				LogVerbose(@"MidiBridge: received Note On %d %d %d", channel, bytes[1], bytes[2]);
-			#endif
-			break;
-		case MIDI_NOTE_OFF: // ignore velocity a pd uses vel 0 to indicate note off
-			[PdBase sendNoteOn:channel pitch:bytes[1] velocity:0];
-			#ifdef DEBUG_MIDI
-				LogVerbose(@"MidiBridge: received Note Off %d %d %d -> 0", channel, bytes[1], bytes[2]);
-			#endif
-			break;
-		case MIDI_CONTROL_CHANGE: {
-			[PdBase sendControlChange:channel controller:bytes[1] value:bytes[2]];
-			#ifdef DEBUG_MIDI
-				LogVerbose(@"MidiBridge: received Control %d %d %d", channel, bytes[1], bytes[2]);
-			#endif
-			break;
-		}
-		case MIDI_PROGRAM_CHANGE:
-			[PdBase sendProgramChange:channel value:bytes[1]];
-			#ifdef DEBUG_MIDI
-				LogVerbose(@"MidiBridge: received Program %d %d", channel, bytes[1]);
-			#endif
-			break;
-		case MIDI_PITCH_BEND: {
-			int value = (bytes[2] << 7) + bytes[1]; // msb + lsb
-			value -= 8192; // convert range from 0 - 16384 to libpd -8192 - 8192
-			[PdBase sendPitchBend:channel value:value];
-			#ifdef DEBUG_MIDI
-				LogVerbose(@"MidiBridge: received PitchBend %d %d", channel, value);
-			#endif
-			break;
-		}
-		case MIDI_AFTERTOUCH:
-			[PdBase sendAftertouch:channel value:bytes[1]];
-			#ifdef DEBUG_MIDI
-				LogVerbose(@"MidiBridge: received Aftertouch %d %d", channel, bytes[1]);
-			#endif
-			break;
-		case MIDI_POLY_AFTERTOUCH:
-			[PdBase sendPolyAftertouch:channel pitch:bytes[1] value:bytes[2]];
-			#ifdef DEBUG_MIDI
-				LogVerbose(@"MidiBridge: received PolyAftertouch %d %d %d", channel, bytes[1], bytes[2]);
-			#endif
-			break;
-		case MIDI_SYSEX:
-			for(int i = 0; i < message.length; ++i) {
-				[PdBase sendSysex:channel byte:bytes[i]];
-			}
-			#ifdef DEBUG_MIDI
-				LogVerbose(@"MidiBridge: received %d Sysex bytes to %d", (int)message.length, channel);
-			#endif
-			break;
-		case MIDI_TIME_CLOCK: case MIDI_START: case MIDI_CONTINUE: case MIDI_STOP:
-		case MIDI_ACTIVE_SENSING: case MIDI_SYSTEM_RESET:
-			[PdBase sendSysRealTime:port byte:bytes[0]];
-			#ifdef DEBUG_MIDI
-				LogVerbose(@"MidiBridge: received %d Realtime bytes", (int)message.length);
-			#endif
-			return; // realtime bytes do not go to [midiin]
-		default:
-			break;
+	if(!ticker) {return;}
+	if(!MidiSchedulerActive(&ticker->scheduler, mach_absolute_time())) {
+		// same as libpd_noteon, etc: lock pd & send, keep order with anything
+		// queued before audio stopped
+		sys_lock();
+		MidiSchedulerFlush(&ticker->scheduler, MidiBridgeSendEvent, NULL);
+		MidiBridgeSendEvent(event, port, NULL);
+		sys_unlock();
 	}
-
-	// send raw byte data to [midiin]
-	for(int i = 0; i < message.length; ++i) {
-		[PdBase sendMidiByte:port byte:bytes[i]];
+	else if(!MidiSchedulerPush(&ticker->scheduler, event, port)) {
+		#ifdef DEBUG_MIDI
+			LogVerbose(@"MidiBridge: input queue full, dropped event");
+		#endif
+	}
+	else {
+		// DSP may have just stopped, deliver once idle if no tick does
+		MidiBridgeArmFlush(ticker);
 	}
 }
 
@@ -267,12 +272,11 @@
 	#ifdef DEBUG_MIDI
 		LogVerbose(@"MidiBridge: sending Note %d %d %d", channel, pitch, velocity);
 	#endif
-	[message setLength:3];
-	unsigned char *bytes = (unsigned char *)[message bytes];
+	unsigned char bytes[3];
 	bytes[0] = MIDI_NOTE_ON+channel;
 	bytes[1] = pitch;
 	bytes[2] = velocity;
-	[self sendMessage:message toPort:port];
+	[self writeMessage:bytes length:3 toPort:port];
 }
 
 - (void)receiveControlChange:(int)value forController:(int)controller forChannel:(int)channel {
@@ -285,12 +289,11 @@
 	#ifdef DEBUG_MIDI
 		LogVerbose(@"MidiBridge: sending Control %d %d %d", channel, controller, value);
 	#endif
-	[message setLength:3];
-	unsigned char *bytes = (unsigned char *)[message bytes];
+	unsigned char bytes[3];
 	bytes[0] = MIDI_CONTROL_CHANGE+channel;
 	bytes[1] = controller;
 	bytes[2] = value;
-	[self sendMessage:message toPort:port];
+	[self writeMessage:bytes length:3 toPort:port];
 }
 
 - (void)receiveProgramChange:(int)value forChannel:(int)channel {
@@ -303,11 +306,10 @@
 	#ifdef DEBUG_MIDI
 		LogVerbose(@"MidiBridge: sending Program %d %d", channel, value);
 	#endif
-	[message setLength:2];
-	unsigned char *bytes = (unsigned char *)[message bytes];
+	unsigned char bytes[2];
 	bytes[0] = MIDI_PROGRAM_CHANGE+channel;
 	bytes[1] = value;
-	[self sendMessage:message toPort:port];
+	[self writeMessage:bytes length:2 toPort:port];
 }
 
 - (void)receivePitchBend:(int)value forChannel:(int)channel {
@@ -321,12 +323,11 @@
 	#ifdef DEBUG_MIDI
 		LogVerbose(@"MidiBridge: sending PitchBend %d %d", channel, value);
 	#endif
-	[message setLength:3];
-	unsigned char *bytes = (unsigned char *)[message bytes];
+	unsigned char bytes[3];
 	bytes[0] = MIDI_PITCH_BEND+channel;
 	bytes[1] = value & 0x7F; // lsb 7bit
 	bytes[2] = (value >> 7) & 0x7F; // msb 7bit
-	[self sendMessage:message toPort:port];
+	[self writeMessage:bytes length:3 toPort:port];
 }
 
 - (void)receiveAftertouch:(int)value forChannel:(int)channel {
@@ -339,11 +340,10 @@
 	#ifdef DEBUG_MIDI
 		LogVerbose(@"MidiBridge: sending Aftertouch %d %d", channel, value);
 	#endif
-	[message setLength:2];
-	unsigned char *bytes = (unsigned char *)[message bytes];
+	unsigned char bytes[2];
 	bytes[0] = MIDI_AFTERTOUCH+channel;
 	bytes[1] = value;
-	[self sendMessage:message toPort:port];
+	[self writeMessage:bytes length:2 toPort:port];
 }
 
 - (void)receivePolyAftertouch:(int)value forPitch:(int)pitch forChannel:(int)channel {
@@ -356,12 +356,11 @@
 	#ifdef DEBUG_MIDI
 		LogVerbose(@"MidiBridge: sending PolyAftertouch %d %d %d", channel, pitch, value);
 	#endif
-	[message setLength:3];
-	unsigned char *bytes = (unsigned char *)[message bytes];
+	unsigned char bytes[3];
 	bytes[0] = MIDI_POLY_AFTERTOUCH+channel;
 	bytes[1] = pitch;
 	bytes[2] = value;
-	[self sendMessage:message toPort:port];
+	[self writeMessage:bytes length:3 toPort:port];
 }
 
 - (void)receiveMidiByte:(int)byte forPort:(int)port {
@@ -369,23 +368,88 @@
 	#ifdef DEBUG_MIDI
 		LogVerbose(@"MidiBridge: sending Midi byte %02X", byte);
 	#endif
-	[message setLength:1];
-	unsigned char *bytes = (unsigned char *)[message bytes];
-	bytes[0] = byte;
-	[self sendMessage:message toPort:port];
+	[self writeByte:byte toPort:port];
 }
 
 #pragma mark Private
 
-- (void)sendMessage:(NSData *)message toPort:(int)port {
+// create the input scheduler & start its pd clock
+- (void)startScheduler {
+	if(ticker) {
+		return;
+	}
+	mach_timebase_info_data_t timebase;
+	mach_timebase_info(&timebase);
+	ticker = (MidiBridgeTicker *)malloc(sizeof(MidiBridgeTicker));
+	MidiSchedulerInit(&ticker->scheduler, 1.0e9 * timebase.denom / timebase.numer);
+	ticker->sampleRate = 0;
+	flushQueue = dispatch_queue_create("MidiBridge.flush", DISPATCH_QUEUE_SERIAL);
+	flushTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, flushQueue);
+	ticker->flushTimer = flushTimer;
+	ticker->flushArmed = 0;
+	MidiBridgeTicker *flushTicker = ticker;
+	dispatch_source_set_event_handler(flushTimer, ^{
+		MidiBridgeFlushIdle(flushTicker);
+	});
+	dispatch_resume(flushTimer);
+	libpd_init(); // the clock needs pd, does nothing if already initialized
+	sys_lock();
+	ticker->clock = clock_new(ticker, (t_method)MidiBridgeTick);
+	clock_setunit(ticker->clock, DEFDACBLKSIZE, 1); // ticks
+	clock_delay(ticker->clock, 0);
+	sys_unlock();
+}
+
+// stop the pd clock & free the input scheduler
+- (void)stopScheduler {
+	if(!ticker) {
+		return;
+	}
+	dispatch_source_cancel(flushTimer);
+	dispatch_sync(flushQueue, ^{}); // wait for a running flush
+	flushTimer = nil;
+	flushQueue = nil;
+	sys_lock();
+	clock_free(ticker->clock);
+	MidiSchedulerStats stats = ticker->scheduler.stats;
+	sys_unlock();
+	LogVerbose(@"MidiBridge: input released %lu dropped %lu jitter %g ms latency %g ms",
+		stats.released, stats.dropped, (stats.maxDelay - stats.minDelay) * 1000.0, stats.latency * 1000.0);
+	free(ticker);
+	ticker = NULL;
+}
+
+// add message to the port's pending output, all ports share port 0 when not
+// in multiple device mode
+- (void)writeMessage:(const unsigned char *)bytes length:(size_t)length toPort:(int)port {
+	if(!self.multiDeviceMode) {port = 0;}
+	if(port < 0 || port >= MIDI_MAX_PORT) {return;}
+	MidiWriterMessage(&writers[port].writer, bytes, length);
+}
+
+// add raw byte to the port's pending output, split into messages as it comes
+- (void)writeByte:(unsigned char)byte toPort:(int)port {
+	if(!self.multiDeviceMode) {port = 0;}
+	if(port < 0 || port >= MIDI_MAX_PORT) {return;}
+	MidiWriterByte(&writers[port].writer, byte);
+}
+
+- (void)sendBytes:(const unsigned char *)bytes length:(size_t)length toPort:(int)port {
 	#ifdef DEBUG_MIDI
-		[Util logData:message withHeader:[NSString stringWithFormat:@"MidiBridge: sending"]];
+		[Util logData:[NSData dataWithBytes:bytes length:length] withHeader:[NSString stringWithFormat:@"MidiBridge: sending"]];
 	#endif
-	if(self.multiDeviceMode) {
-		[self.midi sendMessage:message toPort:port];
-	}
-	else {
-		[self.midi sendMessageToAllPorts:message];
+	// outputs snapshot is sorted by port
+	for(MidiOutput *output in self.sendOutputs) {
+		if(!self.multiDeviceMode) {
+			[output sendBytes:bytes length:length];
+		}
+		else if(output.port == port) {
+			[output sendBytes:bytes length:length];
+			break;
+		}
+		else if(output.port > port) {
+			break;
+		}
 	}
 }
 
@@ -405,3 +469,108 @@
 }
 
 @end
+
+#pragma mark Output
+
+// MidiWriter callback, sends pending bytes for a port as a single packet
+static void MidiBridgeWrite(const uint8_t *bytes, size_t length, void *userData) {
+	MidiBridgeWriter *writer = (MidiBridgeWriter *)userData;
+	[writer->bridge sendBytes:bytes length:length toPort:writer->port];
+}
+
+#pragma mark Input Scheduling
+
+// MidiScheduler callback, called on the audio thread while pd is locked so
+// this talks to pd directly instead of going through PdBase, see libpd_noteon
+static void MidiBridgeSendEvent(const MidiEvent *event, int port, void *userData) {
+	const uint8_t *bytes = event->bytes;
+	int channel = bytes[0] & 0x0F;
+
+	if(event->sysex) {
+		// sysex segment, may not start with the status byte
+		for(size_t i = 0; i < event->sysexLength; ++i) {
+			inmidi_sysex(port, event->sysex[i]);
+		}
+		for(size_t i = 0; i < event->sysexLength; ++i) {
+			inmidi_byte(port, event->sysex[i]);
+		}
+		return;
+	}
+
+	// send message to appropriate object: [notein], [ctlin], [pgmin], etc
+	if(bytes[0] < MIDI_SYSEX) {
+		switch(bytes[0] & 0xF0) {
+			case MIDI_NOTE_ON:
+				inmidi_noteon(port, channel, bytes[1], bytes[2]);
+				break;
+			case MIDI_NOTE_OFF: // ignore velocity a pd uses vel 0 to indicate note off
+				inmidi_noteon(port, channel, bytes[1], 0);
+				break;
+			case MIDI_CONTROL_CHANGE:
+				inmidi_controlchange(port, channel, bytes[1], bytes[2]);
+				break;
+			case MIDI_PROGRAM_CHANGE:
+				inmidi_programchange(port, channel, bytes[1]);
+				break;
+			case MIDI_PITCH_BEND:
+				inmidi_pitchbend(port, channel, (bytes[2] << 7) + bytes[1]); // msb + lsb
+				break;
+			case MIDI_AFTERTOUCH:
+				inmidi_aftertouch(port, channel, bytes[1]);
+				break;
+			case MIDI_POLY_AFTERTOUCH:
+				inmidi_polyaftertouch(port, channel, bytes[1], bytes[2]);
+				break;
+			default:
+				break;
+		}
+	}
+	else if(bytes[0] >= MIDI_TIME_CLOCK) {
+		inmidi_realtimein(port, bytes[0]);
+		return; // realtime bytes do not go to [midiin]
+	}
+
+	// send raw byte data to [midiin]
+	for(int i = 0; i < event->length; ++i) {
+		inmidi_byte(port, bytes[i]);
+	}
+}
+
+// arm the flush timer for when the scheduler goes idle unless already armed
+// producer thread or flush queue
+static void MidiBridgeArmFlush(MidiBridgeTicker *ticker) {
+	if(__atomic_exchange_n(&ticker->flushArmed, 1, __ATOMIC_ACQ_REL)) {
+		return;
+	}
+	uint64_t now = mach_absolute_time(), idle = MidiSchedulerIdleTime(&ticker->scheduler);
+	double delay = (idle > now ? (idle - now) / ticker->scheduler.hostRate : 0) + 0.001;
+	dispatch_source_set_timer(ticker->flushTimer,
+		dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+		DISPATCH_TIME_FOREVER, NSEC_PER_MSEC);
+}
+
+// flush timer callback, delivers events left queued once ticks stopped or
+// waits for the next idle time while ticks are still being run
+static void MidiBridgeFlushIdle(MidiBridgeTicker *ticker) {
+	__atomic_store_n(&ticker->flushArmed, 0, __ATOMIC_RELEASE);
+	if(!MidiSchedulerPending(&ticker->scheduler)) {
+		return; // released by ticks
+	}
+	if(MidiSchedulerActive(&ticker->scheduler, mach_absolute_time())) {
+		MidiBridgeArmFlush(ticker);
+		return;
+	}
+	sys_lock(); // keeps ticks out, same as an idle push
+	MidiSchedulerFlush(&ticker->scheduler, MidiBridgeSendEvent, NULL);
+	sys_unlock();
+}
+
+// pd clock callback, runs right before each DSP tick
+static void MidiBridgeTick(MidiBridgeTicker *ticker) {
+	if(ticker->sampleRate != sys_getsr()) {
+		ticker->sampleRate = sys_getsr();
+		MidiSchedulerSetTickSize(&ticker->scheduler, ticker->sampleRate, DEFDACBLKSIZE);
+	}
+	MidiSchedulerTick(&ticker->scheduler, mach_absolute_time(), MidiBridgeSendEvent, NULL);
+	clock_delay(ticker->clock, 1);
+}
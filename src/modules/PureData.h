@@ -60,6 +60,16 @@
 
 @class Osc;
 @class Sensors;
+@class MidiBridge;
+@class WidgetMailbox;
+
+/// message queue polling stats, intervals are the time in s between polls
+/// which bounds how long pd output waits in the libpd queues
+typedef struct PureDataPollStats {
+	unsigned long polls; ///< polls run
+	double meanInterval; ///< average time between polls, mean latency is half
+	double maxInterval;  ///< longest time between polls, worst case latency
+} PureDataPollStats;
 
 /// custom dispatcher to grab print events
 @interface PureDataDispatcher : PdDispatcher
@@ -93,8 +103,10 @@
 @interface PureData : NSObject <PdReceiverDelegate, PdMidiReceiverDelegate>
 
 @property (strong, nonatomic) PureDataDispatcher *dispatcher; ///< message dispatcher
+@property (strong, nonatomic) WidgetMailbox *mailbox; ///< per frame widget updates
 @property (weak, nonatomic) Osc *osc; ///< pointer to osc instance
 @property (weak, nonatomic) Sensors *sensors; ///< pointer to sensor manager instance
+@property (weak, nonatomic) MidiBridge *midi; ///< pointer to midi bridge instance
 
 /// enable / disable PD audio processing
 @property (getter=isAudioEnabled, nonatomic) BOOL audioEnabled;
@@ -116,6 +128,20 @@
 /// only has effect on iPhone, always NO on iPad or iPod
 @property (nonatomic) BOOL earpieceSpeaker;
 
+/// pd midi output polling rate in Hz (default: 1000)
+///
+/// midi output is polled on a background queue at this rate while audio is
+/// enabled, so it isn't tied to the screen refresh rate, set to 0 to poll with
+/// the messages once per frame
+///
+/// polling backs off to 100 Hz while there is no output and returns to this
+/// rate as soon as there is
+@property (nonatomic) int midiPollRate;
+
+/// polling stats, reset when audio is enabled
+@property (readonly, nonatomic) PureDataPollStats messagePollStats;
+@property (readonly, nonatomic) PureDataPollStats midiPollStats;
+
 /// preferred sample rate from current user defaults (default: 48000)
 /// does not affect or reflect current sampleRate value
 @property (nonatomic) int userSampleRate;
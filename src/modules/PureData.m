@@ -14,11 +14,18 @@
 #import "AppDelegate.h"
 #import "Log.h"
 #import "Osc.h"
+#import "MidiBridge.h"
+#import "WidgetMailbox.h"
 #import "Sensors.h"
 #import "Controllers.h"
 #import "Externals.h"
 #import "Util.h"
 
+// midi output polling backs off to this rate in Hz when there has been no
+// output for the idle time in s, back to the full rate on the next output
+#define MIDI_IDLE_POLL_RATE 100
+#define MIDI_IDLE_TIME 0.25
+
 // for find functionality
 #import "m_pd.h"
 #import "g_canvas.h"
@@ -27,11 +34,33 @@
 	PdAudioController *audioController;
 	PdFile *playbackPatch;
 	CADisplayLink *updateLink;
+	dispatch_queue_t midiQueue;  ///< background midi polling queue
+	dispatch_source_t midiTimer; ///< midi polling timer, nil when not polling
+	CFTimeInterval lastMessagePoll; ///< time of the last poll, 0 if none
+	CFTimeInterval lastMidiPoll;
+	CFTimeInterval lastMidiOutput; ///< time of the last polled midi output
+	BOOL midiPollIdle; ///< polling at the idle rate?
+	PureDataPollStats messageStats;
+	PureDataPollStats midiStats; ///< midi queue only
 	id routeChangeObserver; ///< opaque route change notification handle
 }
 @property (assign, readwrite, getter=isRecording, nonatomic) BOOL recording;
 @end
 
+// add a poll at the current time to the stats
+static void PureDataPollStatsUpdate(PureDataPollStats *stats, CFTimeInterval *last) {
+	CFTimeInterval now = CACurrentMediaTime();
+	if(*last > 0) {
+		double interval = now - *last;
+		stats->meanInterval += (interval - stats->meanInterval) / stats->polls;
+		if(interval > stats->maxInterval) {
+			stats->maxInterval = interval;
+		}
+	}
+	stats->polls++;
+	*last = now;
+}
+
 @implementation PureData
 
 - (id)init {
@@ -64,6 +93,7 @@
 		// set dispatcher delegate
 		self.dispatcher = [[PureDataDispatcher alloc] init];
 		[PdBase setDelegate:self.dispatcher pollingEnabled:NO];
+		self.mailbox = [[WidgetMailbox alloc] initWithDispatcher:self.dispatcher];
 		
 		// add this class as a receiver
 		[self.dispatcher addListener:self forSource:PD_OSC_S];
@@ -86,6 +116,10 @@
 		updateLink.preferredFramesPerSecond = 60;
 		[updateLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
 
+		// background queue for faster midi output polling, started with audio
+		midiQueue = dispatch_queue_create("PureData.midi", DISPATCH_QUEUE_SERIAL);
+		_midiPollRate = (int)[defaults integerForKey:@"midiPollRate"];
+
 		// observe audio route changes
 		routeChangeObserver = [NSNotificationCenter.defaultCenter addObserverForName:AVAudioSessionRouteChangeNotification object:nil queue:NSOperationQueue.mainQueue usingBlock:^(NSNotification *notification) {
 			NSDictionary *info = notification.userInfo;
@@ -128,6 +162,7 @@
 		[updateLink invalidate];
 	}
 	updateLink = nil;
+	[self stopMidiPolling];
 }
 
 - (int)calculateBufferSize {
@@ -713,6 +748,42 @@
 	if(audioController.active == enabled) return;
 	audioController.active = enabled;
 	updateLink.paused = !enabled;
+	if(enabled) {
+		messageStats = (PureDataPollStats){0};
+		lastMessagePoll = 0;
+		if(self.midiPollRate > 0) {
+			[self startMidiPolling];
+		}
+	}
+	else {
+		[self stopMidiPolling];
+	}
+}
+
+- (void)setMidiPollRate:(int)midiPollRate {
+	if(midiPollRate < 0) {
+		LogWarn(@"PureData: ignoring obviously bad midi poll rate: %d", midiPollRate);
+		return;
+	}
+	if(_midiPollRate == midiPollRate) return;
+	_midiPollRate = midiPollRate;
+	[NSUserDefaults.standardUserDefaults setInteger:midiPollRate forKey:@"midiPollRate"];
+	[self stopMidiPolling];
+	if(midiPollRate > 0 && self.audioEnabled) {
+		[self startMidiPolling];
+	}
+}
+
+- (PureDataPollStats)messagePollStats {
+	return messageStats;
+}
+
+- (PureDataPollStats)midiPollStats {
+	__block PureDataPollStats stats;
+	dispatch_sync(midiQueue, ^{
+		stats = self->midiStats;
+	});
+	return stats;
 }
 
 - (void)setPlaying:(BOOL)playing {
@@ -899,10 +970,69 @@ static NSNumberFormatter *s_numFormatter = nil;
 	audioController.active = YES;
 }
 
-// process messages waiting in the queues
+// process messages waiting in the queues, midi is polled separately when
+// the midi timer is running
 - (void)updateMessages:(CADisplayLink *)displayLink {
+	PureDataPollStatsUpdate(&messageStats, &lastMessagePoll);
 	[PdBase receiveMessages];
+	[self.mailbox deliver];
+	if(!midiTimer) {
+		[PdBase receiveMidi];
+		[self.midi sendPendingOutput];
+	}
+}
+
+// start polling midi on the midi queue at the midi poll rate
+- (void)startMidiPolling {
+	if(midiTimer) return;
+	midiStats = (PureDataPollStats){0}; // queue is idle without a timer
+	lastMidiPoll = 0;
+	lastMidiOutput = CACurrentMediaTime();
+	midiPollIdle = NO;
+	midiTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, midiQueue);
+	[PureData setMidiTimer:midiTimer rate:self.midiPollRate];
+	__weak PureData *weakSelf = self;
+	__weak dispatch_source_t weakTimer = midiTimer;
+	dispatch_source_set_event_handler(midiTimer, ^{
+		[weakSelf pollMidiWithTimer:weakTimer];
+	});
+	dispatch_resume(midiTimer);
+	LogVerbose(@"PureData: polling midi at %d Hz", self.midiPollRate);
+}
+
+// stop polling midi & wait for a running poll to finish, libpd's midi queue
+// must only be read from one thread at a time
+- (void)stopMidiPolling {
+	if(!midiTimer) return;
+	dispatch_source_cancel(midiTimer);
+	midiTimer = nil;
+	dispatch_sync(midiQueue, ^{});
+}
+
+// called on the midi queue, polls at the idle rate while there is no output
+- (void)pollMidiWithTimer:(dispatch_source_t)timer {
+	PureDataPollStatsUpdate(&midiStats, &lastMidiPoll);
 	[PdBase receiveMidi];
+	CFTimeInterval now = CACurrentMediaTime();
+	if([self.midi sendPendingOutput]) {
+		lastMidiOutput = now;
+		if(midiPollIdle) {
+			midiPollIdle = NO;
+			[PureData setMidiTimer:timer rate:self.midiPollRate];
+		}
+	}
+	else if(!midiPollIdle && now - lastMidiOutput > MIDI_IDLE_TIME &&
+	        self.midiPollRate > MIDI_IDLE_POLL_RATE) {
+		midiPollIdle = YES;
+		[PureData setMidiTimer:timer rate:MIDI_IDLE_POLL_RATE];
+	}
+}
+
+// (re)start midi poll timer at rate in Hz, 10% leeway
++ (void)setMidiTimer:(dispatch_source_t)timer rate:(int)rate {
+	if(!timer) return;
+	uint64_t interval = NSEC_PER_SEC / rate;
+	dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, interval), interval, interval / 10);
 }
 
 // encode a libpd list of numbers into raw byte data
@@ -925,11 +1055,54 @@ static NSNumberFormatter *s_numFormatter = nil;
 
 @end
 
+/// forwards pd prints from the log queue to osc
+@interface PureDataPrintLogger : Logger
+@property (weak, nonatomic) Osc *osc;
+@end
+
+@implementation PureDataPrintLogger
+
+- (void)logMessage:(NSString *)message {} // prints only
+
+- (void)logPrint:(NSString *)message {
+	Osc *osc = self.osc;
+	if(!osc.isListening || !osc.printSendingEnabled) return;
+	dispatch_async(dispatch_get_main_queue(), ^{
+		[osc sendPrint:message]; // send address is changed on the main thread
+	});
+}
+
+@end
+
+@interface PureDataDispatcher () {
+	PureDataPrintLogger *printLogger;
+}
+@end
+
 @implementation PureDataDispatcher
 
+- (id)init {
+	self = [super init];
+	if(self) {
+		printLogger = [[PureDataPrintLogger alloc] init];
+		[Log addLogger:printLogger];
+	}
+	return self;
+}
+
+- (void)dealloc {
+	[Log removeLogger:printLogger];
+}
+
 - (void)receivePrint:(NSString *)message {
-	LogInfo(@"%@", message);
-	[self.osc sendPrint:message];
+	[Log print:message];
+}
+
+#pragma mark Overridden Getters / Setters
+
+- (void)setOsc:(Osc *)osc {
+	_osc = osc;
+	printLogger.osc = osc;
 }
 
 @end
@@ -16,6 +16,7 @@
 
 #import "Reachability.h"
 
+#import "AppDelegate.h"
 #import "Log.h"
 #import "Util.h"
 
@@ -173,8 +174,39 @@
 	}
 }
 
+#pragma mark GCDWebDAVServerDelegate
+
+// scenes may have changed, the library updates when next searched
+
+- (void)davServer:(GCDWebDAVServer *)server didUploadFileAtPath:(NSString *)path {
+	[self changedPath:path];
+}
+
+- (void)davServer:(GCDWebDAVServer *)server didMoveItemFromPath:(NSString *)fromPath toPath:(NSString *)toPath {
+	[self changedPath:toPath];
+}
+
+- (void)davServer:(GCDWebDAVServer *)server didCopyItemFromPath:(NSString *)fromPath toPath:(NSString *)toPath {
+	[self changedPath:toPath];
+}
+
+- (void)davServer:(GCDWebDAVServer *)server didDeleteItemAtPath:(NSString *)path {
+	[self changedPath:path];
+}
+
+- (void)davServer:(GCDWebDAVServer *)server didCreateDirectoryAtPath:(NSString *)path {
+	[self changedPath:path];
+}
+
 #pragma mark Private
 
+// mark the scene library out of date after a WebDAV edit
+- (void)changedPath:(NSString *)path {
+	LogVerbose(@"WebServer: changed %@", path.lastPathComponent);
+	AppDelegate *app = (AppDelegate *)UIApplication.sharedApplication.delegate;
+	[app.sceneLibrary setNeedsUpdate];
+}
+
 // find current IP address from connected interfaces (IPv4 and IPv6)
 // from http://stackoverflow.com/a/10803584/2146055
 + (NSString *)getIPAddressPreferIPv4:(BOOL)preferIPv4 withCellular:(BOOL)cellular withSimulator:(BOOL)simulator {
@@ -10,6 +10,8 @@
  */
 #import "PartyScene.h"
 
+#import "ZipMount.h"
+
 @interface PartyScene () {
 	NSDictionary *info;
 }
@@ -141,7 +143,7 @@
 + (UIImage *)thumbnailForSceneAt:(NSString *)fullpath {
 	NSArray *imagePaths = [Util whichFilenames:@[@"thumb.png", @"Thumb.png", @"thumb.jpg", @"Thumb.jpg"] existInDirectory:fullpath];
 	if(imagePaths) {
-		return [[UIImage alloc] initWithContentsOfFile:[fullpath stringByAppendingPathComponent:imagePaths.firstObject]];
+		return [UIImage imageWithData:[ZipMount dataWithContentsOfFile:[fullpath stringByAppendingPathComponent:imagePaths.firstObject]]];
 	}
 	return nil;
 }
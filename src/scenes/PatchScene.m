@@ -11,6 +11,7 @@
 #include "PatchScene.h"
 
 #import "AppDelegate.h"
+#import "ZipMount.h"
 
 #define CHECK_SOUNDOUTPUT
 
@@ -125,11 +126,11 @@
 }
 
 - (BOOL)loadBackground:(NSString *)fullpath {
-	if([NSFileManager.defaultManager fileExistsAtPath:fullpath]) {
+	if([ZipMount fileExistsAtPath:fullpath]) {
 		if(!self.background) {
 			self.background = [[UIImageView alloc] init];
 		}
-		UIImage *image = [UIImage imageWithContentsOfFile:fullpath];
+		UIImage *image = [UIImage imageWithData:[ZipMount dataWithContentsOfFile:fullpath]];
 		if(image) {
 			self.background.image = image;
 			[self reshapeBackground];
@@ -163,7 +164,7 @@
 #pragma mark Font
 
 - (BOOL)loadFont:(NSString *)fontPath {
-	if([NSFileManager.defaultManager fileExistsAtPath:fontPath]) {
+	if([ZipMount fileExistsAtPath:fontPath]) {
 		NSString *fontName = [Util registerFont:fontPath];
 		if(fontName) {
 			self.fontPath = fontPath;
@@ -13,6 +13,7 @@
 #import "ControlsView.h"
 #import "RjImage.h"
 #import "RjText.h"
+#import "ZipMount.h"
 
 // TODO: decide on this, leaving for now
 #define IPAD_ALLOW_LANDSCAPE
@@ -71,7 +72,7 @@
 		
 		// load background
 		NSString *backgroundPath = [path stringByAppendingPathComponent:@"image.jpg"];
-		if(![NSFileManager.defaultManager fileExistsAtPath:backgroundPath]) {
+		if(![ZipMount fileExistsAtPath:backgroundPath]) {
 			LogWarn(@"RjScene: no background image, loading default background");
 			backgroundPath = [Util.bundlePath stringByAppendingPathComponent:@"images/rjdj_default.jpg"];
 		}
@@ -285,7 +286,7 @@
 + (UIImage *)thumbnailForSceneAt:(NSString *)fullpath {
 	NSArray *imagePaths = [Util whichFilenames:@[@"thumb.jpg", @"Thumb.jpg", @"image.jpg", @"Image.jpg"] existInDirectory:fullpath];
 	if(imagePaths) {
-		return [[UIImage alloc] initWithContentsOfFile:[fullpath stringByAppendingPathComponent:imagePaths.firstObject]];
+		return [UIImage imageWithData:[ZipMount dataWithContentsOfFile:[fullpath stringByAppendingPathComponent:imagePaths.firstObject]]];
 	}
 	return nil;
 }
@@ -293,7 +294,12 @@
 + (NSDictionary *)infoForSceneAt:(NSString *)fullpath {
 	NSArray *infoPaths = [Util whichFilenames:@[@"Info.plist", @"info.plist"] existInDirectory:fullpath];
 	if(infoPaths) {
-		return [[NSDictionary dictionaryWithContentsOfFile:[fullpath stringByAppendingPathComponent:infoPaths.firstObject]] objectForKey:@"info"];
+		NSData *data = [ZipMount dataWithContentsOfFile:[fullpath stringByAppendingPathComponent:infoPaths.firstObject]];
+		if(!data) {
+			return nil;
+		}
+		NSDictionary *plist = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:nil error:nil];
+		return ([plist isKindOfClass:NSDictionary.class] ? plist[@"info"] : nil);
 	}
 	return nil;
 }
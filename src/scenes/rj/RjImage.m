@@ -10,11 +10,13 @@
  */
 #import "RjImage.h"
 
+#import "ZipMount.h"
+
 @implementation RjImage
 
 + (id)imageWithFile:(NSString *)path andParent:(RjScene *)parent {
-	if([NSFileManager.defaultManager fileExistsAtPath:path]) {
-		UIImageView *iv = [[UIImageView alloc] initWithImage:[UIImage imageWithContentsOfFile:path]];
+	if([ZipMount fileExistsAtPath:path]) {
+		UIImageView *iv = [[UIImageView alloc] initWithImage:[UIImage imageWithData:[ZipMount dataWithContentsOfFile:path]]];
 		if(!iv.image) {
 			LogError(@"RjImage: couldn't load: %@", path);
 			return nil;
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include <stdlib.h>
+#include "MidiParser.h"
+#include "Test.h"
+
+#define PACKET_SIZE 256 // bytes per parse call, ie. a CoreMIDI packet
+#define STREAM_SIZE (PACKET_SIZE * 1024)
+
+static void count(const MidiEvent *event, void *userData) {
+	(*(long *)userData)++;
+	(void)event;
+}
+
+// parse the stream in packets for the given seconds, prints messages/s
+static void run(const char *name, const uint8_t *stream, size_t length, double seconds) {
+	MidiParser parser;
+	long events = 0, passes = 0;
+	MidiParserInit(&parser, count, &events);
+	double start = testNow(), elapsed;
+	do {
+		for(size_t i = 0; i < length; i += PACKET_SIZE) {
+			MidiParserParse(&parser, stream + i, PACKET_SIZE, i);
+		}
+		passes++;
+		elapsed = testNow() - start;
+	} while(elapsed < seconds);
+	printf("%-28s %8.2f Mevents/s %8.1f MB/s\n", name,
+		events / elapsed * 1e-6, passes * (double)length / elapsed * 1e-6);
+}
+
+int main(int argc, char *argv[]) {
+	double seconds = (argc > 1 ? atof(argv[1]) : 1);
+	uint8_t *stream = malloc(STREAM_SIZE);
+	size_t i;
+
+	// full status note messages
+	for(i = 0; i + 3 <= STREAM_SIZE; i += 3) {
+		stream[i] = 0x90 | (i % 16);
+		stream[i + 1] = (uint8_t)(i & 0x7F);
+		stream[i + 2] = 100;
+	}
+	for(; i < STREAM_SIZE; ++i) {stream[i] = 0xF8;}
+	run("note on", stream, STREAM_SIZE, seconds);
+
+	// running status control changes with clock in between
+	stream[0] = 0xB0;
+	for(i = 1; i < STREAM_SIZE; ++i) {
+		stream[i] = (i % 17 == 0 ? 0xF8 : (uint8_t)(i & 0x7F));
+	}
+	run("running status & clock", stream, STREAM_SIZE, seconds);
+
+	// 4 KB sysex dumps
+	for(i = 0; i < STREAM_SIZE; ++i) {
+		stream[i] = (i % 4096 == 0 ? 0xF0 : (i % 4096 == 4095 ? 0xF7 : (uint8_t)(i & 0x7F)));
+	}
+	run("sysex 4 KB", stream, STREAM_SIZE, seconds);
+
+	free(stream);
+	return 0;
+}
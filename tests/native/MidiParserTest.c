@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include "MidiParser.h"
+#include "Test.h"
+
+#define MAX_EVENTS 64
+#define MAX_SYSEX 4096
+
+/// copied events
+typedef struct Events {
+	MidiEvent events[MAX_EVENTS];
+	uint8_t sysex[MAX_EVENTS][MIDI_PARSER_SYSEX_SIZE];
+	int count;
+} Events;
+
+static void collect(const MidiEvent *event, void *userData) {
+	Events *e = (Events *)userData;
+	if(e->count == MAX_EVENTS) {
+		return;
+	}
+	e->events[e->count] = *event;
+	if(event->sysex) {
+		memcpy(e->sysex[e->count], event->sysex, event->sysexLength);
+		e->events[e->count].sysex = e->sysex[e->count];
+	}
+	e->count++;
+}
+
+static void parse(MidiParser *parser, Events *e, const uint8_t *bytes, size_t length) {
+	e->count = 0;
+	MidiParserParse(parser, bytes, length, 0);
+}
+
+static int isMessage(const MidiEvent *event, uint8_t status, int data1, int data2) {
+	if(event->sysex || event->bytes[0] != status) {
+		return 0;
+	}
+	if(data1 < 0) {
+		return event->length == 1;
+	}
+	if(data2 < 0) {
+		return event->length == 2 && event->bytes[1] == data1;
+	}
+	return event->length == 3 && event->bytes[1] == data1 && event->bytes[2] == data2;
+}
+
+static void testRunningStatus(MidiParser *parser, Events *e) {
+	const uint8_t notes[] = {0x90, 60, 100, 61, 101, 62, 0};
+	parse(parser, e, notes, sizeof(notes));
+	CHECK_EQUAL(e->count, 3);
+	CHECK(isMessage(&e->events[0], 0x90, 60, 100));
+	CHECK(isMessage(&e->events[1], 0x90, 61, 101));
+	CHECK(isMessage(&e->events[2], 0x90, 62, 0));
+
+	// running status continues across packets
+	const uint8_t more[] = {63, 64};
+	parse(parser, e, more, sizeof(more));
+	CHECK_EQUAL(e->count, 1);
+	CHECK(isMessage(&e->events[0], 0x90, 63, 64));
+
+	// single data byte messages
+	const uint8_t programs[] = {0xC3, 5, 6, 7};
+	parse(parser, e, programs, sizeof(programs));
+	CHECK_EQUAL(e->count, 3);
+	CHECK(isMessage(&e->events[2], 0xC3, 7, -1));
+
+	// a message split across packets
+	const uint8_t first[] = {0xB0, 7}, second[] = {127};
+	parse(parser, e, first, sizeof(first));
+	CHECK_EQUAL(e->count, 0);
+	parse(parser, e, second, sizeof(second));
+	CHECK_EQUAL(e->count, 1);
+	CHECK(isMessage(&e->events[0], 0xB0, 7, 127));
+}
+
+static void testRealtime(MidiParser *parser, Events *e) {
+	// realtime within a message doesn't break it or running status
+	const uint8_t bytes[] = {0x90, 60, 0xF8, 100, 0xFA, 61, 0xFE, 101};
+	parse(parser, e, bytes, sizeof(bytes));
+	CHECK_EQUAL(e->count, 5);
+	CHECK(isMessage(&e->events[0], 0xF8, -1, -1));
+	CHECK(isMessage(&e->events[1], 0x90, 60, 100));
+	CHECK(isMessage(&e->events[2], 0xFA, -1, -1));
+	CHECK(isMessage(&e->events[3], 0xFE, -1, -1));
+	CHECK(isMessage(&e->events[4], 0x90, 61, 101));
+}
+
+static void testSystemCommon(MidiParser *parser, Events *e) {
+	// system common messages cancel running status
+	const uint8_t bytes[] = {0x90, 60, 100, 0xF1, 0x10, 61, 101, 0xF2, 1, 2, 0xF6, 3};
+	parse(parser, e, bytes, sizeof(bytes));
+	CHECK_EQUAL(e->count, 4);
+	CHECK(isMessage(&e->events[0], 0x90, 60, 100));
+	CHECK(isMessage(&e->events[1], 0xF1, 0x10, -1));
+	CHECK(isMessage(&e->events[2], 0xF2, 1, 2));
+	CHECK(isMessage(&e->events[3], 0xF6, -1, -1));
+
+	// data without a status is dropped, as is a stray sysex end
+	MidiParserReset(parser);
+	const uint8_t stray[] = {1, 2, 0xF7, 3, 0x80, 60, 0};
+	parse(parser, e, stray, sizeof(stray));
+	CHECK_EQUAL(e->count, 1);
+	CHECK(isMessage(&e->events[0], 0x80, 60, 0));
+
+	// reset clears running status & partial messages
+	const uint8_t partial[] = {0x90, 60};
+	parse(parser, e, partial, sizeof(partial));
+	MidiParserReset(parser);
+	parse(parser, e, partial + 1, 1);
+	CHECK_EQUAL(e->count, 0);
+}
+
+static void testSysex(MidiParser *parser, Events *e) {
+	// split across packets with realtime inside
+	const uint8_t first[] = {0xF0, 0x7E, 1, 0xF8, 2}, second[] = {3, 0xF7, 0x90, 60, 100};
+	parse(parser, e, first, sizeof(first));
+	CHECK_EQUAL(e->count, 1);
+	CHECK(isMessage(&e->events[0], 0xF8, -1, -1));
+	parse(parser, e, second, sizeof(second));
+	CHECK_EQUAL(e->count, 2);
+	const uint8_t expected[] = {0xF0, 0x7E, 1, 2, 3, 0xF7};
+	CHECK(e->events[0].sysex != NULL);
+	CHECK(e->events[0].sysexComplete);
+	CHECK_EQUAL(e->events[0].sysexLength, sizeof(expected));
+	CHECK(memcmp(e->events[0].sysex, expected, sizeof(expected)) == 0);
+	CHECK(isMessage(&e->events[1], 0x90, 60, 100));
+
+	// sysex cancels running status
+	const uint8_t running[] = {0xF0, 1, 0xF7, 61, 101};
+	parse(parser, e, running, sizeof(running));
+	CHECK_EQUAL(e->count, 1);
+
+	// a status byte ends an unterminated sysex without an 0xF7
+	const uint8_t cut[] = {0xF0, 1, 2, 0x90, 60, 100};
+	parse(parser, e, cut, sizeof(cut));
+	CHECK_EQUAL(e->count, 2);
+	CHECK(e->events[0].sysexComplete);
+	CHECK_EQUAL(e->events[0].sysexLength, 3);
+	CHECK_EQUAL(e->events[0].sysex[2], 2);
+	CHECK(isMessage(&e->events[1], 0x90, 60, 100));
+}
+
+// long sysex is delivered in bounded segments which add up to the message,
+// fed in packets of a given size
+static void testSysexSegments(MidiParser *parser, Events *e, size_t packet) {
+	static uint8_t message[MAX_SYSEX], joined[MAX_SYSEX];
+	const size_t length = 1300;
+	message[0] = 0xF0;
+	for(size_t i = 1; i < length - 1; ++i) {
+		message[i] = i & 0x7F;
+	}
+	message[length - 1] = 0xF7;
+
+	e->count = 0;
+	for(size_t i = 0; i < length; i += packet) {
+		size_t n = (length - i < packet ? length - i : packet);
+		MidiParserParse(parser, message + i, n, i);
+	}
+	size_t total = 0;
+	for(int s = 0; s < e->count; ++s) {
+		const MidiEvent *event = &e->events[s];
+		CHECK(event->sysex != NULL);
+		CHECK(event->sysexLength > 0 && event->sysexLength < MIDI_PARSER_SYSEX_SIZE);
+		CHECK_EQUAL(event->sysexComplete, (s == e->count - 1));
+		memcpy(joined + total, event->sysex, event->sysexLength);
+		total += event->sysexLength;
+	}
+	CHECK_EQUAL(e->count, (length + MIDI_PARSER_SYSEX_SIZE - 2) / (MIDI_PARSER_SYSEX_SIZE - 1));
+	CHECK_EQUAL(total, length);
+	CHECK(memcmp(joined, message, length) == 0);
+}
+
+static void testTimestamp(MidiParser *parser, Events *e) {
+	const uint8_t first[] = {0x90, 60}, second[] = {100};
+	e->count = 0;
+	MidiParserParse(parser, first, sizeof(first), 1000);
+	MidiParserParse(parser, second, sizeof(second), 2000);
+	CHECK_EQUAL(e->count, 1);
+	CHECK_EQUAL(e->events[0].timestamp, 2000); // when completed
+}
+
+static void testDataLength(void) {
+	CHECK_EQUAL(MidiParserDataLength(0x80), 2);
+	CHECK_EQUAL(MidiParserDataLength(0x9F), 2);
+	CHECK_EQUAL(MidiParserDataLength(0xA0), 2);
+	CHECK_EQUAL(MidiParserDataLength(0xB0), 2);
+	CHECK_EQUAL(MidiParserDataLength(0xC0), 1);
+	CHECK_EQUAL(MidiParserDataLength(0xD0), 1);
+	CHECK_EQUAL(MidiParserDataLength(0xE0), 2);
+	CHECK_EQUAL(MidiParserDataLength(0xF0), -1);
+	CHECK_EQUAL(MidiParserDataLength(0xF1), 1);
+	CHECK_EQUAL(MidiParserDataLength(0xF2), 2);
+	CHECK_EQUAL(MidiParserDataLength(0xF3), 1);
+	CHECK_EQUAL(MidiParserDataLength(0xF6), 0);
+	CHECK_EQUAL(MidiParserDataLength(0xF8), 0);
+}
+
+int main(void) {
+	static Events e;
+	MidiParser parser;
+	MidiParserInit(&parser, collect, &e);
+	testRunningStatus(&parser, &e);
+	testRealtime(&parser, &e);
+	testSystemCommon(&parser, &e);
+	testSysex(&parser, &e);
+	testSysexSegments(&parser, &e, 1300);
+	testSysexSegments(&parser, &e, 64);
+	testSysexSegments(&parser, &e, 1);
+	testTimestamp(&parser, &e);
+	testDataLength();
+	return testResult("MidiParserTest");
+}
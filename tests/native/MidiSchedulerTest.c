@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include <stdlib.h>
+#include "MidiScheduler.h"
+#include "Test.h"
+
+// host time in ns
+#define HOST_RATE 1e9
+#define SAMPLE_RATE 44100
+#define BLOCK_SIZE 64
+#define TICKS_PER_BUFFER 4
+#define TICK_NS ((double)BLOCK_SIZE / SAMPLE_RATE * HOST_RATE)
+#define BUFFER_NS (TICK_NS * TICKS_PER_BUFFER)
+
+#define MAX_RELEASED 4096
+
+/// released events with the tick they were released in
+typedef struct Released {
+	struct {
+		uint64_t timestamp;
+		int source;
+		uint8_t status;
+		uint64_t tick;
+		size_t sysexLength;
+		uint8_t sysexFirst;
+	} events[MAX_RELEASED];
+	int count;
+	uint64_t tick; ///< current tick, set by the test
+} Released;
+
+static void collect(const MidiEvent *event, int source, void *userData) {
+	Released *r = (Released *)userData;
+	if(r->count == MAX_RELEASED) {
+		return;
+	}
+	r->events[r->count].timestamp = event->timestamp;
+	r->events[r->count].source = source;
+	r->events[r->count].status = event->bytes[0];
+	r->events[r->count].tick = r->tick;
+	r->events[r->count].sysexLength = (event->sysex ? event->sysexLength : 0);
+	r->events[r->count].sysexFirst = (event->sysex ? event->sysex[0] : 0);
+	r->count++;
+}
+
+static MidiEvent message(uint64_t timestamp, uint8_t status) {
+	MidiEvent event = {0};
+	event.timestamp = timestamp;
+	event.bytes[0] = status;
+	event.bytes[1] = 60;
+	event.bytes[2] = 100;
+	event.length = 3;
+	return event;
+}
+
+// 32 bit lcg, the same sequence on every platform
+static double uniform(uint32_t *seed) {
+	*seed = *seed * 1664525u + 1013904223u;
+	return (double)(*seed >> 8) / (double)(1 << 24);
+}
+
+// run one simulated audio buffer: ticks back to back 20 us apart
+static void buffer(MidiScheduler *scheduler, Released *r, uint64_t hostTime) {
+	for(int j = 0; j < TICKS_PER_BUFFER; ++j) {
+		MidiSchedulerTick(scheduler, hostTime + j * 20000, collect, r);
+		r->tick++;
+	}
+}
+
+static void testImmediate(MidiScheduler *scheduler, Released *r) {
+	MidiSchedulerReset(scheduler);
+	r->count = 0;
+	r->tick = 0;
+	uint64_t start = 1000000000;
+
+	// untimed events go out on the next tick, in order
+	MidiEvent a = message(0, 0x90), b = message(0, 0xB0);
+	CHECK(MidiSchedulerPush(scheduler, &a, 1));
+	CHECK(MidiSchedulerPush(scheduler, &b, 2));
+	MidiSchedulerTick(scheduler, start, collect, r);
+	CHECK_EQUAL(r->count, 2);
+	CHECK_EQUAL(r->events[0].status, 0x90);
+	CHECK_EQUAL(r->events[0].source, 1);
+	CHECK_EQUAL(r->events[1].status, 0xB0);
+	CHECK_EQUAL(r->events[1].source, 2);
+
+	// bad timestamps far in the future don't block the queue
+	MidiEvent c = message(start + 10 * (uint64_t)HOST_RATE, 0x80);
+	CHECK(MidiSchedulerPush(scheduler, &c, 0));
+	MidiSchedulerTick(scheduler, start + 100000, collect, r);
+	CHECK_EQUAL(r->count, 3);
+	CHECK_EQUAL(scheduler->stats.released, 3);
+}
+
+static void testIdle(MidiScheduler *scheduler, Released *r) {
+	MidiSchedulerReset(scheduler);
+	r->count = 0;
+	uint64_t start = 1000000000;
+
+	// idle until ticks are run & once they stop
+	CHECK(!MidiSchedulerActive(scheduler, start));
+	CHECK_EQUAL(MidiSchedulerIdleTime(scheduler), 0);
+	buffer(scheduler, r, start);
+	CHECK(MidiSchedulerActive(scheduler, start + BUFFER_NS));
+	CHECK(!MidiSchedulerActive(scheduler, start + MIDI_SCHEDULER_IDLE_TIME * HOST_RATE + BUFFER_NS));
+	uint64_t idle = MidiSchedulerIdleTime(scheduler);
+	CHECK(MidiSchedulerActive(scheduler, idle - 1));
+	CHECK(!MidiSchedulerActive(scheduler, idle));
+
+	// flush releases everything queued in order, including sysex bytes
+	uint8_t sysex[] = {0xF0, 1, 2, 3};
+	MidiEvent a = message(start + BUFFER_NS * 100, 0x90), s = {0}, b = message(0, 0xE0);
+	s.timestamp = a.timestamp;
+	s.sysex = sysex;
+	s.sysexLength = sizeof(sysex);
+	CHECK(!MidiSchedulerPending(scheduler));
+	CHECK(MidiSchedulerPush(scheduler, &a, 0));
+	CHECK(MidiSchedulerPush(scheduler, &s, 0));
+	CHECK(MidiSchedulerPush(scheduler, &b, 0));
+	CHECK(MidiSchedulerPending(scheduler));
+	sysex[0] = 0; // copied on push
+	MidiSchedulerFlush(scheduler, collect, r);
+	CHECK(!MidiSchedulerPending(scheduler));
+	CHECK_EQUAL(r->count, 3);
+	CHECK_EQUAL(r->events[0].status, 0x90);
+	CHECK_EQUAL(r->events[1].sysexLength, 4);
+	CHECK_EQUAL(r->events[1].sysexFirst, 0xF0);
+	CHECK_EQUAL(r->events[2].status, 0xE0);
+	MidiSchedulerFlush(scheduler, collect, r);
+	CHECK_EQUAL(r->count, 3);
+}
+
+static void testFull(MidiScheduler *scheduler, Released *r) {
+	MidiSchedulerReset(scheduler);
+	r->count = 0;
+
+	MidiEvent a = message(0, 0x90);
+	for(int i = 0; i < MIDI_SCHEDULER_SIZE; ++i) {
+		CHECK(MidiSchedulerPush(scheduler, &a, 0));
+	}
+	CHECK(!MidiSchedulerPush(scheduler, &a, 0));
+	CHECK_EQUAL(scheduler->stats.dropped, 1);
+	MidiSchedulerFlush(scheduler, collect, r);
+	CHECK(MidiSchedulerPush(scheduler, &a, 0));
+
+	// sysex ring wraps around many times & bytes stay in order
+	static uint8_t bytes[MIDI_PARSER_SYSEX_SIZE - 1];
+	MidiSchedulerFlush(scheduler, collect, r);
+	r->count = 0;
+	int failures = 0;
+	for(int i = 0; i < 1000; ++i) {
+		MidiEvent s = {0};
+		memset(bytes, i & 0x7F, sizeof(bytes));
+		s.sysex = bytes;
+		s.sysexLength = sizeof(bytes) - (i % 7);
+		CHECK(MidiSchedulerPush(scheduler, &s, 0));
+		if(i % 3 == 2) {
+			int from = r->count;
+			MidiSchedulerFlush(scheduler, collect, r);
+			for(int j = from; j < r->count; ++j) {
+				int n = i - 2 + (j - from);
+				failures += (r->events[j].sysexFirst != (n & 0x7F) ||
+				             r->events[j].sysexLength != sizeof(bytes) - (n % 7));
+			}
+			r->count = 0;
+		}
+	}
+	CHECK_EQUAL(failures, 0);
+}
+
+// simulated audio callbacks with jitter and timestamped events arriving at
+// random times: events should be released at the tick matching their
+// timestamp, plus a constant latency, instead of at the next audio callback
+static void testJitter(MidiScheduler *scheduler, Released *r) {
+	const int count = 2000, warmup = 100;
+	const double callbackJitter = 1e6, arrivalJitter = 3e5; // ns
+	static uint64_t timestamps[2000], arrivals[2000];
+	uint32_t seed = 1;
+	uint64_t start = 1000000000;
+
+	MidiSchedulerReset(scheduler);
+	MidiSchedulerSetTickSize(scheduler, SAMPLE_RATE, BLOCK_SIZE);
+	r->count = 0;
+	r->tick = 0;
+
+	// events at random times ~5 ms apart, sent shortly after their timestamp
+	double t = start + 0.1 * HOST_RATE;
+	for(int i = 0; i < count; ++i) {
+		t += 2e6 + 6e6 * uniform(&seed);
+		timestamps[i] = (uint64_t)t;
+		arrivals[i] = timestamps[i] + (uint64_t)(arrivalJitter * uniform(&seed));
+	}
+
+	// callbacks run late by up to the callback jitter, events which arrived
+	// before are pushed first
+	double minDelay = 0, maxDelay = 0, minNaive = 0, maxNaive = 0;
+	int next = 0;
+	for(uint64_t k = 0; r->count < count && k < 1000000; ++k) {
+		uint64_t nominal = start + (uint64_t)(k * BUFFER_NS);
+		uint64_t callback = nominal + (uint64_t)(callbackJitter * uniform(&seed));
+		for(; next < count && arrivals[next] <= callback; ++next) {
+			MidiEvent event = message(timestamps[next], 0x90);
+			CHECK(MidiSchedulerPush(scheduler, &event, 0));
+
+			// without scheduling, events go out at the start of the callback
+			if(next >= warmup) {
+				double naive = (double)nominal - timestamps[next];
+				if(next == warmup || naive < minNaive) {minNaive = naive;}
+				if(next == warmup || naive > maxNaive) {maxNaive = naive;}
+			}
+		}
+		buffer(scheduler, r, callback);
+	}
+	CHECK_EQUAL(r->count, count);
+
+	// delay from the timestamp to the nominal time of the release tick
+	int ordered = 1;
+	for(int i = 0; i < r->count; ++i) {
+		ordered &= (r->events[i].timestamp == timestamps[i]);
+		if(i < warmup) {continue;}
+		double delay = start + r->events[i].tick * TICK_NS - (double)timestamps[i];
+		if(i == warmup || delay < minDelay) {minDelay = delay;}
+		if(i == warmup || delay > maxDelay) {maxDelay = delay;}
+	}
+	CHECK(ordered);
+
+	double jitter = (maxDelay - minDelay) / 1e6, naive = (maxNaive - minNaive) / 1e6;
+	printf("MidiSchedulerTest: tick %.2f ms buffer %.2f ms callback jitter %.2f ms\n",
+		TICK_NS / 1e6, BUFFER_NS / 1e6, callbackJitter / 1e6);
+	printf("MidiSchedulerTest: jitter scheduled %.2f ms (delay %.2f - %.2f ms) unscheduled %.2f ms\n",
+		jitter, minDelay / 1e6, maxDelay / 1e6, naive);
+	printf("MidiSchedulerTest: stats jitter %.2f ms latency %.2f ms\n",
+		(scheduler->stats.maxDelay - scheduler->stats.minDelay) * 1e3, scheduler->stats.latency * 1e3);
+
+	// down to the tick size plus some of the callback jitter, the
+	// unscheduled jitter is about a buffer plus the callback jitter
+	CHECK(jitter < (TICK_NS + callbackJitter * 0.5) / 1e6);
+	CHECK(naive > BUFFER_NS / 1e6);
+	CHECK(minDelay >= 0);
+	CHECK(maxDelay < 2 * BUFFER_NS + callbackJitter);
+	CHECK_EQUAL(scheduler->stats.timed, count);
+	CHECK_EQUAL(scheduler->stats.dropped, 0);
+}
+
+int main(void) {
+	static Released r;
+	MidiScheduler *scheduler = malloc(sizeof(MidiScheduler));
+	MidiSchedulerInit(scheduler, HOST_RATE);
+	testImmediate(scheduler, &r);
+	testIdle(scheduler, &r);
+	testFull(scheduler, &r);
+	testJitter(scheduler, &r);
+	free(scheduler);
+	return testResult("MidiSchedulerTest");
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include "MidiWriter.h"
+#include "MidiParser.h"
+#include "Test.h"
+
+#define MAX_PACKETS 64
+#define MAX_BYTES 4096
+
+/// flushed packets
+typedef struct Packets {
+	uint8_t bytes[MAX_BYTES];
+	size_t offsets[MAX_PACKETS + 1];
+	int count;
+} Packets;
+
+static void collect(const uint8_t *bytes, size_t length, void *userData) {
+	Packets *p = (Packets *)userData;
+	if(p->count == MAX_PACKETS || p->offsets[p->count] + length > MAX_BYTES) {
+		return;
+	}
+	memcpy(p->bytes + p->offsets[p->count], bytes, length);
+	p->count++;
+	p->offsets[p->count] = p->offsets[p->count - 1] + length;
+}
+
+static void clear(Packets *p) {
+	p->count = 0;
+	p->offsets[0] = 0;
+}
+
+static size_t packetLength(Packets *p, int i) {
+	return p->offsets[i + 1] - p->offsets[i];
+}
+
+static int packetIs(Packets *p, int i, const uint8_t *bytes, size_t length) {
+	return i < p->count && packetLength(p, i) == length &&
+	       memcmp(p->bytes + p->offsets[i], bytes, length) == 0;
+}
+
+static void writeBytes(MidiWriter *writer, const uint8_t *bytes, size_t length) {
+	for(size_t i = 0; i < length; ++i) {
+		MidiWriterByte(writer, bytes[i]);
+	}
+}
+
+static void testMessages(MidiWriter *writer, Packets *p) {
+	clear(p);
+	const uint8_t note[] = {0x90, 60, 100}, program[] = {0xC0, 5};
+	MidiWriterMessage(writer, note, sizeof(note));
+	MidiWriterMessage(writer, note, sizeof(note));
+	MidiWriterMessage(writer, program, sizeof(program));
+	MidiWriterFlush(writer);
+	MidiWriterFlush(writer); // nothing left
+	const uint8_t expected[] = {0x90, 60, 100, 0x90, 60, 100, 0xC0, 5};
+	CHECK_EQUAL(p->count, 1);
+	CHECK(packetIs(p, 0, expected, sizeof(expected)));
+}
+
+static void testRawBytes(MidiWriter *writer, Packets *p) {
+	clear(p);
+
+	// running status input is expanded, realtime stays where it is
+	const uint8_t raw[] = {0x90, 60, 100, 61, 0xF8, 101, 0xC1, 1, 2};
+	writeBytes(writer, raw, sizeof(raw));
+	MidiWriterFlush(writer);
+	const uint8_t expected[] = {0x90, 60, 100, 0x90, 61, 0xF8, 101, 0xC1, 1, 0xC1, 2};
+	CHECK_EQUAL(p->count, 1);
+	CHECK(packetIs(p, 0, expected, sizeof(expected)));
+
+	// an incomplete message is kept until completed
+	clear(p);
+	const uint8_t first[] = {0xB0, 7}, second[] = {127};
+	writeBytes(writer, first, sizeof(first));
+	MidiWriterFlush(writer);
+	CHECK_EQUAL(p->count, 0);
+	writeBytes(writer, second, sizeof(second));
+	MidiWriterFlush(writer);
+	const uint8_t control[] = {0xB0, 7, 127};
+	CHECK_EQUAL(p->count, 1);
+	CHECK(packetIs(p, 0, control, sizeof(control)));
+
+	// dropped when interrupted, data without status is dropped
+	clear(p);
+	MidiWriterInit(writer, collect, p, 0);
+	const uint8_t interrupted[] = {1, 2, 0x90, 60, 0xF6, 0xE0, 0, 64, 0xF7};
+	writeBytes(writer, interrupted, sizeof(interrupted));
+	MidiWriterFlush(writer);
+	const uint8_t kept[] = {0xF6, 0xE0, 0, 64};
+	CHECK_EQUAL(p->count, 1);
+	CHECK(packetIs(p, 0, kept, sizeof(kept)));
+}
+
+static void testBoundaries(MidiWriter *writer, Packets *p) {
+	clear(p);
+
+	// fill the buffer with 3 byte messages until it overflows: every packet
+	// must hold whole messages only
+	int messages = MIDI_WRITER_SIZE / 3 + 10;
+	for(int i = 0; i < messages; ++i) {
+		MidiWriterByte(writer, 0x90);
+		MidiWriterByte(writer, i & 0x7F);
+		MidiWriterByte(writer, 100);
+	}
+	MidiWriterFlush(writer);
+	CHECK_EQUAL(p->count, 2);
+	int whole = 1;
+	for(int i = 0; i < p->count; ++i) {
+		whole &= (packetLength(p, i) % 3 == 0 && p->bytes[p->offsets[i]] == 0x90);
+		CHECK(packetLength(p, i) <= MIDI_WRITER_SIZE);
+	}
+	CHECK(whole);
+	CHECK_EQUAL(p->offsets[p->count], messages * 3);
+}
+
+static void testSysex(MidiWriter *writer, Packets *p) {
+	clear(p);
+
+	// sysex goes in its own packets
+	const uint8_t bytes[] = {0x90, 60, 100, 0xF0, 1, 2, 3, 0xF7, 0xB0, 1, 2};
+	writeBytes(writer, bytes, sizeof(bytes));
+	MidiWriterFlush(writer);
+	const uint8_t note[] = {0x90, 60, 100}, sysex[] = {0xF0, 1, 2, 3, 0xF7}, control[] = {0xB0, 1, 2};
+	CHECK_EQUAL(p->count, 3);
+	CHECK(packetIs(p, 0, note, sizeof(note)));
+	CHECK(packetIs(p, 1, sysex, sizeof(sysex)));
+	CHECK(packetIs(p, 2, control, sizeof(control)));
+
+	// long sysex is split into full packets, a message ends it
+	clear(p);
+	MidiWriterByte(writer, 0xF0);
+	for(int i = 0; i < MIDI_WRITER_SIZE * 2; ++i) {
+		MidiWriterByte(writer, i & 0x7F);
+	}
+	MidiWriterMessage(writer, note, sizeof(note));
+	MidiWriterFlush(writer);
+	CHECK_EQUAL(p->count, 4);
+	CHECK_EQUAL(packetLength(p, 0), MIDI_WRITER_SIZE);
+	CHECK_EQUAL(p->bytes[0], 0xF0);
+	CHECK_EQUAL(packetLength(p, 1), MIDI_WRITER_SIZE);
+	CHECK_EQUAL(packetLength(p, 2), 1);
+	CHECK(packetIs(p, 3, note, sizeof(note)));
+}
+
+static void testRunningStatus(Packets *p) {
+	MidiWriter writer;
+	MidiWriterInit(&writer, collect, p, 1);
+	clear(p);
+
+	const uint8_t raw[] = {0x90, 60, 100, 61, 0xF8, 101, 0x90, 62, 102, 0xF1, 1, 0x90, 63, 103};
+	writeBytes(&writer, raw, sizeof(raw));
+	MidiWriterFlush(&writer);
+	const uint8_t note[] = {0x90, 64, 104};
+	MidiWriterMessage(&writer, note, sizeof(note)); // starts with status after flush
+	MidiWriterFlush(&writer);
+	const uint8_t expected[] = {0x90, 60, 100, 61, 0xF8, 101, 62, 102, 0xF1, 1, 0x90, 63, 103};
+	CHECK_EQUAL(p->count, 2);
+	CHECK(packetIs(p, 0, expected, sizeof(expected)));
+	CHECK(packetIs(p, 1, note, sizeof(note)));
+}
+
+// written bytes are parsed back into the same messages
+static void countEvent(const MidiEvent *event, void *userData) {
+	(*(int *)userData)++;
+}
+
+static void testRoundTrip(MidiWriter *writer, Packets *p) {
+	clear(p);
+	uint32_t seed = 1;
+	int written = 0, parsed = 0;
+	for(int i = 0; i < 1000; ++i) {
+		seed = seed * 1664525u + 1013904223u;
+		uint8_t status = 0x80 | ((seed >> 16) & 0x6F); // channel voice, no 0xF0
+		MidiWriterByte(writer, status);
+		for(int j = 0; j < MidiParserDataLength(status); ++j) {
+			MidiWriterByte(writer, (seed >> (8 * j)) & 0x7F);
+		}
+		written++;
+		if(i % 100 == 99) {
+			MidiWriterFlush(writer);
+		}
+	}
+	MidiWriterFlush(writer);
+	MidiParser parser;
+	MidiParserInit(&parser, countEvent, &parsed);
+	for(int i = 0; i < p->count; ++i) {
+		MidiParserReset(&parser); // no state kept between packets
+		MidiParserParse(&parser, p->bytes + p->offsets[i], packetLength(p, i), 0);
+	}
+	CHECK_EQUAL(parsed, written);
+}
+
+int main(void) {
+	static Packets p;
+	static MidiWriter writer;
+	MidiWriterInit(&writer, collect, &p, 0);
+	testMessages(&writer, &p);
+	testRawBytes(&writer, &p);
+	testBoundaries(&writer, &p);
+	testSysex(&writer, &p);
+	testRunningStatus(&p);
+	testRoundTrip(&writer, &p);
+	return testResult("MidiWriterTest");
+}
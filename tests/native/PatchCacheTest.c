@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include <stdlib.h>
+#include <unistd.h>
+#include "PatchCache.h"
+#include "Test.h"
+
+static char dir[64], path[128];
+
+static PatchCacheKey testKey(void) {
+	PatchCacheKey key = {"/patches/test.pd", 1234, 5678000000LL, 1};
+	return key;
+}
+
+// write 3 lines: "#N canvas 0 0", "#X obj , foo", & an empty line
+static int writeCache(const char *file, const PatchCacheKey *key) {
+	PatchCacheWriter writer;
+	if(!PatchCacheWriterOpen(&writer, file, key)) {
+		return 0;
+	}
+	PatchCacheWriterLine(&writer, 4);
+	PatchCacheWriterAtom(&writer, PATCH_CACHE_STRING, "#N", 2);
+	PatchCacheWriterAtom(&writer, PATCH_CACHE_STRING, "canvas", 6);
+	PatchCacheWriterAtom(&writer, PATCH_CACHE_STRING, "0", 1);
+	PatchCacheWriterAtom(&writer, PATCH_CACHE_STRING, "", 0);
+	PatchCacheWriterLine(&writer, 4);
+	PatchCacheWriterAtom(&writer, PATCH_CACHE_STRING, "#X", 2);
+	PatchCacheWriterAtom(&writer, PATCH_CACHE_STRING, "obj", 3);
+	PatchCacheWriterAtom(&writer, PATCH_CACHE_NULL, "ignored", 7);
+	PatchCacheWriterAtom(&writer, PATCH_CACHE_STRING, "foo", 3);
+	PatchCacheWriterLine(&writer, 0);
+	return PatchCacheWriterClose(&writer);
+}
+
+static int atomIs(const PatchCacheAtom *atom, const char *text) {
+	if(!text) {
+		return atom->type == PATCH_CACHE_NULL && atom->text == NULL;
+	}
+	return atom->type == PATCH_CACHE_STRING && atom->length == strlen(text) &&
+	       memcmp(atom->text, text, atom->length) == 0;
+}
+
+static void testReadWrite(void) {
+	PatchCacheKey key = testKey();
+	CHECK(writeCache(path, &key));
+
+	char temp[160];
+	snprintf(temp, sizeof(temp), "%s.tmp", path);
+	CHECK(access(temp, F_OK) != 0); // moved into place
+
+	PatchCache cache;
+	CHECK(PatchCacheOpen(&cache, path, &key));
+	CHECK_EQUAL(cache.lines, 3);
+	const char *expected[2][4] = {{"#N", "canvas", "0", ""}, {"#X", "obj", NULL, "foo"}};
+	uint32_t count;
+	PatchCacheAtom atom;
+	for(int i = 0; i < 2; ++i) {
+		CHECK(PatchCacheNextLine(&cache, &count));
+		CHECK_EQUAL(count, 4);
+		for(int j = 0; j < 4; ++j) {
+			CHECK(PatchCacheNextAtom(&cache, &atom));
+			CHECK(atomIs(&atom, expected[i][j]));
+		}
+	}
+	CHECK(PatchCacheNextLine(&cache, &count));
+	CHECK_EQUAL(count, 0);
+	CHECK(!PatchCacheNextLine(&cache, &count));
+
+	// reading past the end fails instead of reading garbage
+	CHECK(!PatchCacheNextAtom(&cache, &atom));
+	CHECK_EQUAL(atom.type, PATCH_CACHE_NULL);
+	CHECK(atom.text == NULL);
+	PatchCacheClose(&cache);
+	PatchCacheClose(&cache); // twice is fine
+}
+
+static void testInvalidation(void) {
+	PatchCacheKey key = testKey(), other;
+	PatchCache cache;
+	CHECK(writeCache(path, &key));
+	CHECK(PatchCacheOpen(&cache, path, &key));
+	PatchCacheClose(&cache);
+
+	// any difference in the source key or the filter makes the cache stale
+	other = key;
+	other.size++;
+	CHECK(!PatchCacheOpen(&cache, path, &other));
+	other = key;
+	other.mtime++;
+	CHECK(!PatchCacheOpen(&cache, path, &other));
+	other = key;
+	other.path = "/patches/test2.pd";
+	CHECK(!PatchCacheOpen(&cache, path, &other));
+	other.path = "/patches/test";
+	CHECK(!PatchCacheOpen(&cache, path, &other));
+	other = key;
+	other.filter = 2;
+	CHECK(!PatchCacheOpen(&cache, path, &other));
+	CHECK(cache.data == NULL);
+
+	// missing
+	char missing[160];
+	snprintf(missing, sizeof(missing), "%s/missing.cache", dir);
+	CHECK(!PatchCacheOpen(&cache, missing, &key));
+}
+
+// rewrite the cache file with n bytes of the original & a changed byte
+static void corrupt(const uint8_t *data, size_t n, long offset, uint8_t value) {
+	FILE *f = fopen(path, "wb");
+	fwrite(data, 1, n, f);
+	if(offset >= 0 && (size_t)offset < n) {
+		fseek(f, offset, SEEK_SET);
+		fwrite(&value, 1, 1, f);
+	}
+	fclose(f);
+}
+
+static void testCorrupt(void) {
+	PatchCacheKey key = testKey();
+	PatchCache cache;
+	static uint8_t data[4096];
+	CHECK(writeCache(path, &key));
+	FILE *f = fopen(path, "rb");
+	size_t size = fread(data, 1, sizeof(data), f);
+	fclose(f);
+	CHECK(size > 40);
+
+	// every truncation is rejected
+	int opened = 0;
+	for(size_t n = 0; n < size; ++n) {
+		corrupt(data, n, -1, 0);
+		opened += PatchCacheOpen(&cache, path, &key);
+		PatchCacheClose(&cache);
+	}
+	CHECK_EQUAL(opened, 0);
+
+	// trailing garbage, bad magic, bad version, bad atom type
+	FILE *g = fopen(path, "wb");
+	fwrite(data, 1, size, g);
+	fputc(0, g);
+	fclose(g);
+	CHECK(!PatchCacheOpen(&cache, path, &key));
+	corrupt(data, size, 0, 'X');
+	CHECK(!PatchCacheOpen(&cache, path, &key));
+	corrupt(data, size, 4, PATCH_CACHE_VERSION + 1);
+	CHECK(!PatchCacheOpen(&cache, path, &key));
+	size_t firstAtom = 4 + 4 + 4 + 8 + 8 + 4 + strlen(key.path) + 4 + 4;
+	corrupt(data, size, (long)firstAtom, 7);
+	CHECK(!PatchCacheOpen(&cache, path, &key));
+	corrupt(data, size, -1, 0);
+	CHECK(PatchCacheOpen(&cache, path, &key));
+	PatchCacheClose(&cache);
+}
+
+static void testWriteError(void) {
+	PatchCacheKey key = testKey();
+	char bad[160];
+	snprintf(bad, sizeof(bad), "%s/missing/dir.cache", dir);
+	PatchCacheWriter writer;
+	CHECK(!PatchCacheWriterOpen(&writer, bad, &key));
+}
+
+static void testHash(void) {
+	CHECK(PatchCacheHash("") == 14695981039346656037ULL);
+	CHECK(PatchCacheHash("a") == 0xaf63dc4c8601ec8cULL);
+	CHECK(PatchCacheHash("/a/b.pd") != PatchCacheHash("/a/c.pd"));
+}
+
+int main(void) {
+	snprintf(dir, sizeof(dir), "/tmp/PatchCacheTest.XXXXXX");
+	if(!mkdtemp(dir)) {
+		perror("PatchCacheTest: mkdtemp");
+		return 1;
+	}
+	snprintf(path, sizeof(path), "%s/test.cache", dir);
+	testReadWrite();
+	testInvalidation();
+	testCorrupt();
+	testWriteError();
+	testHash();
+	unlink(path);
+	rmdir(dir);
+	return testResult("PatchCacheTest");
+}
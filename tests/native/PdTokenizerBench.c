@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include <stdlib.h>
+#include "PdTokenizer.h"
+#include "Test.h"
+
+/// tokenized totals
+typedef struct Totals {
+	long lines;
+	long tokens;
+} Totals;
+
+static void count(const PdToken *tokens, int count, void *userData) {
+	Totals *t = (Totals *)userData;
+	t->lines++;
+	t->tokens += count;
+}
+
+// typical patch lines: objects, connections, messages with escapes, & iemgui
+// widgets with many arguments
+static const char *templates[] = {
+	"#X obj %d %d osc~ 440;\n",
+	"#X connect %d 0 %d 0;\n",
+	"#X msg %d %d \\; pd dsp 1 \\, set \\$1 0.25;\n",
+	"#X obj %d %d tgl 15 0 empty empty empty 17 7 0 10 -262144 -1 -1 0 1;\n",
+	"#X floatatom %d %d 5 0 0 0 - - -;\n",
+	"#X text %d %d a comment with some words \\, and a comma;\n",
+	"#X obj %d %d hsl 128 15 0 127 0 0 empty empty empty -2 -8 0 10 -262144 -1 -1 0 1;\n",
+	"#X connect %d 1 %d 1;\n"
+};
+
+// synthesize patch text of about size bytes, returns the text length
+static size_t makePatch(char *text, size_t size) {
+	size_t n = snprintf(text, size, "#N canvas 0 50 450 300 12;\n");
+	int i = 0;
+	const int templateCount = sizeof(templates) / sizeof(templates[0]);
+	while(n + 128 < size) {
+		n += snprintf(text + n, size - n, templates[i % templateCount], (i * 7) % 800, (i * 13) % 600);
+		i++;
+	}
+	return n;
+}
+
+// tokenize the patch for the given seconds, prints MB/s & lines/s
+static void run(const char *name, size_t size, double seconds) {
+	char *text = malloc(size);
+	size_t length = makePatch(text, size);
+	PdTokenizer tokenizer;
+	PdTokenizerInit(&tokenizer);
+	Totals totals = {0, 0};
+	long passes = 0;
+	double start = testNow(), elapsed;
+	do {
+		PdTokenizerParse(&tokenizer, text, length, count, &totals);
+		passes++;
+		elapsed = testNow() - start;
+	} while(elapsed < seconds);
+	printf("%-8s %8.1f MB/s %8.2f Mlines/s %8.2f Mtokens/s %6.2f ms/patch, %ld lines, %d token capacity\n",
+		name, passes * (double)length / elapsed * 1e-6, totals.lines / elapsed * 1e-6,
+		totals.tokens / elapsed * 1e-6, elapsed / passes * 1e3, totals.lines / passes,
+		tokenizer.capacity);
+	PdTokenizerFree(&tokenizer);
+	free(text);
+}
+
+int main(int argc, char *argv[]) {
+	double seconds = (argc > 1 ? atof(argv[1]) : 1);
+	run("64 KB", 64 * 1024, seconds);
+	run("1 MB", 1024 * 1024, seconds);
+	run("16 MB", 16 * 1024 * 1024, seconds);
+	return 0;
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include "PdTokenizer.h"
+#include "Test.h"
+
+#define MAX_LINES 16
+#define MAX_TOKENS 16
+
+/// copied lines of token text, commas as ",", floats prefixed with "#"
+typedef struct Lines {
+	char tokens[MAX_LINES][MAX_TOKENS][64];
+	double values[MAX_LINES][MAX_TOKENS];
+	int counts[MAX_LINES];
+	int count;
+} Lines;
+
+static void collect(const PdToken *tokens, int count, void *userData) {
+	Lines *l = (Lines *)userData;
+	if(l->count == MAX_LINES) {
+		return;
+	}
+	for(int i = 0; i < count && i < MAX_TOKENS; ++i) {
+		char *text = l->tokens[l->count][i];
+		if(tokens[i].type == PD_TOKEN_FLOAT) {
+			text[0] = '#';
+			PdTokenCopy(&tokens[i], text + 1, 63);
+		}
+		else {
+			PdTokenCopy(&tokens[i], text, 64);
+		}
+		l->values[l->count][i] = tokens[i].value;
+	}
+	l->counts[l->count] = count;
+	l->count++;
+}
+
+static int parse(Lines *l, const char *text) {
+	PdTokenizer tokenizer;
+	PdTokenizerInit(&tokenizer);
+	l->count = 0;
+	int lines = PdTokenizerParse(&tokenizer, text, strlen(text), collect, l);
+	PdTokenizerFree(&tokenizer);
+	return lines;
+}
+
+static void testLines(Lines *l) {
+	CHECK_EQUAL(parse(l, "#N canvas 0 0 450 300 12;\n#X obj 10 20 osc~ 440;\r\n;; \n#X text 1 2 trailing"), 3);
+	CHECK_EQUAL(l->counts[0], 7);
+	CHECK_STRING(l->tokens[0][0], "#N");
+	CHECK_STRING(l->tokens[0][2], "#0");
+	CHECK_STRING(l->tokens[0][6], "#12");
+	CHECK_EQUAL(l->counts[1], 6);
+	CHECK_STRING(l->tokens[1][4], "osc~");
+	CHECK(l->values[1][5] == 440);
+	CHECK_EQUAL(l->counts[2], 5); // trailing line without a semicolon
+	CHECK_STRING(l->tokens[2][4], "trailing");
+	CHECK_EQUAL(parse(l, ""), 0);
+	CHECK_EQUAL(parse(l, " ;\n;\t"), 0);
+}
+
+static void testNumbers(Lines *l) {
+	CHECK_EQUAL(parse(l, "1 -2 .5 3. 1e3 -1.5e-2 1e 1-2 - . e3 0x10 1.2.3;"), 1);
+	const char *expected[] = {"#1", "#-2", "#.5", "#3.", "#1e3", "#-1.5e-2",
+		"1e", "1-2", "-", ".", "e3", "0x10", "1.2.3"};
+	CHECK_EQUAL(l->counts[0], 13);
+	for(int i = 0; i < 13; ++i) {
+		CHECK_STRING(l->tokens[0][i], expected[i]);
+	}
+	CHECK(l->values[0][5] == -1.5e-2);
+
+	// too long to be a number
+	char text[128];
+	memset(text, '1', 100);
+	text[100] = '\0';
+	CHECK_EQUAL(parse(l, text), 1);
+	CHECK(l->tokens[0][0][0] == '1');
+}
+
+static void testEscapes(Lines *l) {
+	CHECK_EQUAL(parse(l, "#X msg 10 10 \\; pd dsp 1 \\, a\\ b \\$1 \\5, foo;next"), 2);
+	const char *expected[] = {"#X", "msg", "#10", "#10", ";", "pd", "dsp", "#1",
+		",", "a b", "$1", "5", ",", "foo"};
+	CHECK_EQUAL(l->counts[0], 14);
+	for(int i = 0; i < 14; ++i) {
+		CHECK_STRING(l->tokens[0][i], expected[i]);
+	}
+	CHECK_STRING(l->tokens[1][0], "next");
+
+	// escaped trailing backslash
+	CHECK_EQUAL(parse(l, "a\\"), 1);
+	CHECK_STRING(l->tokens[0][0], "a\\");
+}
+
+static void testCopy(void) {
+	PdToken token = {PD_TOKEN_SYMBOL, "ab\\ cd", 6, 1, 0};
+	char buffer[4];
+	CHECK_EQUAL(PdTokenCopy(&token, buffer, sizeof(buffer)), 5);
+	CHECK_STRING(buffer, "ab ");
+	CHECK_EQUAL(PdTokenCopy(&token, buffer, 0), 5);
+}
+
+static void countTokens(const PdToken *tokens, int count, void *userData) {
+	int *total = (int *)userData;
+	for(int i = 0; i < count; ++i) {
+		*total += (tokens[i].type == PD_TOKEN_FLOAT && tokens[i].value == *total);
+	}
+}
+
+static void testGrowth(void) {
+	// a line longer than the initial token storage
+	static char text[65536];
+	size_t n = 0;
+	for(int i = 0; i < 5000; ++i) {
+		n += snprintf(text + n, sizeof(text) - n, "%d ", i);
+	}
+	PdTokenizer tokenizer;
+	PdTokenizerInit(&tokenizer);
+	int total = 0;
+	CHECK_EQUAL(PdTokenizerParse(&tokenizer, text, n, countTokens, &total), 1);
+	CHECK_EQUAL(total, 5000); // all floats, in order
+	CHECK(tokenizer.capacity >= 5000);
+	PdTokenizerFree(&tokenizer);
+}
+
+int main(void) {
+	static Lines l;
+	testLines(&l);
+	testNumbers(&l);
+	testEscapes(&l);
+	testCopy();
+	testGrowth();
+	return testResult("PdTokenizerTest");
+}
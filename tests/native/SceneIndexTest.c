@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include <stdlib.h>
+#include <unistd.h>
+#include "SceneIndex.h"
+#include "Test.h"
+
+// on disk sizes, see SceneIndex.h
+#define HEADER_SIZE 32
+#define RECORD_SIZE 40
+#define ENTRY_SIZE 12
+
+static char dir[64], path[128], modified[160];
+
+// texts are folded as SceneLibrary does: lowercase words
+static const SceneIndexRecord records[] = {
+	{"a/Drums.rj", "Drums", "Dan", NULL, "osc~ dac~", "drums dan osc~ dac~ beat", 100, 0},
+	{"Synth", "Synth Pad", "Wilcox", "pads", "osc~ lop~", "synth pad wilcox osc~ lop~", 200, 1},
+	{"Party", "Party", NULL, NULL, NULL, "party drums droid", 300, 2},
+	{"Empty", "Empty", NULL, NULL, NULL, "", 400, 1},
+	{"Trigrams", "Trigrams", NULL, NULL, NULL, "bcab xabc", 500, 3}
+};
+static const int recordCount = sizeof(records) / sizeof(records[0]);
+
+static int writeIndex(const char *file, const SceneIndexRecord *list, int count) {
+	SceneIndexBuilder builder;
+	SceneIndexBuilderInit(&builder);
+	for(int i = 0; i < count; ++i) {
+		SceneIndexBuilderAdd(&builder, &list[i]);
+	}
+	int ok = SceneIndexBuilderWrite(&builder, file);
+	SceneIndexBuilderFree(&builder);
+	return ok;
+}
+
+// search & compare the results with the expected record indices, -1 ends
+static int search(const SceneIndex *index, const char *query, uint32_t typeMask, const int *expected) {
+	uint32_t results[16];
+	int count = SceneIndexSearch(index, query, typeMask, results, 16);
+	int i = 0;
+	for(; expected[i] >= 0; ++i) {
+		if(i >= count || results[i] != (uint32_t)expected[i]) {
+			return 0;
+		}
+	}
+	return i == count;
+}
+
+#define ALL 0xffffffff
+#define NONE ((const int[]){-1})
+#define R(...) ((const int[]){__VA_ARGS__, -1})
+
+static void testSearch(void) {
+	CHECK(writeIndex(path, records, recordCount));
+	char temp[160];
+	snprintf(temp, sizeof(temp), "%s.tmp", path);
+	CHECK(access(temp, F_OK) != 0); // moved into place
+
+	SceneIndex index;
+	CHECK(SceneIndexOpen(&index, path));
+	CHECK_EQUAL(index.count, recordCount);
+
+	// records, NULL strings are stored as ""
+	SceneIndexRecord record;
+	SceneIndexGetRecord(&index, 0, &record);
+	CHECK_STRING(record.path, "a/Drums.rj");
+	CHECK_STRING(record.name, "Drums");
+	CHECK_STRING(record.author, "Dan");
+	CHECK_STRING(record.category, "");
+	CHECK_STRING(record.objects, "osc~ dac~");
+	CHECK_STRING(record.text, "drums dan osc~ dac~ beat");
+	CHECK_EQUAL(record.mtime, 100);
+	CHECK_EQUAL(record.type, 0);
+	SceneIndexGetRecord(&index, 2, &record);
+	CHECK_STRING(record.author, "");
+	CHECK_STRING(record.objects, "");
+	CHECK_EQUAL(record.type, 2);
+
+	// empty query matches all records of the types
+	CHECK(search(&index, "", ALL, R(0, 1, 2, 3, 4)));
+	CHECK(search(&index, "  ", ALL, R(0, 1, 2, 3, 4)));
+	CHECK(search(&index, "", 1 << 1, R(1, 3)));
+	CHECK(search(&index, "", 0, NONE));
+
+	// exact words
+	CHECK(search(&index, "synth", ALL, R(1)));
+	CHECK(search(&index, "drums", ALL, R(0, 2)));
+	CHECK(search(&index, "osc~", ALL, R(0, 1)));
+
+	// short words match word prefixes only
+	CHECK(search(&index, "d", ALL, R(0, 2)));
+	CHECK(search(&index, "dr", ALL, R(0, 2)));
+	CHECK(search(&index, "os", ALL, R(0, 1)));
+	CHECK(search(&index, "um", ALL, NONE));
+	CHECK(search(&index, "zz", ALL, NONE));
+
+	// longer words match anywhere, trigrams out of order are rejected
+	CHECK(search(&index, "rum", ALL, R(0, 2)));
+	CHECK(search(&index, "ilco", ALL, R(1)));
+	CHECK(search(&index, "bcab", ALL, R(4)));
+	CHECK(search(&index, "abcab", ALL, NONE));
+	CHECK(search(&index, "zzz", ALL, NONE));
+
+	// all words must match
+	CHECK(search(&index, "drums dan", ALL, R(0)));
+	CHECK(search(&index, " party  dr ", ALL, R(2)));
+	CHECK(search(&index, "drums synth", ALL, NONE));
+	CHECK(search(&index, "osc~ pad", ALL, R(1)));
+
+	// type masks
+	CHECK(search(&index, "drums", 1 << 2, R(2)));
+	CHECK(search(&index, "drums", (1 << 0) | (1 << 1), R(0)));
+	CHECK(search(&index, "synth", 1 << 0, NONE));
+
+	// results are limited to max, the count is not
+	uint32_t results[2];
+	CHECK_EQUAL(SceneIndexSearch(&index, "", ALL, results, 2), recordCount);
+	CHECK_EQUAL(results[0], 0);
+	CHECK_EQUAL(results[1], 1);
+	SceneIndexClose(&index);
+	CHECK(index.data == NULL);
+
+	// empty index
+	CHECK(writeIndex(path, NULL, 0));
+	CHECK(SceneIndexOpen(&index, path));
+	CHECK_EQUAL(index.count, 0);
+	CHECK(search(&index, "", ALL, NONE));
+	SceneIndexClose(&index);
+}
+
+static uint32_t readU32(const unsigned char *data, size_t offset) {
+	uint32_t value;
+	memcpy(&value, data + offset, 4);
+	return value;
+}
+
+// copy the index to the modified path, truncated to size & with bytes
+// written at offset, then try opening it
+static int openModified(const unsigned char *data, size_t size,
+                        size_t offset, const void *bytes, size_t length) {
+	unsigned char *copy = (unsigned char *)malloc(size > 0 ? size : 1);
+	if(!copy) {
+		return -1;
+	}
+	memcpy(copy, data, size);
+	if(bytes) {
+		memcpy(copy + offset, bytes, length);
+	}
+	FILE *f = fopen(modified, "wb");
+	int ok = (f && fwrite(copy, 1, size, f) == size);
+	if(f) {
+		fclose(f);
+	}
+	free(copy);
+	if(!ok) {
+		return -1;
+	}
+	SceneIndex index;
+	int opened = SceneIndexOpen(&index, modified);
+	SceneIndexClose(&index);
+	return opened;
+}
+
+static void testInvalid(void) {
+	SceneIndex index;
+	snprintf(modified, sizeof(modified), "%s/modified.idx", dir);
+	CHECK(!SceneIndexOpen(&index, modified)); // missing
+	CHECK(index.data == NULL);
+
+	CHECK(writeIndex(path, records, recordCount));
+	FILE *f = fopen(path, "rb");
+	CHECK(f != NULL);
+	if(!f) {
+		return;
+	}
+	unsigned char data[4096];
+	size_t size = fread(data, 1, sizeof(data), f);
+	fclose(f);
+	CHECK(size > HEADER_SIZE && size < sizeof(data));
+	uint32_t recordTotal = readU32(data, 8), terms = readU32(data, 12);
+	uint32_t trigrams = readU32(data, 16), postings = readU32(data, 20);
+	CHECK_EQUAL(recordTotal, recordCount);
+	CHECK(terms > 1 && trigrams > 0 && postings > 0);
+	size_t termsOffset = HEADER_SIZE + recordTotal * RECORD_SIZE;
+	size_t postingsOffset = termsOffset + (terms + trigrams) * ENTRY_SIZE;
+
+	// unmodified copy opens
+	CHECK_EQUAL(openModified(data, size, 0, NULL, 0), 1);
+
+	// truncated
+	CHECK_EQUAL(openModified(data, 0, 0, NULL, 0), 0);
+	CHECK_EQUAL(openModified(data, HEADER_SIZE - 1, 0, NULL, 0), 0);
+	CHECK_EQUAL(openModified(data, HEADER_SIZE, 0, NULL, 0), 0);
+	CHECK_EQUAL(openModified(data, size - 1, 0, NULL, 0), 0);
+
+	// corrupt header
+	uint32_t bad = 0xffffffff, version = SCENE_INDEX_VERSION + 1;
+	CHECK_EQUAL(openModified(data, size, 0, "PdSX", 4), 0);
+	CHECK_EQUAL(openModified(data, size, 4, &version, 4), 0);
+	CHECK_EQUAL(openModified(data, size, 8, &bad, 4), 0);
+
+	// string offset, type, term order, posting range, & record id out of
+	// bounds, unterminated strings
+	uint32_t type = 32;
+	CHECK_EQUAL(openModified(data, size, HEADER_SIZE + 8, &bad, 4), 0);
+	CHECK_EQUAL(openModified(data, size, HEADER_SIZE + 32, &type, 4), 0);
+	uint32_t secondKey = readU32(data, termsOffset + ENTRY_SIZE);
+	CHECK_EQUAL(openModified(data, size, termsOffset, &secondKey, 4), 0);
+	CHECK_EQUAL(openModified(data, size, termsOffset + 8, &bad, 4), 0);
+	CHECK_EQUAL(openModified(data, size, postingsOffset, &recordTotal, 4), 0);
+	CHECK_EQUAL(openModified(data, size, size - 1, "x", 1), 0);
+	unlink(modified);
+}
+
+// incremental update as SceneLibrary does it: records with an unchanged stamp
+// are added straight from the open index, which stays mapped & readable while
+// the new index replaces it
+static void testCarryOver(void) {
+	CHECK(writeIndex(path, records, recordCount));
+	SceneIndex current;
+	CHECK(SceneIndexOpen(&current, path));
+
+	// "Synth" changed, "Empty" removed, "New" added
+	SceneIndexRecord changed = records[1];
+	changed.text = "synth pad wilcox osc~ lop~ vcf~";
+	changed.mtime = 250;
+	SceneIndexRecord added = {"New", "New", NULL, NULL, NULL, "new scene", 600, 0};
+
+	SceneIndexBuilder builder;
+	SceneIndexBuilderInit(&builder);
+	SceneIndexRecord record;
+	int carried = 0;
+	for(uint32_t i = 0; i < current.count; ++i) {
+		SceneIndexGetRecord(&current, i, &record);
+		if(strcmp(record.path, "Empty") == 0) {
+			continue;
+		}
+		if(strcmp(record.path, changed.path) == 0 && record.mtime != changed.mtime) {
+			SceneIndexBuilderAdd(&builder, &changed);
+			continue;
+		}
+		SceneIndexBuilderAdd(&builder, &record);
+		carried++;
+	}
+	SceneIndexBuilderAdd(&builder, &added);
+	CHECK_EQUAL(carried, 3);
+	CHECK(SceneIndexBuilderWrite(&builder, path));
+	SceneIndexBuilderFree(&builder);
+
+	// old mapping is untouched
+	SceneIndexGetRecord(&current, 3, &record);
+	CHECK_STRING(record.path, "Empty");
+	SceneIndexClose(&current);
+
+	SceneIndex index;
+	CHECK(SceneIndexOpen(&index, path));
+	CHECK_EQUAL(index.count, recordCount);
+	const char *paths[] = {"a/Drums.rj", "Synth", "Party", "Trigrams", "New"};
+	const int64_t stamps[] = {100, 250, 300, 500, 600};
+	for(uint32_t i = 0; i < index.count; ++i) {
+		SceneIndexGetRecord(&index, i, &record);
+		CHECK_STRING(record.path, paths[i]);
+		CHECK_EQUAL(record.mtime, stamps[i]);
+	}
+	SceneIndexGetRecord(&index, 0, &record);
+	CHECK_STRING(record.author, "Dan");
+	CHECK_STRING(record.objects, "osc~ dac~");
+	CHECK_STRING(record.text, "drums dan osc~ dac~ beat");
+	CHECK(search(&index, "drums", ALL, R(0, 2)));
+	CHECK(search(&index, "vcf", ALL, R(1)));
+	CHECK(search(&index, "new", ALL, R(4)));
+	CHECK(search(&index, "empty", ALL, NONE));
+	CHECK(search(&index, "abcab", ALL, NONE));
+	SceneIndexClose(&index);
+}
+
+int main(void) {
+	snprintf(dir, sizeof(dir), "/tmp/SceneIndexTest.XXXXXX");
+	if(!mkdtemp(dir)) {
+		perror("SceneIndexTest: mkdtemp");
+		return 1;
+	}
+	snprintf(path, sizeof(path), "%s/scenes.idx", dir);
+	testSearch();
+	testInvalid();
+	testCarryOver();
+	unlink(path);
+	rmdir(dir);
+	return testResult("SceneIndexTest");
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+/* minimal check macros & timing for the native unit tests & benchmarks */
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static int testChecks = 0;
+static int testFailures = 0;
+
+/// check a condition, prints the location & expression on failure
+#define CHECK(cond) do { \
+	testChecks++; \
+	if(!(cond)) { \
+		testFailures++; \
+		fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+	} \
+} while(0)
+
+/// check two integer values are equal, prints both on failure
+#define CHECK_EQUAL(a, b) do { \
+	long long _a = (long long)(a), _b = (long long)(b); \
+	testChecks++; \
+	if(_a != _b) { \
+		testFailures++; \
+		fprintf(stderr, "%s:%d: check failed: %s == %s (%lld != %lld)\n", \
+			__FILE__, __LINE__, #a, #b, _a, _b); \
+	} \
+} while(0)
+
+/// check two strings are equal, prints both on failure
+#define CHECK_STRING(a, b) do { \
+	const char *_a = (a), *_b = (b); \
+	testChecks++; \
+	if(!_a || !_b || strcmp(_a, _b) != 0) { \
+		testFailures++; \
+		fprintf(stderr, "%s:%d: check failed: %s == %s\n  \"%s\"\n  \"%s\"\n", \
+			__FILE__, __LINE__, #a, #b, (_a ? _a : "(null)"), (_b ? _b : "(null)")); \
+	} \
+} while(0)
+
+/// print the check summary & return the exit code for main
+static inline int testResult(const char *name) {
+	printf("%s: %d checks, %d failed\n", name, testChecks, testFailures);
+	return (testFailures ? 1 : 0);
+}
+
+/// monotonic time in seconds
+static inline double testNow(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#endif
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include <stdlib.h>
+#include <unistd.h>
+#include "minizip/unzip.h"
+#include "minizip/iommap.h"
+#include "ZipFixture.h"
+#include "Test.h"
+
+// hashed file name index: unzBuildIndex & unzLocateFileIndexed
+
+static char dir[64];
+
+// read the current entry into buffer as a string, returns 0 on error
+static int readCurrent(unzFile zip, char *buffer, int size) {
+	if(unzOpenCurrentFile(zip) != UNZ_OK) {
+		return 0;
+	}
+	int length = unzReadCurrentFile(zip, buffer, size - 1);
+	unzCloseCurrentFile(zip);
+	if(length < 0) {
+		return 0;
+	}
+	buffer[length] = '\0';
+	return 1;
+}
+
+// locate a name with the index & compare the entry contents, NULL for a miss
+static int locate(unzFile zip, const char *name, int caseSensitivity, const char *expected) {
+	char buffer[64];
+	int err = unzLocateFileIndexed(zip, name, caseSensitivity);
+	if(!expected) {
+		return err == UNZ_END_OF_LIST_OF_FILE;
+	}
+	return err == UNZ_OK && readCurrent(zip, buffer, sizeof(buffer)) && strcmp(buffer, expected) == 0;
+}
+
+// name of the current entry
+static const char *currentName(unzFile zip) {
+	static char name[256];
+	if(unzGetCurrentFileInfo64(zip, NULL, name, sizeof(name), NULL, 0, NULL, 0) != UNZ_OK) {
+		return "";
+	}
+	return name;
+}
+
+static void testLookup(void) {
+	char path[128];
+	snprintf(path, sizeof(path), "%s/index.zip", dir);
+	zipFile writer = zipOpen64(path, APPEND_STATUS_CREATE);
+	CHECK(writer != NULL);
+	const char *entries[][2] = {
+		{"Scene/", ""},
+		{"Scene/_main.pd", "main"},
+		{"Scene/Image.JPG", "image"},
+		{"win\\path\\file.txt", "win"},
+		{"dup.txt", "first"},
+		{"dup.txt", "second"},
+		{"Case.txt", "upper"},
+		{"case.txt", "lower"}
+	};
+	const int count = sizeof(entries) / sizeof(entries[0]);
+	for(int i = 0; i < count && writer; ++i) {
+		CHECK(ZipFixtureAdd(writer, entries[i][0], entries[i][1], strlen(entries[i][1]), i % 2));
+	}
+	CHECK(writer && zipClose(writer, NULL) == ZIP_OK);
+
+	// through the mmap backend, as ZipMount opens archives
+	mmap_filefunc_mapping mapping = {NULL, 0};
+	zlib_filefunc64_def filefunc;
+	fill_mmap_filefunc64(&filefunc, &mapping);
+	unzFile zip = unzOpen2_64(path, &filefunc);
+	CHECK(zip != NULL);
+	if(!zip) {
+		return;
+	}
+	CHECK(mapping.data != NULL);
+
+	// building keeps the current entry
+	CHECK(unzGoToFirstFile(zip) == UNZ_OK);
+	CHECK(unzGoToNextFile(zip) == UNZ_OK);
+	CHECK(unzBuildIndex(zip, 1) == UNZ_OK);
+	CHECK_STRING(currentName(zip), "Scene/_main.pd");
+
+	// exact
+	CHECK(locate(zip, "Scene/_main.pd", 1, "main"));
+	CHECK(locate(zip, "Scene/Image.JPG", 1, "image"));
+	CHECK(locate(zip, "Scene/", 1, ""));
+	CHECK(locate(zip, "case.txt", 1, "lower"));
+	CHECK(locate(zip, "Case.txt", 1, "upper"));
+
+	// backslashes match slashes both ways
+	CHECK(locate(zip, "win/path/file.txt", 1, "win"));
+	CHECK(locate(zip, "win\\path/file.txt", 1, "win"));
+	CHECK(locate(zip, "Scene\\_main.pd", 1, "main"));
+
+	// duplicates, the first wins like unzLocateFile
+	CHECK(locate(zip, "dup.txt", 1, "first"));
+	CHECK(unzLocateFile(zip, "dup.txt", 1) == UNZ_OK);
+	unz64_file_pos linear, indexed;
+	CHECK(unzGetFilePos64(zip, &linear) == UNZ_OK);
+	CHECK(unzLocateFileIndexed(zip, "dup.txt", 1) == UNZ_OK);
+	CHECK(unzGetFilePos64(zip, &indexed) == UNZ_OK);
+	CHECK_EQUAL(indexed.num_of_file, linear.num_of_file);
+	CHECK_EQUAL(indexed.pos_in_zip_directory, linear.pos_in_zip_directory);
+
+	// misses keep the current entry
+	CHECK(locate(zip, "Scene/_main.pd", 1, "main"));
+	CHECK(locate(zip, "missing.pd", 1, NULL));
+	CHECK(locate(zip, "Scene/_main.p", 1, NULL));
+	CHECK(locate(zip, "scene/image.jpg", 1, NULL));
+	CHECK(locate(zip, "", 1, NULL));
+	CHECK_STRING(currentName(zip), "Scene/_main.pd");
+
+	// case folding rebuilds the index, the first of folded duplicates wins
+	CHECK(locate(zip, "scene/image.jpg", 2, "image"));
+	CHECK(locate(zip, "SCENE\\_MAIN.PD", 2, "main"));
+	CHECK(locate(zip, "CASE.TXT", 2, "upper"));
+	CHECK(locate(zip, "case.txt", 2, "upper"));
+
+	// & back
+	CHECK(locate(zip, "scene/image.jpg", 1, NULL));
+	CHECK(locate(zip, "case.txt", 1, "lower"));
+
+	// every entry agrees with the linear search
+	int err = unzGoToFirstFile(zip), checked = 0;
+	while(err == UNZ_OK) {
+		char name[256];
+		unz64_file_pos current;
+		CHECK(unzGetFilePos64(zip, &current) == UNZ_OK);
+		CHECK(unzGetCurrentFileInfo64(zip, NULL, name, sizeof(name), NULL, 0, NULL, 0) == UNZ_OK);
+		CHECK(unzLocateFile(zip, name, 1) == UNZ_OK);
+		CHECK(unzGetFilePos64(zip, &linear) == UNZ_OK);
+		CHECK(unzLocateFileIndexed(zip, name, 1) == UNZ_OK);
+		CHECK(unzGetFilePos64(zip, &indexed) == UNZ_OK);
+		CHECK_EQUAL(indexed.num_of_file, linear.num_of_file);
+		CHECK(unzGoToFilePos64(zip, &current) == UNZ_OK);
+		err = unzGoToNextFile(zip);
+		checked++;
+	}
+	CHECK_EQUAL(err, UNZ_END_OF_LIST_OF_FILE);
+	CHECK_EQUAL(checked, count);
+	unzClose(zip);
+	CHECK(mapping.data == NULL);
+}
+
+// set the zip64 end of central directory entry counts, as written by tools
+// which truncate them to 0xffff
+static int truncateCount(const char *path) {
+	FILE *f = fopen(path, "r+b");
+	if(!f || fseek(f, 0, SEEK_END) != 0) {
+		if(f) {
+			fclose(f);
+		}
+		return 0;
+	}
+	long size = ftell(f), found = -1;
+	unsigned char tail[1024];
+	long start = (size > (long)sizeof(tail) ? size - (long)sizeof(tail) : 0);
+	fseek(f, start, SEEK_SET);
+	size_t length = fread(tail, 1, sizeof(tail), f);
+	for(long i = (long)length - 4; i >= 0; --i) {
+		if(tail[i] == 0x50 && tail[i + 1] == 0x4b && tail[i + 2] == 0x06 && tail[i + 3] == 0x06) {
+			found = start + i;
+			break;
+		}
+	}
+	unsigned char count[16] = {0xff, 0xff, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 0, 0, 0, 0, 0, 0};
+	int ok = (found >= 0 && fseek(f, found + 24, SEEK_SET) == 0 && fwrite(count, 1, 16, f) == 16);
+	return (fclose(f) == 0 && ok);
+}
+
+// more entries than the truncated count suggests, the index has to grow past
+// the 2 * 0xffff slots sized from the count
+static void testManyEntries(void) {
+	enum {count = 140000};
+	char path[128], name[32];
+	snprintf(path, sizeof(path), "%s/many.zip", dir);
+	zipFile writer = zipOpen64(path, APPEND_STATUS_CREATE);
+	CHECK(writer != NULL);
+	int ok = (writer != NULL);
+	for(int i = 0; i < count && ok; ++i) {
+		snprintf(name, sizeof(name), "f/%06d", i);
+		ok = ZipFixtureAdd(writer, name, name, strlen(name), 1);
+	}
+	CHECK(ok);
+	CHECK(writer && zipClose(writer, NULL) == ZIP_OK);
+	CHECK(truncateCount(path));
+
+	unzFile zip = unzOpen64(path);
+	CHECK(zip != NULL);
+	if(!zip) {
+		return;
+	}
+	unz_global_info64 global;
+	CHECK(unzGetGlobalInfo64(zip, &global) == UNZ_OK);
+	CHECK_EQUAL(global.number_entry, 0xffff);
+
+	// the list ends at the end of the central directory
+	int err = unzGoToFirstFile(zip), listed = 0;
+	while(err == UNZ_OK) {
+		listed++;
+		err = unzGoToNextFile(zip);
+	}
+	CHECK_EQUAL(err, UNZ_END_OF_LIST_OF_FILE);
+	CHECK_EQUAL(listed, count);
+
+	double start = testNow();
+	CHECK(unzBuildIndex(zip, 1) == UNZ_OK);
+	double elapsed = testNow() - start;
+	const int lookups[] = {0, 0xfffe, 0xffff, 0x10000, 0x20001, count - 1};
+	for(int i = 0; i < 6; ++i) {
+		snprintf(name, sizeof(name), "f/%06d", lookups[i]);
+		CHECK(locate(zip, name, 1, name));
+	}
+	snprintf(name, sizeof(name), "f/%06d", count);
+	CHECK(locate(zip, name, 1, NULL));
+	CHECK(unzLocateFile(zip, name, 1) == UNZ_END_OF_LIST_OF_FILE);
+	printf("UnzipIndexTest: indexed %d entries in %.1f ms\n", count, elapsed * 1e3);
+	unzClose(zip);
+}
+
+int main(int argc, char *argv[]) {
+	snprintf(dir, sizeof(dir), "/tmp/UnzipIndexTest.XXXXXX");
+	if(!ZipFixtureTempDir(dir)) {
+		perror("UnzipIndexTest: mkdtemp");
+		return 1;
+	}
+	testLookup();
+	testManyEntries();
+	ZipFixtureRemove(dir);
+	return testResult("UnzipIndexTest");
+}
@@ -0,0 +1,505 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#ifdef __linux__
+	#include <sys/sendfile.h>
+#endif
+#include "Test.h"
+
+// http GET & PUT throughput client
+//
+// loopback: models the web server's file transfer paths before & after
+// serving dispatch data directly, against a server thread on 127.0.0.1 with
+// a page cached file
+//
+//   WebServerBench                      # 1 second per case, 256 MB file
+//   WebServerBench 5 512                # 5 seconds per case, 512 MB file
+//
+// remote: GETs a file from the app's WebDAV server & PUTs the same amount
+// back to a new file next to it, ie. over wifi from a device
+//
+//   WebServerBench 192.168.1.5:8080 /tests/big.wav [seconds]
+
+#define OLD_READ_SIZE (32 * 1024)    // zeroed NSMutableData read chunk
+#define NEW_READ_SIZE (256 * 1024)   // unzeroed pread chunk
+#define OLD_BODY_CAPACITY (256 * 1024) // kBodyReadCapacity body buffer
+#define SOCKET_READ_SIZE (64 * 1024) // dispatch_read socket chunk
+#define HEADER_SIZE 4096
+
+static char dir[64];
+static char sourcePath[128]; ///< GET file
+static char destPath[128];   ///< PUT file
+static long long sourceSize;
+
+// send all bytes, returns 0 on error
+static int sendAll(int fd, const void *bytes, size_t length) {
+	const char *b = (const char *)bytes;
+	while(length > 0) {
+		ssize_t sent = send(fd, b, length, MSG_NOSIGNAL);
+		if(sent < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			return 0;
+		}
+		b += sent;
+		length -= (size_t)sent;
+	}
+	return 1;
+}
+
+// write all bytes to a file, returns 0 on error
+static int writeAll(int fd, const void *bytes, size_t length) {
+	const char *b = (const char *)bytes;
+	while(length > 0) {
+		ssize_t written = write(fd, b, length);
+		if(written < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			return 0;
+		}
+		b += written;
+		length -= (size_t)written;
+	}
+	return 1;
+}
+
+// read a header up to & including the blank line, any body bytes read past
+// it are left in header after the terminator, returns the total bytes read
+// or 0 on error
+static size_t readHeader(int fd, char *header, size_t size, size_t *headerLength) {
+	size_t length = 0;
+	while(length + 1 < size) {
+		ssize_t received = recv(fd, header + length, size - length - 1, 0);
+		if(received <= 0) {
+			return 0;
+		}
+		length += (size_t)received;
+		header[length] = '\0';
+		char *end = strstr(header, "\r\n\r\n");
+		if(end) {
+			*headerLength = (size_t)(end + 4 - header);
+			return length;
+		}
+	}
+	return 0;
+}
+
+// returns the Content-Length header value or -1 if missing
+static long long contentLength(const char *header) {
+	const char *field = strcasestr(header, "\r\nContent-Length:");
+	return (field ? strtoll(field + 17, NULL, 10) : -1);
+}
+
+/// loopback server transfer paths, selected by request path
+typedef enum Path {
+	PATH_OLD,
+	PATH_NEW,
+	PATH_SENDFILE
+} Path;
+
+// old GET: zeroed 32 KB reads copied again when wrapped as dispatch data
+static int getOld(int client, int fd) {
+	char *buffer = malloc(OLD_READ_SIZE), *copy = malloc(OLD_READ_SIZE);
+	int ok = 1;
+	ssize_t length;
+	while(ok) {
+		memset(buffer, 0, OLD_READ_SIZE);
+		if((length = read(fd, buffer, OLD_READ_SIZE)) <= 0) {
+			ok = (length == 0);
+			break;
+		}
+		memcpy(copy, buffer, (size_t)length);
+		ok = sendAll(client, copy, (size_t)length);
+	}
+	free(buffer);
+	free(copy);
+	return ok;
+}
+
+// new GET: 256 KB preads at the offset sent as is
+static int getNew(int client, int fd) {
+	char *buffer = malloc(NEW_READ_SIZE);
+	int ok = 1;
+	off_t offset = 0;
+	ssize_t length;
+	while(ok) {
+		if((length = pread(fd, buffer, NEW_READ_SIZE, offset)) <= 0) {
+			ok = (length == 0);
+			break;
+		}
+		offset += length;
+		ok = sendAll(client, buffer, (size_t)length);
+	}
+	free(buffer);
+	return ok;
+}
+
+// reference GET: kernel copy, not usable with dispatch io owning the socket
+static int getSendfile(int client, int fd) {
+#ifdef __linux__
+	off_t offset = 0;
+	while(offset < sourceSize) {
+		ssize_t sent = sendfile(client, fd, &offset, (size_t)(sourceSize - offset));
+		if(sent <= 0) {
+			return 0;
+		}
+	}
+	return 1;
+#else
+	return getNew(client, fd);
+#endif
+}
+
+// old PUT: each socket chunk copied into a new 256 KB capacity body buffer,
+// then written
+static int putOld(int client, int fd, const char *body, size_t bodyLength, long long length) {
+	char *buffer = malloc(SOCKET_READ_SIZE);
+	int ok = writeAll(fd, body, bodyLength);
+	length -= (long long)bodyLength;
+	while(ok && length > 0) {
+		ssize_t received = recv(client, buffer, SOCKET_READ_SIZE, 0);
+		if(received <= 0) {
+			ok = 0;
+			break;
+		}
+		length -= received;
+		char *bodyData = malloc(OLD_BODY_CAPACITY);
+		memcpy(bodyData, buffer, (size_t)received);
+		ok = writeAll(fd, bodyData, (size_t)received);
+		free(bodyData);
+	}
+	free(buffer);
+	return ok;
+}
+
+// new PUT: socket chunks written as they arrive
+static int putNew(int client, int fd, const char *body, size_t bodyLength, long long length) {
+	char *buffer = malloc(SOCKET_READ_SIZE);
+	int ok = writeAll(fd, body, bodyLength);
+	length -= (long long)bodyLength;
+	while(ok && length > 0) {
+		ssize_t received = recv(client, buffer, SOCKET_READ_SIZE, 0);
+		if(received <= 0) {
+			ok = 0;
+			break;
+		}
+		length -= received;
+		ok = writeAll(fd, buffer, (size_t)received);
+	}
+	free(buffer);
+	return ok;
+}
+
+// handle one request per connection
+static void serve(int client) {
+	char header[HEADER_SIZE], method[8] = "", path[64] = "";
+	size_t headerLength = 0, length = readHeader(client, header, sizeof(header), &headerLength);
+	if(length == 0 || sscanf(header, "%7s %63s", method, path) != 2) {
+		return;
+	}
+	Path which = (strcmp(path, "/new") == 0 ? PATH_NEW :
+	             (strcmp(path, "/sendfile") == 0 ? PATH_SENDFILE : PATH_OLD));
+	int ok = 0;
+	if(strcmp(method, "GET") == 0) {
+		int fd = open(sourcePath, O_RDONLY);
+		if(fd < 0) {
+			return;
+		}
+		char response[128];
+		int n = snprintf(response, sizeof(response),
+			"HTTP/1.1 200 OK\r\nContent-Length: %lld\r\nConnection: close\r\n\r\n", sourceSize);
+		if(sendAll(client, response, (size_t)n)) {
+			switch(which) {
+				case PATH_OLD: ok = getOld(client, fd); break;
+				case PATH_NEW: ok = getNew(client, fd); break;
+				case PATH_SENDFILE: ok = getSendfile(client, fd); break;
+			}
+		}
+		close(fd);
+	}
+	else if(strcmp(method, "PUT") == 0) {
+		int fd = open(destPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if(fd < 0) {
+			return;
+		}
+		long long bodySize = contentLength(header);
+		if(which == PATH_NEW) {
+			ok = putNew(client, fd, header + headerLength, length - headerLength, bodySize);
+		}
+		else {
+			ok = putOld(client, fd, header + headerLength, length - headerLength, bodySize);
+		}
+		ok = (close(fd) == 0 && ok);
+		const char *response = (ok ? "HTTP/1.1 201 Created\r\nContent-Length: 0\r\nConnection: close\r\n\r\n" :
+		                             "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+		sendAll(client, response, strlen(response));
+	}
+}
+
+static void *serverThread(void *userData) {
+	int listener = *(int *)userData;
+	while(1) {
+		int client = accept(listener, NULL, NULL);
+		if(client < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			break; // closed
+		}
+		serve(client);
+		close(client);
+	}
+	return NULL;
+}
+
+// connect to a host, returns the socket or -1 on error
+static int connectTo(const char *host, const char *port) {
+	struct addrinfo hints, *result;
+	memset(&hints, 0, sizeof(struct addrinfo));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	if(getaddrinfo(host, port, &hints, &result) != 0) {
+		return -1;
+	}
+	int fd = -1;
+	for(struct addrinfo *a = result; a; a = a->ai_next) {
+		fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+		if(fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) == 0) {
+			break;
+		}
+		if(fd >= 0) {
+			close(fd);
+			fd = -1;
+		}
+	}
+	freeaddrinfo(result);
+	return fd;
+}
+
+// GET a path & discard the body, returns the body size or -1 on error
+static long long httpGet(const char *host, const char *port, const char *path) {
+	int fd = connectTo(host, port);
+	if(fd < 0) {
+		return -1;
+	}
+	char header[HEADER_SIZE];
+	int n = snprintf(header, sizeof(header), "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n",
+		path, host);
+	size_t headerLength = 0, length = 0;
+	long long size = -1;
+	if(sendAll(fd, header, (size_t)n) &&
+	   (length = readHeader(fd, header, sizeof(header), &headerLength)) > 0 &&
+	   strncmp(header + 9, "200", 3) == 0 && (size = contentLength(header)) >= 0) {
+		char *buffer = malloc(NEW_READ_SIZE);
+		long long received = (long long)(length - headerLength);
+		while(received < size) {
+			ssize_t r = recv(fd, buffer, NEW_READ_SIZE, 0);
+			if(r <= 0) {
+				break;
+			}
+			received += r;
+		}
+		free(buffer);
+		if(received != size) {
+			size = -1;
+		}
+	}
+	close(fd);
+	return size;
+}
+
+// PUT size bytes to a path, returns 1 on success
+static int httpPut(const char *host, const char *port, const char *path, long long size) {
+	int fd = connectTo(host, port);
+	if(fd < 0) {
+		return 0;
+	}
+	char header[HEADER_SIZE];
+	int n = snprintf(header, sizeof(header),
+		"PUT %s HTTP/1.1\r\nHost: %s\r\nContent-Length: %lld\r\nContent-Type: application/octet-stream\r\n"
+		"Connection: close\r\n\r\n", path, host, size);
+	int ok = sendAll(fd, header, (size_t)n);
+	char *buffer = calloc(1, NEW_READ_SIZE);
+	for(long long sent = 0; ok && sent < size; sent += NEW_READ_SIZE) {
+		size_t length = (size - sent < NEW_READ_SIZE ? (size_t)(size - sent) : NEW_READ_SIZE);
+		ok = sendAll(fd, buffer, length);
+	}
+	free(buffer);
+	size_t headerLength = 0;
+	ok = ok && readHeader(fd, header, sizeof(header), &headerLength) > 0 && header[9] == '2';
+	close(fd);
+	return ok;
+}
+
+/// GET, or PUT when putSize > 0, case
+typedef struct Case {
+	const char *name;
+	const char *path;
+	long long putSize;
+	double best;  ///< best time, < 0 on failure
+	long long size;
+} Case;
+
+// run one transfer, returns the elapsed time or -1 on failure
+static double transfer(const char *host, const char *port, Case *c) {
+	double start = testNow();
+	if(c->putSize > 0) {
+		c->size = (httpPut(host, port, c->path, c->putSize) ? c->putSize : -1);
+	}
+	else {
+		c->size = httpGet(host, port, c->path);
+	}
+	return (c->size < 0 ? -1 : testNow() - start);
+}
+
+// run all cases in rounds for the given seconds, at least 3 rounds, prints
+// the best throughput of each, flush removes the loopback upload & writes
+// back dirty pages before each transfer so a PUT doesn't pay for the one
+// before it
+static void run(const char *host, const char *port, Case *cases, int count, double seconds, int flush) {
+	double start = testNow();
+	for(int round = 0; round < 3 || testNow() - start < seconds * count; ++round) {
+		for(int i = 0; i < count; ++i) {
+			if(cases[i].best < 0) {
+				continue;
+			}
+			if(flush) {
+				unlink(destPath); // uploads go to a new temp file
+				sync();
+			}
+			double elapsed = transfer(host, port, &cases[i]);
+			if(elapsed < 0 || cases[i].best == 0 || elapsed < cases[i].best) {
+				cases[i].best = elapsed;
+			}
+		}
+	}
+	for(int i = 0; i < count; ++i) {
+		if(cases[i].best < 0) {
+			printf("%-16s failed\n", cases[i].name);
+			continue;
+		}
+		printf("%-16s %8.1f ms %8.2f GB/s\n", cases[i].name, cases[i].best * 1e3,
+			cases[i].size / cases[i].best * 1e-9);
+	}
+}
+
+// write a file of random-ish bytes & read it once so it's page cached
+static int writeSource(const char *path, long long size) {
+	int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0) {
+		return 0;
+	}
+	unsigned int *buffer = malloc(NEW_READ_SIZE);
+	unsigned int x = 1;
+	int ok = 1;
+	for(long long written = 0; ok && written < size; written += NEW_READ_SIZE) {
+		for(size_t i = 0; i < NEW_READ_SIZE / sizeof(unsigned int); ++i) {
+			x = x * 1664525u + 1013904223u;
+			buffer[i] = x;
+		}
+		size_t length = (size - written < NEW_READ_SIZE ? (size_t)(size - written) : NEW_READ_SIZE);
+		ok = writeAll(fd, buffer, length);
+	}
+	for(off_t offset = 0; ok && pread(fd, buffer, NEW_READ_SIZE, offset) > 0; offset += NEW_READ_SIZE) {}
+	free(buffer);
+	return (close(fd) == 0 && ok);
+}
+
+static int loopback(double seconds, long long size) {
+	snprintf(dir, sizeof(dir), "/tmp/WebServerBench.XXXXXX");
+	if(!mkdtemp(dir)) {
+		perror("WebServerBench: mkdtemp");
+		return 1;
+	}
+	snprintf(sourcePath, sizeof(sourcePath), "%s/source.wav", dir);
+	snprintf(destPath, sizeof(destPath), "%s/dest.wav", dir);
+	sourceSize = size;
+	if(!writeSource(sourcePath, size)) {
+		fprintf(stderr, "WebServerBench: couldn't write %s\n", sourcePath);
+		return 1;
+	}
+
+	int listener = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in address;
+	socklen_t addressLength = sizeof(address);
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	pthread_t thread;
+	if(listener < 0 ||
+	   bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+	   listen(listener, 4) != 0 ||
+	   getsockname(listener, (struct sockaddr *)&address, &addressLength) != 0 ||
+	   pthread_create(&thread, NULL, serverThread, &listener) != 0) {
+		perror("WebServerBench: listen");
+		return 1;
+	}
+	char port[16];
+	snprintf(port, sizeof(port), "%d", ntohs(address.sin_port));
+
+	printf("%lld MB file, %ld cores\n", size / (1024 * 1024), sysconf(_SC_NPROCESSORS_ONLN));
+	Case cases[] = {
+		{"GET 32 KB zeroed", "/old", 0, 0, 0},
+		{"GET 256 KB pread", "/new", 0, 0, 0},
+		{"GET sendfile", "/sendfile", 0, 0, 0},
+		{"PUT copied", "/old", size, 0, 0},
+		{"PUT direct", "/new", size, 0, 0}
+	};
+	run("127.0.0.1", port, cases, sizeof(cases) / sizeof(cases[0]), seconds, 1);
+
+	shutdown(listener, SHUT_RDWR);
+	close(listener);
+	pthread_join(thread, NULL);
+	unlink(sourcePath);
+	unlink(destPath);
+	rmdir(dir);
+	return 0;
+}
+
+static int remote(const char *address, const char *path, double seconds) {
+	char host[256], putPath[1024];
+	const char *colon = strrchr(address, ':');
+	snprintf(host, sizeof(host), "%.*s", (int)(colon - address), address);
+	long long size = httpGet(host, colon + 1, path);
+	if(size < 0) {
+		fprintf(stderr, "WebServerBench: couldn't GET %s from %s\n", path, address);
+		return 1;
+	}
+	snprintf(putPath, sizeof(putPath), "%s.put", path);
+	printf("%s%s, %.1f MB\n", address, path, size * 1e-6);
+	Case cases[] = {
+		{"GET", path, 0, 0, 0},
+		{"PUT", putPath, size, 0, 0}
+	};
+	run(host, colon + 1, cases, 2, seconds, 0);
+	return 0;
+}
+
+int main(int argc, char *argv[]) {
+	if(argc > 2 && strchr(argv[1], ':')) {
+		return remote(argv[1], argv[2], (argc > 3 ? atof(argv[3]) : 1));
+	}
+	double seconds = (argc > 1 ? atof(argv[1]) : 1);
+	long long size = (argc > 2 ? atoll(argv[2]) : 256) * 1024 * 1024;
+	return loopback(seconds, size);
+}
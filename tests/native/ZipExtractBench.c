@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "ZipExtract.h"
+#include "ZipFixture.h"
+#include "minizip/unzip.h"
+#include "Test.h"
+
+static char dir[64];
+
+// create a directory & any missing parents
+static void makeDirectories(const char *path) {
+	char buffer[1024];
+	snprintf(buffer, sizeof(buffer), "%s", path);
+	for(char *c = buffer + 1; *c; ++c) {
+		if(*c == '/') {
+			*c = '\0';
+			mkdir(buffer, 0755);
+			*c = '/';
+		}
+	}
+	mkdir(buffer, 0755);
+}
+
+// baseline: sequential extraction through one handle with a 4 KB buffer &
+// stdio per entry, as done before ZipExtract, returns files written
+static unsigned long extractSequential(const char *zipPath, const char *destPath) {
+	unzFile zip = unzOpen64(zipPath);
+	if(!zip) {
+		return 0;
+	}
+	unsigned char buffer[4096];
+	char name[512], path[1024];
+	unsigned long files = 0;
+	int ret = unzGoToFirstFile(zip);
+	while(ret == UNZ_OK) {
+		unz_file_info64 info;
+		if(unzGetCurrentFileInfo64(zip, &info, name, sizeof(name), NULL, 0, NULL, 0) != UNZ_OK ||
+		   unzOpenCurrentFile(zip) != UNZ_OK) {
+			break;
+		}
+		size_t length = strlen(name);
+		snprintf(path, sizeof(path), "%s/%s", destPath, name);
+		if(length > 0 && name[length - 1] == '/') {
+			makeDirectories(path);
+		}
+		else {
+			*strrchr(path, '/') = '\0';
+			makeDirectories(path);
+			path[strlen(path)] = '/';
+			FILE *f = fopen(path, "wb");
+			int read;
+			while(f && (read = unzReadCurrentFile(zip, buffer, sizeof(buffer))) > 0) {
+				fwrite(buffer, read, 1, f);
+			}
+			if(f) {
+				fclose(f);
+				struct timeval times[2] = {{0, 0}, {0, 0}};
+				utimes(path, times);
+				files++;
+			}
+		}
+		unzCloseCurrentFile(zip);
+		ret = unzGoToNextFile(zip);
+	}
+	unzClose(zip);
+	return files;
+}
+
+// extract into a new dir once, threads < 0 runs the sequential baseline,
+// sets the files written & threads used, returns the elapsed time
+static double extract(const char *zip, int threads, unsigned long *files, int *used) {
+	char dest[128];
+	snprintf(dest, sizeof(dest), "%s/dest", dir);
+	double start = testNow();
+	if(threads < 0) {
+		*files = extractSequential(zip, dest);
+		*used = 1;
+	}
+	else {
+		ZipExtractStats stats;
+		ZipExtract(zip, dest, 0, threads, &stats);
+		*files = stats.files;
+		*used = stats.threads;
+	}
+	double elapsed = testNow() - start;
+	ZipFixtureRemove(dest);
+	return elapsed;
+}
+
+// run all variants in rounds for the given seconds, at least 3 rounds, so
+// file system drift hits each variant alike, prints the best time of each
+static void run(const char *zip, size_t bytes, double seconds) {
+	enum {count = 5};
+	const int threads[count] = {-1, 1, 2, 4, 8};
+	double best[count] = {0};
+	unsigned long files[count] = {0};
+	int used[count] = {0};
+	double start = testNow();
+	for(int round = 0; round < 3 || testNow() - start < seconds; ++round) {
+		for(int i = 0; i < count; ++i) {
+			double elapsed = extract(zip, threads[i], &files[i], &used[i]);
+			if(best[i] == 0 || elapsed < best[i]) {
+				best[i] = elapsed;
+			}
+		}
+	}
+	for(int i = 0; i < count; ++i) {
+		char name[32];
+		if(threads[i] < 0) {
+			snprintf(name, sizeof(name), "sequential 4 KB");
+		}
+		else {
+			snprintf(name, sizeof(name), "ZipExtract %d thread%s", used[i], (used[i] == 1 ? "" : "s"));
+		}
+		printf("%-22s %8.1f ms %8.0f files/s %7.1f MB/s", name, best[i] * 1e3,
+			files[i] / best[i], bytes / best[i] * 1e-6);
+		if(i > 0) {
+			printf(" %5.2fx", best[0] / best[i]);
+		}
+		printf("\n");
+	}
+}
+
+int main(int argc, char *argv[]) {
+	double seconds = (argc > 1 ? atof(argv[1]) : 1);
+	char zip[128];
+	snprintf(dir, sizeof(dir), "/tmp/ZipExtractBench.XXXXXX");
+	if(!ZipFixtureTempDir(dir)) {
+		perror("ZipExtractBench: mkdtemp");
+		return 1;
+	}
+	snprintf(zip, sizeof(zip), "%s/patches.zip", dir);
+
+	// small files are bound by file creation, threads help when the file
+	// system allows concurrent creates & there are cores to spare
+	printf("%ld cores\n", sysconf(_SC_NPROCESSORS_ONLN));
+	const int counts[] = {1000, 5000};
+	for(int c = 0; c < 2; ++c) {
+		size_t bytes = ZipFixturePatches(zip, counts[c], counts[c] / 50);
+		if(bytes == 0) {
+			fprintf(stderr, "ZipExtractBench: couldn't write %s\n", zip);
+			break;
+		}
+		printf("%d patches in %d dirs, %.1f MB:\n", counts[c], counts[c] / 50, bytes * 1e-6);
+		run(zip, bytes, seconds);
+		unlink(zip);
+	}
+	ZipFixtureRemove(dir);
+	return 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include <stdlib.h>
+#include <unistd.h>
+#include "ZipExtract.h"
+#include "ZipFixture.h"
+#include "Test.h"
+
+static char dir[64];
+
+static int checkSanitize(const char *name, const char *expected) {
+	char path[64];
+	int ok = ZipExtractSanitizePath(name, path, sizeof(path));
+	if(!expected) {
+		return !ok;
+	}
+	return ok && strcmp(path, expected) == 0;
+}
+
+static void testSanitize(void) {
+	CHECK(checkSanitize("a/b.pd", "a/b.pd"));
+	CHECK(checkSanitize("/abs/x.pd", "abs/x.pd"));
+	CHECK(checkSanitize("a\\b\\c.pd", "a/b/c.pd"));
+	CHECK(checkSanitize("./a//b/./", "a/b"));
+	CHECK(checkSanitize(".../..a/b..", ".../..a/b.."));
+	CHECK(checkSanitize("../x", NULL));
+	CHECK(checkSanitize("a/../x", NULL));
+	CHECK(checkSanitize("a\\..\\x", NULL));
+	CHECK(checkSanitize("", NULL));
+	CHECK(checkSanitize("/./", NULL));
+	char path[4];
+	CHECK(!ZipExtractSanitizePath("abcd", path, sizeof(path)));
+	CHECK(ZipExtractSanitizePath("abc", path, sizeof(path)));
+}
+
+// compare an extracted patch with the fixture
+static int samePatch(const char *path, int index) {
+	char expected[8192], actual[8192];
+	size_t length = ZipFixturePatch(index, expected, sizeof(expected));
+	FILE *f = fopen(path, "rb");
+	if(!f) {
+		return 0;
+	}
+	size_t read = fread(actual, 1, sizeof(actual), f);
+	fclose(f);
+	return read == length && memcmp(actual, expected, length) == 0;
+}
+
+static void testExtract(void) {
+	char zip[128], dest[128], path[256];
+	const int count = 200, directories = 8;
+	snprintf(zip, sizeof(zip), "%s/patches.zip", dir);
+	snprintf(dest, sizeof(dest), "%s/dest", dir);
+	CHECK(ZipFixturePatches(zip, count, directories) > 0);
+
+	ZipExtractStats stats;
+	CHECK(ZipExtract(zip, dest, 0, 4, &stats));
+	CHECK_EQUAL(stats.entries, count + directories + 2);
+	CHECK_EQUAL(stats.files, count + 1);
+	CHECK_EQUAL(stats.errors, 0);
+	CHECK_EQUAL(stats.rejected, 0);
+	CHECK_EQUAL(stats.threads, 4);
+	CHECK_EQUAL(ZipFixtureCountFiles(dest), count + 1);
+	int same = 0;
+	for(int i = 0; i < count; ++i) {
+		snprintf(path, sizeof(path), "%s/Scenes/scene%03d/patch%05d.pd", dest, i % directories, i);
+		same += samePatch(path, i);
+	}
+	CHECK_EQUAL(same, count);
+
+	// existing files are skipped unless overwriting
+	CHECK(ZipExtract(zip, dest, 0, 2, &stats));
+	CHECK_EQUAL(stats.files, 0);
+	CHECK_EQUAL(stats.skipped, count + 1);
+	CHECK(ZipExtract(zip, dest, 1, 0, &stats));
+	CHECK_EQUAL(stats.files, count + 1);
+	CHECK_EQUAL(stats.skipped, 0);
+	CHECK(ZipFixtureRemove(dest));
+
+	// a single directory
+	CHECK(ZipExtractDirectory(zip, "Scenes/scene001/", dest, 0, 1, &stats));
+	CHECK_EQUAL(stats.files, count / directories);
+	CHECK_EQUAL(stats.threads, 1);
+	CHECK_EQUAL(ZipFixtureCountFiles(dest), count / directories);
+	snprintf(path, sizeof(path), "%s/Scenes/scene001/patch00009.pd", dest);
+	CHECK(samePatch(path, 9));
+	CHECK(ZipFixtureRemove(dest));
+
+	// missing
+	snprintf(path, sizeof(path), "%s/missing.zip", dir);
+	CHECK(!ZipExtract(path, dest, 0, 1, &stats));
+	CHECK_EQUAL(stats.files, 0);
+	unlink(zip);
+}
+
+static void testUnsafe(void) {
+	char zip[128], dest[128], path[256];
+	snprintf(zip, sizeof(zip), "%s/unsafe.zip", dir);
+	snprintf(dest, sizeof(dest), "%s/dest", dir);
+	zipFile z = zipOpen64(zip, APPEND_STATUS_CREATE);
+	CHECK(z != NULL);
+	CHECK(ZipFixtureAdd(z, "../evil.txt", "evil", 4, 0));
+	CHECK(ZipFixtureAdd(z, "sub/../../evil2.txt", "evil", 4, 1));
+	CHECK(ZipFixtureAdd(z, "/ok.txt", "ok", 2, 0));
+	CHECK(zipClose(z, NULL) == ZIP_OK);
+
+	ZipExtractStats stats;
+	CHECK(ZipExtract(zip, dest, 0, 1, &stats));
+	CHECK_EQUAL(stats.rejected, 2);
+	CHECK_EQUAL(stats.files, 1);
+	snprintf(path, sizeof(path), "%s/evil.txt", dir);
+	CHECK(access(path, F_OK) != 0);
+	snprintf(path, sizeof(path), "%s/ok.txt", dest);
+	CHECK(access(path, F_OK) == 0);
+	CHECK(ZipFixtureRemove(dest));
+	unlink(zip);
+}
+
+// flip a byte of entry data found by its text, returns 0 if not found
+static int corrupt(const char *zip, const char *text) {
+	static char data[65536];
+	FILE *f = fopen(zip, "r+b");
+	if(!f) {
+		return 0;
+	}
+	size_t size = fread(data, 1, sizeof(data), f);
+	size_t length = strlen(text);
+	for(size_t i = 0; i + length <= size; ++i) {
+		if(memcmp(data + i, text, length) == 0) {
+			fseek(f, (long)i, SEEK_SET);
+			fputc(text[0] ^ 0x20, f);
+			fclose(f);
+			return 1;
+		}
+	}
+	fclose(f);
+	return 0;
+}
+
+static void testCorrupt(void) {
+	char zip[128], dest[128], path[256];
+	snprintf(zip, sizeof(zip), "%s/corrupt.zip", dir);
+	snprintf(dest, sizeof(dest), "%s/dest", dir);
+	zipFile z = zipOpen64(zip, APPEND_STATUS_CREATE);
+	CHECK(z != NULL);
+	CHECK(ZipFixtureAdd(z, "stored.txt", "stored data to corrupt", 22, 1));
+	CHECK(ZipFixtureAdd(z, "good.txt", "good", 4, 1));
+	CHECK(zipClose(z, NULL) == ZIP_OK);
+	CHECK(corrupt(zip, "data to corrupt"));
+
+	// bad crc fails & doesn't leave a partial file behind
+	ZipExtractStats stats;
+	CHECK(!ZipExtract(zip, dest, 0, 1, &stats));
+	CHECK_EQUAL(stats.errors, 1);
+	CHECK_EQUAL(stats.files, 1);
+	snprintf(path, sizeof(path), "%s/stored.txt", dest);
+	CHECK(access(path, F_OK) != 0);
+	CHECK(ZipFixtureRemove(dest));
+	unlink(zip);
+}
+
+int main(void) {
+	snprintf(dir, sizeof(dir), "/tmp/ZipExtractTest.XXXXXX");
+	if(!ZipFixtureTempDir(dir)) {
+		perror("ZipExtractTest: mkdtemp");
+		return 1;
+	}
+	testSanitize();
+	testExtract();
+	testUnsafe();
+	testCorrupt();
+	ZipFixtureRemove(dir);
+	return testResult("ZipExtractTest");
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#define _XOPEN_SOURCE 700
+#include "ZipFixture.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ftw.h>
+#include <unistd.h>
+
+int ZipFixtureAdd(zipFile zip, const char *name, const void *data, size_t size, int stored) {
+	zip_fileinfo info;
+	memset(&info, 0, sizeof(zip_fileinfo));
+	info.tmz_date.tm_year = 2026;
+	info.tmz_date.tm_mon = 0;
+	info.tmz_date.tm_mday = 1;
+	if(zipOpenNewFileInZip64(zip, name, &info, NULL, 0, NULL, 0, NULL,
+	                         (stored ? 0 : Z_DEFLATED), (stored ? 0 : Z_DEFAULT_COMPRESSION),
+	                         size >= 0xFFFFFFFF) != ZIP_OK) {
+		return 0;
+	}
+	int ok = (size == 0 || zipWriteInFileInZip(zip, data, (unsigned)size) == ZIP_OK);
+	return (zipCloseFileInZip(zip) == ZIP_OK && ok);
+}
+
+size_t ZipFixturePatch(int index, char *buffer, size_t size) {
+	size_t n = snprintf(buffer, size, "#N canvas 0 50 450 300 12;\n");
+	int objects = 8 + (index % 32);
+	for(int i = 0; i < objects && n + 128 < size; ++i) {
+		n += snprintf(buffer + n, size - n, "#X obj %d %d osc~ %d;\n#X msg %d %d \\; pd dsp 1;\n",
+			(i * 7) % 400, (i * 13) % 300, 100 + index + i, i, i);
+	}
+	for(int i = 0; i + 1 < objects && n + 64 < size; ++i) {
+		n += snprintf(buffer + n, size - n, "#X connect %d 0 %d 0;\n", i, i + 1);
+	}
+	return n;
+}
+
+size_t ZipFixturePatches(const char *path, int count, int directories) {
+	zipFile zip = zipOpen64(path, APPEND_STATUS_CREATE);
+	if(!zip) {
+		return 0;
+	}
+	char name[256], patch[8192];
+	size_t total = 0;
+	int ok = ZipFixtureAdd(zip, "Scenes/", NULL, 0, 1);
+	for(int d = 0; d < directories && ok; ++d) {
+		snprintf(name, sizeof(name), "Scenes/scene%03d/", d);
+		ok = ZipFixtureAdd(zip, name, NULL, 0, 1);
+		for(int i = d; i < count && ok; i += directories) {
+			size_t length = ZipFixturePatch(i, patch, sizeof(patch));
+			snprintf(name, sizeof(name), "Scenes/scene%03d/patch%05d.pd", d, i);
+			ok = ZipFixtureAdd(zip, name, patch, length, (i % 10 == 0));
+			total += length;
+		}
+	}
+	const char readme[] = "synthetic scenes\n";
+	ok = ok && ZipFixtureAdd(zip, "readme.txt", readme, sizeof(readme) - 1, 0);
+	total += sizeof(readme) - 1;
+	if(zipClose(zip, NULL) != ZIP_OK || !ok) {
+		unlink(path);
+		return 0;
+	}
+	return total;
+}
+
+int ZipFixtureTempDir(char *path) {
+	return (mkdtemp(path) != NULL);
+}
+
+static int removeEntry(const char *path, const struct stat *st, int flag, struct FTW *ftw) {
+	return remove(path);
+}
+
+int ZipFixtureRemove(const char *path) {
+	return (nftw(path, removeEntry, 16, FTW_DEPTH | FTW_PHYS) == 0);
+}
+
+static int s_files;
+
+static int countEntry(const char *path, const struct stat *st, int flag, struct FTW *ftw) {
+	if(flag == FTW_F) {
+		s_files++;
+	}
+	return 0;
+}
+
+int ZipFixtureCountFiles(const char *path) {
+	s_files = 0;
+	nftw(path, countEntry, 16, FTW_PHYS);
+	return s_files;
+}
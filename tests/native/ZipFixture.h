@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+/* synthetic zip archives & temp dirs for the zip tests & benchmarks */
+#ifndef ZIPFIXTURE_H
+#define ZIPFIXTURE_H
+
+#include <stddef.h>
+#include "minizip/zip.h"
+
+/// add an entry, deflated or stored, a name ending in '/' adds a directory,
+/// returns 0 on error
+int ZipFixtureAdd(zipFile zip, const char *name, const void *data, size_t size, int stored);
+
+/// write a small synthetic pd patch for index into buffer, returns its length
+size_t ZipFixturePatch(int index, char *buffer, size_t size);
+
+/// write an archive of count patches spread over directories within a top
+/// level "Scenes/" directory, every 10th patch is stored, plus a top level
+/// "readme.txt", returns the total uncompressed size or 0 on error
+size_t ZipFixturePatches(const char *path, int count, int directories);
+
+/// create a new temp dir from a template ending in XXXXXX, returns 0 on error
+int ZipFixtureTempDir(char *path);
+
+/// remove a directory & its contents, returns 0 on error
+int ZipFixtureRemove(const char *path);
+
+/// count files below a directory
+int ZipFixtureCountFiles(const char *path);
+
+#endif
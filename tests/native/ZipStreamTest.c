@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2026 Dan Wilcox <danomatika@gmail.com>
+ *
+ * BSD Simplified License.
+ * For information on usage and redistribution, and for a DISCLAIMER OF ALL
+ * WARRANTIES, see the file, "LICENSE.txt," in this distribution.
+ *
+ * See https://github.com/danomatika/PdParty for documentation
+ *
+ */
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "minizip/zip.h"
+#include "minizip/unzip.h"
+#include "ZipFixture.h"
+#include "Test.h"
+
+// streamed directory download as done by GCDWebServerZipResponse: files are
+// read in chunks & written with data descriptors to an output which can't
+// seek back, the pending body is sent whenever it reaches the chunk size
+//
+//   ZipStreamTest         # with a 1 GB sparse .wav
+//   ZipStreamTest 64      # with a 64 MB sparse .wav
+//   ZipStreamTest 4100    # past 4 GB, zip64 sizes & offsets
+
+#define READ_BUFFER_SIZE (64 * 1024)
+#define CHUNK_SIZE (64 * 1024)
+
+#define FLAG_DATA_DESCRIPTOR (1 << 3)
+#define FLAG_UTF8 (1 << 11)
+#define VERSION_MADE_BY_UNIX ((3 << 8) | 20)
+
+static char dir[64];
+
+/// pending body, forward only
+typedef struct Output {
+	unsigned char *data;
+	size_t length;
+	size_t capacity;
+	size_t peak;         ///< largest pending length before the central directory
+	ZPOS64_T position;
+	int fd;              ///< "sent" body
+	unsigned long seeks; ///< rejected seeks
+} Output;
+
+static voidpf ZCALLBACK outputOpen(voidpf opaque, const void *filename, int mode) {
+	return opaque;
+}
+
+static uLong ZCALLBACK outputRead(voidpf opaque, voidpf stream, void *buf, uLong size) {
+	return 0;
+}
+
+static uLong ZCALLBACK outputWrite(voidpf opaque, voidpf stream, const void *buf, uLong size) {
+	Output *output = (Output *)stream;
+	if(output->length + size > output->capacity) {
+		size_t capacity = (output->length + size) * 2;
+		unsigned char *data = realloc(output->data, capacity);
+		if(!data) {
+			return 0;
+		}
+		output->data = data;
+		output->capacity = capacity;
+	}
+	memcpy(output->data + output->length, buf, size);
+	output->length += size;
+	output->position += size;
+	return size;
+}
+
+static ZPOS64_T ZCALLBACK outputTell(voidpf opaque, voidpf stream) {
+	return ((Output *)stream)->position;
+}
+
+static long ZCALLBACK outputSeek(voidpf opaque, voidpf stream, ZPOS64_T offset, int origin) {
+	Output *output = (Output *)stream;
+	if((origin == ZLIB_FILEFUNC_SEEK_SET && offset == output->position) ||
+	   (origin != ZLIB_FILEFUNC_SEEK_SET && offset == 0)) {
+		return 0;
+	}
+	output->seeks++;
+	return -1;
+}
+
+static int ZCALLBACK outputClose(voidpf opaque, voidpf stream) {
+	return 0;
+}
+
+static int ZCALLBACK outputError(voidpf opaque, voidpf stream) {
+	return 0;
+}
+
+// send the pending body
+static int outputSend(Output *output) {
+	if(output->length > output->peak) {
+		output->peak = output->length;
+	}
+	size_t sent = 0;
+	while(sent < output->length) {
+		ssize_t written = write(output->fd, output->data + sent, output->length - sent);
+		if(written <= 0) {
+			return 0;
+		}
+		sent += (size_t)written;
+	}
+	output->length = 0;
+	return 1;
+}
+
+/// source file & what the archive should hold for it
+typedef struct Source {
+	const char *name;
+	int stored;
+	int zip64;
+	mode_t mode;
+	unsigned long long size;
+	unsigned long crc; ///< computed while streaming
+} Source;
+
+// stream one file into the archive, flushing the pending body by chunks
+static int streamFile(zipFile zip, Output *output, Source *source, unsigned char *buffer) {
+	char path[256];
+	snprintf(path, sizeof(path), "%s/src/%s", dir, source->name);
+	int fd = open(path, O_RDONLY);
+	if(fd < 0) {
+		return 0;
+	}
+	zip_fileinfo info;
+	memset(&info, 0, sizeof(zip_fileinfo));
+	info.tmz_date.tm_year = 2026;
+	info.tmz_date.tm_mday = 1;
+	info.external_fa = (uLong)(S_IFREG | source->mode) << 16;
+	int ok = (zipOpenNewFileInZip4_64(zip, source->name, &info, NULL, 0, NULL, 0, NULL,
+		(source->stored ? 0 : Z_DEFLATED), (source->stored ? 0 : Z_DEFAULT_COMPRESSION), 0,
+		-MAX_WBITS, DEF_MEM_LEVEL, Z_DEFAULT_STRATEGY, NULL, 0, VERSION_MADE_BY_UNIX,
+		FLAG_DATA_DESCRIPTOR | FLAG_UTF8, source->zip64) == ZIP_OK);
+	source->crc = crc32(0L, Z_NULL, 0);
+	ssize_t length;
+	while(ok && (length = read(fd, buffer, READ_BUFFER_SIZE)) > 0) {
+		source->crc = crc32(source->crc, buffer, (uInt)length);
+		ok = (zipWriteInFileInZip(zip, buffer, (unsigned)length) == ZIP_OK);
+		if(ok && output->length >= CHUNK_SIZE) {
+			ok = outputSend(output);
+		}
+	}
+	close(fd);
+	return ok && length == 0 && zipCloseFileInZip(zip) == ZIP_OK;
+}
+
+// write a source file, a sparse file when data is NULL
+static int writeSource(const Source *source, const void *data) {
+	char path[256];
+	snprintf(path, sizeof(path), "%s/src/%s", dir, source->name);
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, source->mode);
+	if(fd < 0) {
+		return 0;
+	}
+	int ok = (data ? write(fd, data, source->size) == (ssize_t)source->size :
+	                 ftruncate(fd, (off_t)source->size) == 0);
+	return (close(fd) == 0 && ok);
+}
+
+// read an entry back through unzip, returns its crc or 0 on a read error
+static unsigned long readEntry(unzFile zip, unsigned char *buffer, unsigned long long *size) {
+	unsigned long crc = crc32(0L, Z_NULL, 0);
+	*size = 0;
+	if(unzOpenCurrentFile(zip) != UNZ_OK) {
+		return 0;
+	}
+	int length;
+	while((length = unzReadCurrentFile(zip, buffer, READ_BUFFER_SIZE)) > 0) {
+		crc = crc32(crc, buffer, (uInt)length);
+		*size += (unsigned long long)length;
+	}
+	if(unzCloseCurrentFile(zip) != UNZ_OK || length < 0) {
+		return 0; // crc mismatch with the descriptor or corrupt data
+	}
+	return crc;
+}
+
+static void testStream(unsigned long long bigSize) {
+	enum {count = 5};
+	static char text[3 * 1024 * 1024];
+	char patch[8192], path[256], zipPath[128];
+	size_t patchLength = ZipFixturePatch(7, patch, sizeof(patch));
+	for(size_t i = 0; i < sizeof(text); ++i) {
+		text[i] = (char)('a' + (i * 2654435761u >> 13) % 26); // deflates, but not to nothing
+	}
+	Source sources[count] = {
+		{"main.pd", 0, 0, 0644, patchLength, 0},
+		{"text.txt", 0, 0, 0600, sizeof(text), 0},
+		{"small.wav", 1, 0, 0644, sizeof(text), 0},
+		{"zip64.txt", 0, 1, 0644, patchLength, 0}, // 8 byte descriptor sizes
+		{"big.wav", 1, (bigSize >= 0xFFFFFFFF), 0644, bigSize, 0}
+	};
+	const void *data[count] = {patch, text, text, patch, NULL};
+	snprintf(path, sizeof(path), "%s/src", dir);
+	CHECK(mkdir(path, 0755) == 0);
+	for(int i = 0; i < count; ++i) {
+		CHECK(writeSource(&sources[i], data[i]));
+	}
+
+	// stream
+	snprintf(zipPath, sizeof(zipPath), "%s/download.zip", dir);
+	Output output = {NULL, 0, 0, 0, 0, -1, 0};
+	output.fd = open(zipPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	CHECK(output.fd >= 0);
+	zlib_filefunc64_def filefunc = {outputOpen, outputRead, outputWrite, outputTell,
+	                                outputSeek, outputClose, outputError, &output};
+	zipFile zip = zipOpen2_64("", APPEND_STATUS_CREATE, NULL, &filefunc);
+	CHECK(zip != NULL);
+	unsigned char *buffer = malloc(READ_BUFFER_SIZE);
+	double start = testNow();
+	for(int i = 0; i < count && zip; ++i) {
+		CHECK(streamFile(zip, &output, &sources[i], buffer));
+	}
+	size_t peak = output.peak;
+	CHECK(zip && zipClose(zip, NULL) == ZIP_OK);
+	CHECK(outputSend(&output));
+	double elapsed = testNow() - start;
+	CHECK(close(output.fd) == 0);
+	CHECK_EQUAL(output.seeks, 0);
+	CHECK(peak <= CHUNK_SIZE + READ_BUFFER_SIZE + 1024); // plus a header & descriptor
+	struct stat st;
+	CHECK(stat(zipPath, &st) == 0 && (ZPOS64_T)st.st_size == output.position);
+	printf("ZipStreamTest: streamed %.1f MB in %.2f s, %.1f MB/s, peak pending %zu bytes\n",
+		output.position * 1e-6, elapsed, output.position * 1e-6 / elapsed, peak);
+	free(output.data);
+
+	// read back
+	unzFile unzip = unzOpen64(zipPath);
+	CHECK(unzip != NULL);
+	if(!unzip) {
+		free(buffer);
+		return;
+	}
+	unz_global_info64 global;
+	CHECK(unzGetGlobalInfo64(unzip, &global) == UNZ_OK);
+	CHECK_EQUAL(global.number_entry, count);
+	int i = 0;
+	for(int ret = unzGoToFirstFile(unzip); ret == UNZ_OK && i < count; ret = unzGoToNextFile(unzip), ++i) {
+		unz_file_info64 info;
+		char name[256];
+		CHECK(unzGetCurrentFileInfo64(unzip, &info, name, sizeof(name), NULL, 0, NULL, 0) == UNZ_OK);
+		CHECK_STRING(name, sources[i].name);
+		CHECK((info.flag & FLAG_DATA_DESCRIPTOR) != 0);
+		CHECK((info.flag & FLAG_UTF8) != 0);
+		CHECK_EQUAL(info.version >> 8, 3); // unix host, kept by the zip64 fixup
+		CHECK_EQUAL((info.external_fa >> 16) & 0777, sources[i].mode);
+		CHECK_EQUAL(info.compression_method, (sources[i].stored ? 0 : Z_DEFLATED));
+		CHECK_EQUAL(info.uncompressed_size, sources[i].size);
+		CHECK_EQUAL(info.crc, sources[i].crc);
+		unsigned long long size;
+		CHECK_EQUAL(readEntry(unzip, buffer, &size), sources[i].crc);
+		CHECK_EQUAL(size, sources[i].size);
+	}
+	CHECK_EQUAL(i, count);
+	unzClose(unzip);
+	free(buffer);
+}
+
+int main(int argc, char *argv[]) {
+	unsigned long long bigSize = (argc > 1 ? strtoull(argv[1], NULL, 10) : 1024) * 1024 * 1024;
+	snprintf(dir, sizeof(dir), "/tmp/ZipStreamTest.XXXXXX");
+	if(!ZipFixtureTempDir(dir)) {
+		perror("ZipStreamTest: mkdtemp");
+		return 1;
+	}
+	testStream(bigSize);
+	ZipFixtureRemove(dir);
+	return testResult("ZipStreamTest");
+}